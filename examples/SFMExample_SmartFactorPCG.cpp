@@ -23,6 +23,7 @@
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/linear/Preconditioner.h>
 #include <gtsam/linear/PCGSolver.h>
+#include <gtsam/slam/ImplicitSchurSystem.h>
 
 using namespace std;
 using namespace gtsam;
@@ -47,6 +48,11 @@ int main(int argc, char* argv[]) {
   vector<Point3> points = createPoints();
   vector<Pose3> poses = createPoses();
 
+  // Linearize the smart factors as implicit Schur complements, which the
+  // PCG solver below multiplies with without forming the reduced system
+  SmartProjectionParams smartParams;
+  smartParams.setLinearizationMode(gtsam::IMPLICIT_SCHUR);
+
   // Create a factor graph
   NonlinearFactorGraph graph;
 
@@ -54,7 +60,7 @@ int main(int argc, char* argv[]) {
   for (size_t j = 0; j < points.size(); ++j) {
 
     // every landmark represent a single landmark, we use shared pointer to init the factor, and then insert measurements.
-    SmartFactor::shared_ptr smartfactor(new SmartFactor(measurementNoise, K));
+    SmartFactor::shared_ptr smartfactor(new SmartFactor(measurementNoise, K, smartParams));
 
     for (size_t i = 0; i < poses.size(); ++i) {
 
@@ -88,14 +94,14 @@ int main(int argc, char* argv[]) {
   // We will use LM in the outer optimization loop, but by specifying "Iterative" below
   // We indicate that an iterative linear solver should be used.
   // In addition, the *type* of the iterativeParams decides on the type of
-  // iterative solver, in this case the SPCG (subgraph PCG)
+  // iterative solver, in this case PCG on the implicit Schur complements
   LevenbergMarquardtParams parameters;
   parameters.linearSolverType = NonlinearOptimizerParams::Iterative;
   parameters.absoluteErrorTol = 1e-10;
   parameters.relativeErrorTol = 1e-10;
   parameters.maxIterations = 500;
-  PCGSolverParameters::shared_ptr pcg =
-      boost::make_shared<PCGSolverParameters>();
+  ImplicitSchurPCGSolverParameters<Camera>::shared_ptr pcg =
+      boost::make_shared<ImplicitSchurPCGSolverParameters<Camera> >();
   pcg->preconditioner_ =
       boost::make_shared<BlockJacobiPreconditionerParameters>();
   // Following is crucial:
@@ -2411,6 +2411,12 @@ class ISAM2Params {
   void setEnableDetailedResults(bool enableDetailedResults);
   bool isEnablePartialRelinearizationCheck() const;
   void setEnablePartialRelinearizationCheck(bool enablePartialRelinearizationCheck);
+  string getSlidingWindowMode() const;
+  void setSlidingWindowMode(string slidingWindowMode);
+  double getSlidingWindowLag() const;
+  void setSlidingWindowLag(double slidingWindowLag);
+  size_t getSlidingWindowBatchSize() const;
+  void setSlidingWindowBatchSize(size_t slidingWindowBatchSize);
 };
 
 class ISAM2Clique {
@@ -0,0 +1,114 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinaryBuffer.h
+ * @brief   Append numbers to, and read them back from, a contiguous buffer
+ * @author  agent
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gtsam {
+
+/**
+ * Appends trivially copyable values, in native byte order, to a contiguous
+ * buffer. There is no per-value bookkeeping: what is written is read back in
+ * the same order with a BinaryReader.
+ */
+class BinaryWriter {
+  std::string buffer_;
+
+public:
+  /// Append a number, or any other trivially copyable value
+  template<typename T>
+  void write(const T& x) {
+    static_assert(std::is_trivially_copyable<T>::value,
+        "BinaryWriter::write needs a trivially copyable type");
+    buffer_.append(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+
+  /// Append n values
+  template<typename T>
+  void write(const T* x, size_t n) {
+    static_assert(std::is_trivially_copyable<T>::value,
+        "BinaryWriter::write needs a trivially copyable type");
+    buffer_.append(reinterpret_cast<const char*>(x), n * sizeof(T));
+  }
+
+  /// Reserve room for n more bytes
+  void reserve(size_t n) { buffer_.reserve(buffer_.size() + n); }
+
+  /// Number of bytes written
+  size_t size() const { return buffer_.size(); }
+
+  const std::string& buffer() const { return buffer_; }
+  std::string& buffer() { return buffer_; }
+  void clear() { buffer_.clear(); }
+};
+
+/**
+ * Reads values back from a buffer written by a BinaryWriter, without copying
+ * the buffer. Reading past its end throws std::invalid_argument.
+ */
+class BinaryReader {
+  const char* p_;
+  const char* end_;
+
+public:
+  /// Read from [begin, end), which must outlive the reader
+  BinaryReader(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+  /// Read from a string, which must outlive the reader
+  explicit BinaryReader(const std::string& buffer) :
+      p_(buffer.data()), end_(buffer.data() + buffer.size()) {}
+
+  /// Read a number, or any other trivially copyable value
+  template<typename T>
+  T read() {
+    T x;
+    read(&x, 1);
+    return x;
+  }
+
+  /// Read n values into x
+  template<typename T>
+  void read(T* x, size_t n) {
+    static_assert(std::is_trivially_copyable<T>::value,
+        "BinaryReader::read needs a trivially copyable type");
+    const char* p = skip(n * sizeof(T));
+    if (n)
+      std::memcpy(x, p, n * sizeof(T));
+  }
+
+  /// Skip n bytes, returning a pointer to them
+  const char* skip(size_t n) {
+    if (n > remaining())
+      throw std::invalid_argument("BinaryReader: unexpected end of buffer");
+    const char* p = p_;
+    p_ += n;
+    return p;
+  }
+
+  /// Number of bytes not read yet
+  size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+  /// Current position in the buffer
+  const char* position() const { return p_; }
+};
+
+} // namespace gtsam
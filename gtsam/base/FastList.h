@@ -22,6 +22,10 @@
 #include <list>
 #include <boost/utility/enable_if.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107400
+#include <boost/serialization/library_version_type.hpp>
+#endif
 #include <boost/serialization/list.hpp>
 
 namespace gtsam {
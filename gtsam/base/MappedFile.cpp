@@ -0,0 +1,77 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MappedFile.cpp
+ * @brief   Read-only view of the contents of a file, memory-mapped if possible
+ * @author  agent
+ */
+
+#include <gtsam/base/MappedFile.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+MappedFile::MappedFile(const string& filename) :
+    data_(nullptr), size_(0), valid_(false), mapped_(false) {
+#ifndef _WIN32
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      size_ = static_cast<size_t>(st.st_size);
+      if (size_ == 0) {
+        valid_ = true;
+      } else {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          ::posix_madvise(p, size_, POSIX_MADV_SEQUENTIAL);
+          data_ = static_cast<const char*>(p);
+          valid_ = mapped_ = true;
+        }
+      }
+    }
+    ::close(fd);
+  }
+  if (valid_)
+    return;
+#endif
+  // Fall back on reading the whole file
+  ifstream is(filename.c_str(), ios::binary);
+  if (!is)
+    return;
+  buffer_.assign(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  valid_ = true;
+}
+
+/* ************************************************************************* */
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (mapped_)
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+} // namespace gtsam
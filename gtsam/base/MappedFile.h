@@ -0,0 +1,60 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MappedFile.h
+ * @brief   Read-only view of the contents of a file, memory-mapped if possible
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <cstddef>
+#include <string>
+
+namespace gtsam {
+
+/**
+ * Read-only view of the contents of a whole file. On POSIX systems the file
+ * is memory-mapped, so pages are only read from disk when touched, and are
+ * shared with the page cache. Elsewhere, or if mapping fails, the file is
+ * read into a buffer. The contents of a mapped file are page-aligned.
+ */
+class GTSAM_EXPORT MappedFile {
+  const char* data_;
+  size_t size_;
+  bool valid_, mapped_;
+  std::string buffer_; ///< contents, if the file could not be mapped
+
+public:
+  /// Map the file, check valid() to see whether that succeeded
+  explicit MappedFile(const std::string& filename);
+
+  /// Unmap the file
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// Whether the file could be opened
+  bool valid() const { return valid_; }
+
+  /// Whether the file is memory-mapped, rather than read into a buffer
+  bool mapped() const { return mapped_; }
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+};
+
+} // namespace gtsam
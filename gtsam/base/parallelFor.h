@@ -0,0 +1,50 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file     parallelFor.h
+ * @brief    Loop over a range of indices, in parallel if GTSAM is compiled with TBB
+ * @author   agent
+ * @addtogroup base
+ */
+
+#pragma once
+
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#include <cstddef>
+
+namespace gtsam {
+
+/**
+ * Call f(i) for i in [0, n), in parallel if TBB is available and in increasing
+ * order otherwise. Calls for different i must not depend on each other.
+ */
+template<class F>
+void parallelFor(size_t n, const F& f) {
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i)
+          f(i);
+      });
+#else
+  for (size_t i = 0; i < n; ++i)
+    f(i);
+#endif
+}
+
+} // namespace gtsam
@@ -24,10 +24,15 @@
 #include <string>
 
 // includes for standard serialization types
+#include <boost/serialization/version.hpp> // must precede optional.hpp in Boost 1.74
 #include <boost/serialization/optional.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/version.hpp>
+#if BOOST_VERSION >= 107400
+#include <boost/serialization/library_version_type.hpp>
+#endif
 #include <boost/serialization/list.hpp>
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/weak_ptr.hpp>
@@ -238,6 +238,94 @@ public:
     }
   }
 
+  /**
+   * Products of the (whitened) Jacobian blocks F_i, E_i and error b_i of m
+   * cameras observing a point, accumulated one camera at a time for the fused
+   * Schur complement below. Only fixed-size blocks are stored, so neither F
+   * nor E is ever materialized. Keep an instance around to reuse its memory.
+   */
+  template<int N> // N = 2 or 3
+  struct SchurBlocks {
+    typedef Eigen::Matrix<double, D, D> MatrixDD;
+    typedef Eigen::Matrix<double, D, N> MatrixDN;
+    typedef Eigen::Matrix<double, D, 1> VectorD;
+    typedef Eigen::Matrix<double, ZDim, N> MatrixZN;
+    typedef Eigen::Matrix<double, ZDim, 1> VectorZ;
+
+    std::vector<MatrixDD, Eigen::aligned_allocator<MatrixDD> > FtF; ///< F_i' * F_i
+    std::vector<MatrixDN, Eigen::aligned_allocator<MatrixDN> > FtE; ///< F_i' * E_i
+    std::vector<VectorD, Eigen::aligned_allocator<VectorD> > Ftb; ///< F_i' * b_i
+    Eigen::Matrix<double, N, N> EtE; ///< E' * E
+    Eigen::Matrix<double, N, 1> Etb; ///< E' * b
+    double btb; ///< b' * b
+
+    /// Prepare for m cameras, without releasing memory
+    void reset(size_t m) {
+      FtF.resize(m);
+      FtE.resize(m);
+      Ftb.resize(m);
+      EtE.setZero();
+      Etb.setZero();
+      btb = 0.0;
+    }
+
+    /// Set the products of camera i
+    void set(size_t i, const MatrixZD& Fi, const MatrixZN& Ei,
+        const VectorZ& bi) {
+      FtF[i].noalias() = Fi.transpose() * Fi;
+      FtE[i].noalias() = Fi.transpose() * Ei;
+      Ftb[i].noalias() = Fi.transpose() * bi;
+      EtE.noalias() += Ei.transpose() * Ei;
+      Etb.noalias() += Ei.transpose() * bi;
+      btb += bi.squaredNorm();
+    }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**
+   * Fused Schur complement, same result as SchurComplement(Fs, E, b, lambda,
+   * diagonalDamping) but computed from SchurBlocks. With FtEP_i = F_i'*E_i*P,
+   * G_ij = F_i'*F_i*delta_ij - FtEP_i * (F_j'*E_j)' and
+   * g_i = F_i'*b_i - FtEP_i * E'*b, so each pair of cameras costs a single
+   * (DxN)*(NxD) product, and only the upper triangle is computed.
+   */
+  template<int N> // N = 2 or 3
+  static SymmetricBlockMatrix SchurComplement(const SchurBlocks<N>& blocks,
+      const double lambda = 0.0, bool diagonalDamping = false) {
+    typedef typename SchurBlocks<N>::MatrixDD MatrixDD;
+    typedef typename SchurBlocks<N>::MatrixDN MatrixDN;
+
+    // Point covariance, as in ComputePointCovariance
+    Eigen::Matrix<double, N, N> EtE = blocks.EtE;
+    if (diagonalDamping)
+      EtE.diagonal() += lambda * EtE.diagonal();
+    else
+      EtE.diagonal().array() += lambda;
+    const Eigen::Matrix<double, N, N> P = EtE.inverse();
+    const Eigen::Matrix<double, N, 1> PEtb = P * blocks.Etb;
+
+    // a single point is observed in m cameras
+    const size_t m = blocks.FtE.size();
+    std::vector<DenseIndex> dims(m + 1, D); // this also includes the b term
+    dims.back() = 1;
+    SymmetricBlockMatrix augmentedHessian(dims);
+
+    MatrixDD Gii;
+    for (size_t i = 0; i < m; i++) { // for each camera
+      const MatrixDN FtEP_i = blocks.FtE[i] * P;
+      augmentedHessian.setOffDiagonalBlock(i, m,
+          blocks.Ftb[i] - blocks.FtE[i] * PEtb);
+      Gii.noalias() = blocks.FtF[i] - FtEP_i * blocks.FtE[i].transpose();
+      augmentedHessian.setDiagonalBlock(i, Gii);
+      for (size_t j = i + 1; j < m; j++) // upper triangular part
+        augmentedHessian.setOffDiagonalBlock(i, j,
+            -FtEP_i * blocks.FtE[j].transpose());
+    }
+    augmentedHessian.diagonalBlock(m)(0, 0) = blocks.btb;
+    return augmentedHessian;
+  }
+
   /**
    * Applies Schur complement (exploiting block structure) to get a smart factor on cameras,
    * and adds the contribution of the smart factor to a pre-allocated augmented Hessian.
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <stdexcept>
 
 using namespace std;
 
@@ -260,6 +261,130 @@ Matrix6 Pose3::LogmapDerivative(const Pose3& pose) {
   return J;
 }
 
+/* ************************************************************************* */
+typedef Eigen::Array<double, 1, Eigen::Dynamic> Row;
+
+// Cross products of the columns of two 3*n matrices, one row per coordinate
+static void crossBatch(const Row& ax, const Row& ay, const Row& az,
+    const Row& bx, const Row& by, const Row& bz, Row& cx, Row& cy, Row& cz) {
+  cx = ay * bz - az * by;
+  cy = az * bx - ax * bz;
+  cz = ax * by - ay * bx;
+}
+
+/* ************************************************************************* */
+void Pose3::ExpmapBatch(const Matrix& xis, vector<Pose3>& poses,
+    boost::optional<Matrix&> H) {
+  if (xis.rows() != 6)
+    throw invalid_argument("Pose3::ExpmapBatch: xis must be 6*n");
+  const Eigen::Index n = xis.cols();
+  const Matrix omegas = xis.topRows<3>();
+  Matrix R, Jw;
+  if (H)
+    so3::ExpmapBatch(omegas, R, Jw);
+  else
+    so3::ExpmapBatch(omegas, R);
+
+  // t = (w x v - R * (w x v) + w * w'v) / theta2, as in Expmap
+  const Row wx = xis.row(0).array(), wy = xis.row(1).array(),
+      wz = xis.row(2).array();
+  const Row vx = xis.row(3).array(), vy = xis.row(4).array(),
+      vz = xis.row(5).array();
+  const Row theta2 = wx.square() + wy.square() + wz.square();
+  Row cx, cy, cz;
+  crossBatch(wx, wy, wz, vx, vy, vz, cx, cy, cz);
+  const Row d = wx * vx + wy * vy + wz * vz;
+  const auto large = theta2 > numeric_limits<double>::epsilon();
+  const Row scale = large.select(theta2.inverse(), 0.0);
+  const Row tx = large.select(scale * (cx - (R.row(0).array() * cx
+      + R.row(3).array() * cy + R.row(6).array() * cz) + wx * d), vx);
+  const Row ty = large.select(scale * (cy - (R.row(1).array() * cx
+      + R.row(4).array() * cy + R.row(7).array() * cz) + wy * d), vy);
+  const Row tz = large.select(scale * (cz - (R.row(2).array() * cx
+      + R.row(5).array() * cy + R.row(8).array() * cz) + wz * d), vz);
+
+  poses.resize(n);
+  for (Eigen::Index j = 0; j < n; ++j)
+    poses[j] = Pose3(Rot3(Matrix3(Eigen::Map<const Matrix3>(R.col(j).data()))),
+        Point3(tx(j), ty(j), tz(j)));
+
+  if (H) {
+    H->resize(36, n);
+    for (Eigen::Index j = 0; j < n; ++j) {
+      const Eigen::Map<const Matrix3> Jw_j(Jw.col(j).data());
+      Eigen::Map<Matrix6> H_j(H->col(j).data());
+      H_j << Jw_j, Z_3x3, computeQforExpmapDerivative(xis.col(j)), Jw_j;
+    }
+  }
+}
+
+/* ************************************************************************* */
+void Pose3::LogmapBatch(const vector<Pose3>& poses, Matrix& xis,
+    boost::optional<Matrix&> H) {
+  const Eigen::Index n = poses.size();
+  Matrix R(9, n), T(3, n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    Eigen::Map<Matrix3>(R.col(j).data()) = poses[j].rotation().matrix();
+    T.col(j) = poses[j].translation();
+  }
+  Matrix omegas, Jw;
+  if (H)
+    so3::LogmapBatch(R, omegas, Jw);
+  else
+    so3::LogmapBatch(R, omegas);
+
+  // u = T - 0.5 * w x T + (1 - t / (2 tan(t/2))) / t^2 * w x (w x T), with
+  // t = |w|, as in Logmap
+  Row half(n), F(n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    const double t = omegas.col(j).norm();
+    if (t < 1e-10) {
+      half(j) = 0.0, F(j) = 0.0;
+    } else {
+      half(j) = 0.5;
+      F(j) = (1 - t / (2. * tan(0.5 * t))) / (t * t);
+    }
+  }
+  const Row wx = omegas.row(0).array(), wy = omegas.row(1).array(),
+      wz = omegas.row(2).array();
+  const Row Tx = T.row(0).array(), Ty = T.row(1).array(),
+      Tz = T.row(2).array();
+  Row ax, ay, az, bx, by, bz;
+  crossBatch(wx, wy, wz, Tx, Ty, Tz, ax, ay, az);
+  crossBatch(wx, wy, wz, ax, ay, az, bx, by, bz);
+  xis.resize(6, n);
+  xis.topRows<3>() = omegas;
+  xis.row(3).array() = Tx - half * ax + F * bx;
+  xis.row(4).array() = Ty - half * ay + F * by;
+  xis.row(5).array() = Tz - half * az + F * bz;
+
+  if (H) {
+    // As in LogmapDerivative
+    H->resize(36, n);
+    for (Eigen::Index j = 0; j < n; ++j) {
+      const Eigen::Map<const Matrix3> Jw_j(Jw.col(j).data());
+      const Matrix3 Q = computeQforExpmapDerivative(xis.col(j));
+      Eigen::Map<Matrix6> H_j(H->col(j).data());
+      H_j << Jw_j, Z_3x3, -Jw_j * Q * Jw_j, Jw_j;
+    }
+  }
+}
+
+/* ************************************************************************* */
+void Pose3::RetractBatch(const Matrix& xis, vector<Pose3>& poses) {
+#ifdef GTSAM_POSE3_EXPMAP
+  ExpmapBatch(xis, poses);
+#else
+  if (xis.rows() != 6)
+    throw invalid_argument("Pose3::RetractBatch: xis must be 6*n");
+  vector<Rot3> rotations;
+  Rot3::RetractBatch(xis.topRows<3>(), rotations);
+  poses.resize(rotations.size());
+  for (size_t j = 0; j < rotations.size(); ++j)
+    poses[j] = Pose3(rotations[j], Point3(xis.block<3, 1>(3, j)));
+#endif
+}
+
 /* ************************************************************************* */
 const Point3& Pose3::translation(OptionalJacobian<3, 6> H) const {
   if (H) *H << Z_3x3, rotation().matrix();
@@ -183,6 +183,21 @@ public:
 
   using LieGroup<Pose3, 6>::inverse; // version with derivative
 
+  /**
+   * Expmap of each column of the 6*n matrix xis.  The rotations and
+   * translations of all poses are computed together, see so3::ExpmapBatch.
+   * If asked for, H is 36*n and holds the 6*6 ExpmapDerivative, column-major.
+   */
+  static void ExpmapBatch(const Matrix& xis, std::vector<Pose3>& poses,
+      boost::optional<Matrix&> H = boost::none);
+
+  /// Logmap of each pose into the columns of the 6*n matrix xis, see ExpmapBatch
+  static void LogmapBatch(const std::vector<Pose3>& poses, Matrix& xis,
+      boost::optional<Matrix&> H = boost::none);
+
+  /// ChartAtOrigin::Retract of each column of the 6*n matrix xis
+  static void RetractBatch(const Matrix& xis, std::vector<Pose3>& poses);
+
   /**
    * wedge for Pose3:
    * @param xi 6-dim twist (omega,v) where
@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include <random>
+#include <stdexcept>
 
 using namespace std;
 
@@ -223,6 +224,61 @@ ostream &operator<<(ostream &os, const Rot3& R) {
   return os;
 }
 
+/* ************************************************************************* */
+// Unpack the 9*n column-major rotation matrices of the so3 batch functions
+static void unpack(const Matrix& matrices, vector<Rot3>& rotations) {
+  const size_t n = matrices.cols();
+  rotations.resize(n);
+  for (size_t j = 0; j < n; ++j)
+    rotations[j] = Rot3(Matrix3(Eigen::Map<const Matrix3>(matrices.col(j).data())));
+}
+
+/* ************************************************************************* */
+void Rot3::ExpmapBatch(const Matrix& omegas, vector<Rot3>& rotations,
+    boost::optional<Matrix&> H) {
+  Matrix matrices;
+  so3::ExpmapBatch(omegas, matrices, H);
+  unpack(matrices, rotations);
+}
+
+/* ************************************************************************* */
+void Rot3::LogmapBatch(const vector<Rot3>& rotations, Matrix& omegas,
+    boost::optional<Matrix&> H) {
+  Matrix matrices(9, rotations.size());
+  for (size_t j = 0; j < rotations.size(); ++j)
+    Eigen::Map<Matrix3>(matrices.col(j).data()) = rotations[j].matrix();
+  so3::LogmapBatch(matrices, omegas, H);
+}
+
+/* ************************************************************************* */
+void Rot3::RetractBatch(const Matrix& omegas, vector<Rot3>& rotations) {
+#ifndef GTSAM_USE_QUATERNIONS
+  if (ROT3_DEFAULT_COORDINATES_MODE == Rot3::CAYLEY) {
+    // Same as CayleyChart::Retract, one row per matrix entry
+    if (omegas.rows() != 3)
+      throw invalid_argument("Rot3::RetractBatch: omegas must be 3*n");
+    typedef Eigen::Array<double, 1, Eigen::Dynamic> Row;
+    const auto x = omegas.row(0).array(), y = omegas.row(1).array(),
+        z = omegas.row(2).array();
+    const Row x2 = x.square(), y2 = y.square(), z2 = z.square();
+    const Row f = (4.0 + x2 + y2 + z2).inverse(), _2f = 2.0 * f;
+    Matrix matrices(9, omegas.cols());
+    matrices.row(0).array() = (4.0 + x2 - y2 - z2) * f;
+    matrices.row(1).array() = (x * y + 2.0 * z) * _2f;
+    matrices.row(2).array() = (x * z - 2.0 * y) * _2f;
+    matrices.row(3).array() = (x * y - 2.0 * z) * _2f;
+    matrices.row(4).array() = (4.0 - x2 + y2 - z2) * f;
+    matrices.row(5).array() = (y * z + 2.0 * x) * _2f;
+    matrices.row(6).array() = (x * z + 2.0 * y) * _2f;
+    matrices.row(7).array() = (y * z - 2.0 * x) * _2f;
+    matrices.row(8).array() = (4.0 - x2 - y2 + z2) * f;
+    unpack(matrices, rotations);
+    return;
+  }
+#endif
+  ExpmapBatch(omegas, rotations);
+}
+
 /* ************************************************************************* */
 Rot3 Rot3::slerp(double t, const Rot3& other) const {
   return interpolate(*this, other, t);
@@ -363,6 +363,24 @@ namespace gtsam {
 
     using LieGroup<Rot3, 3>::inverse; // version with derivative
 
+    /// @}
+    /// @name Batch Lie Group operations
+    /// @{
+
+    /**
+     * Expmap of each column of the 3*n matrix omegas, see so3::ExpmapBatch.
+     * If asked for, H is 9*n and holds the 3*3 ExpmapDerivative, column-major.
+     */
+    static void ExpmapBatch(const Matrix& omegas, std::vector<Rot3>& rotations,
+        boost::optional<Matrix&> H = boost::none);
+
+    /// Logmap of each rotation into the columns of omegas, see so3::LogmapBatch
+    static void LogmapBatch(const std::vector<Rot3>& rotations, Matrix& omegas,
+        boost::optional<Matrix&> H = boost::none);
+
+    /// ChartAtOrigin::Retract of each column of the 3*n matrix omegas
+    static void RetractBatch(const Matrix& omegas, std::vector<Rot3>& rotations);
+
     /// @}
     /// @name Group Action on Point3
     /// @{
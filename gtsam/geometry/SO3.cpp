@@ -26,6 +26,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 
 namespace gtsam {
 
@@ -130,6 +131,131 @@ Vector3 DexpFunctor::applyInvDexp(const Vector3& v, OptionalJacobian<3, 3> H1,
   return c;
 }
 
+//******************************************************************************
+typedef Eigen::Array<double, 1, Eigen::Dynamic> Row;
+
+// Write I + A * W + B * W * W for all columns, where W = Hat(omega) and
+// W * W = omega * omega' - theta2 * I.  This is the common form of Rodrigues'
+// formula and of the derivatives of Expmap and Logmap.
+static void rodrigues(const Matrix& omegas, const Row& theta2, const Row& A,
+                      const Row& B, Matrix& M) {
+  const auto wx = omegas.row(0).array(), wy = omegas.row(1).array(),
+             wz = omegas.row(2).array();
+  M.resize(9, omegas.cols());
+  const Row Bxy = B * wx * wy, Bxz = B * wx * wz, Byz = B * wy * wz;
+  M.row(0).array() = 1.0 + B * (wx.square() - theta2);
+  M.row(1).array() = Bxy + A * wz;
+  M.row(2).array() = Bxz - A * wy;
+  M.row(3).array() = Bxy - A * wz;
+  M.row(4).array() = 1.0 + B * (wy.square() - theta2);
+  M.row(5).array() = Byz + A * wx;
+  M.row(6).array() = Bxz + A * wy;
+  M.row(7).array() = Byz - A * wx;
+  M.row(8).array() = 1.0 + B * (wz.square() - theta2);
+}
+
+static Row squaredNorms(const Matrix& omegas) {
+  if (omegas.rows() != 3)
+    throw std::invalid_argument("so3: tangent vectors must be 3*n");
+  return omegas.colwise().squaredNorm().array();
+}
+
+//******************************************************************************
+void ExpmapBatch(const Matrix& omegas, Matrix& rotations,
+                 boost::optional<Matrix&> H) {
+  const Eigen::Index n = omegas.cols();
+  const Row theta2 = squaredNorms(omegas);
+
+  // Coefficients as in ExpmapFunctor and DexpFunctor, first-order near zero
+  Row A(n), B(n), C(n), D(n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    if (theta2(j) <= std::numeric_limits<double>::epsilon()) {
+      A(j) = 1.0, B(j) = 0.0, C(j) = -0.5, D(j) = 0.0;
+    } else {
+      const double theta = std::sqrt(theta2(j));
+      const double s2 = std::sin(theta / 2.0);
+      A(j) = std::sin(theta) / theta;
+      B(j) = 2.0 * s2 * s2 / theta2(j);
+      C(j) = -B(j);
+      D(j) = (1.0 - A(j)) / theta2(j);
+    }
+  }
+
+  rodrigues(omegas, theta2, A, B, rotations);
+  if (H) rodrigues(omegas, theta2, C, D, *H);
+}
+
+//******************************************************************************
+void DexpBatch(const Matrix& omegas, Matrix& H) {
+  const Eigen::Index n = omegas.cols();
+  const Row theta2 = squaredNorms(omegas);
+  Row C(n), D(n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    if (theta2(j) <= std::numeric_limits<double>::epsilon()) {
+      C(j) = -0.5, D(j) = 0.0;
+    } else {
+      const double theta = std::sqrt(theta2(j));
+      const double s2 = std::sin(theta / 2.0);
+      C(j) = -2.0 * s2 * s2 / theta2(j);
+      D(j) = (1.0 - std::sin(theta) / theta) / theta2(j);
+    }
+  }
+  rodrigues(omegas, theta2, C, D, H);
+}
+
+//******************************************************************************
+void LogmapBatch(const Matrix& rotations, Matrix& omegas,
+                 boost::optional<Matrix&> H) {
+  if (rotations.rows() != 9)
+    throw std::invalid_argument("so3::LogmapBatch: rotations must be 9*n");
+  const Eigen::Index n = rotations.cols();
+  const auto& R = rotations;
+
+  // Magnitude of the angle-axis vector, as in SO3::Logmap
+  Row magnitude(n);
+  for (Eigen::Index j = 0; j < n; ++j) {
+    const double tr = R(0, j) + R(4, j) + R(8, j);
+    const double tr_3 = tr - 3.0;
+    if (std::abs(tr + 1.0) < 1e-10) {
+      magnitude(j) = 0.0;  // theta = pi, done below
+    } else if (tr_3 < -1e-7) {
+      const double theta = std::acos((tr - 1.0) / 2.0);
+      magnitude(j) = theta / (2.0 * std::sin(theta));
+    } else {
+      magnitude(j) = 0.5 - tr_3 * tr_3 / 12.0;
+    }
+  }
+
+  omegas.resize(3, n);
+  omegas.row(0).array() = magnitude * (R.row(5).array() - R.row(7).array());
+  omegas.row(1).array() = magnitude * (R.row(6).array() - R.row(2).array());
+  omegas.row(2).array() = magnitude * (R.row(1).array() - R.row(3).array());
+
+  // Rotations by pi are rare, and handled one by one
+  for (Eigen::Index j = 0; j < n; ++j) {
+    if (std::abs(R(0, j) + R(4, j) + R(8, j) + 1.0) < 1e-10)
+      omegas.col(j) =
+          SO3::Logmap(SO3(Eigen::Map<const Matrix3>(R.col(j).data())));
+  }
+
+  if (H) {
+    // Coefficients as in SO3::LogmapDerivative
+    const Row theta2 = squaredNorms(omegas);
+    Row A(n), B(n);
+    for (Eigen::Index j = 0; j < n; ++j) {
+      if (theta2(j) <= std::numeric_limits<double>::epsilon()) {
+        A(j) = 0.0, B(j) = 0.0;
+      } else {
+        const double theta = std::sqrt(theta2(j));
+        A(j) = 0.5;
+        B(j) = 1 / theta2(j) -
+               (1 + std::cos(theta)) / (2 * theta * std::sin(theta));
+      }
+    }
+    rodrigues(omegas, theta2, A, B, *H);
+  }
+}
+
 }  // namespace so3
 
 //******************************************************************************
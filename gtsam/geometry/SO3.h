@@ -178,6 +178,25 @@ class DexpFunctor : public ExpmapFunctor {
                        OptionalJacobian<3, 3> H1 = boost::none,
                        OptionalJacobian<3, 3> H2 = boost::none) const;
 };
+
+// Below are batch versions of Expmap, ExpmapDerivative and Logmap, for many
+// rotations at once. They use a structure-of-arrays layout: the n tangent
+// vectors are the columns of a 3*n matrix, and the n rotation matrices (or 3*3
+// Jacobians) are the columns of a 9*n matrix, each stored column-major. The
+// elementwise arithmetic then runs over contiguous rows, which the compiler
+// can vectorize across rotations.
+
+/// Batch SO3::Expmap, with optional Jacobians SO3::ExpmapDerivative
+GTSAM_EXPORT void ExpmapBatch(const Matrix& omegas, Matrix& rotations,
+                              boost::optional<Matrix&> H = boost::none);
+
+/// Batch SO3::ExpmapDerivative, i.e., DexpFunctor::dexp()
+GTSAM_EXPORT void DexpBatch(const Matrix& omegas, Matrix& H);
+
+/// Batch SO3::Logmap, with optional Jacobians SO3::LogmapDerivative
+GTSAM_EXPORT void LogmapBatch(const Matrix& rotations, Matrix& omegas,
+                              boost::optional<Matrix&> H = boost::none);
+
 }  //  namespace so3
 
 /*
@@ -21,11 +21,11 @@
 
 #include <gtsam/geometry/Unit3.h>
 #include <gtsam/geometry/Point2.h>
-#include <gtsam/config.h>  // for GTSAM_USE_TBB
 
 #include <iostream>
 #include <limits>
 #include <cmath>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -73,20 +73,27 @@ static Point3 CalculateBestAxis(const Point3& n) {
 }
 
 /* ************************************************************************* */
-const Matrix32& Unit3::basis(OptionalJacobian<6, 2> H) const {
-#ifdef GTSAM_USE_TBB
-  // NOTE(hayk): At some point it seemed like this reproducably resulted in
-  // deadlock. However, I don't know why and I can no longer reproduce it.
-  // It either was a red herring or there is still a latent bug left to debug.
-  tbb::mutex::scoped_lock lock(B_mutex_);
-#endif
-
-  const bool cachedBasis = static_cast<bool>(B_);
-  const bool cachedJacobian = static_cast<bool>(H_B_);
+template <class COMPUTE>
+void Unit3::ComputeOnce(std::atomic<int>& state, COMPUTE compute) {
+  if (state.load(std::memory_order_acquire) == kReady)
+    return;
+  int expected = kEmpty;
+  if (state.compare_exchange_strong(expected, kComputing,
+                                    std::memory_order_acquire)) {
+    compute();
+    state.store(kReady, std::memory_order_release);
+  } else {
+    // Another thread is computing, which takes less than a microsecond
+    while (state.load(std::memory_order_acquire) != kReady)
+      std::this_thread::yield();
+  }
+}
 
+/* ************************************************************************* */
+const Matrix32& Unit3::basis(OptionalJacobian<6, 2> H) const {
   if (H) {
-    if (!cachedJacobian) {
-      // Compute Jacobian. Recomputes B_
+    ComputeOnce(H_B_state_, [this]() {
+      // Compute Jacobian, and the basis with it
       Matrix32 B;
       Matrix62 jacobian;
       Matrix33 H_B1_n, H_b1_B1, H_b2_n, H_b2_b1;
@@ -108,28 +115,24 @@ const Matrix32& Unit3::basis(OptionalJacobian<6, 2> H) const {
       auto H_b1_p = jacobian.block<3, 2>(0, 0);
       jacobian.block<3, 2>(3, 0) = H_b2_n * H_n_p + H_b2_b1 * H_b1_p;
 
-      // Cache the result and jacobian
-      H_B_.reset(jacobian);
-      B_.reset(B);
-    }
+      // Cache the jacobian, and the basis unless that was cached already
+      H_B_ = jacobian;
+      ComputeOnce(B_state_, [this, &B]() { B_ = B; });
+    });
 
     // Return cached jacobian, possibly computed just above
-    *H = *H_B_;
+    *H = H_B_;
   }
 
-  if (!cachedBasis) {
+  ComputeOnce(B_state_, [this]() {
     // Same calculation as above, without derivatives.
-    // Done after H block, as that possibly computes B_ for the first time
-    Matrix32 B;
-
     const Point3 n(p_), axis = CalculateBestAxis(n);
     const Point3 B1 = gtsam::cross(n, axis);
-    B.col(0) = normalize(B1);
-    B.col(1) = gtsam::cross(n, B.col(0));
-    B_.reset(B);
-  }
+    B_.col(0) = normalize(B1);
+    B_.col(1) = gtsam::cross(n, B_.col(0));
+  });
 
-  return *B_;
+  return B_;
 }
 
 /* ************************************************************************* */
@@ -29,13 +29,10 @@
 #include <boost/optional.hpp>
 #include <boost/serialization/nvp.hpp>
 
+#include <atomic>
 #include <random>
 #include <string>
 
-#ifdef GTSAM_USE_TBB
-#include <tbb/mutex.h>
-#endif
-
 namespace gtsam {
 
 /// Represents a 3D point on a unit sphere.
@@ -44,12 +41,18 @@ class Unit3 {
 private:
 
   Vector3 p_; ///< The location of the point on the unit sphere
-  mutable boost::optional<Matrix32> B_; ///< Cached basis
-  mutable boost::optional<Matrix62> H_B_; ///< Cached basis derivative
 
-#ifdef GTSAM_USE_TBB
-  mutable tbb::mutex B_mutex_; ///< Mutex to protect the cached basis.
-#endif
+  // The basis and its derivative are computed on first use. Each has a state,
+  // see ComputeOnce, so that reading them once computed takes no lock.
+  enum CacheState { kEmpty, kComputing, kReady };
+  mutable Matrix32 B_; ///< Cached basis
+  mutable Matrix62 H_B_; ///< Cached basis derivative
+  mutable std::atomic<int> B_state_{kEmpty}; ///< State of B_
+  mutable std::atomic<int> H_B_state_{kEmpty}; ///< State of H_B_
+
+  /// Run compute if state is empty, or wait until another thread has done so
+  template <class COMPUTE>
+  static void ComputeOnce(std::atomic<int>& state, COMPUTE compute);
 
 public:
 
@@ -82,14 +85,15 @@ public:
     p_.normalize();
   }
 
-  /// Copy constructor
-  Unit3(const Unit3& u) {
-    p_ = u.p_;
+  /// Copy constructor, the cached basis is computed anew when needed
+  Unit3(const Unit3& u) : p_(u.p_), B_state_(kEmpty), H_B_state_(kEmpty) {
   }
 
-  /// Copy assignment
+  /// Copy assignment, which invalidates the cached basis
   Unit3& operator=(const Unit3 & u) {
     p_ = u.p_;
+    B_state_.store(kEmpty, std::memory_order_relaxed);
+    H_B_state_.store(kEmpty, std::memory_order_relaxed);
     return *this;
   }
 
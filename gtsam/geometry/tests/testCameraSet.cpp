@@ -126,6 +126,41 @@ TEST(CameraSet, Pinhole) {
   EXPECT(assert_equal(actualE, E));
 }
 
+/* ************************************************************************* */
+TEST(CameraSet, FusedSchurComplement) {
+  typedef PinholeCamera<Cal3Bundler> Camera;
+  typedef CameraSet<Camera> Set;
+  Set set;
+  const Cal3Bundler K(500, 1e-3, 1e-3);
+  for (size_t i = 0; i < 3; i++)
+    set.push_back(Camera(Pose3(Rot3::Ypr(0.1 * i, -0.1, 0.2),
+        Point3(0.5 * i, -0.2 * i, -5)), K));
+  Point2Vector measured;
+  measured.push_back(Point2(1, 2));
+  measured.push_back(Point2(3, -4));
+  measured.push_back(Point2(-2, 1));
+  const Point3 p(0.2, 0.1, 1);
+
+  Set::FBlocks Fs;
+  Matrix E;
+  const Vector b = -set.reprojectionError(p, measured, Fs, E);
+
+  Set::SchurBlocks<3> blocks;
+  blocks.reset(3);
+  for (size_t i = 0; i < 3; i++)
+    blocks.set(i, Fs[i], E.block<2, 3>(2 * i, 0), b.segment<2>(2 * i));
+  for (double lambda : {0.0, 0.5}) {
+    for (bool diagonalDamping : {false, true}) {
+      const SymmetricBlockMatrix expected = Set::SchurComplement(Fs, E, b,
+          lambda, diagonalDamping);
+      const SymmetricBlockMatrix actual = Set::SchurComplement(blocks, lambda,
+          diagonalDamping);
+      EXPECT(assert_equal(Matrix(expected.selfadjointView()),
+          Matrix(actual.selfadjointView()), 1e-5));
+    }
+  }
+}
+
 /* ************************************************************************* */
 #include <gtsam/geometry/StereoCamera.h>
 TEST(CameraSet, Stereo) {
@@ -1019,6 +1019,47 @@ TEST(Pose3, print) {
   CHECK_EQUAL(expected.str(), actual);
 }
 
+/* ************************************************************************* */
+TEST(Pose3, Batch) {
+  Matrix xis(6, 4);
+  xis << 0.0, 0.1, -0.3, 1e-12,  //
+         0.0, 0.2, 0.5,  0.0,    //
+         0.0, 0.3, 2.0,  0.0,    //
+         1.0, 0.4, -1.0, 0.2,    //
+         2.0, 0.5, 3.0,  0.3,    //
+         3.0, 0.6, 0.1,  0.4;
+  vector<Pose3> poses, retracted;
+  Matrix H, logs, Hlog;
+  Pose3::ExpmapBatch(xis, poses, H);
+  Pose3::LogmapBatch(poses, logs, Hlog);
+  Pose3::RetractBatch(xis, retracted);
+  for (size_t j = 0; j < 4; ++j) {
+    const Vector6 xi = xis.col(j);
+    Matrix6 expectedH, expectedHlog;
+    const Pose3 expected = Pose3::Expmap(xi, expectedH);
+    EXPECT(assert_equal(expected, poses[j], 1e-12));
+    EXPECT(assert_equal(expectedH,
+        Matrix6(Eigen::Map<const Matrix6>(H.col(j).data())), 1e-12));
+    EXPECT(assert_equal(Pose3::Logmap(expected, expectedHlog),
+        Vector6(logs.col(j)), 1e-12));
+    EXPECT(assert_equal(expectedHlog,
+        Matrix6(Eigen::Map<const Matrix6>(Hlog.col(j).data())), 1e-9));
+    EXPECT(assert_equal(Pose3::Retract(xi), retracted[j], 1e-12));
+  }
+
+  // Rotations alone
+  vector<Rot3> rotations;
+  Matrix omegas;
+  Rot3::RetractBatch(xis.topRows<3>(), rotations);
+  Rot3::LogmapBatch(rotations, omegas);
+  for (size_t j = 0; j < 4; ++j) {
+    const Vector3 omega = xis.block<3, 1>(0, j);
+    EXPECT(assert_equal(Rot3::Retract(omega), rotations[j], 1e-12));
+    EXPECT(assert_equal(Rot3::Logmap(rotations[j]), Vector3(omegas.col(j)),
+        1e-12));
+  }
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
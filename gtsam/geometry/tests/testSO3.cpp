@@ -181,6 +181,35 @@ TEST(SO3, ExpmapFunctor) {
   CHECK(assert_equal(expected, actual4.matrix(), 1e-5));
 }
 
+//******************************************************************************
+TEST(SO3, Batch) {
+  // Columns include zero, near zero, a rotation by pi, and general rotations
+  Matrix omegas(3, 5);
+  omegas << 0.0, 1e-9, M_PI, 0.1, -1.2,  //
+            0.0, 0.0,  0.0,  0.2, 0.7,   //
+            0.0, 0.0,  0.0,  0.3, 2.0;
+  Matrix rotations, H, dexp, omegas2, Hlog;
+  so3::ExpmapBatch(omegas, rotations, H);
+  so3::DexpBatch(omegas, dexp);
+  EXPECT(assert_equal(H, dexp));
+  so3::LogmapBatch(rotations, omegas2, Hlog);
+  for (size_t j = 0; j < 5; ++j) {
+    const Vector3 omega = omegas.col(j);
+    Matrix3 expectedH;
+    const SO3 expected = SO3::Expmap(omega, expectedH);
+    EXPECT(assert_equal(expected.matrix(),
+        Matrix3(Eigen::Map<const Matrix3>(rotations.col(j).data())), 1e-12));
+    EXPECT(assert_equal(expectedH,
+        Matrix3(Eigen::Map<const Matrix3>(H.col(j).data())), 1e-12));
+
+    Matrix3 expectedHlog;
+    const Vector3 expectedLog = SO3::Logmap(expected, expectedHlog);
+    EXPECT(assert_equal(expectedLog, Vector3(omegas2.col(j)), 1e-12));
+    EXPECT(assert_equal(expectedHlog,
+        Matrix3(Eigen::Map<const Matrix3>(Hlog.col(j).data())), 1e-9));
+  }
+}
+
 /* ************************************************************************* */
 namespace exmap_derivative {
 static const Vector3 w(0.1, 0.27, -0.2);
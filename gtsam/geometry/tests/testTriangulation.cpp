@@ -432,6 +432,66 @@ TEST( triangulation, StereotriangulateNonlinear ) {
   }
 }
 
+//******************************************************************************
+// Batch triangulation gives the same results as triangulateSafe, per track
+TEST( triangulation, batch) {
+  typedef PinholeCamera<Cal3_S2> Camera;
+  const Pose3 pose3 = pose1 * Pose3(Rot3::Ypr(0.1, 0.2, 0.1), Point3(0.1, -2, -.1));
+  CameraSet<Camera> cameras;
+  cameras += camera1, camera2, Camera(pose3, Cal3_S2(700, 500, 0, 640, 480));
+
+  // noisy, single-camera, identical-camera, and outlier tracks
+  vector<TriangulationTrack> tracks(5);
+  tracks[0].cameras += 0, 1;
+  tracks[0].measurements += z1 + Point2(0.1, 0.5), z2 + Point2(-0.2, 0.3);
+  tracks[1].cameras += 0;
+  tracks[1].measurements += z1;
+  tracks[2].cameras += 1, 1;
+  tracks[2].measurements += z2, z2;
+  tracks[3].cameras += 0, 1, 2;
+  tracks[3].measurements += z1, z2, cameras[2].project(landmark) + Point2(10, -10);
+  tracks[4].cameras += 2, 0;
+  tracks[4].measurements += cameras[2].project(landmark), z1;
+
+  for (bool enableEPI : {false, true}) {
+    const TriangulationParameters params(1.0, enableEPI, 10, 5);
+    const vector<TriangulationResult> actual = triangulateBatch(cameras, tracks,
+        params);
+    LONGS_EQUAL(5, actual.size());
+    for (size_t j = 0; j < tracks.size(); ++j) {
+      CameraSet<Camera> trackCameras;
+      for (size_t i : tracks[j].cameras)
+        trackCameras.push_back(cameras[i]);
+      const TriangulationResult expected = triangulateSafe(trackCameras,
+          tracks[j].measurements, params);
+      EXPECT(expected.valid() == actual[j].valid());
+      EXPECT(expected.degenerate() == actual[j].degenerate());
+      EXPECT(expected.outlier() == actual[j].outlier());
+      if (expected)
+        EXPECT(assert_equal(*expected, *actual[j], 1e-5));
+    }
+    EXPECT(actual[0].valid());
+    EXPECT(actual[1].degenerate());
+    EXPECT(actual[2].degenerate());
+    EXPECT(actual[3].outlier());
+    EXPECT(assert_equal(landmark, *actual[4], 1e-7));
+  }
+
+  // far points are flagged
+  const vector<TriangulationResult> far = triangulateBatch(cameras, tracks,
+      TriangulationParameters(1.0, false, 4));
+  EXPECT(far[4].farPoint());
+
+  // inconsistent tracks are rejected
+  tracks[0].measurements.pop_back();
+  CHECK_EXCEPTION(triangulateBatch(cameras, tracks, TriangulationParameters()),
+      std::invalid_argument);
+  tracks[0].measurements.push_back(z2);
+  tracks[0].cameras[1] = 3;
+  CHECK_EXCEPTION(triangulateBatch(cameras, tracks, TriangulationParameters()),
+      std::invalid_argument);
+}
+
 //******************************************************************************
 int main() {
   TestResult tr;
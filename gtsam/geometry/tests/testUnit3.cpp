@@ -37,6 +37,7 @@
 
 #include <cmath>
 #include <random>
+#include <thread>
 
 using namespace boost::assign;
 using namespace gtsam;
@@ -353,6 +354,61 @@ TEST(Unit3, basis_derivatives) {
   }
 }
 
+//*******************************************************************************
+/// Threads sharing a Unit3 compute its basis once, and all see the same result.
+TEST(Unit3, basis_threads) {
+  const Unit3 q(0.1, -0.2, 0.9);
+  Matrix62 expectedH;
+  const Matrix32 expected = q.basis(expectedH);
+
+  for (int trial = 0; trial < 20; trial++) {
+    const Unit3 p(0.1, -0.2, 0.9);
+    vector<Matrix32> B(4);
+    vector<Matrix62> H(4);
+    vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++)
+      threads.emplace_back([&, t]() {
+        // Half the threads ask for the derivative first
+        if (t % 2) {
+          B[t] = p.basis(H[t]);
+        } else {
+          B[t] = p.basis();
+          p.basis(H[t]);
+        }
+      });
+    for (std::thread& thread : threads) thread.join();
+    for (size_t t = 0; t < 4; t++) {
+      EXPECT(assert_equal(expected, B[t]));
+      EXPECT(assert_equal(expectedH, H[t]));
+    }
+  }
+}
+
+//*******************************************************************************
+/// Copying or assigning a Unit3 whose basis was cached yields the new basis.
+TEST(Unit3, basis_assignment) {
+  const Unit3 q(0.1, -0.2, 0.9);
+  Matrix62 expectedH;
+  const Matrix32 expected = q.basis(expectedH);
+
+  Unit3 p(0.7, 0.7, 0.0);
+  Matrix62 H;
+  p.basis(H);
+  p = q;
+  EXPECT(assert_equal(expected, p.basis(H)));
+  EXPECT(assert_equal(expectedH, H));
+
+  Unit3 r(0.0, 1.0, 0.0);
+  r.basis();
+  r = q;
+  EXPECT(assert_equal(expected, r.basis()));
+  EXPECT(assert_equal(expectedH, (r.basis(H), H)));
+
+  const Unit3 copy(q);
+  EXPECT(assert_equal(expected, copy.basis(H)));
+  EXPECT(assert_equal(expectedH, H));
+}
+
 //*******************************************************************************
 TEST(Unit3, retract) {
   {
@@ -62,6 +62,35 @@ Point3 triangulateDLT(const std::vector<Matrix34, Eigen::aligned_allocator<Matri
   return Point3(v.head<3>() / v[3]);
 }
 
+void accumulateDLT(Matrix4& R, const Matrix34& projection,
+    const Point2& p) {
+  // Re-triangularize R with the two rows of the new measurement appended
+  Eigen::Matrix<double, 6, 4> stacked;
+  stacked.topRows<4>() = R;
+  stacked.row(4) = p.x() * projection.row(2) - projection.row(0);
+  stacked.row(5) = p.y() * projection.row(2) - projection.row(1);
+  const Eigen::HouseholderQR<Eigen::Matrix<double, 6, 4> > qr(stacked);
+  R = qr.matrixQR().topRows<4>().triangularView<Eigen::Upper>();
+}
+
+boost::optional<Point3> triangulateCompactDLT(const Matrix4& R,
+    double rank_tol) {
+  // A = QR, so A and R have the same singular values and right singular
+  // vectors, and the SVD of R is as accurate as that of A
+  const Eigen::JacobiSVD<Matrix4> svd(R, Eigen::ComputeFullV);
+  const Vector4& s = svd.singularValues();
+  int rank = 0;
+  for (size_t j = 0; j < 4; j++)
+    if (s(j) > rank_tol) rank++;
+
+  if (rank < 3)
+    return boost::none;
+
+  // Create 3D point from homogeneous coordinates
+  const Vector4 v = svd.matrixV().col(3);
+  return Point3(v.head<3>() / v[3]);
+}
+
 ///
 /**
  * Optimize for triangulation
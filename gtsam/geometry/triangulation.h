@@ -25,6 +25,7 @@
 #include <gtsam/slam/PriorFactor.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/base/parallelFor.h>
 
 namespace gtsam {
 
@@ -68,6 +69,28 @@ GTSAM_EXPORT Point3 triangulateDLT(
     const Point2Vector& measurements,
     double rank_tol = 1e-9);
 
+/**
+ * Add the two rows of a measurement to the DLT system in compact form: the 4*4
+ * upper-triangular factor R of A = QR, where A is the 2m*4 DLT matrix of
+ * triangulateHomogeneousDLT. Starting from R = 0, this builds R in fixed-size
+ * matrices without allocating A, and unlike A'*A keeps its conditioning.
+ * @param R triangular factor of the DLT matrix, updated in place
+ * @param projection projection matrix of the camera
+ * @param p measurement in that camera
+ */
+GTSAM_EXPORT void accumulateDLT(Matrix4& R, const Matrix34& projection,
+    const Point2& p);
+
+/**
+ * DLT triangulation from the compact DLT system of accumulateDLT, solved with
+ * a 4*4 SVD of R, which has the same singular values as A.
+ * @param R triangular factor of the DLT matrix A
+ * @param rank_tol rank tolerance on the singular values of A
+ * @return Triangulated Point3, or none if A has rank < 3
+ */
+GTSAM_EXPORT boost::optional<Point3> triangulateCompactDLT(const Matrix4& R,
+    double rank_tol = 1e-9);
+
 /**
  * Create a factor graph with projection factors from poses and one calibration
  * @param poses Camera poses
@@ -514,5 +537,177 @@ TriangulationResult triangulateSafe(const CameraSet<CAMERA>& cameras,
     }
 }
 
+/// A feature track: the cameras a landmark is seen in, and where
+struct TriangulationTrack {
+  std::vector<size_t> cameras; ///< indices into a CameraSet
+  Point2Vector measurements; ///< measurement in each of those cameras
+};
+
+/**
+ * Refine a triangulated point with Levenberg-Marquardt on the reprojection
+ * errors, accumulating the 3*3 normal equations directly rather than building
+ * and optimizing a factor graph, as triangulateNonlinear does. Steps that do
+ * not decrease the error, or that move the point behind a camera, are
+ * rejected and the damping increased. Stops when the step is small, or when
+ * the damping grows too large.
+ * @param cameras all cameras
+ * @param track the cameras the point is seen in, and its measurements
+ * @param point initial estimate
+ * @param maxIterations maximum number of iterations, including rejected steps
+ * @return refined Point3, never with a larger error than the initial estimate
+ */
+template<class CAMERA>
+Point3 refineTriangulation(const CameraSet<CAMERA>& cameras,
+    const TriangulationTrack& track, Point3 point, size_t maxIterations = 10) {
+  // Squared reprojection error at x, and if H and g are given the normal
+  // equations; infinite if x projects behind a camera
+  auto linearize = [&](const Point3& x, Matrix3* H, Vector3* g) {
+    double error = 0.0;
+    Matrix23 D;
+    try {
+      for (size_t k = 0; k < track.cameras.size(); ++k) {
+        const Point2 e = cameras[track.cameras[k]].project2(x, boost::none,
+            H ? &D : 0) - track.measurements[k];
+        if (H) {
+          H->noalias() += D.transpose() * D;
+          g->noalias() += D.transpose() * e;
+        }
+        error += e.squaredNorm();
+      }
+    } catch (CheiralityException&) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return error;
+  };
+
+  Matrix3 H = Matrix3::Zero();
+  Vector3 g = Vector3::Zero();
+  double error = linearize(point, &H, &g);
+  double lambda = 1e-5;
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration) {
+    Matrix3 damped = H;
+    damped.diagonal() += lambda * (H.diagonal().array() + 1e-9).matrix();
+    const Vector3 delta = -damped.ldlt().solve(g);
+    const Point3 candidate = point + delta;
+    const double candidateError = linearize(candidate, 0, 0);
+    if (candidateError < error) {
+      point = candidate;
+      if (delta.norm() <= 1e-9 * (1.0 + point.norm()))
+        break;
+      H.setZero();
+      g.setZero();
+      error = linearize(point, &H, &g);
+      lambda = std::max(lambda / 10, 1e-10);
+    } else {
+      if (lambda > 1e10)
+        break;
+      lambda *= 10;
+    }
+  }
+  return point;
+}
+
+/**
+ * triangulateSafe for one track of a batch, see triangulateBatch: the same
+ * checks, but with triangulateCompactDLT and refineTriangulation.
+ * @param cameras all cameras
+ * @param P projection matrices of all cameras
+ * @param track the cameras the landmark is seen in, and its measurements
+ * @param params triangulation parameters
+ */
+template<class CAMERA>
+TriangulationResult triangulateTrack(const CameraSet<CAMERA>& cameras,
+    const std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> >& P,
+    const TriangulationTrack& track, const TriangulationParameters& params) {
+  const size_t m = track.cameras.size();
+  if (track.measurements.size() != m)
+    throw std::invalid_argument(
+        "triangulateTrack: number of cameras and measurements differ");
+  for (const size_t i : track.cameras)
+    if (i >= cameras.size() || i >= P.size())
+      throw std::invalid_argument("triangulateTrack: invalid camera index");
+
+  // if we have a single pose the corresponding factor is uninformative
+  if (m < 2)
+    return TriangulationResult::Degenerate();
+
+  // Accumulate the DLT system in compact form
+  Matrix4 R = Matrix4::Zero();
+  for (size_t k = 0; k < m; ++k)
+    accumulateDLT(R, P[track.cameras[k]], track.measurements[k]);
+  boost::optional<Point3> dlt = triangulateCompactDLT(R, params.rankTolerance);
+  if (!dlt)
+    return TriangulationResult::Degenerate();
+  Point3 point = *dlt;
+
+  try {
+    if (params.enableEPI)
+      point = refineTriangulation(cameras, track, point);
+
+    // Check landmark distance and re-projection errors to avoid outliers
+    double maxReprojError = 0.0;
+    for (size_t k = 0; k < m; ++k) {
+      const CAMERA& camera = cameras[track.cameras[k]];
+      const Pose3& pose = camera.pose();
+      if (params.landmarkDistanceThreshold > 0
+          && distance3(pose.translation(), point)
+              > params.landmarkDistanceThreshold)
+        return TriangulationResult::FarPoint();
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+      // verify that the triangulated point lies in front of all cameras
+      if (pose.transformTo(point).z() <= 0)
+        return TriangulationResult::BehindCamera();
+#endif
+      // Check reprojection error
+      if (params.dynamicOutlierRejectionThreshold > 0) {
+        const Point2 reprojectionError(camera.project(point)
+            - track.measurements[k]);
+        maxReprojError = std::max(maxReprojError, reprojectionError.norm());
+      }
+    }
+    // Flag as degenerate if average reprojection error is too large
+    if (params.dynamicOutlierRejectionThreshold > 0
+        && maxReprojError > params.dynamicOutlierRejectionThreshold)
+      return TriangulationResult::Outlier();
+  } catch (CheiralityException&) {
+    // point ended up behind a camera while refining or projecting
+    return TriangulationResult::BehindCamera();
+  }
+
+  // all good!
+  return TriangulationResult(point);
+}
+
+/**
+ * Triangulate many tracks, e.g., to initialize all landmarks for bundle
+ * adjustment. The projection matrices are computed once per camera, and the
+ * tracks are triangulated in parallel when GTSAM is built with TBB. Each
+ * result has the same status triangulateSafe would give, but the DLT is solved
+ * in the compact form of accumulateDLT, and if params.enableEPI is set the
+ * refinement is done by refineTriangulation.
+ * @param cameras all cameras
+ * @param tracks feature tracks, with indices into cameras
+ * @param params triangulation parameters
+ * @return a TriangulationResult for every track
+ */
+template<class CAMERA>
+std::vector<TriangulationResult> triangulateBatch(
+    const CameraSet<CAMERA>& cameras,
+    const std::vector<TriangulationTrack>& tracks,
+    const TriangulationParameters& params) {
+  // construct projection matrices from poses & calibration
+  std::vector<Matrix34, Eigen::aligned_allocator<Matrix34> > P;
+  P.reserve(cameras.size());
+  for (const CAMERA& camera : cameras)
+    P.push_back(CameraProjectionMatrix<typename CAMERA::CalibrationType>(
+        camera.calibration())(camera.pose()));
+
+  std::vector<TriangulationResult> results(tracks.size());
+  parallelFor(tracks.size(), [&](size_t j) {
+    results[j] = triangulateTrack(cameras, P, tracks[j], params);
+  });
+  return results;
+}
+
 } // \namespace gtsam
 
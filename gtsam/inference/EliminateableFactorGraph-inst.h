@@ -20,6 +20,7 @@
 
 #include <gtsam/inference/EliminateableFactorGraph.h>
 #include <gtsam/inference/inferenceExceptions.h>
+#include <gtsam/inference/OrderingCache.h>
 #include <boost/tuple/tuple.hpp>
 
 namespace gtsam {
@@ -35,6 +36,14 @@ namespace gtsam {
       // for no variable index first so that it's always computed if we need to call COLAMD because
       // no Ordering is provided.  When removing optional from VariableIndex, create VariableIndex
       // before creating ordering.
+      if (OrderingCache::Global().enabled()) {
+        // Reuse the index and ordering of an earlier graph with the same structure
+        const Ordering::OrderingType type =
+            (orderingType == Ordering::METIS || orderingType == Ordering::NESTED_DISSECTION) ?
+            *orderingType : Ordering::COLAMD;
+        const OrderingCache::Entry cached = OrderingCache::Global().lookup(asDerived(), type);
+        return eliminateSequential(cached.ordering, function, *cached.variableIndex, orderingType);
+      }
       VariableIndex computedVariableIndex(asDerived());
       return eliminateSequential(function, computedVariableIndex, orderingType);
     }
@@ -44,6 +53,10 @@ namespace gtsam {
       if (orderingType == Ordering::METIS) {
         Ordering computedOrdering = Ordering::Metis(asDerived());
         return eliminateSequential(computedOrdering, function, variableIndex, orderingType);
+      } else if (orderingType == Ordering::NESTED_DISSECTION) {
+        Ordering computedOrdering =
+            Ordering::NestedDissection(FlatVariableIndex(*variableIndex));
+        return eliminateSequential(computedOrdering, function, variableIndex, orderingType);
       } else {
         Ordering computedOrdering = Ordering::Colamd(*variableIndex);
         return eliminateSequential(computedOrdering, function, variableIndex, orderingType);
@@ -60,6 +73,9 @@ namespace gtsam {
   {
     if(!variableIndex) {
       // If no VariableIndex provided, compute one and call this function again
+      if (OrderingCache::Global().enabled())
+        return eliminateSequential(ordering, function,
+            *OrderingCache::Global().variableIndex(asDerived()));
       VariableIndex computedVariableIndex(asDerived());
       return eliminateSequential(ordering, function, computedVariableIndex);
     } else {
@@ -89,6 +105,14 @@ namespace gtsam {
       // for no variable index first so that it's always computed if we need to call COLAMD because
       // no Ordering is provided.  When removing optional from VariableIndex, create VariableIndex
       // before creating ordering.
+      if (OrderingCache::Global().enabled()) {
+        // Reuse the index and ordering of an earlier graph with the same structure
+        const Ordering::OrderingType type =
+            (orderingType == Ordering::METIS || orderingType == Ordering::NESTED_DISSECTION) ?
+            *orderingType : Ordering::COLAMD;
+        const OrderingCache::Entry cached = OrderingCache::Global().lookup(asDerived(), type);
+        return eliminateMultifrontal(cached.ordering, function, *cached.variableIndex, orderingType);
+      }
       VariableIndex computedVariableIndex(asDerived());
       return eliminateMultifrontal(function, computedVariableIndex, orderingType);
     }
@@ -98,6 +122,10 @@ namespace gtsam {
       if (orderingType == Ordering::METIS) {
         Ordering computedOrdering = Ordering::Metis(asDerived());
         return eliminateMultifrontal(computedOrdering, function, variableIndex, orderingType);
+      } else if (orderingType == Ordering::NESTED_DISSECTION) {
+        Ordering computedOrdering =
+            Ordering::NestedDissection(FlatVariableIndex(*variableIndex));
+        return eliminateMultifrontal(computedOrdering, function, variableIndex, orderingType);
       } else {
         Ordering computedOrdering = Ordering::Colamd(*variableIndex);
         return eliminateMultifrontal(computedOrdering, function, variableIndex, orderingType);
@@ -114,6 +142,9 @@ namespace gtsam {
   {
     if(!variableIndex) {
       // If no VariableIndex provided, compute one and call this function again
+      if (OrderingCache::Global().enabled())
+        return eliminateMultifrontal(ordering, function,
+            *OrderingCache::Global().variableIndex(asDerived()));
       VariableIndex computedVariableIndex(asDerived());
       return eliminateMultifrontal(ordering, function, computedVariableIndex);
     } else {
@@ -25,6 +25,7 @@
 #include <gtsam/base/treeTraversal-inst.h>
 #include <gtsam/inference/EliminationTree.h>
 #include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/FlatVariableIndex.h>
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/inference/inference-inst.h>
 
@@ -77,6 +78,23 @@ namespace gtsam {
   template<class BAYESNET, class GRAPH>
   EliminationTree<BAYESNET,GRAPH>::EliminationTree(const FactorGraphType& graph,
     const VariableIndex& structure, const Ordering& order)
+  {
+    construct(graph, structure, order);
+  }
+
+  /* ************************************************************************* */
+  template<class BAYESNET, class GRAPH>
+  EliminationTree<BAYESNET,GRAPH>::EliminationTree(const FactorGraphType& graph,
+    const FlatVariableIndex& structure, const Ordering& order)
+  {
+    construct(graph, structure, order);
+  }
+
+  /* ************************************************************************* */
+  template<class BAYESNET, class GRAPH>
+  template<class STRUCTURE>
+  void EliminationTree<BAYESNET,GRAPH>::construct(const FactorGraphType& graph,
+    const STRUCTURE& structure, const Ordering& order)
   {
     gttic(EliminationTree_Contructor);
 
@@ -87,9 +105,14 @@ namespace gtsam {
 
     static const size_t none = std::numeric_limits<size_t>::max();
 
-    // Allocate result parent vector and vector of last factor columns
+    // Allocate result parent vector and vector of last factor columns.  The
+    // ancestors vector is a path-compressed version of parents, pointing to
+    // the highest node found so far in each subtree, so that finding the root
+    // of the subtree containing a node is amortized nearly constant time
+    // instead of proportional to the depth of the tree.
     FastVector<sharedNode> nodes(n);
     FastVector<size_t> parents(n, none);
+    FastVector<size_t> ancestors(n, none);
     FastVector<size_t> prevCol(m, none);
     FastVector<bool> factorUsed(m, false);
 
@@ -98,7 +121,7 @@ namespace gtsam {
       for (size_t j = 0; j < n; j++)
       {
         // Retrieve the factors involving this variable and create the current node
-        const FactorIndices& factors = structure[order[j]];
+        const auto& factors = structure[order[j]];
         const sharedNode node = boost::make_shared<Node>();
         node->key = order[j];
 
@@ -110,20 +133,22 @@ namespace gtsam {
           // variable in this factor a child of the current node.  This means that the variables
           // eliminated earlier in the factor depend on the later variables in the factor.  If we
           // haven't yet hit a variable in this factor, we add the factor to the current node.
-          // TODO: Store root shortcuts instead of parents.
           if (prevCol[i] != none) {
-            size_t k = prevCol[i];
-            // Find root r of the current tree that contains k. Use raw pointers in computing the
-            // parents to avoid changing the reference counts while traversing up the tree.
-            size_t r = k;
-            while (parents[r] != none)
-              r = parents[r];
-            // If the root of the subtree involving this node is actually the current node,
-            // TODO: what does this mean?  forest?
-            if (r != j) {
-              // Now that we found the root, hook up parent and child pointers in the nodes.
+            // Find root r of the current tree that contains k, compressing the path to it so that
+            // all nodes on the way point directly to the current node.
+            size_t r = prevCol[i];
+            while (ancestors[r] != none && ancestors[r] != j) {
+              const size_t next = ancestors[r];
+              ancestors[r] = j;
+              r = next;
+            }
+            // If the root is already the current node, the subtree was hooked up through an
+            // earlier factor.  Otherwise hook up parent and child pointers in the nodes.
+            if (ancestors[r] == none && r != j) {
+              ancestors[r] = j;
               parents[r] = j;
               node->children.push_back(nodes[r]);
+              node->problemSize_ += nodes[r]->problemSize_;
             }
           } else {
             // Add the factor to the current node since we are at the first variable in this factor.
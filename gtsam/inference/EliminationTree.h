@@ -28,6 +28,7 @@ class EliminationTreeTester; // for unit tests, see testEliminationTree
 namespace gtsam {
 
   class VariableIndex;
+  class FlatVariableIndex;
   class Ordering;
 
   /**
@@ -70,6 +71,10 @@ namespace gtsam {
       Key key; ///< key associated with root
       Factors factors; ///< factors associated with root
       Children children; ///< sub-trees
+      int problemSize_ = 1; ///< number of nodes in this sub-tree
+
+      /// Size of the sub-tree, used to decide when to spawn parallel tasks
+      int problemSize() const { return problemSize_; }
 
       sharedFactor eliminate(const boost::shared_ptr<BayesNetType>& output,
         const Eliminate& function, const FastVector<sharedFactor>& childrenFactors) const;
@@ -100,6 +105,12 @@ namespace gtsam {
     EliminationTree(const FactorGraphType& factorGraph,
       const VariableIndex& structure, const Ordering& order);
 
+    /** Build the elimination tree of a factor graph using pre-computed column structure stored
+    * in a FlatVariableIndex.
+    */
+    EliminationTree(const FactorGraphType& factorGraph,
+      const FlatVariableIndex& structure, const Ordering& order);
+
     /** Build the elimination tree of a factor graph.  Note that this has to compute the column
     * structure as a VariableIndex, so if you already have this precomputed, use the other
     * constructor instead.
@@ -161,6 +172,11 @@ namespace gtsam {
     EliminationTree() {}
 
   private:
+    /// Implementation of the constructors from pre-computed column structure
+    template<class STRUCTURE>
+    void construct(const FactorGraphType& graph, const STRUCTURE& structure,
+      const Ordering& order);
+
     /// Allow access to constructor and add methods for testing purposes
     friend class ::EliminationTreeTester;
   };
@@ -0,0 +1,139 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    FlatVariableIndex-inl.h
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/inference/FlatVariableIndex.h>
+#include <gtsam/base/timing.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+template<class FG>
+void FlatVariableIndex::build(const FG& factors) {
+  gttic(FlatVariableIndex_build);
+  assert(keys_.empty());
+
+  // First pass: count the factors of each variable, numbering variables in
+  // the order they are first seen, and remember the number of every entry
+  const size_t m = factors.size();
+  std::unordered_map<Key, size_t> seen;
+  FastVector<size_t> counts, entryIds;
+  for (size_t i = 0; i < m; ++i) {
+    if (!factors[i]) continue;
+    for (const Key key : *factors[i]) {
+      const auto it = seen.emplace(key, counts.size());
+      if (it.second) {
+        keys_.push_back(key);
+        counts.push_back(0);
+      }
+      ++counts[it.first->second];
+      entryIds.push_back(it.first->second);
+    }
+  }
+  nFactors_ = m;
+  nEntries_ = entryIds.size();
+
+  // Columns are in key order, their starts are the prefix sums of the counts
+  std::sort(keys_.begin(), keys_.end());
+  FastVector<size_t> cursors(keys_.size());
+  columns_.resize(keys_.size());
+  size_t start = 0;
+  for (size_t j = 0; j < keys_.size(); ++j) {
+    const size_t id = seen[keys_[j]];
+    const Column column = { start, counts[id], counts[id] };
+    columns_[j] = column;
+    cursors[id] = start;
+    start += counts[id];
+  }
+
+  // Second pass: fill the columns, in increasing factor order as in augment()
+  entries_.resize(nEntries_);
+  size_t k = 0;
+  for (size_t i = 0; i < m; ++i) {
+    if (!factors[i]) continue;
+    for (size_t n = 0; n < factors[i]->size(); ++n)
+      entries_[cursors[entryIds[k++]]++] = i;
+  }
+}
+
+/* ************************************************************************* */
+template<class FG>
+void FlatVariableIndex::augment(const FG& factors,
+    boost::optional<const FactorIndices&> newFactorIndices) {
+  gttic(FlatVariableIndex_augment);
+
+  for (size_t i = 0; i < factors.size(); ++i) {
+    if (factors[i]) {
+      const size_t globalI =
+          newFactorIndices ? (*newFactorIndices)[i] : nFactors_;
+      for (const Key key : *factors[i]) {
+        append(findOrInsert(key), globalI);
+        ++nEntries_;
+      }
+    }
+
+    // Increment factor count even if factors are null, to keep indices consistent
+    if (newFactorIndices) {
+      if ((*newFactorIndices)[i] >= nFactors_)
+        nFactors_ = (*newFactorIndices)[i] + 1;
+    } else {
+      ++nFactors_;
+    }
+  }
+}
+
+/* ************************************************************************* */
+template<typename ITERATOR, class FG>
+void FlatVariableIndex::remove(ITERATOR firstFactor, ITERATOR lastFactor,
+    const FG& factors) {
+  gttic(FlatVariableIndex_remove);
+
+  ITERATOR factorIndex = firstFactor;
+  size_t i = 0;
+  for (; factorIndex != lastFactor; ++factorIndex, ++i) {
+    if (i >= factors.size())
+      throw std::invalid_argument(
+          "Internal error, requested inconsistent number of factor indices and factors in FlatVariableIndex::remove");
+    if (factors[i]) {
+      for (const Key key : *factors[i]) {
+        const size_t j = find(key);
+        if (j == size() || !erase(j, *factorIndex))
+          throw std::invalid_argument(
+              "Internal error, indices and factors passed into FlatVariableIndex::remove are not consistent with the existing variable index");
+        --nEntries_;
+      }
+    }
+  }
+}
+
+/* ************************************************************************* */
+template<typename ITERATOR>
+void FlatVariableIndex::removeUnusedVariables(ITERATOR firstKey, ITERATOR lastKey) {
+  for (ITERATOR key = firstKey; key != lastKey; ++key) {
+    const size_t j = find(*key);
+    if (j == size() || columns_[j].size != 0)
+      throw std::invalid_argument(
+          "Asking to remove variables from the variable index that are not unused");
+    eraseColumn(j);
+  }
+}
+
+}
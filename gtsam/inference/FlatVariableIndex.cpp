@@ -0,0 +1,177 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    FlatVariableIndex.cpp
+ * @author  agent
+ */
+
+#include <gtsam/inference/FlatVariableIndex.h>
+#include <gtsam/inference/VariableIndex.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace gtsam {
+
+using namespace std;
+
+// Capacity of a column the first time it has to grow
+static const size_t kMinColumnCapacity = 4;
+
+/* ************************************************************************* */
+FlatVariableIndex::FlatVariableIndex(const VariableIndex& variableIndex) :
+    nFactors_(variableIndex.nFactors()), nEntries_(variableIndex.nEntries()),
+    nUnused_(0) {
+  keys_.reserve(variableIndex.size());
+  columns_.reserve(variableIndex.size());
+  entries_.reserve(nEntries_);
+  for (const VariableIndex::value_type& key_factors : variableIndex) {
+    const Column column = { entries_.size(), key_factors.second.size(),
+        key_factors.second.size() };
+    keys_.push_back(key_factors.first);
+    columns_.push_back(column);
+    entries_.insert(entries_.end(), key_factors.second.begin(),
+        key_factors.second.end());
+  }
+}
+
+/* ************************************************************************* */
+size_t FlatVariableIndex::find(Key variable) const {
+  const KeyVector::const_iterator it =
+      std::lower_bound(keys_.begin(), keys_.end(), variable);
+  if (it == keys_.end() || *it != variable)
+    return size();
+  return it - keys_.begin();
+}
+
+/* ************************************************************************* */
+FlatVariableIndex::Factors FlatVariableIndex::operator[](Key variable) const {
+  const size_t j = find(variable);
+  if (j == size())
+    throw std::invalid_argument(
+        "Requested non-existent variable from FlatVariableIndex");
+  return column(j);
+}
+
+/* ************************************************************************* */
+bool FlatVariableIndex::equals(const FlatVariableIndex& other, double tol) const {
+  if (nEntries_ != other.nEntries_ || nFactors_ != other.nFactors_
+      || keys_ != other.keys_)
+    return false;
+  for (size_t j = 0; j < size(); ++j) {
+    const Factors mine = column(j), theirs = other.column(j);
+    if (mine.size() != theirs.size()
+        || !std::equal(mine.begin(), mine.end(), theirs.begin()))
+      return false;
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+void FlatVariableIndex::print(const string& str,
+    const KeyFormatter& keyFormatter) const {
+  cout << str;
+  cout << "nEntries = " << nEntries() << ", nFactors = " << nFactors() << "\n";
+  for (size_t j = 0; j < size(); ++j) {
+    cout << "var " << keyFormatter(keys_[j]) << ":";
+    for (const FactorIndex index : column(j))
+      cout << " " << index;
+    cout << "\n";
+  }
+  cout.flush();
+}
+
+/* ************************************************************************* */
+void FlatVariableIndex::compact() {
+  gttic(FlatVariableIndex_compact);
+  std::vector<FactorIndex> entries;
+  entries.reserve(nEntries_);
+  for (Column& column : columns_) {
+    const size_t start = entries.size();
+    entries.insert(entries.end(), entries_.begin() + column.start,
+        entries_.begin() + column.start + column.size);
+    column.start = start;
+    column.capacity = column.size;
+  }
+  entries_.swap(entries);
+  nUnused_ = 0;
+}
+
+/* ************************************************************************* */
+size_t FlatVariableIndex::findOrInsert(Key variable) {
+  // New variables usually have the largest key so far
+  const Column empty = { entries_.size(), 0, 0 };
+  if (keys_.empty() || variable > keys_.back()) {
+    keys_.push_back(variable);
+    columns_.push_back(empty);
+    return size() - 1;
+  }
+  const KeyVector::iterator it =
+      std::lower_bound(keys_.begin(), keys_.end(), variable);
+  const size_t j = it - keys_.begin();
+  if (*it != variable) {
+    keys_.insert(it, variable);
+    columns_.insert(columns_.begin() + j, empty);
+  }
+  return j;
+}
+
+/* ************************************************************************* */
+void FlatVariableIndex::append(size_t j, FactorIndex factorIndex) {
+  Column& column = columns_[j];
+  if (column.size == column.capacity) {
+    const size_t capacity = std::max(kMinColumnCapacity, 2 * column.capacity);
+    if (column.start + column.capacity == entries_.size()) {
+      // Last column in the array, grow in place
+      entries_.resize(column.start + capacity);
+    } else {
+      // Move the column to the end of the array
+      const size_t start = entries_.size();
+      entries_.resize(start + capacity);
+      std::copy(entries_.begin() + column.start,
+          entries_.begin() + column.start + column.size,
+          entries_.begin() + start);
+      nUnused_ += column.capacity;
+      column.start = start;
+    }
+    column.capacity = capacity;
+  }
+  entries_[column.start + column.size++] = factorIndex;
+
+  // Give back the space of moved columns once it dominates the array
+  if (2 * nUnused_ > entries_.size())
+    compact();
+}
+
+/* ************************************************************************* */
+bool FlatVariableIndex::erase(size_t j, FactorIndex factorIndex) {
+  Column& column = columns_[j];
+  const std::vector<FactorIndex>::iterator first = entries_.begin()
+      + column.start, last = first + column.size;
+  const std::vector<FactorIndex>::iterator entry = std::find(first, last,
+      factorIndex);
+  if (entry == last)
+    return false;
+  std::copy(entry + 1, last, entry);
+  --column.size;
+  return true;
+}
+
+/* ************************************************************************* */
+void FlatVariableIndex::eraseColumn(size_t j) {
+  assert(columns_[j].size == 0);
+  nUnused_ += columns_[j].capacity;
+  keys_.erase(keys_.begin() + j);
+  columns_.erase(columns_.begin() + j);
+}
+
+}
@@ -0,0 +1,219 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    FlatVariableIndex.h
+ * @brief   Variable index stored in compressed sparse column format
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/inference/Factor.h>
+#include <gtsam/inference/Key.h>
+#include <gtsam/base/FastVector.h>
+#include <gtsam/base/Testable.h>
+#include <gtsam/base/types.h>
+#include <gtsam/dllexport.h>
+
+#include <boost/optional/optional.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+class VariableIndex;
+
+/**
+ * A FlatVariableIndex stores the same information as a VariableIndex, i.e.
+ * the list of factors involving each variable, but in flat arrays: the keys
+ * are kept sorted in one vector and identified by their dense position
+ * ("column") in it, and the factor lists of all columns live in a single
+ * contiguous array of factor indices.  This is the compressed sparse column
+ * layout COLAMD and METIS work with, so orderings and elimination trees can be
+ * computed from it without per-key map lookups or per-key heap vectors.
+ *
+ * To support incremental use, every column has a capacity that may exceed its
+ * size.  When a full column is appended to, it is moved to the end of the
+ * array with doubled capacity, and the array is compacted once more than half
+ * of it is unused.  Column indices are only valid until the next call that
+ * adds or removes variables.
+ * \nosubgrouping
+ */
+class GTSAM_EXPORT FlatVariableIndex {
+ public:
+  typedef boost::shared_ptr<FlatVariableIndex> shared_ptr;
+
+  /// Read-only view of the factor indices of one variable
+  class Factors {
+    const FactorIndex* begin_;
+    const FactorIndex* end_;
+   public:
+    typedef const FactorIndex* const_iterator;
+    Factors(const FactorIndex* begin, const FactorIndex* end) :
+        begin_(begin), end_(end) {
+    }
+    const_iterator begin() const { return begin_; }
+    const_iterator end() const { return end_; }
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    FactorIndex operator[](size_t i) const { return begin_[i]; }
+  };
+
+ protected:
+  /// Location of one column in entries_
+  struct Column {
+    size_t start;
+    size_t size;
+    size_t capacity;
+  };
+
+  KeyVector keys_;  ///< Sorted keys, position is the column index
+  std::vector<Column> columns_;  ///< Column j holds the factors of keys_[j]
+  std::vector<FactorIndex> entries_;  ///< Factor indices of all columns
+  size_t nFactors_;  ///< Number of factors in the original factor graph.
+  size_t nEntries_;  ///< Sum of involved variable counts of each factor.
+  size_t nUnused_;  ///< Number of slots in entries_ not owned by any column
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Default constructor, creates an empty FlatVariableIndex
+  FlatVariableIndex() : nFactors_(0), nEntries_(0), nUnused_(0) {}
+
+  /**
+   * Create a FlatVariableIndex that computes and stores the block column
+   * structure of a factor graph.
+   */
+  template <class FG>
+  explicit FlatVariableIndex(const FG& factorGraph) :
+      nFactors_(0), nEntries_(0), nUnused_(0) {
+    build(factorGraph);
+  }
+
+  /// Copy the structure of a VariableIndex into flat arrays
+  explicit FlatVariableIndex(const VariableIndex& variableIndex);
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// The number of variable entries.  This is equal to the number of unique variable Keys.
+  size_t size() const { return keys_.size(); }
+
+  /// The number of factors in the original factor graph
+  size_t nFactors() const { return nFactors_; }
+
+  /// The number of nonzero blocks, i.e. the number of variable-factor entries
+  size_t nEntries() const { return nEntries_; }
+
+  /// All keys in increasing order, key(j) == keys()[j]
+  const KeyVector& keys() const { return keys_; }
+
+  /// The key of column j
+  Key key(size_t j) const { return keys_[j]; }
+
+  /// The factors involving the variable in column j
+  Factors column(size_t j) const {
+    const Column& c = columns_[j];
+    const FactorIndex* start = entries_.data() + c.start;
+    return Factors(start, start + c.size);
+  }
+
+  /// Find the column of a variable, or size() if it does not exist
+  size_t find(Key variable) const;
+
+  /// Return true if the variable exists in the index
+  bool exists(Key variable) const { return find(variable) != size(); }
+
+  /// Access the factors involving a variable, throws if it does not exist
+  Factors operator[](Key variable) const;
+
+  /// Return true if no factors associated with a variable
+  bool empty(Key variable) const { return (*this)[variable].empty(); }
+
+  /// @}
+  /// @name Testable
+  /// @{
+
+  /// Test for equality (for unit tests and debug assertions).
+  bool equals(const FlatVariableIndex& other, double tol=0.0) const;
+
+  /// Print the variable index (for unit tests and debugging).
+  void print(const std::string& str = "FlatVariableIndex: ",
+      const KeyFormatter& keyFormatter = DefaultKeyFormatter) const;
+
+  /// @}
+  /// @name Advanced Interface
+  /// @{
+
+  /**
+   * Augment the variable index with new factors.  This can be used when
+   * solving problems incrementally.
+   */
+  template<class FG>
+  void augment(const FG& factors, boost::optional<const FactorIndices&> newFactorIndices = boost::none);
+
+  /**
+   * Remove entries corresponding to the specified factors.  As in
+   * VariableIndex::remove, nFactors_ is intentionally not decremented.
+   *
+   * @param indices The indices of the factors to remove, which must match \c factors
+   * @param factors The factors being removed, which must symbolically correspond exactly to the
+   *        factors with the specified \c indices that were added.
+   */
+  template<typename ITERATOR, class FG>
+  void remove(ITERATOR firstFactor, ITERATOR lastFactor, const FG& factors);
+
+  /// Remove unused empty variables, throws if any of them is still in use.
+  template<typename ITERATOR>
+  void removeUnusedVariables(ITERATOR firstKey, ITERATOR lastKey);
+
+  /// Store all columns contiguously in key order, without any slack.
+  void compact();
+
+  /// @}
+
+ protected:
+  /**
+   * Build the index from scratch in two passes: count the factors of each
+   * variable, then fill every column at its prefix-sum offset. Only the
+   * distinct keys are sorted, not the entries.
+   */
+  template<class FG>
+  void build(const FG& factors);
+
+  /// Column of a key, inserting an empty column if it does not exist yet
+  size_t findOrInsert(Key variable);
+
+  /// Append a factor index to column j, growing it if it is full
+  void append(size_t j, FactorIndex factorIndex);
+
+  /// Remove a factor index from column j, returns false if it is not there
+  bool erase(size_t j, FactorIndex factorIndex);
+
+  /// Remove column j, which must be empty
+  void eraseColumn(size_t j);
+};
+
+/// traits
+template<>
+struct traits<FlatVariableIndex> : public Testable<FlatVariableIndex> {
+};
+
+} // \namespace gtsam
+
+#include <gtsam/inference/FlatVariableIndex-inl.h>
@@ -33,6 +33,7 @@ struct ConstructorTraversalData {
   typedef typename JunctionTree<BAYESTREE, GRAPH>::sharedNode sharedNode;
 
   ConstructorTraversalData* const parentData;
+  size_t myIndexInParent;
   sharedNode myJTNode;
   FastVector<SymbolicConditional::shared_ptr> childSymbolicConditionals;
   FastVector<SymbolicFactor::shared_ptr> childSymbolicFactors;
@@ -42,7 +43,7 @@ struct ConstructorTraversalData {
   };
 
   ConstructorTraversalData(ConstructorTraversalData* _parentData) :
-      parentData(_parentData) {
+      parentData(_parentData), myIndexInParent(0) {
   }
 
   // Pre-order visitor function
@@ -51,10 +52,16 @@ struct ConstructorTraversalData {
       ConstructorTraversalData& parentData) {
     // On the pre-order pass, before children have been visited, we just set up
     // a traversal data structure with its own JT node, and create a child
-    // pointer in its parent.
+    // pointer in its parent.  We also reserve the slots in the parent where
+    // our symbolic elimination results will go, so that siblings can be
+    // processed concurrently and still be stored in child order.
     ConstructorTraversalData myData = ConstructorTraversalData(&parentData);
     myData.myJTNode = boost::make_shared<Node>(node->key, node->factors);
     parentData.myJTNode->addChild(myData.myJTNode);
+    myData.myIndexInParent = parentData.childSymbolicConditionals.size();
+    parentData.childSymbolicConditionals.push_back(
+        SymbolicConditional::shared_ptr());
+    parentData.childSymbolicFactors.push_back(SymbolicFactor::shared_ptr());
     return myData;
   }
 
@@ -88,8 +95,10 @@ struct ConstructorTraversalData {
         symbolicFactors, keyAsOrdering);
 
     // Store symbolic elimination results in the parent
-    myData.parentData->childSymbolicConditionals.push_back(myConditional);
-    myData.parentData->childSymbolicFactors.push_back(mySeparatorFactor);
+    myData.parentData->childSymbolicConditionals[myData.myIndexInParent] =
+        myConditional;
+    myData.parentData->childSymbolicFactors[myData.myIndexInParent] =
+        mySeparatorFactor;
 
     sharedNode node = myData.myJTNode;
     const FastVector<SymbolicConditional::shared_ptr>& childConditionals =
@@ -140,9 +149,12 @@ JunctionTree<BAYESTREE, GRAPH>::JunctionTree(
   Data rootData(0);
   rootData.myJTNode = boost::make_shared<typename Base::Node>(); // Make a dummy node to gather
                                                                  // the junction tree roots
-  treeTraversal::DepthFirstForest(eliminationTree, rootData,
+  // Sub-trees are processed in parallel (if TBB is enabled) when they have at
+  // least this many elimination tree nodes.
+  static const int kParallelThreshold = 1000;
+  treeTraversal::DepthFirstForestParallel(eliminationTree, rootData,
       Data::ConstructorTraversalVisitorPre,
-      Data::ConstructorTraversalVisitorPostAlg2);
+      Data::ConstructorTraversalVisitorPostAlg2, kParallelThreshold);
 
   // Assign roots from the dummy node
   this->addChildrenAsRoots(rootData.myJTNode);
@@ -0,0 +1,66 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MetisIndex.cpp
+ * @author  agent
+ */
+
+#include <gtsam/inference/MetisIndex.h>
+#include <gtsam/inference/FlatVariableIndex.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+MetisIndex::MetisIndex(const FlatVariableIndex& variableIndex) :
+    nKeys_(variableIndex.size()) {
+  gttic(MetisIndex_FlatVariableIndex);
+  const size_t n = variableIndex.size(), m = variableIndex.nFactors();
+
+  // Transpose the variable columns into factor rows
+  vector<size_t> rowStart(m + 1, 0);
+  for (size_t j = 0; j < n; ++j)
+    for (const FactorIndex i : variableIndex.column(j))
+      ++rowStart[i + 1];
+  for (size_t i = 0; i < m; ++i)
+    rowStart[i + 1] += rowStart[i];
+  vector<int32_t> rows(rowStart[m]);
+  vector<size_t> next(rowStart.begin(), rowStart.end() - 1);
+  for (size_t j = 0; j < n; ++j)
+    for (const FactorIndex i : variableIndex.column(j))
+      rows[next[i]++] = (int32_t) j;
+
+  // Neighbors of a variable are all other variables of its factors, the
+  // marker array removes duplicates without any set
+  vector<size_t> marker(n, n);
+  xadj_.reserve(n + 1);
+  xadj_.push_back(0);
+  for (size_t j = 0; j < n; ++j) {
+    marker[j] = j;
+    for (const FactorIndex i : variableIndex.column(j)) {
+      for (size_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+        const int32_t neighbor = rows[k];
+        if (marker[neighbor] != j) {
+          marker[neighbor] = j;
+          adj_.push_back(neighbor);
+        }
+      }
+    }
+    sort(adj_.begin() + xadj_.back(), adj_.end());
+    xadj_.push_back((int32_t) adj_.size());
+    intKeyBMap_.insert(bm_type::value_type(variableIndex.key(j), (int32_t) j));
+  }
+}
+
+} // \ gtsam
@@ -35,6 +35,9 @@
 #include <vector>
 
 namespace gtsam {
+
+class FlatVariableIndex;
+
 /**
  * The MetisIndex class converts a factor graph into the Compressed Sparse Row format for use in
  * METIS algorithms. Specifically, two vectors store the adjacency structure of the graph. It is built
@@ -68,6 +71,13 @@ public:
     augment(factorGraph);
   }
 
+  /**
+   * Build the adjacency structure directly from the columns of a
+   * FlatVariableIndex.  Variables are numbered by their column, so that every
+   * variable gets an entry in xadj, even if it has no neighbors.
+   */
+  explicit MetisIndex(const FlatVariableIndex& variableIndex);
+
   ~MetisIndex() {
   }
   /// @}
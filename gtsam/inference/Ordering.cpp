@@ -40,6 +40,45 @@ FastMap<Key, size_t> Ordering::invert() const {
   return inverted;
 }
 
+/* ************************************************************************* */
+// Run CCOLAMD on a column-compressed structure.  A has to be allocated with
+// ccolamd_recommended entries, and keys[j] is the key of column j.
+static Ordering callCcolamd(size_t nFactors, const KeyVector& keys,
+    vector<int>& A, vector<int>& p, vector<int>& cmember) {
+  const size_t nVars = keys.size();
+
+  //double* knobs = NULL; /* colamd arg 6: parameters (uses defaults if NULL) */
+  double knobs[CCOLAMD_KNOBS];
+  ccolamd_set_defaults(knobs);
+  knobs[CCOLAMD_DENSE_ROW] = -1;
+  knobs[CCOLAMD_DENSE_COL] = -1;
+
+  int stats[CCOLAMD_STATS]; /* colamd arg 7: colamd output statistics and error codes */
+
+  // call colamd, result will be in p
+  /* returns (1) if successful, (0) otherwise*/
+  if (nVars > 0) {
+    gttic(ccolamd);
+    int rv = ccolamd((int) nFactors, (int) nVars, (int) A.size(), &A[0], &p[0],
+        knobs, stats, &cmember[0]);
+    if (rv != 1)
+      throw runtime_error(
+          (boost::format("ccolamd failed with return value %1%") % rv).str());
+  }
+
+  //  ccolamd_report(stats);
+
+  // Convert elimination ordering in p to an ordering
+  gttic(Fill_Ordering);
+  Ordering result;
+  result.resize(nVars);
+  for (size_t j = 0; j < nVars; ++j)
+    result[j] = keys[p[j]];
+  gttoc(Fill_Ordering);
+
+  return result;
+}
+
 /* ************************************************************************* */
 Ordering Ordering::Colamd(const VariableIndex& variableIndex) {
   // Call constrained version with all groups set to zero
@@ -90,39 +129,109 @@ Ordering Ordering::ColamdConstrained(const VariableIndex& variableIndex,
   }
 
   assert((size_t)count == variableIndex.nEntries());
+  gttoc(Prepare);
 
-  //double* knobs = NULL; /* colamd arg 6: parameters (uses defaults if NULL) */
-  double knobs[CCOLAMD_KNOBS];
-  ccolamd_set_defaults(knobs);
-  knobs[CCOLAMD_DENSE_ROW] = -1;
-  knobs[CCOLAMD_DENSE_COL] = -1;
+  return callCcolamd(nFactors, keys, A, p, cmember);
+}
 
-  int stats[CCOLAMD_STATS]; /* colamd arg 7: colamd output statistics and error codes */
+/* ************************************************************************* */
+Ordering Ordering::Colamd(const FlatVariableIndex& variableIndex) {
+  vector<int> dummy_groups(variableIndex.size(), 0);
+  return Ordering::ColamdConstrained(variableIndex, dummy_groups);
+}
 
+/* ************************************************************************* */
+Ordering Ordering::ColamdConstrained(const FlatVariableIndex& variableIndex,
+    std::vector<int>& cmember) {
+  gttic(Ordering_COLAMDConstrained);
+
+  gttic(Prepare);
+  const size_t nVars = variableIndex.size();
+  if (nVars == 0)
+    return Ordering();
+  if (nVars == 1)
+    return Ordering(variableIndex.keys());
+
+  // The index already is in compressed column format, only the slack between
+  // columns has to be dropped
+  const size_t nEntries = variableIndex.nEntries(), nFactors =
+      variableIndex.nFactors();
+  const size_t Alen = ccolamd_recommended((int) nEntries, (int) nFactors,
+      (int) nVars);
+  vector<int> A(Alen);
+  vector<int> p(nVars + 1);
+  p[0] = 0;
+  for (size_t j = 0; j < nVars; ++j) {
+    const FlatVariableIndex::Factors column = variableIndex.column(j);
+    std::copy(column.begin(), column.end(), A.begin() + p[j]);
+    p[j + 1] = p[j] + (int) column.size();
+  }
+  assert((size_t)p[nVars] == nEntries);
   gttoc(Prepare);
 
-  // call colamd, result will be in p
-  /* returns (1) if successful, (0) otherwise*/
-  if (nVars > 0) {
-    gttic(ccolamd);
-    int rv = ccolamd((int) nFactors, (int) nVars, (int) Alen, &A[0], &p[0],
-        knobs, stats, &cmember[0]);
-    if (rv != 1)
-      throw runtime_error(
-          (boost::format("ccolamd failed with return value %1%") % rv).str());
+  return callCcolamd(nFactors, variableIndex.keys(), A, p, cmember);
+}
+
+/* ************************************************************************* */
+// Column of a key that has to be present in a FlatVariableIndex
+static size_t requireColumn(const FlatVariableIndex& variableIndex, Key key) {
+  const size_t j = variableIndex.find(key);
+  if (j == variableIndex.size())
+    throw std::invalid_argument(
+        "Ordering: constrained variable is not in the FlatVariableIndex");
+  return j;
+}
+
+/* ************************************************************************* */
+Ordering Ordering::ColamdConstrainedLast(const FlatVariableIndex& variableIndex,
+    const KeyVector& constrainLast, bool forceOrder) {
+  gttic(Ordering_COLAMDConstrainedLast);
+
+  const size_t n = variableIndex.size();
+  std::vector<int> cmember(n, 0);
+  int group = (constrainLast.size() != n ? 1 : 0);
+  for (Key key: constrainLast) {
+    cmember[requireColumn(variableIndex, key)] = group;
+    if (forceOrder)
+      ++group;
   }
 
-  //  ccolamd_report(stats);
+  return Ordering::ColamdConstrained(variableIndex, cmember);
+}
 
-  // Convert elimination ordering in p to an ordering
-  gttic(Fill_Ordering);
-  Ordering result;
-  result.resize(nVars);
-  for (size_t j = 0; j < nVars; ++j)
-    result[j] = keys[p[j]];
-  gttoc(Fill_Ordering);
+/* ************************************************************************* */
+Ordering Ordering::ColamdConstrainedFirst(const FlatVariableIndex& variableIndex,
+    const KeyVector& constrainFirst, bool forceOrder) {
+  gttic(Ordering_COLAMDConstrainedFirst);
 
-  return result;
+  const int none = -1;
+  std::vector<int> cmember(variableIndex.size(), none);
+  int group = 0;
+  for (Key key: constrainFirst) {
+    cmember[requireColumn(variableIndex, key)] = group;
+    if (forceOrder)
+      ++group;
+  }
+
+  if (!forceOrder && !constrainFirst.empty())
+    ++group;
+  for(int& c: cmember)
+    if (c == none)
+      c = group;
+
+  return Ordering::ColamdConstrained(variableIndex, cmember);
+}
+
+/* ************************************************************************* */
+Ordering Ordering::ColamdConstrained(const FlatVariableIndex& variableIndex,
+    const FastMap<Key, int>& groups) {
+  gttic(Ordering_COLAMDConstrained);
+  std::vector<int> cmember(variableIndex.size(), 0);
+  typedef FastMap<Key, int>::value_type key_group;
+  for(const key_group& p: groups)
+    cmember[requireColumn(variableIndex, p.first)] = p.second;
+
+  return Ordering::ColamdConstrained(variableIndex, cmember);
 }
 
 /* ************************************************************************* */
@@ -256,6 +365,223 @@ Ordering Ordering::Metis(const MetisIndex& met) {
 #endif
 }
 
+/* ************************************************************************* */
+namespace {
+// Recursive nested dissection of the adjacency graph of a MetisIndex.  Every
+// leaf and every separator becomes one CCOLAMD constraint group, numbered in
+// post-order, so that each separator is eliminated after both of its parts.
+class NestedDissector {
+  typedef std::vector<int32_t> Vertices;
+
+  const std::vector<int32_t>& xadj_;
+  const std::vector<int32_t>& adj_;
+  const size_t leafSize_;
+  std::vector<int>& cmember_;
+  int nextGroup_;
+  std::vector<int32_t> position_; // Position in the current subset, or -1
+  std::vector<int32_t> level_; // Scratch space for breadth-first search
+
+ public:
+  NestedDissector(const MetisIndex& graph, size_t leafSize,
+      std::vector<int>& cmember) :
+      xadj_(graph.xadj()), adj_(graph.adj()), leafSize_(leafSize),
+      cmember_(cmember), nextGroup_(0), position_(graph.nValues(), -1),
+      level_(graph.nValues(), -1) {
+  }
+
+  void dissect(const Vertices& vertices) {
+    Vertices A, B, S;
+    if (vertices.size() > leafSize_ && split(vertices, A, B, S)) {
+      dissect(A);
+      dissect(B);
+      assignGroup(S);
+    } else {
+      assignGroup(vertices);
+    }
+  }
+
+ private:
+  void assignGroup(const Vertices& vertices) {
+    if (vertices.empty())
+      return;
+    for (const int32_t v : vertices)
+      cmember_[v] = nextGroup_;
+    ++nextGroup_;
+  }
+
+  // Height objective of a split, a proxy for the critical path it leaves
+  static size_t cost(const Vertices& A, const Vertices& B, const Vertices& S) {
+    return S.size() + std::max(A.size(), B.size());
+  }
+
+  // Split vertices into two parts that are not adjacent and a separator
+  bool split(const Vertices& vertices, Vertices& A, Vertices& B, Vertices& S) {
+    for (size_t i = 0; i < vertices.size(); ++i)
+      position_[vertices[i]] = (int32_t) i;
+
+    bool found = splitComponents(vertices, A, B);
+    if (!found) {
+      found = levelSeparator(vertices, A, B, S);
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+      Vertices A2, B2, S2;
+      if (metisSeparator(vertices, A2, B2, S2)
+          && (!found || cost(A2, B2, S2) < cost(A, B, S))) {
+        A.swap(A2);
+        B.swap(B2);
+        S.swap(S2);
+        found = true;
+      }
+#endif
+    }
+
+    for (const int32_t v : vertices)
+      position_[v] = -1;
+    return found;
+  }
+
+  // Breadth-first search within the subset from a root, returns the last
+  // vertex reached and stores the level of each vertex in level_
+  int32_t bfs(int32_t root, Vertices& queue) {
+    queue.clear();
+    queue.push_back(root);
+    level_[root] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+      const int32_t v = queue[head];
+      for (int32_t k = xadj_[v]; k < xadj_[v + 1]; ++k) {
+        const int32_t w = adj_[k];
+        if (position_[w] >= 0 && level_[w] < 0) {
+          level_[w] = level_[v] + 1;
+          queue.push_back(w);
+        }
+      }
+    }
+    return queue.back();
+  }
+
+  void clearLevels(const Vertices& vertices) {
+    for (const int32_t v : vertices)
+      level_[v] = -1;
+  }
+
+  // If the subset is disconnected, distribute its components over two parts
+  bool splitComponents(const Vertices& vertices, Vertices& A, Vertices& B) {
+    std::vector<Vertices> components;
+    Vertices queue;
+    for (const int32_t v : vertices) {
+      if (level_[v] < 0) {
+        bfs(v, queue);
+        components.push_back(queue);
+      }
+    }
+    clearLevels(vertices);
+    if (components.size() < 2)
+      return false;
+
+    // Largest components first, each to the currently smaller part
+    std::sort(components.begin(), components.end(),
+        [](const Vertices& a, const Vertices& b) { return a.size() > b.size(); });
+    for (const Vertices& component : components) {
+      Vertices& part = A.size() <= B.size() ? A : B;
+      part.insert(part.end(), component.begin(), component.end());
+    }
+    return true;
+  }
+
+  // Separator from the level structure rooted at a pseudo-peripheral vertex:
+  // the level that minimizes the height objective
+  bool levelSeparator(const Vertices& vertices, Vertices& A, Vertices& B,
+      Vertices& S) {
+    Vertices queue;
+    const int32_t far = bfs(vertices.front(), queue);
+    clearLevels(vertices);
+    bfs(far, queue);
+    const int32_t nrLevels = level_[queue.back()] + 1;
+
+    bool found = false;
+    if (nrLevels >= 3) {
+      std::vector<size_t> count(nrLevels, 0);
+      for (const int32_t v : vertices)
+        ++count[level_[v]];
+      size_t before = count[0], best = vertices.size();
+      int32_t separatorLevel = -1;
+      for (int32_t l = 1; l + 1 < nrLevels; ++l) {
+        const size_t after = vertices.size() - before - count[l];
+        const size_t c = count[l] + std::max(before, after);
+        if (c < best) {
+          best = c;
+          separatorLevel = l;
+        }
+        before += count[l];
+      }
+      for (const int32_t v : vertices) {
+        if (level_[v] < separatorLevel)
+          A.push_back(v);
+        else if (level_[v] == separatorLevel)
+          S.push_back(v);
+        else
+          B.push_back(v);
+      }
+      found = true;
+    }
+    clearLevels(vertices);
+    return found;
+  }
+
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+  // Separator computed by METIS on the subgraph induced by the subset
+  bool metisSeparator(const Vertices& vertices, Vertices& A, Vertices& B,
+      Vertices& S) {
+    std::vector<idx_t> xadj(1, 0), adj;
+    for (const int32_t v : vertices) {
+      for (int32_t k = xadj_[v]; k < xadj_[v + 1]; ++k)
+        if (position_[adj_[k]] >= 0)
+          adj.push_back(position_[adj_[k]]);
+      xadj.push_back((idx_t) adj.size());
+    }
+    if (adj.empty())
+      return false;
+
+    idx_t nrVertices = (idx_t) vertices.size(), separatorSize = 0;
+    std::vector<idx_t> part(vertices.size());
+    if (METIS_ComputeVertexSeparator(&nrVertices, &xadj[0], &adj[0], NULL,
+        NULL, &separatorSize, &part[0]) != METIS_OK)
+      return false;
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+      (part[i] == 0 ? A : part[i] == 1 ? B : S).push_back(vertices[i]);
+    if (A.empty() || B.empty()) {
+      A.clear();
+      B.clear();
+      S.clear();
+      return false;
+    }
+    return true;
+  }
+#endif
+};
+}
+
+/* ************************************************************************* */
+Ordering Ordering::NestedDissection(const FlatVariableIndex& variableIndex,
+    size_t leafSize) {
+  gttic(Ordering_NestedDissection);
+  const size_t n = variableIndex.size();
+  if (n == 0)
+    return Ordering();
+
+  gttic(dissect);
+  const MetisIndex graph(variableIndex);
+  std::vector<int> cmember(n, 0);
+  std::vector<int32_t> vertices(n);
+  for (size_t j = 0; j < n; ++j)
+    vertices[j] = (int32_t) j;
+  NestedDissector(graph, std::max(leafSize, size_t(1)), cmember).dissect(
+      vertices);
+  gttoc(dissect);
+
+  return Ordering::ColamdConstrained(variableIndex, cmember);
+}
+
 /* ************************************************************************* */
 void Ordering::print(const std::string& str,
     const KeyFormatter& keyFormatter) const {
@@ -22,6 +22,7 @@
 
 #include <gtsam/inference/Key.h>
 #include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/FlatVariableIndex.h>
 #include <gtsam/inference/MetisIndex.h>
 #include <gtsam/base/FastSet.h>
 
@@ -39,7 +40,7 @@ public:
 
   /// Type of ordering to use
   enum OrderingType {
-    COLAMD, METIS, NATURAL, CUSTOM
+    COLAMD, METIS, NATURAL, CUSTOM, NESTED_DISSECTION
   };
 
   typedef Ordering This; ///< Typedef to this class
@@ -172,6 +173,28 @@ public:
   static GTSAM_EXPORT Ordering ColamdConstrained(
       const VariableIndex& variableIndex, const FastMap<Key, int>& groups);
 
+  /// Compute a fill-reducing ordering using COLAMD from a FlatVariableIndex.  The columns of the
+  /// index are copied into the CCOLAMD workspace as they are, so this is the cheapest way to order
+  /// a graph whose structure is already available.
+  static GTSAM_EXPORT Ordering Colamd(const FlatVariableIndex& variableIndex);
+
+  /// Same as ColamdConstrainedLast(const VariableIndex&, const KeyVector&, bool), from a
+  /// FlatVariableIndex.
+  static GTSAM_EXPORT Ordering ColamdConstrainedLast(
+      const FlatVariableIndex& variableIndex, const KeyVector& constrainLast,
+      bool forceOrder = false);
+
+  /// Same as ColamdConstrainedFirst(const VariableIndex&, const KeyVector&, bool), from a
+  /// FlatVariableIndex.
+  static GTSAM_EXPORT Ordering ColamdConstrainedFirst(
+      const FlatVariableIndex& variableIndex, const KeyVector& constrainFirst,
+      bool forceOrder = false);
+
+  /// Same as ColamdConstrained(const VariableIndex&, const FastMap<Key, int>&), from a
+  /// FlatVariableIndex.
+  static GTSAM_EXPORT Ordering ColamdConstrained(
+      const FlatVariableIndex& variableIndex, const FastMap<Key, int>& groups);
+
   /// Return a natural Ordering. Typically used by iterative solvers
   template<class FACTOR_GRAPH>
   static Ordering Natural(const FACTOR_GRAPH &fg) {
@@ -189,6 +212,11 @@ public:
   /// Compute an ordering determined by METIS from a VariableIndex
   static GTSAM_EXPORT Ordering Metis(const MetisIndex& met);
 
+  /// Compute an ordering determined by METIS from a FlatVariableIndex
+  static Ordering Metis(const FlatVariableIndex& variableIndex) {
+    return Metis(MetisIndex(variableIndex));
+  }
+
   template<class FACTOR_GRAPH>
   static Ordering Metis(const FACTOR_GRAPH& graph) {
     if (graph.empty())
@@ -197,6 +225,28 @@ public:
       return Metis(MetisIndex(graph));
   }
 
+  /// Compute an ordering for parallel elimination by nested dissection.  The graph is split
+  /// recursively by vertex separators, and each separator is ordered after the two parts it
+  /// separates.  As the parts share no factors, they become disjoint subtrees of the elimination
+  /// tree that can be eliminated in parallel.  Separator candidates come from METIS (when GTSAM is
+  /// built with nested dissection support) and from a breadth-first level structure; the one with
+  /// the smallest separator size plus larger part size is kept, which bounds the height of the
+  /// tree.  Parts of at most \c leafSize variables and the separators themselves are ordered
+  /// internally by constrained COLAMD.
+  static GTSAM_EXPORT Ordering NestedDissection(
+      const FlatVariableIndex& variableIndex, size_t leafSize = 64);
+
+  /// Compute a nested dissection ordering from a factor graph, see
+  /// NestedDissection(const FlatVariableIndex&, size_t).
+  template<class FACTOR_GRAPH>
+  static Ordering NestedDissection(const FACTOR_GRAPH& graph,
+      size_t leafSize = 64) {
+    if (graph.empty())
+      return Ordering();
+    else
+      return NestedDissection(FlatVariableIndex(graph), leafSize);
+  }
+
   /// @}
 
   /// @name Named Constructors @{
@@ -212,6 +262,8 @@ public:
       return Colamd(graph);
     case METIS:
       return Metis(graph);
+    case NESTED_DISSECTION:
+      return NestedDissection(graph);
     case NATURAL:
       return Natural(graph);
     case CUSTOM:
@@ -241,6 +293,10 @@ private:
   static GTSAM_EXPORT Ordering ColamdConstrained(
       const VariableIndex& variableIndex, std::vector<int>& cmember);
 
+  /// Internal COLAMD function
+  static GTSAM_EXPORT Ordering ColamdConstrained(
+      const FlatVariableIndex& variableIndex, std::vector<int>& cmember);
+
   /** Serialization function */
   friend class boost::serialization::access;
   template<class ARCHIVE>
@@ -0,0 +1,163 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    OrderingCache.cpp
+ * @author  agent
+ */
+
+#include <gtsam/inference/OrderingCache.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace gtsam {
+
+const size_t OrderingCache::Structure::kNull =
+    std::numeric_limits<size_t>::max();
+
+/* ************************************************************************* */
+void OrderingCache::Structure::computeHash() {
+  hash = 0;
+  boost::hash_combine(hash, sizes.size());
+  for (const size_t size : sizes)
+    boost::hash_combine(hash, size);
+  for (const Key key : keys)
+    boost::hash_combine(hash, key);
+}
+
+/* ************************************************************************* */
+OrderingCache& OrderingCache::Global() {
+  static OrderingCache cache(0);
+  return cache;
+}
+
+/* ************************************************************************* */
+bool OrderingCache::enabled() const {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  return capacity_ > 0;
+}
+
+/* ************************************************************************* */
+void OrderingCache::setCapacity(size_t capacity) {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  capacity_ = capacity;
+  while (items_.size() > capacity_)
+    items_.pop_back();
+}
+
+/* ************************************************************************* */
+size_t OrderingCache::size() const {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  return items_.size();
+}
+
+/* ************************************************************************* */
+size_t OrderingCache::hits() const {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  return hits_;
+}
+
+/* ************************************************************************* */
+size_t OrderingCache::misses() const {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  return misses_;
+}
+
+/* ************************************************************************* */
+void OrderingCache::clear() {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  items_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+/* ************************************************************************* */
+void OrderingCache::print(const string& str) const {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  cout << str << items_.size() << " of " << capacity_ << " structures, "
+      << hits_ << " hits, " << misses_ << " misses" << endl;
+}
+
+/* ************************************************************************* */
+bool OrderingCache::find(const Structure& structure,
+    boost::optional<Ordering::OrderingType> orderingType, Entry* entry) {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  for (list<Item>::iterator item = items_.begin(); item != items_.end();
+      ++item) {
+    if (item->structure == structure) {
+      items_.splice(items_.begin(), items_, item);
+      entry->variableIndex = item->variableIndex;
+      if (!orderingType) {
+        ++hits_;
+        return true;
+      }
+      const map<Ordering::OrderingType, Ordering>::const_iterator ordering =
+          item->orderings.find(*orderingType);
+      if (ordering != item->orderings.end()) {
+        entry->ordering = ordering->second;
+        ++hits_;
+        return true;
+      }
+      break;
+    }
+  }
+  ++misses_;
+  return false;
+}
+
+/* ************************************************************************* */
+void OrderingCache::insert(const Structure& structure,
+    boost::optional<Ordering::OrderingType> orderingType, const Entry& entry) {
+#ifdef GTSAM_USE_TBB
+  tbb::mutex::scoped_lock lock(mutex_);
+#endif
+  if (capacity_ == 0)
+    return;
+
+  // Another thread may have inserted the same structure in the meantime
+  list<Item>::iterator item = items_.begin();
+  while (item != items_.end() && !(item->structure == structure))
+    ++item;
+  if (item == items_.end()) {
+    items_.push_front(Item(structure));
+    item = items_.begin();
+    if (items_.size() > capacity_)
+      items_.pop_back();
+  }
+
+  if (!item->variableIndex)
+    item->variableIndex = entry.variableIndex;
+  if (orderingType)
+    item->orderings[*orderingType] = entry.ordering;
+}
+
+}
@@ -0,0 +1,201 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    OrderingCache.h
+ * @brief   Cache of variable indices and orderings keyed by graph structure
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/base/timing.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/mutex.h>
+#endif
+
+#include <list>
+#include <map>
+
+namespace gtsam {
+
+/**
+ * An OrderingCache remembers the VariableIndex and the orderings computed for
+ * recently seen factor graph structures, i.e. the sequence of key lists of the
+ * factors.  Solving many graphs with the same structure, e.g. in parameter
+ * sweeps, then only pays for hashing and comparing the keys instead of
+ * building a VariableIndex and running COLAMD every time.  Graphs of different
+ * types with the same structure, e.g. a NonlinearFactorGraph and its
+ * linearization, share an entry.
+ *
+ * The Global() cache is consulted by EliminateableFactorGraph elimination (and
+ * hence Marginals) when no VariableIndex is passed, and by the nonlinear
+ * optimizers when they compute an ordering.  It is disabled (capacity 0) until
+ * enabled with setCapacity.
+ * \nosubgrouping
+ */
+class GTSAM_EXPORT OrderingCache {
+ public:
+  typedef boost::shared_ptr<const VariableIndex> sharedVariableIndex;
+
+  /// What is cached for one graph structure
+  struct Entry {
+    sharedVariableIndex variableIndex;
+    Ordering ordering;
+  };
+
+ protected:
+  /// The key lists of all factors, with a hash for fast rejection
+  struct Structure {
+    KeyVector keys;
+    std::vector<size_t> sizes; ///< Number of keys per factor, or kNull
+    size_t hash;
+
+    static const size_t kNull;
+
+    template<class FG>
+    explicit Structure(const FG& graph) : hash(0) {
+      sizes.reserve(graph.size());
+      for (size_t i = 0; i < graph.size(); ++i) {
+        if (graph[i]) {
+          sizes.push_back(graph[i]->size());
+          keys.insert(keys.end(), graph[i]->begin(), graph[i]->end());
+        } else {
+          sizes.push_back(kNull);
+        }
+      }
+      computeHash();
+    }
+
+    void computeHash();
+
+    bool operator==(const Structure& other) const {
+      return hash == other.hash && sizes == other.sizes && keys == other.keys;
+    }
+  };
+
+  struct Item {
+    Structure structure;
+    sharedVariableIndex variableIndex;
+    std::map<Ordering::OrderingType, Ordering> orderings;
+    explicit Item(const Structure& structure) : structure(structure) {}
+  };
+
+  std::list<Item> items_; ///< Most recently used first
+  size_t capacity_;
+  size_t hits_;
+  size_t misses_;
+#ifdef GTSAM_USE_TBB
+  mutable tbb::mutex mutex_;
+#endif
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Create a cache holding at most \c capacity graph structures
+  explicit OrderingCache(size_t capacity = 16) :
+      capacity_(capacity), hits_(0), misses_(0) {
+  }
+
+  /// The process-wide cache used by elimination and the nonlinear optimizers
+  static OrderingCache& Global();
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// Whether the cache stores anything
+  bool enabled() const;
+
+  /// Set the number of structures kept, 0 disables and clears the cache
+  void setCapacity(size_t capacity);
+
+  /// Number of structures currently cached
+  size_t size() const;
+
+  /// Number of lookups that found everything they asked for
+  size_t hits() const;
+
+  /// Number of lookups that had to compute something
+  size_t misses() const;
+
+  /// Remove all entries and reset the statistics
+  void clear();
+
+  /// Print the statistics
+  void print(const std::string& str = "OrderingCache: ") const;
+
+  /**
+   * The VariableIndex and ordering of a graph, computed only if no graph with
+   * the same structure is cached.  COLAMD orderings are computed from the
+   * cached VariableIndex, other types with Ordering::Create.
+   */
+  template<class FG>
+  Entry lookup(const FG& graph, Ordering::OrderingType orderingType) {
+    gttic(OrderingCache_lookup);
+    const Structure structure(graph);
+    Entry entry;
+    if (find(structure, orderingType, &entry))
+      return entry;
+    if (!entry.variableIndex)
+      entry.variableIndex = boost::make_shared<VariableIndex>(graph);
+    if (orderingType == Ordering::COLAMD)
+      entry.ordering = Ordering::Colamd(*entry.variableIndex);
+    else
+      entry.ordering = Ordering::Create(orderingType, graph);
+    insert(structure, orderingType, entry);
+    return entry;
+  }
+
+  /// The VariableIndex of a graph, computed only if no graph with the same structure is cached
+  template<class FG>
+  sharedVariableIndex variableIndex(const FG& graph) {
+    gttic(OrderingCache_variableIndex);
+    const Structure structure(graph);
+    Entry entry;
+    if (!find(structure, boost::none, &entry)) {
+      entry.variableIndex = boost::make_shared<VariableIndex>(graph);
+      insert(structure, boost::none, entry);
+    }
+    return entry.variableIndex;
+  }
+
+  /// Same as Ordering::Create, but through the Global() cache if it is enabled
+  template<class FG>
+  static Ordering Create(Ordering::OrderingType orderingType, const FG& graph) {
+    OrderingCache& cache = Global();
+    if (cache.enabled() && orderingType != Ordering::CUSTOM && !graph.empty())
+      return cache.lookup(graph, orderingType).ordering;
+    return Ordering::Create(orderingType, graph);
+  }
+
+  /// @}
+
+ protected:
+  /// Look up a structure, filling in whatever is cached; returns true on a hit
+  bool find(const Structure& structure,
+      boost::optional<Ordering::OrderingType> orderingType, Entry* entry);
+
+  /// Store a computed entry, evicting the least recently used one if full
+  void insert(const Structure& structure,
+      boost::optional<Ordering::OrderingType> orderingType,
+      const Entry& entry);
+};
+
+} // \namespace gtsam
@@ -19,9 +19,61 @@
 
 #include <gtsam/inference/VariableIndex.h>
 #include <gtsam/base/timing.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <algorithm>
+#include <map>
 
 namespace gtsam {
 
+/* ************************************************************************* */
+template<class FG>
+void VariableIndex::build(const FG& factors) {
+  gttic(VariableIndex_build);
+  assert(index_.empty());
+
+  // Small graphs are not worth splitting
+  const size_t chunkSize = 1000;
+  const size_t m = factors.size();
+  if (m <= chunkSize) {
+    augment(factors);
+    return;
+  }
+
+  // Count how often each key occurs in each range of factors
+  const size_t nrChunks = (m + chunkSize - 1) / chunkSize;
+  std::vector<std::map<Key, size_t> > counts(nrChunks);
+  parallelFor(nrChunks, [&](size_t c) {
+    const size_t end = std::min(m, (c + 1) * chunkSize);
+    for (size_t i = c * chunkSize; i < end; ++i)
+      if (factors[i])
+        for (const Key key : *factors[i])
+          ++counts[c][key];
+  });
+
+  // Grow the factor lists, and turn the counts into the position at which each
+  // range starts writing, so that factor indices stay in increasing order
+  for (std::map<Key, size_t>& chunkCounts : counts) {
+    for (auto& key_count : chunkCounts) {
+      FactorIndices& factorIndices = index_[key_count.first];
+      const size_t position = factorIndices.size();
+      factorIndices.resize(position + key_count.second);
+      nEntries_ += key_count.second;
+      key_count.second = position;
+    }
+  }
+
+  // Fill in the factor indices, every range into its own slots
+  parallelFor(nrChunks, [&](size_t c) {
+    const size_t end = std::min(m, (c + 1) * chunkSize);
+    for (size_t i = c * chunkSize; i < end; ++i)
+      if (factors[i])
+        for (const Key key : *factors[i])
+          index_.find(key)->second[counts[c].find(key)->second++] = i;
+  });
+  nFactors_ = m;
+}
+
 /* ************************************************************************* */
 template<class FG>
 void VariableIndex::augment(const FG& factors,
@@ -69,7 +69,7 @@ class GTSAM_EXPORT VariableIndex {
    */
   template <class FG>
   explicit VariableIndex(const FG& factorGraph) : nFactors_(0), nEntries_(0) {
-    augment(factorGraph);
+    build(factorGraph);
   }
 
   /// @}
@@ -162,6 +162,14 @@ class GTSAM_EXPORT VariableIndex {
   const_iterator find(Key key) const { return index_.find(key); }
 
 protected:
+  /**
+   * Build the index of a whole factor graph.  Large graphs are split into
+   * ranges of factors that are counted and then filled in parallel, giving
+   * the same index as augment.
+   */
+  template<class FG>
+  void build(const FG& factors);
+
   Factor_iterator factorsBegin(Key variable) { return internalAt(variable).begin(); }
   Factor_iterator factorsEnd(Key variable) { return internalAt(variable).end(); }
 
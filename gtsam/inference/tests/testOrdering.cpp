@@ -17,6 +17,7 @@
 
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/symbolic/SymbolicFactorGraph.h>
+#include <gtsam/symbolic/SymbolicEliminationTree.h>
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/inference/MetisIndex.h>
 #include <gtsam/base/TestableAssertions.h>
@@ -349,6 +350,53 @@ TEST(Ordering, Create) {
   CHECK_EXCEPTION(Ordering::Create(Ordering::CUSTOM, symbolicGraph), runtime_error);
 }
 
+/* ************************************************************************* */
+TEST(Ordering, NestedDissection) {
+  // Chain of 21 variables, too long for one leaf
+  SymbolicFactorGraph chain;
+  for (size_t j = 0; j < 20; ++j)
+    chain.push_factor(j, j + 1);
+
+  const Ordering ordering = Ordering::NestedDissection(chain, 4);
+  KeyVector sorted(ordering.begin(), ordering.end());
+  std::sort(sorted.begin(), sorted.end());
+  const KeySet keys = chain.keys();
+  EXPECT(KeyVector(keys.begin(), keys.end()) == sorted);
+
+  // The separator is eliminated last, splitting the tree into two subtrees
+  const SymbolicEliminationTree etree(chain, ordering);
+  LONGS_EQUAL(1, etree.roots().size());
+  LONGS_EQUAL(2, etree.roots().front()->children.size());
+
+  // Same through Create
+  EXPECT(assert_equal(Ordering::NestedDissection(chain),
+      Ordering::Create(Ordering::NESTED_DISSECTION, chain)));
+  EXPECT(assert_equal(Ordering::NestedDissection(chain),
+      Ordering::NestedDissection(FlatVariableIndex(chain))));
+}
+
+/* ************************************************************************* */
+TEST(Ordering, NestedDissectionDisconnected) {
+  // Two chains that do not interact end up in separate trees
+  SymbolicFactorGraph graph;
+  for (size_t j = 0; j < 10; ++j) {
+    graph.push_factor(j, j + 1);
+    graph.push_factor(100 + j, 100 + j + 1);
+  }
+  const Ordering ordering = Ordering::NestedDissection(graph, 4);
+  LONGS_EQUAL(22, ordering.size());
+  const SymbolicEliminationTree etree(graph, ordering);
+  LONGS_EQUAL(2, etree.roots().size());
+
+  // Empty graph and single variable
+  EXPECT(assert_equal(Ordering(),
+      Ordering::Create(Ordering::NESTED_DISSECTION, SymbolicFactorGraph())));
+  SymbolicFactorGraph single;
+  single.push_factor(7);
+  EXPECT(assert_equal(Ordering(list_of(7)),
+      Ordering::NestedDissection(single)));
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
@@ -0,0 +1,110 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testOrderingCache.cpp
+ * @brief   Unit tests for OrderingCache
+ * @author  agent
+ */
+
+#include <gtsam/inference/OrderingCache.h>
+#include <gtsam/symbolic/SymbolicFactorGraph.h>
+#include <gtsam/symbolic/SymbolicBayesTree.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+static SymbolicFactorGraph chain(size_t n) {
+  SymbolicFactorGraph graph;
+  for (size_t j = 0; j + 1 < n; ++j)
+    graph.push_factor(j, j + 1);
+  return graph;
+}
+
+/* ************************************************************************* */
+TEST(OrderingCache, lookup) {
+  OrderingCache cache(2);
+  const SymbolicFactorGraph graph = chain(6);
+
+  const OrderingCache::Entry first = cache.lookup(graph, Ordering::COLAMD);
+  EXPECT(assert_equal(Ordering::Colamd(graph), first.ordering));
+  EXPECT(assert_equal(VariableIndex(graph), *first.variableIndex));
+  LONGS_EQUAL(0, cache.hits());
+  LONGS_EQUAL(1, cache.misses());
+
+  // Same structure in a different graph object is a hit, sharing the index
+  const OrderingCache::Entry second = cache.lookup(chain(6), Ordering::COLAMD);
+  EXPECT(assert_equal(first.ordering, second.ordering));
+  EXPECT(first.variableIndex == second.variableIndex);
+  EXPECT(first.variableIndex == cache.variableIndex(graph));
+  LONGS_EQUAL(2, cache.hits());
+  LONGS_EQUAL(1, cache.misses());
+
+  // Another ordering type for the same structure reuses the index
+  const OrderingCache::Entry natural = cache.lookup(graph, Ordering::NATURAL);
+  EXPECT(assert_equal(Ordering::Natural(graph), natural.ordering));
+  EXPECT(first.variableIndex == natural.variableIndex);
+  LONGS_EQUAL(2, cache.misses());
+  LONGS_EQUAL(1, cache.size());
+
+  // Same keys in different factors is a different structure
+  SymbolicFactorGraph other;
+  other.push_factor(0, 1, 2);
+  other.push_factor(3, 4, 5);
+  cache.lookup(other, Ordering::COLAMD);
+  LONGS_EQUAL(3, cache.misses());
+  LONGS_EQUAL(2, cache.size());
+
+  // A third structure evicts the least recently used one
+  cache.lookup(chain(3), Ordering::COLAMD);
+  LONGS_EQUAL(2, cache.size());
+  cache.lookup(graph, Ordering::COLAMD);
+  LONGS_EQUAL(5, cache.misses());
+
+  cache.clear();
+  LONGS_EQUAL(0, cache.size());
+  LONGS_EQUAL(0, cache.hits());
+  LONGS_EQUAL(0, cache.misses());
+}
+
+/* ************************************************************************* */
+TEST(OrderingCache, Global) {
+  OrderingCache& cache = OrderingCache::Global();
+  EXPECT(!cache.enabled());
+  const SymbolicFactorGraph graph = chain(10);
+  const SymbolicBayesTree expected = *graph.eliminateMultifrontal();
+
+  // Elimination consults the global cache once it is enabled
+  cache.setCapacity(4);
+  EXPECT(assert_equal(expected, *graph.eliminateMultifrontal()));
+  EXPECT(assert_equal(expected, *graph.eliminateMultifrontal()));
+  LONGS_EQUAL(1, cache.misses());
+  LONGS_EQUAL(1, cache.hits());
+
+  const Ordering ordering = OrderingCache::Create(Ordering::COLAMD, graph);
+  graph.eliminateMultifrontal(ordering);
+  LONGS_EQUAL(3, cache.hits());
+
+  cache.setCapacity(0);
+  cache.clear();
+  EXPECT(!cache.enabled());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -30,6 +30,12 @@ namespace gtsam {
     const Ordering& order) :
   Base(factorGraph, structure, order) {}
 
+  /* ************************************************************************* */
+  GaussianEliminationTree::GaussianEliminationTree(
+    const GaussianFactorGraph& factorGraph, const FlatVariableIndex& structure,
+    const Ordering& order) :
+  Base(factorGraph, structure, order) {}
+
   /* ************************************************************************* */
   GaussianEliminationTree::GaussianEliminationTree(
     const GaussianFactorGraph& factorGraph, const Ordering& order) :
@@ -408,6 +408,8 @@ namespace gtsam {
 
     // be very selective on who can access these private methods:
     template<typename T> friend class ExpressionFactor;
+    friend class NoiseModelFactor;
+    friend class BatchLinearizer;
 
     /** Serialization function */
     friend class boost::serialization::access;
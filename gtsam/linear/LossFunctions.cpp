@@ -117,6 +117,17 @@ void Base::reweight(Matrix &A1, Matrix &A2, Matrix &A3, Vector &error) const {
   }
 }
 
+// Reweight an augmented system [A b] in place
+void Base::reweight(VerticalBlockMatrix &Ab) const {
+  VerticalBlockMatrix::Block full = Ab.full();
+  if (reweight_ == Block) {
+    full *= sqrtWeight(full.rightCols<1>().norm());
+  } else {
+    const Vector W = sqrtWeight(Vector(full.rightCols<1>()));
+    full = W.asDiagonal() * full;
+  }
+}
+
 /* ************************************************************************* */
 // Null model
 /* ************************************************************************* */
@@ -175,6 +186,11 @@ double Huber::weight(double error) const {
   return (absError <= k_) ? (1.0) : (k_ / absError);
 }
 
+Vector Huber::weight(const Vector& error) const {
+  const auto absError = error.array().abs();
+  return (absError <= k_).select(1.0, k_ * absError.inverse()).matrix();
+}
+
 double Huber::residual(double error) const {
   const double absError = std::abs(error);
   if (absError <= k_) {  // |x| <= k
@@ -212,6 +228,10 @@ double Cauchy::weight(double error) const {
   return ksquared_ / (ksquared_ + error*error);
 }
 
+Vector Cauchy::weight(const Vector& error) const {
+  return (ksquared_ * (ksquared_ + error.array().square()).inverse()).matrix();
+}
+
 double Cauchy::residual(double error) const {
   const double val = std::log1p(error * error / ksquared_);
   return ksquared_ * val * 0.5;
@@ -249,6 +269,11 @@ double Tukey::weight(double error) const {
   return 0.0;
 }
 
+Vector Tukey::weight(const Vector& error) const {
+  const auto one_minus_xc2 = 1.0 - error.array().square() / csquared_;
+  return (error.array().abs() <= c_).select(one_minus_xc2.square(), 0.0).matrix();
+}
+
 double Tukey::residual(double error) const {
   double absError = std::abs(error);
   if (absError <= c_) {
@@ -318,6 +343,12 @@ double GemanMcClure::weight(double error) const {
   return c4/(c2error*c2error);
 }
 
+Vector GemanMcClure::weight(const Vector& error) const {
+  const double c2 = c_*c_;
+  const double c4 = c2*c2;
+  return (c4 * (c2 + error.array().square()).square().inverse()).matrix();
+}
+
 double GemanMcClure::residual(double error) const {
   const double c2 = c_*c_;
   const double error2 = error*error;
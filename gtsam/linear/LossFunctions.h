@@ -21,10 +21,12 @@
 
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/Testable.h>
+#include <gtsam/base/VerticalBlockMatrix.h>
 #include <gtsam/dllexport.h>
 
 #include <boost/serialization/extended_type_info.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp> // must precede optional.hpp in Boost 1.74
 #include <boost/serialization/optional.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/singleton.hpp>
@@ -69,6 +71,9 @@ class GTSAM_EXPORT Base {
   Base(const ReweightScheme reweight = Block) : reweight_(reweight) {}
   virtual ~Base() {}
 
+  /// Returns the reweighting scheme
+  ReweightScheme reweightScheme() const { return reweight_; }
+
   /*
    * This method is responsible for returning the total penalty for a given
    * amount of error. For example, this method is responsible for implementing
@@ -98,8 +103,8 @@ class GTSAM_EXPORT Base {
   double sqrtWeight(double error) const { return std::sqrt(weight(error)); }
 
   /** produce a weight vector according to an error vector and the implemented
-   * robust function */
-  Vector weight(const Vector &error) const;
+   * robust function, override with a version that does all errors at once */
+  virtual Vector weight(const Vector &error) const;
 
   /** square root version of the weight function */
   Vector sqrtWeight(const Vector &error) const {
@@ -114,6 +119,9 @@ class GTSAM_EXPORT Base {
   void reweight(Matrix &A1, Matrix &A2, Vector &error) const;
   void reweight(Matrix &A1, Matrix &A2, Matrix &A3, Vector &error) const;
 
+  /// reweight the augmented system [A b] in place, b being the last block
+  void reweight(VerticalBlockMatrix &Ab) const;
+
  private:
   /** Serialization function */
   friend class boost::serialization::access;
@@ -159,6 +167,7 @@ class GTSAM_EXPORT Fair : public Base {
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double c, const ReweightScheme reweight = Block);
+  double modelParameter() const { return c_; }
 
  private:
   /** Serialization function */
@@ -180,10 +189,12 @@ class GTSAM_EXPORT Huber : public Base {
 
   Huber(double k = 1.345, const ReweightScheme reweight = Block);
   double weight(double error) const override;
+  Vector weight(const Vector &error) const override;
   double residual(double error) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return k_; }
 
  private:
   /** Serialization function */
@@ -210,10 +221,12 @@ class GTSAM_EXPORT Cauchy : public Base {
 
   Cauchy(double k = 0.1, const ReweightScheme reweight = Block);
   double weight(double error) const override;
+  Vector weight(const Vector &error) const override;
   double residual(double error) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return k_; }
 
  private:
   /** Serialization function */
@@ -235,10 +248,12 @@ class GTSAM_EXPORT Tukey : public Base {
 
   Tukey(double c = 4.6851, const ReweightScheme reweight = Block);
   double weight(double error) const override;
+  Vector weight(const Vector &error) const override;
   double residual(double error) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return c_; }
 
  private:
   /** Serialization function */
@@ -264,6 +279,7 @@ class GTSAM_EXPORT Welsch : public Base {
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return c_; }
 
  private:
   /** Serialization function */
@@ -296,10 +312,12 @@ class GTSAM_EXPORT GemanMcClure : public Base {
   GemanMcClure(double c = 1.0, const ReweightScheme reweight = Block);
   ~GemanMcClure() {}
   double weight(double error) const override;
+  Vector weight(const Vector &error) const override;
   double residual(double error) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return c_; }
 
  protected:
   double c_;
@@ -330,6 +348,7 @@ class GTSAM_EXPORT DCS : public Base {
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return c_; }
 
  protected:
   double c_;
@@ -363,6 +382,7 @@ class GTSAM_EXPORT L2WithDeadZone : public Base {
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
+  double modelParameter() const { return k_; }
 
  private:
   /** Serialization function */
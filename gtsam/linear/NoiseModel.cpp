@@ -75,6 +75,15 @@ Vector Base::sigmas() const {
   throw("Base::sigmas: sigmas() not implemented for this noise model");
 }
 
+/* ************************************************************************* */
+void Base::WhitenSystem(VerticalBlockMatrix& Ab) const {
+  // Whiten b along with A, the copy is for models that need its norm
+  Matrix A = Ab.full();
+  Vector b = A.rightCols<1>();
+  WhitenSystem(A, b);
+  Ab.full() = A;
+}
+
 /* ************************************************************************* */
 Gaussian::shared_ptr Gaussian::SqrtInformation(const Matrix& R, bool smart) {
   size_t m = R.rows(), n = R.cols();
@@ -230,6 +239,10 @@ void Gaussian::WhitenSystem(Matrix& A1, Matrix& A2, Matrix& A3, Vector& b) const
   whitenInPlace(b);
 }
 
+void Gaussian::WhitenSystem(VerticalBlockMatrix& Ab) const {
+  WhitenInPlace(Ab.full());
+}
+
 /* ************************************************************************* */
 // Diagonal
 /* ************************************************************************* */
@@ -654,6 +667,11 @@ void Robust::WhitenSystem(Matrix& A1, Matrix& A2, Matrix& A3, Vector& b) const{
   robust_->reweight(A1,A2,A3,b);
 }
 
+void Robust::WhitenSystem(VerticalBlockMatrix& Ab) const {
+  noise_->WhitenSystem(Ab);
+  robust_->reweight(Ab);
+}
+
 Robust::shared_ptr Robust::Create(
   const RobustModel::shared_ptr &robust, const NoiseModel::shared_ptr noise){
   return shared_ptr(new Robust(robust,noise));
@@ -20,6 +20,7 @@
 
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/Matrix.h>
+#include <gtsam/base/VerticalBlockMatrix.h>
 #include <gtsam/dllexport.h>
 #include <gtsam/linear/LossFunctions.h>
 
@@ -27,6 +28,7 @@
 #include <boost/serialization/extended_type_info.hpp>
 #include <boost/serialization/singleton.hpp>
 #include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/version.hpp> // must precede optional.hpp in Boost 1.74
 #include <boost/serialization/optional.hpp>
 
 namespace gtsam {
@@ -97,6 +99,13 @@ namespace gtsam {
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Vector& b) const = 0;
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Matrix& A3, Vector& b) const = 0;
 
+      /**
+       * Whiten the augmented system [A b] of a JacobianFactor in place, where b
+       * is the last block of Ab.  This default copies b out and back in,
+       * override if the model can work on the matrix directly.
+       */
+      virtual void WhitenSystem(VerticalBlockMatrix& Ab) const;
+
       /** in-place whiten, override if can be done more efficiently */
       virtual void whitenInPlace(Vector& v) const {
         v = whiten(v);
@@ -239,6 +248,9 @@ namespace gtsam {
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Vector& b) const;
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Matrix& A3, Vector& b) const;
 
+      /// Whiten [A b] in place, as all of Ab is whitened the same way
+      virtual void WhitenSystem(VerticalBlockMatrix& Ab) const;
+
       /**
        * Apply appropriately weighted QR factorization to the system [A b]
        *               Q'  *   [A b]  =  [R d]
@@ -703,6 +715,7 @@ namespace gtsam {
       virtual void WhitenSystem(Matrix& A, Vector& b) const;
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Vector& b) const;
       virtual void WhitenSystem(Matrix& A1, Matrix& A2, Matrix& A3, Vector& b) const;
+      virtual void WhitenSystem(VerticalBlockMatrix& Ab) const;
 
       virtual Vector unweightedWhiten(const Vector& v) const {
         return noise_->unweightedWhiten(v);
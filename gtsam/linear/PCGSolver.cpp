@@ -23,6 +23,7 @@
 #include <gtsam/linear/VectorValues.h>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 
 #include <algorithm>
 #include <iostream>
@@ -39,6 +40,11 @@ void PCGSolverParameters::print(ostream &os) const {
   preconditioner_->print(os);
 }
 
+/*****************************************************************************/
+boost::shared_ptr<PCGSolver> PCGSolverParameters::createSolver() const {
+  return boost::make_shared<PCGSolver>(*this);
+}
+
 /*****************************************************************************/
 PCGSolver::PCGSolver(const PCGSolverParameters &p) {
   parameters_ = p;
@@ -28,6 +28,7 @@ class GaussianFactorGraph;
 class KeyInfo;
 class Preconditioner;
 class VectorValues;
+class PCGSolver;
 struct PreconditionerParameters;
 
 /**
@@ -43,6 +44,12 @@ public:
 
   virtual void print(std::ostream &os) const;
 
+  /**
+   * Create the solver that NonlinearOptimizer uses with these parameters, a
+   * PCGSolver unless a derived parameter class creates a specialized one
+   */
+  virtual boost::shared_ptr<PCGSolver> createSolver() const;
+
   /* interface to preconditioner parameters */
   inline const PreconditionerParameters& preconditioner() const {
     return *preconditioner_;
@@ -19,22 +19,31 @@ namespace gtsam {
 
 /* ************************************************************************* */
 Sampler::Sampler(const noiseModel::Diagonal::shared_ptr& model, int32_t seed)
-  : model_(model), generator_(static_cast<unsigned>(seed))
+  : model_(model), seed_(seed), generator_(static_cast<unsigned>(seed))
 {
 }
 
 /* ************************************************************************* */
 Sampler::Sampler(const Vector& sigmas, int32_t seed)
-: model_(noiseModel::Diagonal::Sigmas(sigmas, true)), generator_(static_cast<unsigned>(seed))
+: model_(noiseModel::Diagonal::Sigmas(sigmas, true)), seed_(seed), generator_(static_cast<unsigned>(seed))
 {
 }
 
 /* ************************************************************************* */
 Sampler::Sampler(int32_t seed)
-: generator_(static_cast<unsigned>(seed))
+: seed_(seed), generator_(static_cast<unsigned>(seed))
 {
 }
 
+/* ************************************************************************* */
+Sampler Sampler::stream(uint64_t i) const {
+  Sampler result(*this);
+  std::seed_seq seeds{static_cast<uint32_t>(seed_), static_cast<uint32_t>(i),
+      static_cast<uint32_t>(i >> 32)};
+  result.generator_.seed(seeds);
+  return result;
+}
+
 /* ************************************************************************* */
 Vector Sampler::sampleDiagonal(const Vector& sigmas) {
   size_t d = sigmas.size();
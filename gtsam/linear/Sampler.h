@@ -30,12 +30,19 @@ namespace gtsam {
  *
  * This is primarily to allow for variable seeds, and does roughly the same
  * thing as sample() in NoiseModel.
+ *
+ * A Sampler updates its generator, so it should not be shared between
+ * threads. Instead, use stream() to give every thread, or every Monte Carlo
+ * trial, an independently seeded copy that is reproducible.
  */
 class GTSAM_EXPORT Sampler {
 protected:
   /** noiseModel created at generation */
   noiseModel::Diagonal::shared_ptr model_;
 
+  /** seed of the generator, from which the seeds of streams are derived */
+  int32_t seed_;
+
   /** generator */
   std::mt19937_64 generator_;
 
@@ -68,6 +75,15 @@ public:
   size_t dim() const { assert(model_.get()); return model_->dim(); }
   Vector sigmas() const { assert(model_.get()); return model_->sigmas(); }
   const noiseModel::Diagonal::shared_ptr& model() const { return model_; }
+  int32_t seed() const { return seed_; }
+
+  /**
+   * Create a sampler for the same distribution, with a generator seeded from
+   * both the seed of this sampler and the stream index i. Different streams
+   * are statistically independent, and the same stream always yields the
+   * same samples, regardless of the state of this sampler.
+   */
+  Sampler stream(uint64_t i) const;
 
   /**
    * sample from distribution
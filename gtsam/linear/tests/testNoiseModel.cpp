@@ -23,6 +23,7 @@
 #include <CppUnitLite/TestHarness.h>
 
 #include <boost/assign/std/vector.hpp>
+#include <boost/assign/list_of.hpp>
 
 #include <iostream>
 #include <limits>
@@ -447,6 +448,41 @@ TEST(NoiseModel, WhitenInPlace)
   EXPECT(assert_equal(expected, A));
 }
 
+/* ************************************************************************* */
+TEST(NoiseModel, WhitenSystemInPlace)
+{
+  // Whitening [A1 A2 b] in place agrees with WhitenSystem(A1, A2, b)
+  Matrix3 R;
+  R << 6, 5, 4, 0, 3, 2, 0, 0, 1;
+  const SharedDiagonal diagonal = Diagonal::Sigmas(Vector3(0.1, 0.2, 0.5));
+  const vector<SharedNoiseModel> models = list_of<SharedNoiseModel>
+    (Gaussian::SqrtInformation(R))(diagonal)(Isotropic::Sigma(3, 0.3))
+    (Unit::Create(3))(Constrained::MixedSigmas(Vector3(0.1, 0.0, 0.5)))
+    (Robust::Create(mEstimator::Huber::Create(1.0), diagonal))
+    (Robust::Create(mEstimator::Cauchy::Create(0.5, mEstimator::Base::Scalar),
+        Gaussian::SqrtInformation(R)));
+
+  Matrix A1(3, 2), A2(3, 1);
+  A1 << 1, 2, 3, 4, 5, 6;
+  A2 << 7, 8, 9;
+  const Vector3 b(0.1, -2.0, 0.5);
+  for (const SharedNoiseModel& model : models) {
+    Matrix expectedA1 = A1, expectedA2 = A2;
+    Vector expectedb = b;
+    model->WhitenSystem(expectedA1, expectedA2, expectedb);
+
+    const vector<size_t> dims = list_of(2)(1)(1);
+    VerticalBlockMatrix Ab(dims, 3);
+    Ab(0) = A1;
+    Ab(1) = A2;
+    Ab(2).col(0) = b;
+    model->WhitenSystem(Ab);
+    EXPECT(assert_equal(expectedA1, Matrix(Ab(0)), 1e-9));
+    EXPECT(assert_equal(expectedA2, Matrix(Ab(1)), 1e-9));
+    EXPECT(assert_equal(expectedb, Vector(Ab(2).col(0)), 1e-9));
+  }
+}
+
 /* ************************************************************************* */
 
 /*
@@ -719,6 +755,24 @@ TEST(NoiseModel, NonDiagonalGaussian)
   }
 }
 
+/* ************************************************************************* */
+TEST(NoiseModel, robustFunctionBatchWeight)
+{
+  // Batch weights agree with the scalar versions
+  const Vector errors = (Vector(7) << 0.0, 0.5, -0.5, 1.0, -3.0, 10.0, -100.0).finished();
+  const vector<mEstimator::Base::shared_ptr> functions =
+      list_of<mEstimator::Base::shared_ptr>
+    (mEstimator::Huber::Create(1.0))(mEstimator::Cauchy::Create(0.5))
+    (mEstimator::Tukey::Create(4.0))(mEstimator::GemanMcClure::Create(1.5))
+    (mEstimator::Fair::Create(2.0));
+  for (const mEstimator::Base::shared_ptr& function : functions) {
+    Vector expected(errors.size());
+    for (Eigen::Index i = 0; i < errors.size(); ++i)
+      expected(i) = function->weight(errors(i));
+    EXPECT(assert_equal(expected, function->weight(errors), 1e-12));
+  }
+}
+
 /* ************************************************************************* */
 int main() {  TestResult tr; return TestRegistry::runAllTests(tr); }
 /* ************************************************************************* */
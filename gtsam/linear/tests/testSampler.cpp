@@ -37,6 +37,23 @@ TEST(testSampler, basic) {
   EXPECT(assert_equal(sampler2.sample(), sampler3.sample(), tol));
 }
 
+/* ************************************************************************* */
+TEST(testSampler, stream) {
+  Sampler sampler(noiseModel::Isotropic::Sigma(3, 1.0), 7);
+  EXPECT_LONGS_EQUAL(7, sampler.seed());
+
+  // Streams are reproducible, and do not depend on the state of the sampler
+  Sampler stream1 = sampler.stream(1);
+  const Vector first = stream1.sample();
+  sampler.sample();
+  EXPECT(assert_equal(first, sampler.stream(1).sample(), tol));
+  EXPECT_LONGS_EQUAL(3, stream1.dim());
+
+  // Different streams, and the sampler itself, yield different samples
+  EXPECT(!first.isApprox(sampler.stream(2).sample()));
+  EXPECT(!first.isApprox(Sampler(sampler.model(), 7).sample()));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
 /* ************************************************************************* */
@@ -121,6 +121,28 @@ void PreintegratedCombinedMeasurements::integrateMeasurement(
   preintMeasCov_ = F * preintMeasCov_ * F.transpose() + G_measCov_Gt;
 }
 
+//------------------------------------------------------------------------------
+#ifdef GTSAM_TANGENT_PREINTEGRATION
+void PreintegratedCombinedMeasurements::mergeWith(
+    const PreintegratedCombinedMeasurements& pim12, Matrix9* H1, Matrix9* H2) {
+  PreintegrationType::mergeWith(pim12, H1, H2);
+
+  // Jacobian of the merged state [zeta02; bias] wrt [zeta01; bias]: the bias
+  // enters zeta12 through the bias Jacobians of pim12
+  Eigen::Matrix<double, 15, 15> F = Eigen::Matrix<double, 15, 15>::Identity();
+  F.block<9, 9>(0, 0) = *H1;
+  F.block<9, 3>(0, 9) = *H2 * pim12.preintegrated_H_biasAcc_;
+  F.block<9, 3>(0, 12) = *H2 * pim12.preintegrated_H_biasOmega_;
+
+  // Jacobian of the merged state wrt [zeta12; bias random walk over 12]
+  Eigen::Matrix<double, 15, 15> G = Eigen::Matrix<double, 15, 15>::Identity();
+  G.block<9, 9>(0, 0) = *H2;
+
+  const Eigen::Matrix<double, 15, 15> P = F * preintMeasCov_ * F.transpose();
+  preintMeasCov_ = P + G * pim12.preintMeasCov_ * G.transpose();
+}
+#endif
+
 //------------------------------------------------------------------------------
 #ifdef GTSAM_ALLOW_DEPRECATED_SINCE_V4
 PreintegratedCombinedMeasurements::PreintegratedCombinedMeasurements(
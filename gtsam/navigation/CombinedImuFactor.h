@@ -187,6 +187,15 @@ public:
   void integrateMeasurement(const Vector3& measuredAcc,
       const Vector3& measuredOmega, const double dt) override;
 
+#ifdef GTSAM_TANGENT_PREINTEGRATION
+  /**
+   * Merge in a different set of measurements, which follow the ones in this.
+   * The bias uncertainty of this is propagated into the merged preintegrated
+   * measurements through the bias Jacobians of pim, to first order.
+   */
+  void mergeWith(const PreintegratedCombinedMeasurements& pim, Matrix9* H1, Matrix9* H2);
+#endif
+
   /// @}
 
 #ifdef GTSAM_ALLOW_DEPRECATED_SINCE_V4
@@ -52,33 +52,87 @@ void PreintegratedImuMeasurements::resetIntegration() {
 //------------------------------------------------------------------------------
 void PreintegratedImuMeasurements::integrateMeasurement(
     const Vector3& measuredAcc, const Vector3& measuredOmega, double dt) {
-  if (dt <= 0) {
-    throw std::runtime_error(
-        "PreintegratedImuMeasurements::integrateMeasurement: dt <=0");
-  }
+  const DiscreteNoise noise = discreteNoise(dt);
 
   // Update preintegrated measurements (also get Jacobian)
   Matrix9 A;  // overall Jacobian wrt preintegrated measurements (df/dx)
   Matrix93 B, C;
   PreintegrationType::update(measuredAcc, measuredOmega, dt, &A, &B, &C);
+  propagateCovariance(A, B, C, noise);
+}
+
+//------------------------------------------------------------------------------
+PreintegratedImuMeasurements::DiscreteNoise
+PreintegratedImuMeasurements::discreteNoise(double dt) const {
+  if (dt <= 0) {
+    throw std::runtime_error(
+        "PreintegratedImuMeasurements::integrateMeasurement: dt <=0");
+  }
+
+  // (1/dt) allows to pass from continuous time noise to discrete time noise
+  // TODO(frank): use noiseModel routine so we can have arbitrary noise models.
+  DiscreteNoise noise;
+  noise.dt = dt;
+  noise.aCov = p().accelerometerCovariance / dt;
+  noise.wCov = p().gyroscopeCovariance / dt;
+  noise.iCov = p().integrationCovariance * dt;
+  noise.leverArm = p().body_P_sensor
+      && !p().body_P_sensor->translation().isZero();
+  return noise;
+}
 
+//------------------------------------------------------------------------------
+void PreintegratedImuMeasurements::propagateCovariance(const Matrix9& A,
+    const Matrix93& B, const Matrix93& C, const DiscreteNoise& noise) {
   // first order covariance propagation:
   // as in [2] we consider a first order propagation that can be seen as a
   // prediction phase in EKF
 
   // propagate uncertainty
-  // TODO(frank): use noiseModel routine so we can have arbitrary noise models.
-  const Matrix3& aCov = p().accelerometerCovariance;
-  const Matrix3& wCov = p().gyroscopeCovariance;
-  const Matrix3& iCov = p().integrationCovariance;
+  const double dt = noise.dt;
+  Matrix9& P = preintMeasCov_;
 
-  // (1/dt) allows to pass from continuous time noise to discrete time noise
-  preintMeasCov_ = A * preintMeasCov_ * A.transpose();
-  preintMeasCov_.noalias() += B * (aCov / dt) * B.transpose();
-  preintMeasCov_.noalias() += C * (wCov / dt) * C.transpose();
+#ifdef GTSAM_TANGENT_PREINTEGRATION
+  // TangentPreintegration::update yields A = [Arr 0 0; Apr I I*dt; Avr 0 I]
+  // and B = [0; Bv*dt/2; Bv], so P = A*P*A' + B*(aCov/dt)*B' is computed
+  // block by block, at a third of the cost of the dense products.
+  const auto Arr = A.block<3, 3>(0, 0);
+  const auto Apr = A.block<3, 3>(3, 0);
+  const auto Avr = A.block<3, 3>(6, 0);
+  Matrix9 T;  // A*P
+  T.topRows<3>().noalias() = Arr * P.topRows<3>();
+  T.middleRows<3>(3).noalias() = Apr * P.topRows<3>();
+  T.middleRows<3>(3) += P.middleRows<3>(3) + dt * P.bottomRows<3>();
+  T.bottomRows<3>().noalias() = Avr * P.topRows<3>();
+  T.bottomRows<3>() += P.bottomRows<3>();
+  P.leftCols<3>().noalias() = T.leftCols<3>() * Arr.transpose();
+  P.middleCols<3>(3).noalias() = T.leftCols<3>() * Apr.transpose();
+  P.middleCols<3>(3) += T.middleCols<3>(3) + dt * T.rightCols<3>();
+  P.rightCols<3>().noalias() = T.leftCols<3>() * Avr.transpose();
+  P.rightCols<3>() += T.rightCols<3>();
+
+  const auto Bv = B.block<3, 3>(6, 0);
+  const Matrix3 M = Bv * noise.aCov * Bv.transpose();
+  P.block<3, 3>(3, 3) += (0.25 * dt * dt) * M;
+  P.block<3, 3>(3, 6) += (0.5 * dt) * M;
+  P.block<3, 3>(6, 3) += (0.5 * dt) * M;
+  P.block<3, 3>(6, 6) += M;
+
+  // C = [Cr; 0; 0], unless a sensor lever arm couples omega into acceleration
+  if (noise.leverArm) {
+    P.noalias() += C * noise.wCov * C.transpose();
+  } else {
+    const auto Cr = C.block<3, 3>(0, 0);
+    P.block<3, 3>(0, 0).noalias() += Cr * noise.wCov * Cr.transpose();
+  }
+#else
+  P = A * P * A.transpose();
+  P.noalias() += B * noise.aCov * B.transpose();
+  P.noalias() += C * noise.wCov * C.transpose();
+#endif
 
   // NOTE(frank): (Gi*dt)*(C/dt)*(Gi'*dt), with Gi << Z_3x3, I_3x3, Z_3x3
-  preintMeasCov_.block<3, 3>(3, 3).noalias() += iCov * dt;
+  P.block<3, 3>(3, 3) += noise.iCov;
 }
 
 //------------------------------------------------------------------------------
@@ -90,9 +144,37 @@ void PreintegratedImuMeasurements::integrateMeasurements(
   assert(dts.cols() >= 1);
   assert(measuredAccs.cols() == dts.cols());
   assert(measuredOmegas.cols() == dts.cols());
-  size_t n = static_cast<size_t>(dts.cols());
+  const size_t n = static_cast<size_t>(dts.cols());
+
+  // Call the update and covariance kernels directly, rather than the virtual
+  // integrateMeasurement, with the Jacobians in scratch space shared by all samples
+  Matrix9 A;
+  Matrix93 B, C;
+  for (size_t j = 0; j < n; j++) {
+    const DiscreteNoise noise = discreteNoise(dts(0, j));
+    const Vector3 measuredAcc = measuredAccs.col(j);
+    const Vector3 measuredOmega = measuredOmegas.col(j);
+    PreintegrationType::update(measuredAcc, measuredOmega, noise.dt, &A, &B, &C);
+    propagateCovariance(A, B, C, noise);
+  }
+}
+
+//------------------------------------------------------------------------------
+void PreintegratedImuMeasurements::integrateMeasurements(
+    const Matrix& measuredAccs, const Matrix& measuredOmegas, double dt) {
+  assert(measuredAccs.rows() == 3 && measuredOmegas.rows() == 3);
+  assert(measuredAccs.cols() == measuredOmegas.cols());
+  const size_t n = static_cast<size_t>(measuredAccs.cols());
+
+  // Same as above, but the noise is discretized once for all samples
+  const DiscreteNoise noise = discreteNoise(dt);
+  Matrix9 A;
+  Matrix93 B, C;
   for (size_t j = 0; j < n; j++) {
-    integrateMeasurement(measuredAccs.col(j), measuredOmegas.col(j), dts(0, j));
+    const Vector3 measuredAcc = measuredAccs.col(j);
+    const Vector3 measuredOmega = measuredOmegas.col(j);
+    PreintegrationType::update(measuredAcc, measuredOmega, dt, &A, &B, &C);
+    propagateCovariance(A, B, C, noise);
   }
 }
 
@@ -128,10 +128,24 @@ public:
   void integrateMeasurement(const Vector3& measuredAcc,
       const Vector3& measuredOmega, const double dt) override;
 
-  /// Add multiple measurements, in matrix columns
+  /**
+   * Add multiple measurements, in matrix columns. Same as calling
+   * integrateMeasurement for every column, but without virtual dispatch.
+   * @param measuredAccs 3*n measured accelerations
+   * @param measuredOmegas 3*n measured angular velocities
+   * @param dts 1*n time intervals
+   */
   void integrateMeasurements(const Matrix& measuredAccs, const Matrix& measuredOmegas,
                              const Matrix& dts);
 
+  /**
+   * Add multiple measurements, in matrix columns, sampled at a constant rate
+   * 1/dt. Cheaper than passing the time intervals, as the measurement noise is
+   * discretized only once.
+   */
+  void integrateMeasurements(const Matrix& measuredAccs, const Matrix& measuredOmegas,
+                             double dt);
+
   /// Return pre-integrated measurement covariance
   Matrix preintMeasCov() const { return preintMeasCov_; }
 
@@ -158,6 +172,22 @@ public:
 
 private:
 
+  /// The measurement noise over a time interval dt, in discrete time
+  struct DiscreteNoise {
+    double dt;
+    Matrix3 aCov;   ///< accelerometer covariance / dt
+    Matrix3 wCov;   ///< gyroscope covariance / dt
+    Matrix3 iCov;   ///< integration covariance * dt
+    bool leverArm;  ///< whether the sensor has a lever arm
+  };
+
+  /// Discretize the noise for a time interval dt, throws if dt <= 0
+  DiscreteNoise discreteNoise(double dt) const;
+
+  /// Propagate preintMeasCov_ over one measurement, given the Jacobians of update
+  void propagateCovariance(const Matrix9& A, const Matrix93& B,
+      const Matrix93& C, const DiscreteNoise& noise);
+
   /// Serialization function
   friend class boost::serialization::access;
   template<class ARCHIVE>
@@ -0,0 +1,228 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    PreintegrationTree.h
+ * @brief   Parallel and tree-structured preintegration of IMU measurements
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/navigation/ImuFactor.h>
+#include <gtsam/navigation/CombinedImuFactor.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace gtsam {
+
+#ifdef GTSAM_TANGENT_PREINTEGRATION
+
+namespace internal {
+
+/// Integrate the measurements in columns [begin, end) into pim
+template<class PIM>
+void integrateColumns(PIM& pim, const Matrix& measuredAccs,
+    const Matrix& measuredOmegas, const Matrix& dts, size_t begin, size_t end) {
+  for (size_t j = begin; j < end; ++j)
+    pim.integrateMeasurement(measuredAccs.col(j), measuredOmegas.col(j), dts(0, j));
+}
+
+/// Merge pim12 into pim01, where an empty pim01 simply becomes pim12
+template<class PIM>
+void mergeInto(PIM& pim01, const PIM& pim12) {
+  if (pim01.deltaTij() == 0) {
+    pim01 = pim12;
+  } else {
+    Matrix9 H1, H2;
+    pim01.mergeWith(pim12, &H1, &H2);
+  }
+}
+
+} // namespace internal
+
+/**
+ * Segment tree over a buffer of IMU measurements, for creating IMU factors
+ * between arbitrary keyframes without re-integrating the raw measurements.
+ * The measurements are split in chunks of chunkSize samples, which are
+ * preintegrated in parallel, and every node of the tree holds the merge of
+ * its two children. The preintegration between any two samples is then
+ * assembled from O(log n) nodes, plus at most 2*chunkSize raw measurements at
+ * either end that do not fill a chunk.
+ *
+ * PIM is PreintegratedImuMeasurements or PreintegratedCombinedMeasurements.
+ * All chunks are integrated with the same bias estimate. As merging relies on
+ * mergeWith, it is only available with tangent preintegration, and does not
+ * support a sensor pose.
+ */
+template<class PIM>
+class PreintegrationTree {
+public:
+
+  typedef typename PIM::Params Params;
+
+private:
+
+  boost::shared_ptr<Params> p_;
+  imuBias::ConstantBias biasHat_;
+  Matrix measuredAccs_, measuredOmegas_, dts_;
+  size_t chunkSize_, nrChunks_;
+  size_t nrLeaves_; ///< nrChunks_ rounded up to a power of two
+
+  /// Node 1 is the root, nodes 2i and 2i+1 are the children of node i, and
+  /// chunk k is leaf nrLeaves_+k. Nodes without any chunks are left empty.
+  std::vector<PIM> nodes_;
+
+public:
+
+  /**
+   * Preintegrate all chunks and build the tree
+   * @param p Preintegration parameters
+   * @param measuredAccs 3*n measured accelerations
+   * @param measuredOmegas 3*n measured angular velocities
+   * @param dts 1*n time intervals
+   * @param chunkSize Number of measurements per leaf
+   * @param biasHat Bias estimate used for the preintegration
+   */
+  PreintegrationTree(const boost::shared_ptr<Params>& p,
+      const Matrix& measuredAccs, const Matrix& measuredOmegas,
+      const Matrix& dts, size_t chunkSize = 100,
+      const imuBias::ConstantBias& biasHat = imuBias::ConstantBias()) :
+      p_(p), biasHat_(biasHat), measuredAccs_(measuredAccs),
+      measuredOmegas_(measuredOmegas), dts_(dts), chunkSize_(chunkSize) {
+    if (chunkSize == 0 || measuredAccs.cols() != dts.cols()
+        || measuredOmegas.cols() != dts.cols())
+      throw std::invalid_argument(
+          "PreintegrationTree: inconsistent measurements or chunk size");
+    nrChunks_ = (size() + chunkSize_ - 1) / chunkSize_;
+    nrLeaves_ = 1;
+    while (nrLeaves_ < nrChunks_)
+      nrLeaves_ *= 2;
+    nodes_.resize(2 * nrLeaves_);
+
+    // Leaves
+    parallelFor(nrChunks_, [this](size_t k) {
+      PIM& leaf = nodes_[nrLeaves_ + k];
+      leaf = PIM(p_, biasHat_);
+      internal::integrateColumns(leaf, measuredAccs_, measuredOmegas_, dts_,
+          k * chunkSize_, chunkBegin(k + 1));
+    });
+
+    // Internal nodes, level by level: nodes [first, 2*first) span 'span' leaves
+    for (size_t first = nrLeaves_ / 2, span = 2; first >= 1; first /= 2, span *= 2) {
+      const size_t count = (nrChunks_ + span - 1) / span;
+      parallelFor(count, [&](size_t j) {
+        const size_t i = first + j;
+        nodes_[i] = nodes_[2 * i];
+        if ((2 * j + 1) * (span / 2) < nrChunks_)
+          internal::mergeInto(nodes_[i], nodes_[2 * i + 1]);
+      });
+    }
+  }
+
+  /// Number of measurements
+  size_t size() const {
+    return static_cast<size_t>(dts_.cols());
+  }
+
+  /// Number of measurements per leaf
+  size_t chunkSize() const {
+    return chunkSize_;
+  }
+
+  /// Number of leaves, the last of which may be partially filled
+  size_t nrChunks() const {
+    return nrChunks_;
+  }
+
+  /// Preintegrated measurements of samples [begin, end)
+  PIM preintegrate(size_t begin, size_t end) const {
+    if (begin > end || end > size())
+      throw std::invalid_argument("PreintegrationTree::preintegrate: invalid range");
+    PIM result(p_, biasHat_);
+    const size_t firstChunk = (begin + chunkSize_ - 1) / chunkSize_;
+    const size_t lastChunk = end == size() ? nrChunks_ : end / chunkSize_;
+    if (firstChunk >= lastChunk) {
+      internal::integrateColumns(result, measuredAccs_, measuredOmegas_, dts_,
+          begin, end);
+      return result;
+    }
+    internal::integrateColumns(result, measuredAccs_, measuredOmegas_, dts_,
+        begin, chunkBegin(firstChunk));
+    append(result, 1, 0, nrLeaves_, firstChunk, lastChunk);
+    internal::integrateColumns(result, measuredAccs_, measuredOmegas_, dts_,
+        chunkBegin(lastChunk), end);
+    return result;
+  }
+
+private:
+
+  /// Index of the first measurement of chunk k
+  size_t chunkBegin(size_t k) const {
+    return std::min(k * chunkSize_, size());
+  }
+
+  /// Merge chunks [lo, hi) of the subtree at node, which spans [nodeLo, nodeHi), into result
+  void append(PIM& result, size_t node, size_t nodeLo, size_t nodeHi,
+      size_t lo, size_t hi) const {
+    if (nodeHi <= lo || nodeLo >= hi)
+      return;
+    if (lo <= nodeLo && std::min(nodeHi, nrChunks_) <= hi) {
+      internal::mergeInto(result, nodes_[node]);
+      return;
+    }
+    const size_t mid = (nodeLo + nodeHi) / 2;
+    append(result, 2 * node, nodeLo, mid, lo, hi);
+    append(result, 2 * node + 1, mid, nodeHi, lo, hi);
+  }
+};
+
+/**
+ * Preintegrate a buffer of IMU measurements as a parallel reduction: chunks of
+ * chunkSize measurements are integrated in parallel, and then merged pairwise,
+ * in log2(n/chunkSize) parallel rounds. Equal, to first order, to integrating
+ * all measurements in turn. See PreintegrationTree for the requirements on PIM.
+ */
+template<class PIM>
+PIM ParallelPreintegrate(const boost::shared_ptr<typename PIM::Params>& p,
+    const Matrix& measuredAccs, const Matrix& measuredOmegas, const Matrix& dts,
+    size_t chunkSize = 100,
+    const imuBias::ConstantBias& biasHat = imuBias::ConstantBias()) {
+  if (chunkSize == 0 || measuredAccs.cols() != dts.cols()
+      || measuredOmegas.cols() != dts.cols())
+    throw std::invalid_argument(
+        "ParallelPreintegrate: inconsistent measurements or chunk size");
+  const size_t n = static_cast<size_t>(dts.cols());
+  std::vector<PIM> level((n + chunkSize - 1) / chunkSize, PIM(p, biasHat));
+  parallelFor(level.size(), [&](size_t k) {
+    internal::integrateColumns(level[k], measuredAccs, measuredOmegas, dts,
+        k * chunkSize, std::min((k + 1) * chunkSize, n));
+  });
+
+  // Merge pairs, carrying an odd one out to the next round
+  while (level.size() > 1) {
+    std::vector<PIM> next((level.size() + 1) / 2);
+    parallelFor(next.size(), [&](size_t i) {
+      next[i] = level[2 * i];
+      if (2 * i + 1 < level.size())
+        internal::mergeInto(next[i], level[2 * i + 1]);
+    });
+    level.swap(next);
+  }
+  return level.empty() ? PIM(p, biasHat) : level.front();
+}
+
+#endif
+
+} // namespace gtsam
@@ -17,6 +17,7 @@
 
 #include <gtsam/navigation/ScenarioRunner.h>
 #include <gtsam/base/timing.h>
+#include <gtsam/base/parallelFor.h>
 
 #include <boost/assign.hpp>
 #include <cmath>
@@ -32,16 +33,27 @@ static const Matrix3 kIntegrationErrorCovariance = intNoiseVar * I_3x3;
 PreintegratedImuMeasurements ScenarioRunner::integrate(
     double T, const Bias& estimatedBias, bool corrupted) const {
   gttic_(integrate);
+  return corrupted ? integrate(T, estimatedBias, &gyroSampler_, &accSampler_)
+                   : integrate(T, estimatedBias, nullptr, nullptr);
+}
+
+PreintegratedImuMeasurements ScenarioRunner::integrate(
+    double T, const Bias& estimatedBias, Sampler* gyroSampler,
+    Sampler* accSampler) const {
   PreintegratedImuMeasurements pim(p_, estimatedBias);
 
   const double dt = imuSampleTime();
   const size_t nrSteps = T / dt;
   double t = 0;
   for (size_t k = 0; k < nrSteps; k++, t += dt) {
-    Vector3 measuredOmega =
-        corrupted ? measuredAngularVelocity(t) : actualAngularVelocity(t);
-    Vector3 measuredAcc =
-        corrupted ? measuredSpecificForce(t) : actualSpecificForce(t);
+    Vector3 measuredOmega = actualAngularVelocity(t);
+    Vector3 measuredAcc = actualSpecificForce(t);
+    if (gyroSampler && accSampler) {
+      measuredOmega +=
+          estimatedBias_.gyroscope() + gyroSampler->sample() / sqrt_dt_;
+      measuredAcc +=
+          estimatedBias_.accelerometer() + accSampler->sample() / sqrt_dt_;
+    }
     pim.integrateMeasurement(measuredAcc, measuredOmega, dt);
   }
 
@@ -54,6 +66,26 @@ NavState ScenarioRunner::predict(const PreintegratedImuMeasurements& pim,
   return pim.predict(state_i, estimatedBias);
 }
 
+// Sample covariance of the columns of samples
+template <int N>
+static Eigen::Matrix<double, N, N> sampleCovariance(const Matrix& samples) {
+  typedef Eigen::Matrix<double, N, 1> VectorN;
+  const size_t nrSamples = samples.cols();
+  VectorN sum = VectorN::Zero();
+  for (size_t i = 0; i < nrSamples; i++) sum += samples.col(i);
+
+  // Compute MC covariance
+  VectorN sampleMean = sum / nrSamples;
+  Eigen::Matrix<double, N, N> Q;
+  Q.setZero();
+  for (size_t i = 0; i < nrSamples; i++) {
+    VectorN xi = samples.col(i) - sampleMean;
+    Q += xi * xi.transpose();
+  }
+
+  return Q / (nrSamples - 1);
+}
+
 Matrix9 ScenarioRunner::estimateCovariance(double T, size_t N,
                                            const Bias& estimatedBias) const {
   gttic_(estimateCovariance);
@@ -63,46 +95,53 @@ Matrix9 ScenarioRunner::estimateCovariance(double T, size_t N,
 
   // Sample !
   Matrix samples(9, N);
-  Vector9 sum = Vector9::Zero();
   for (size_t i = 0; i < N; i++) {
     auto pim = integrate(T, estimatedBias, true);
     NavState sampled = predict(pim);
-    Vector9 xi = sampled.localCoordinates(prediction);
-    samples.col(i) = xi;
-    sum += xi;
-  }
-
-  // Compute MC covariance
-  Vector9 sampleMean = sum / N;
-  Matrix9 Q;
-  Q.setZero();
-  for (size_t i = 0; i < N; i++) {
-    Vector9 xi = samples.col(i) - sampleMean;
-    Q += xi * xi.transpose();
+    samples.col(i) = sampled.localCoordinates(prediction);
   }
 
-  return Q / (N - 1);
+  return sampleCovariance<9>(samples);
 }
 
 Matrix6 ScenarioRunner::estimateNoiseCovariance(size_t N) const {
   Matrix samples(6, N);
-  Vector6 sum = Vector6::Zero();
   for (size_t i = 0; i < N; i++) {
     samples.col(i) << accSampler_.sample() / sqrt_dt_,
         gyroSampler_.sample() / sqrt_dt_;
-    sum += samples.col(i);
   }
 
-  // Compute MC covariance
-  Vector6 sampleMean = sum / N;
-  Matrix6 Q;
-  Q.setZero();
-  for (size_t i = 0; i < N; i++) {
-    Vector6 xi = samples.col(i) - sampleMean;
-    Q += xi * xi.transpose();
-  }
+  return sampleCovariance<6>(samples);
+}
+
+Matrix9 ScenarioRunner::estimateCovarianceInParallel(
+    double T, size_t N, const Bias& estimatedBias) const {
+  gttic_(estimateCovarianceInParallel);
+
+  // Get predict prediction from ground truth measurements
+  const NavState prediction = predict(integrate(T));
+
+  // Sample, every sample into its own column
+  Matrix samples(9, N);
+  parallelFor(N, [&](size_t i) {
+    Sampler gyroSampler = gyroSampler_.stream(i);
+    Sampler accSampler = accSampler_.stream(i);
+    auto pim = integrate(T, estimatedBias, &gyroSampler, &accSampler);
+    NavState sampled = predict(pim);
+    samples.col(i) = sampled.localCoordinates(prediction);
+  });
+
+  return sampleCovariance<9>(samples);
+}
+
+Matrix6 ScenarioRunner::estimateNoiseCovarianceInParallel(size_t N) const {
+  Matrix samples(6, N);
+  parallelFor(N, [&](size_t i) {
+    samples.col(i) << accSampler_.stream(i).sample() / sqrt_dt_,
+        gyroSampler_.stream(i).sample() / sqrt_dt_;
+  });
 
-  return Q / (N - 1);
+  return sampleCovariance<6>(samples);
 }
 
 }  // namespace gtsam
@@ -105,6 +105,17 @@ class GTSAM_EXPORT ScenarioRunner {
   /// Estimate covariance of sampled noise for sanity-check
   Matrix6 estimateNoiseCovariance(size_t N = 1000) const;
 
+  /**
+   * Same as estimateCovariance, but the N samples are drawn in parallel if
+   * TBB is available. Sample i uses its own stream i of the noise samplers,
+   * so the estimate does not depend on the number of threads.
+   */
+  Matrix9 estimateCovarianceInParallel(double T, size_t N = 1000,
+                                       const Bias& estimatedBias = Bias()) const;
+
+  /// Same as estimateNoiseCovariance, with sample i drawn from stream i
+  Matrix6 estimateNoiseCovarianceInParallel(size_t N = 1000) const;
+
 #ifdef GTSAM_ALLOW_DEPRECATED_SINCE_V4
   /// @name Deprecated
   /// @{
@@ -113,6 +124,13 @@ class GTSAM_EXPORT ScenarioRunner {
       : ScenarioRunner(*scenario, p, imuSampleTime, bias) {}
   /// @}
 #endif
+
+ private:
+  /// Integrate measurements for T seconds, corrupted with noise from the
+  /// given samplers if not null
+  PreintegratedImuMeasurements integrate(double T, const Bias& estimatedBias,
+                                         Sampler* gyroSampler,
+                                         Sampler* accSampler) const;
 };
 
 }  // namespace gtsam
@@ -239,6 +239,72 @@ TEST(ImuFactor, MultipleMeasurements) {
   EXPECT(assert_equal(expected,actual));
 }
 
+/* ************************************************************************* */
+namespace {
+// Covariance propagated with the dense first order formulas
+Matrix9 denseCovariance(const boost::shared_ptr<PreintegrationParams>& p,
+    const Matrix& accs, const Matrix& omegas, const Matrix& dts) {
+  PreintegrationType pim(p, kZeroBiasHat);
+  Matrix9 P = Z_9x9, A;
+  Matrix93 B, C;
+  for (int j = 0; j < dts.cols(); ++j) {
+    const double dt = dts(0, j);
+    pim.update(accs.col(j), omegas.col(j), dt, &A, &B, &C);
+    P = A * P * A.transpose()
+        + B * (p->accelerometerCovariance / dt) * B.transpose()
+        + C * (p->gyroscopeCovariance / dt) * C.transpose();
+    P.block<3, 3>(3, 3) += p->integrationCovariance * dt;
+  }
+  return P;
+}
+}
+
+TEST(ImuFactor, BatchIntegration) {
+  // Measurements at a varying rate
+  const int n = 50;
+  Matrix accs(3, n), omegas(3, n), dts(1, n);
+  for (int j = 0; j < n; ++j) {
+    accs.col(j) << 0.1 + 0.01 * j, 0.2 * sin(0.1 * j), kGravity;
+    omegas.col(j) << 0.3 * cos(0.2 * j), 0.1, -0.05 * j / n;
+    dts(0, j) = 0.005 + 0.0001 * (j % 7);
+  }
+
+  // Large noise, so the covariances are well above the tolerance
+  auto p = testing::Params();
+  p->accelerometerCovariance = 0.01 * I_3x3;
+  p->gyroscopeCovariance = 0.001 * I_3x3;
+
+  PreintegratedImuMeasurements expected(p, kZeroBiasHat);
+  for (int j = 0; j < n; ++j)
+    expected.integrateMeasurement(accs.col(j), omegas.col(j), dts(0, j));
+  PreintegratedImuMeasurements actual(p, kZeroBiasHat);
+  actual.integrateMeasurements(accs, omegas, dts);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+  EXPECT(assert_equal(denseCovariance(p, accs, omegas, dts),
+      actual.preintMeasCov(), 1e-9));
+
+  // Same, with a rotated sensor that has a lever arm
+  auto q = boost::make_shared<PreintegrationParams>(*p);
+  q->body_P_sensor = Pose3(Rot3::Ypr(0.1, 0.2, 0.3), Point3(0.1, 0.05, 0.02));
+  PreintegratedImuMeasurements withLeverArm(q, kZeroBiasHat);
+  withLeverArm.integrateMeasurements(accs, omegas, dts);
+  EXPECT(assert_equal(denseCovariance(q, accs, omegas, dts),
+      withLeverArm.preintMeasCov(), 1e-9));
+
+  // Constant rate
+  PreintegratedImuMeasurements constantRate(p, kZeroBiasHat);
+  constantRate.integrateMeasurements(accs, omegas, 0.01);
+  PreintegratedImuMeasurements varyingRate(p, kZeroBiasHat);
+  varyingRate.integrateMeasurements(accs, omegas, Matrix::Constant(1, n, 0.01));
+  EXPECT(assert_equal(varyingRate, constantRate));
+
+  // Non-positive time intervals are rejected
+  dts(0, n / 2) = 0;
+  PreintegratedImuMeasurements invalid(p, kZeroBiasHat);
+  CHECK_EXCEPTION(invalid.integrateMeasurements(accs, omegas, dts),
+      std::runtime_error);
+}
+
 /* ************************************************************************* */
 TEST(ImuFactor, ErrorAndJacobians) {
   using namespace common;
@@ -0,0 +1,130 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testPreintegrationTree.cpp
+ * @brief   Unit test for parallel and tree-structured preintegration
+ * @author  agent
+ */
+
+#include <gtsam/navigation/PreintegrationTree.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include "imuFactorTesting.h"
+
+#ifdef GTSAM_TANGENT_PREINTEGRATION
+
+namespace testing {
+// Combined parameters with above noise parameters, and bias random walk
+static boost::shared_ptr<PreintegrationCombinedParams> Params() {
+  auto p = PreintegrationCombinedParams::MakeSharedD(kGravity);
+  p->gyroscopeCovariance = kGyroSigma * kGyroSigma * I_3x3;
+  p->accelerometerCovariance = kAccelSigma * kAccelSigma * I_3x3;
+  p->integrationCovariance = 1e-8 * I_3x3;
+  p->biasAccCovariance = 1e-6 * I_3x3;
+  p->biasOmegaCovariance = 1e-8 * I_3x3;
+  p->biasAccOmegaInt = 1e-6 * I_6x6;
+  return p;
+}
+
+// A 100Hz IMU on a vehicle that turns and accelerates
+static const size_t kN = 100;
+static Matrix Accs() {
+  Matrix accs(3, kN);
+  for (size_t j = 0; j < kN; ++j)
+    accs.col(j) << 0.5 * sin(0.05 * j), 0.2 * cos(0.02 * j), -kGravity;
+  return accs;
+}
+static Matrix Omegas() {
+  Matrix omegas(3, kN);
+  for (size_t j = 0; j < kN; ++j)
+    omegas.col(j) << 0.1 * cos(0.03 * j), 0.05, 0.2;
+  return omegas;
+}
+static const Matrix kDts = Matrix::Constant(1, kN, 0.01);
+
+// Integrate samples [begin, end) in turn
+template<class PIM>
+PIM integrate(const boost::shared_ptr<PreintegrationCombinedParams>& p,
+    size_t begin, size_t end) {
+  PIM pim(p, kZeroBiasHat);
+  const Matrix accs = Accs(), omegas = Omegas();
+  for (size_t j = begin; j < end; ++j)
+    pim.integrateMeasurement(accs.col(j), omegas.col(j), kDts(0, j));
+  return pim;
+}
+}
+
+/* ************************************************************************* */
+TEST(PreintegrationTree, ImuMeasurements) {
+  // 13 chunks, the last of which has 4 samples
+  auto p = testing::Params();
+  const PreintegrationTree<PreintegratedImuMeasurements> tree(p,
+      testing::Accs(), testing::Omegas(), testing::kDts, 8);
+  EXPECT_LONGS_EQUAL(13, tree.nrChunks());
+
+  // Within a chunk, across chunk boundaries, and aligned with chunks
+  const size_t ranges[][2] = { { 0, 0 }, { 3, 6 }, { 5, 37 }, { 8, 64 },
+      { 17, 100 }, { 0, 100 } };
+  for (const auto& range : ranges) {
+    const auto expected = testing::integrate<PreintegratedImuMeasurements>(p,
+        range[0], range[1]);
+    const auto actual = tree.preintegrate(range[0], range[1]);
+    EXPECT(assert_equal(expected.preintegrated(), actual.preintegrated(), 1e-5));
+    EXPECT(assert_equal(expected.preintMeasCov(), actual.preintMeasCov(), 1e-10));
+  }
+
+  CHECK_EXCEPTION(tree.preintegrate(5, 101), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(PreintegrationTree, CombinedMeasurements) {
+  auto p = testing::Params();
+  const PreintegrationTree<PreintegratedCombinedMeasurements> tree(p,
+      testing::Accs(), testing::Omegas(), testing::kDts, 8);
+
+  // Merging is only first order accurate, as integrateMeasurement integrates
+  // the rotation in the tangent space. The covariances differ a bit more, as
+  // the bias Jacobians account for the effect of acceleration bias on
+  // position, which the covariance propagation of integrateMeasurement neglects
+  const auto expected =
+      testing::integrate<PreintegratedCombinedMeasurements>(p, 5, 95);
+  const auto actual = tree.preintegrate(5, 95);
+  EXPECT(assert_equal(expected.preintegrated(), actual.preintegrated(), 1e-5));
+  EXPECT(assert_equal(expected.preintMeasCov(), actual.preintMeasCov(), 1e-8));
+
+  // A factor between keyframes at samples 5 and 95
+  CombinedImuFactor factor(X(1), V(1), X(2), V(2), B(1), B(2), actual);
+  EXPECT_DOUBLES_EQUAL(0.9, factor.preintegratedMeasurements().deltaTij(), 1e-9);
+}
+
+/* ************************************************************************* */
+TEST(PreintegrationTree, ParallelPreintegrate) {
+  // The parallel reduction merges in a different order than the tree
+  auto p = testing::Params();
+  const auto expected =
+      testing::integrate<PreintegratedImuMeasurements>(p, 0, testing::kN);
+  const auto actual = ParallelPreintegrate<PreintegratedImuMeasurements>(p,
+      testing::Accs(), testing::Omegas(), testing::kDts, 7);
+  EXPECT(assert_equal(expected.preintegrated(), actual.preintegrated(), 1e-5));
+  EXPECT(assert_equal(expected.preintMeasCov(), actual.preintMeasCov(), 1e-10));
+}
+
+#endif
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -95,6 +95,27 @@ TEST(ScenarioRunner, Forward) {
   EXPECT(assert_equal(estimatedCov, pim.preintMeasCov(), 1e-5));
 }
 
+/* ************************************************************************* */
+TEST(ScenarioRunner, ForwardInParallel) {
+  using namespace forward;
+  ScenarioRunner runner(scenario, defaultParams(), kDt);
+  const double T = 0.1;  // seconds
+
+  auto pim = runner.integrate(T);
+  Matrix9 estimatedCov = runner.estimateCovarianceInParallel(T, 100);
+  EXPECT_NEAR(estimatedCov.diagonal(), pim.preintMeasCov().diagonal(), 0.1);
+  EXPECT(assert_equal(estimatedCov, pim.preintMeasCov(), 1e-5));
+
+  // Every sample has its own noise stream, so the estimate is reproducible
+  EXPECT(assert_equal(estimatedCov, runner.estimateCovarianceInParallel(T, 100), 0));
+
+  Matrix6 expected;
+  expected << defaultParams()->accelerometerCovariance / kDt, Z_3x3,  //
+      Z_3x3, defaultParams()->gyroscopeCovariance / kDt;
+  Matrix6 actual = runner.estimateNoiseCovarianceInParallel(1000);
+  EXPECT(assert_equal(expected, actual, 5e-5));
+}
+
 /* ************************************************************************* */
 TEST(ScenarioRunner, ForwardWithBias) {
   gttic(ForwardWithBias);
@@ -0,0 +1,122 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BatchLinearizer.cpp
+ * @author  agent
+ */
+
+#include <gtsam/nonlinear/BatchLinearizer.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+boost::shared_ptr<JacobianFactor> BatchLinearizer::AllocateJacobian(
+    const KeyVector& keys, const FastVector<DenseIndex>& dims, DenseIndex rows,
+    const SharedDiagonal& model) {
+  return boost::shared_ptr<JacobianFactor>(
+      new JacobianFactor(keys, dims, rows, model));
+}
+
+/* ************************************************************************* */
+boost::shared_ptr<JacobianFactor> BatchLinearizer::Kernel::Allocate(
+    const KeyVector& keys, const FastVector<DenseIndex>& dims, DenseIndex rows,
+    const SharedNoiseModel& noiseModel) {
+  SharedDiagonal model;
+  if (noiseModel && noiseModel->isConstrained())
+    model = boost::static_pointer_cast<noiseModel::Constrained>(noiseModel)->unit();
+  return AllocateJacobian(keys, dims, rows, model);
+}
+
+/* ************************************************************************* */
+void BatchLinearizer::Kernel::Whiten(const SharedNoiseModel& noiseModel,
+    JacobianFactor& factor) {
+  if (noiseModel)
+    noiseModel->WhitenSystem(factor.matrixObject());
+}
+
+/* ************************************************************************* */
+namespace {
+
+// Number of factors handed to a kernel at once
+const size_t chunkSize = 256;
+
+// Linearizes a group of factors of one type, with a kernel or one by one
+void linearizeGroup(const BatchLinearizer::Kernel* kernel,
+    const NonlinearFactorGraph& graph, const Values& values,
+    FactorIndices::const_iterator first, FactorIndices::const_iterator last,
+    GaussianFactorGraph& linearGraph) {
+  if (kernel) {
+    kernel->linearize(graph, values, first, last, linearGraph);
+  } else {
+    for (FactorIndices::const_iterator i = first; i != last; ++i)
+      linearGraph[*i] = graph[*i]->linearize(values);
+  }
+}
+
+}
+
+/* ************************************************************************* */
+GaussianFactorGraph::shared_ptr BatchLinearizer::linearize(
+    const NonlinearFactorGraph& graph, const Values& values) const {
+  gttic(BatchLinearizer_linearize);
+
+  // Group the factors by kernel, factors without one are kept together
+  vector<const Kernel*> kernels;
+  vector<FactorIndices> groups(1);
+  map<const Kernel*, size_t> groupOf;
+  kernels.push_back(0);
+  groupOf[0] = 0;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    if (!graph[i])
+      continue;
+    const Kernels::const_iterator kernel = kernels_.find(
+        std::type_index(typeid(*graph[i])));
+    const Kernel* k = kernel == kernels_.end() ? 0 : kernel->second.get();
+    const pair<map<const Kernel*, size_t>::iterator, bool> group =
+        groupOf.insert(make_pair(k, groups.size()));
+    if (group.second) {
+      kernels.push_back(k);
+      groups.push_back(FactorIndices());
+    }
+    groups[group.first->second].push_back(i);
+  }
+
+  // Null factors stay null
+  GaussianFactorGraph::shared_ptr linearGraph =
+      boost::make_shared<GaussianFactorGraph>();
+  linearGraph->resize(graph.size());
+
+  // Every group is linearized in chunks, in parallel
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+  for (size_t g = 0; g < groups.size(); ++g) {
+    const FactorIndices& indices = groups[g];
+    const size_t nrChunks = (indices.size() + chunkSize - 1) / chunkSize;
+    parallelFor(nrChunks, [&](size_t c) {
+      const size_t begin = c * chunkSize;
+      const size_t end = std::min(begin + chunkSize, indices.size());
+      linearizeGroup(kernels[g], graph, values, indices.begin() + begin,
+          indices.begin() + end, *linearGraph);
+    });
+  }
+
+  return linearGraph;
+}
+
+} // \namespace gtsam
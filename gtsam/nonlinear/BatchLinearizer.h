@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BatchLinearizer.h
+ * @brief   Linearize a factor graph with one batched kernel per factor type
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/JacobianFactor.h>
+
+#include <map>
+#include <typeindex>
+#include <typeinfo>
+
+namespace gtsam {
+
+/**
+ * A BatchLinearizer linearizes a NonlinearFactorGraph exactly like
+ * NonlinearFactorGraph::linearize, but groups the factors by their dynamic
+ * type first.  Every group for which a Kernel is registered is handed to that
+ * kernel in one call, so it can gather the variables of all its factors into
+ * contiguous buffers once and linearize them in a tight loop, without a
+ * virtual linearize call per factor.  Factors of any other type are linearized
+ * one by one as usual.
+ *
+ * Kernels are registered for an exact type: a class derived from a factor
+ * with a kernel is not handled by that kernel, as it may override the error.
+ * \nosubgrouping
+ */
+class GTSAM_EXPORT BatchLinearizer {
+ public:
+  /// Linearizes a group of factors of one type
+  class GTSAM_EXPORT Kernel {
+   public:
+    virtual ~Kernel() {}
+
+    /**
+     * Linearize the factors graph[i] for all i in [first, last), storing the
+     * results in linearGraph[i].  All those factors have the type the kernel
+     * was registered for, and are not null.
+     */
+    virtual void linearize(const NonlinearFactorGraph& graph,
+        const Values& values, FactorIndices::const_iterator first,
+        FactorIndices::const_iterator last,
+        GaussianFactorGraph& linearGraph) const = 0;
+
+   protected:
+    /**
+     * Allocate an uninitialized JacobianFactor with the given block widths and
+     * number of rows, to be filled with [A | -e] and then passed to Whiten.
+     * Constrained noise models are carried over as unit constrained models,
+     * as in NoiseModelFactor::linearize.
+     */
+    static boost::shared_ptr<JacobianFactor> Allocate(const KeyVector& keys,
+        const FastVector<DenseIndex>& dims, DenseIndex rows,
+        const SharedNoiseModel& noiseModel);
+
+    /// Whiten the augmented matrix of a factor created by Allocate in place
+    static void Whiten(const SharedNoiseModel& noiseModel,
+        JacobianFactor& factor);
+  };
+
+  typedef boost::shared_ptr<Kernel> sharedKernel;
+
+ protected:
+  typedef std::map<std::type_index, sharedKernel> Kernels;
+  Kernels kernels_;
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Create a linearizer without any kernels
+  BatchLinearizer() {}
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// Register a kernel for all factors of type FACTOR, replacing any previous one
+  template<class FACTOR>
+  void add(const sharedKernel& kernel) {
+    kernels_[std::type_index(typeid(FACTOR))] = kernel;
+  }
+
+  /// Number of factor types with a kernel
+  size_t nrKernels() const { return kernels_.size(); }
+
+  /// Whether a factor will be linearized by a kernel
+  bool hasKernel(const NonlinearFactor& factor) const {
+    return kernels_.find(std::type_index(typeid(factor))) != kernels_.end();
+  }
+
+  /// Linearize a graph, same as graph.linearize(values)
+  GaussianFactorGraph::shared_ptr linearize(const NonlinearFactorGraph& graph,
+      const Values& values) const;
+
+  /// @}
+
+ private:
+  static boost::shared_ptr<JacobianFactor> AllocateJacobian(
+      const KeyVector& keys, const FastVector<DenseIndex>& dims,
+      DenseIndex rows, const SharedDiagonal& model);
+};
+
+} // \namespace gtsam
@@ -22,6 +22,7 @@
 #include <gtsam/linear/GaussianBayesTree.h>
 #include <gtsam/linear/GaussianBayesNet.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/inference/OrderingCache.h>
 #include <gtsam/linear/VectorValues.h>
 
 #include <boost/algorithm/string.hpp>
@@ -125,7 +126,7 @@ GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
 /* ************************************************************************* */
 DoglegParams DoglegOptimizer::ensureHasOrdering(DoglegParams params, const NonlinearFactorGraph& graph) const {
   if (!params.ordering)
-    params.ordering = Ordering::Create(params.orderingType, graph);
+    params.ordering = OrderingCache::Create(params.orderingType, graph);
   return params;
 }
 
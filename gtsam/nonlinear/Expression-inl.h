@@ -83,7 +83,7 @@ Expression<T>::Expression(const Expression<A>& expression,
     T (A::*method)(typename MakeOptionalJacobian<T, A>::type) const) :
     root_(
         new internal::UnaryExpression<T, A>(boost::bind(method, _1, _2),
-            expression)) {
+            expression, internal::PointerStructure(method))) {
 }
 
 /// Construct a unary method expression
@@ -95,7 +95,8 @@ Expression<T>::Expression(const Expression<A1>& expression1,
     const Expression<A2>& expression2) :
     root_(
         new internal::BinaryExpression<T, A1, A2>(
-            boost::bind(method, _1, _2, _3, _4), expression1, expression2)) {
+            boost::bind(method, _1, _2, _3, _4), expression1, expression2,
+            internal::PointerStructure(method))) {
 }
 
 /// Construct a binary method expression
@@ -110,7 +111,7 @@ Expression<T>::Expression(const Expression<A1>& expression1,
     root_(
         new internal::TernaryExpression<T, A1, A2, A3>(
             boost::bind(method, _1, _2, _3, _4, _5, _6), expression1,
-            expression2, expression3)) {
+            expression2, expression3, internal::PointerStructure(method))) {
 }
 
 template<typename T>
@@ -237,6 +238,11 @@ struct apply_compose {
       boost::none, OptionalJacobian<Dim, Dim> H2 = boost::none) const {
     return x.compose(y, H1, H2);
   }
+  // As a function pointer, so that products have a known structure
+  static T Compose(const T& x, const T& y, OptionalJacobian<Dim, Dim> H1,
+      OptionalJacobian<Dim, Dim> H2) {
+    return x.compose(y, H1, H2);
+  }
 };
 }
 
@@ -246,8 +252,7 @@ struct apply_compose {
 template<typename T>
 Expression<T> operator*(const Expression<T>& expression1,
     const Expression<T>& expression2) {
-  return Expression<T>(
-      boost::bind(internal::apply_compose<T>(), _1, _2, _3, _4), expression1,
+  return Expression<T>(&internal::apply_compose<T>::Compose, expression1,
       expression2);
 }
 
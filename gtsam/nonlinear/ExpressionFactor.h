@@ -26,12 +26,36 @@
 
 namespace gtsam {
 
+namespace internal {
+
+/**
+ * Interface through which ExpressionFactorGraph reaches the tapes of
+ * ExpressionFactors of any measurement type, to share subexpressions.
+ */
+class TapedFactor {
+ public:
+  virtual ~TapedFactor() {}
+
+  /// The compiled expression, or null if it could not be compiled
+  virtual const ExpressionTape* tape() const = 0;
+
+  /// Compile the expression again, reading the subexpressions in shared
+  virtual boost::shared_ptr<ExpressionTape> compile(
+      const SharedSubexpressions& shared) const = 0;
+
+  /// Linearize by executing the given tape of the expression
+  virtual boost::shared_ptr<GaussianFactor> linearizeWithTape(const Values& x,
+      const ExpressionTape& tape) const = 0;
+};
+
+}  // namespace internal
+
 /**
 
  * Factor that supports arbitrary expressions via AD
  */
 template<typename T>
-class ExpressionFactor: public NoiseModelFactor {
+class ExpressionFactor: public NoiseModelFactor, public internal::TapedFactor {
   BOOST_CONCEPT_ASSERT((IsTestable<T>));
 
 protected:
@@ -42,6 +66,7 @@ protected:
   T measured_;  ///< the measurement to be compared with the expression
   Expression<T> expression_;  ///< the expression that is AD enabled
   FastVector<int> dims_;      ///< dimensions of the Jacobian matrices
+  boost::shared_ptr<internal::ExpressionTape> tape_; ///< compiled expression, if possible
 
 
  public:
@@ -100,6 +125,12 @@ protected:
   }
 
   virtual boost::shared_ptr<GaussianFactor> linearize(const Values& x) const {
+    return linearizeUsing(x, tape_.get());
+  }
+
+  /// Linearize with the given tape, or with the expression tree if null
+  boost::shared_ptr<GaussianFactor> linearizeUsing(const Values& x,
+      const internal::ExpressionTape* tape) const {
     // Only linearize if the factor is active
     if (!active(x))
       return boost::shared_ptr<JacobianFactor>();
@@ -123,20 +154,38 @@ protected:
     Ab.matrix().setZero();
 
     // Get value and Jacobians, writing directly into JacobianFactor
-    T value = expression_.valueAndJacobianMap(x, jacobianMap); // <<< Reverse AD happens here !
+    // Reverse AD happens here, with the compiled tape if there is one !
+    T value = tape ? tape->execute<T>(x, Ab)
+        : expression_.valueAndJacobianMap(x, jacobianMap);
 
     // Evaluate error and set RHS vector b
     Ab(size()).col(0) = traits<T>::Local(value, measured_);
 
-    // Whiten the corresponding system, Ab already contains RHS
-    if (noiseModel_) {
-      Vector b = Ab(size()).col(0);  // need b to be valid for Robust noise models
-      noiseModel_->WhitenSystem(Ab.matrix(), b);
-    }
+    // Whiten the corresponding system in place, Ab already contains RHS
+    if (noiseModel_)
+      noiseModel_->WhitenSystem(Ab);
 
     return factor;
   }
 
+  /// @name TapedFactor interface
+  /// @{
+
+  virtual const internal::ExpressionTape* tape() const { return tape_.get(); }
+
+  virtual boost::shared_ptr<internal::ExpressionTape> compile(
+      const internal::SharedSubexpressions& shared) const {
+    return internal::ExpressionTape::Compile(*expression_.root(), keys_,
+        &shared);
+  }
+
+  virtual boost::shared_ptr<GaussianFactor> linearizeWithTape(const Values& x,
+      const internal::ExpressionTape& tape) const {
+    return linearizeUsing(x, &tape);
+  }
+
+  /// @}
+
   /// @return a deep copy of this factor
   virtual gtsam::NonlinearFactor::shared_ptr clone() const {
     return boost::static_pointer_cast<gtsam::NonlinearFactor>(
@@ -176,6 +225,9 @@ protected:
      expression_.dims(keyedDims);
      for (Key key : keys_) dims_.push_back(keyedDims[key]);
    }
+
+   // Compile the expression once, keeping the tree as fallback if that fails
+   tape_ = internal::ExpressionTape::Compile(*expression_.root(), keys_);
  }
 
  /// Recreate expression from keys_ and measured_, used in load below.
@@ -0,0 +1,81 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ *  @file  ExpressionFactorGraph.cpp
+ *  @brief Factor graph that supports adding ExpressionFactors directly
+ *  @author agent
+ */
+
+#include <gtsam/nonlinear/ExpressionFactorGraph.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/base/timing.h>
+
+#include <boost/make_shared.hpp>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+boost::shared_ptr<GaussianFactorGraph> ExpressionFactorGraph::linearizeShared(
+    const Values& values) {
+  gttic(ExpressionFactorGraph_linearizeShared);
+
+  // Find the shared subexpressions, and compile the factors against them
+  if (sharedCache_.factors != factors_) {
+    gttic(analyze);
+    vector<const internal::ExpressionTape*> tapes(size());
+    for (size_t i = 0; i < size(); ++i) {
+      const internal::TapedFactor* factor =
+          dynamic_cast<const internal::TapedFactor*>(factors_[i].get());
+      if (factor)
+        tapes[i] = factor->tape();
+    }
+    sharedCache_.shared = boost::make_shared<internal::SharedSubexpressions>(
+        tapes);
+    sharedCache_.tapes.assign(size(), boost::shared_ptr<internal::ExpressionTape>());
+    for (size_t i = 0; i < size() && sharedCache_.shared->size() > 0; ++i) {
+      if (!tapes[i])
+        continue;
+      boost::shared_ptr<internal::ExpressionTape> tape =
+          dynamic_cast<const internal::TapedFactor&>(*factors_[i]).compile(
+              *sharedCache_.shared);
+      if (tape && tape->nrShared() > 0)
+        sharedCache_.tapes[i] = tape;
+    }
+    sharedCache_.factors = factors_;
+  }
+
+  gttic(evaluate);
+  sharedCache_.shared->evaluate(values);
+  gttoc(evaluate);
+
+  // Linearize, the factors that use shared subexpressions with their own tape
+  GaussianFactorGraph::shared_ptr linearFG =
+      boost::make_shared<GaussianFactorGraph>();
+  linearFG->resize(size());
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+  parallelFor(size(), [&](size_t i) {
+    const sharedFactor& factor = factors_[i];
+    if (!factor)
+      return;
+    if (sharedCache_.tapes[i])
+      (*linearFG)[i] = dynamic_cast<const internal::TapedFactor&>(*factor)
+          .linearizeWithTape(values, *sharedCache_.tapes[i]);
+    else
+      (*linearFG)[i] = factor->linearize(values);
+  });
+  return linearFG;
+}
+
+} // namespace gtsam
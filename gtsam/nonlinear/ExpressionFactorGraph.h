@@ -26,7 +26,25 @@ namespace gtsam {
 /**
  * Factor graph that supports adding ExpressionFactors directly
  */
-class ExpressionFactorGraph: public NonlinearFactorGraph {
+class GTSAM_EXPORT ExpressionFactorGraph: public NonlinearFactorGraph {
+
+  /// Subexpressions shared between the factors, see linearizeShared
+  struct SharedCache {
+    FastVector<sharedFactor> factors;  ///< The factors it was built for
+    boost::shared_ptr<internal::SharedSubexpressions> shared;
+    std::vector<boost::shared_ptr<internal::ExpressionTape> > tapes;
+
+    SharedCache() {}
+    // A copied graph builds its own cache, as evaluation writes into it
+    SharedCache(const SharedCache&) {}
+    SharedCache& operator=(const SharedCache&) {
+      factors.clear();
+      tapes.clear();
+      shared.reset();
+      return *this;
+    }
+  };
+  SharedCache sharedCache_;
 
 public:
 
@@ -47,6 +65,27 @@ public:
   }
 
   /// @}
+
+  /// @name Linearization
+  /// @{
+
+  /**
+   * Linearize, evaluating the subexpressions that several ExpressionFactors
+   * have in common only once.  These are subexpressions with the same
+   * structure, e.g., the pose of a camera composed with its calibration, or a
+   * landmark transformed into a shared frame, whether the factors were built
+   * from the same Expression or each from its own.  The result is the same as
+   * that of linearize().  Which subexpressions are shared is worked out on the
+   * first call and kept in the graph until the factors change.
+   */
+  boost::shared_ptr<GaussianFactorGraph> linearizeShared(const Values& values);
+
+  /// Number of subexpressions linearizeShared evaluates once, 0 if not called
+  size_t nrSharedSubexpressions() const {
+    return sharedCache_.shared ? sharedCache_.shared->size() : 0;
+  }
+
+  /// @}
 };
 
 }
@@ -19,6 +19,7 @@
 #include <gtsam/nonlinear/GaussNewtonOptimizer.h>
 #include <gtsam/nonlinear/internal/NonlinearOptimizerState.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/inference/OrderingCache.h>
 #include <gtsam/linear/VectorValues.h>
 
 namespace gtsam {
@@ -69,7 +70,7 @@ GaussianFactorGraph::shared_ptr GaussNewtonOptimizer::iterate() {
 GaussNewtonParams GaussNewtonOptimizer::ensureHasOrdering(
     GaussNewtonParams params, const NonlinearFactorGraph& graph) const {
   if (!params.ordering)
-    params.ordering = Ordering::Create(params.orderingType, graph);
+    params.ordering = OrderingCache::Create(params.orderingType, graph);
   return params;
 }
 
@@ -23,6 +23,7 @@
 #include <gtsam/base/debug.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/inference/BayesTree-inst.h>
+#include <gtsam/inference/FlatVariableIndex.h>
 #include <gtsam/nonlinear/LinearContainerFactor.h>
 
 #include <algorithm>
@@ -41,6 +42,8 @@ ISAM2::ISAM2(const ISAM2Params& params) : params_(params), update_count_(0) {
   if (params_.optimizationParams.type() == typeid(ISAM2DoglegParams))
     doglegDelta_ =
         boost::get<ISAM2DoglegParams>(params_.optimizationParams).initialDelta;
+  // Reuse the factor slots freed by marginalization to bound memory
+  if (params_.isSlidingWindow()) params_.findUnusedFactorSlots = true;
 }
 
 /* ************************************************************************* */
@@ -179,8 +182,9 @@ void ISAM2::recalculateBatch(const ISAM2UpdateParams& updateParams,
   br::copy(variableIndex_ | br::map_keys,
            std::inserter(*affectedKeysSet, affectedKeysSet->end()));
 
-  // Removed unused keys:
-  VariableIndex affectedFactorsVarIndex = variableIndex_;
+  // Removed unused keys, in a flat copy of the index that the ordering and
+  // elimination tree consume directly:
+  FlatVariableIndex affectedFactorsVarIndex(variableIndex_);
 
   affectedFactorsVarIndex.removeUnusedVariables(result->unusedKeys.begin(),
                                                 result->unusedKeys.end());
@@ -307,7 +311,7 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   affectedKeysSet->insert(affectedKeys.begin(), affectedKeys.end());
   gttoc(list_to_set);
 
-  VariableIndex affectedFactorsVarIndex(factors);
+  FlatVariableIndex affectedFactorsVarIndex(factors);
 
   gttic(ordering_constraints);
   // Create ordering constraints
@@ -390,6 +394,118 @@ void ISAM2::removeVariables(const KeySet& unusedKeys) {
     theta_.erase(key);
     fixedVariables_.erase(key);
   }
+
+  // Forget the timestamps of variables leaving the sliding window
+  if (!keyTimestamps_.empty()) {
+    for (Key key : unusedKeys) {
+      auto it = keyTimestamps_.find(key);
+      if (it == keyTimestamps_.end()) continue;
+      auto range = timestampKeys_.equal_range(it->second);
+      for (auto jt = range.first; jt != range.second; ++jt) {
+        if (jt->second == key) {
+          timestampKeys_.erase(jt);
+          break;
+        }
+      }
+      keyTimestamps_.erase(it);
+    }
+  }
+}
+
+/* ************************************************************************* */
+void ISAM2::stampNewVariables(const Values& newTheta,
+                              const ISAM2UpdateParams& updateParams) {
+  gttic(stampNewVariables);
+  // Default stamp: the update count when counting variables, otherwise the
+  // most recent timestamp seen
+  double defaultTimestamp = 0.0;
+  if (params_.slidingWindowMode == ISAM2Params::COUNT_LAG)
+    defaultTimestamp = update_count_;
+  else if (!timestampKeys_.empty())
+    defaultTimestamp = timestampKeys_.rbegin()->first;
+
+  for (Key key : newTheta.keys()) {
+    double timestamp = defaultTimestamp;
+    if (updateParams.newKeyTimestamps) {
+      auto it = updateParams.newKeyTimestamps->find(key);
+      if (it != updateParams.newKeyTimestamps->end()) timestamp = it->second;
+    }
+    keyTimestamps_[key] = timestamp;
+    timestampKeys_.insert(std::make_pair(timestamp, key));
+  }
+}
+
+/* ************************************************************************* */
+KeyVector ISAM2::findMarginalizableKeys() const {
+  KeyVector marginalizableKeys;
+  if (timestampKeys_.empty()) return marginalizableKeys;
+
+  if (params_.slidingWindowMode == ISAM2Params::TIME_LAG) {
+    const double oldest =
+        timestampKeys_.rbegin()->first - params_.slidingWindowLag;
+    for (auto it = timestampKeys_.begin();
+         it != timestampKeys_.end() && it->first < oldest; ++it)
+      marginalizableKeys.push_back(it->second);
+  } else {
+    const size_t lag = static_cast<size_t>(params_.slidingWindowLag);
+    if (timestampKeys_.size() > lag) {
+      const size_t nrOld = timestampKeys_.size() - lag;
+      auto it = timestampKeys_.begin();
+      for (size_t i = 0; i < nrOld; ++i, ++it)
+        marginalizableKeys.push_back(it->second);
+    }
+  }
+
+  // Wait until a full batch has accumulated
+  if (marginalizableKeys.size() < params_.slidingWindowBatchSize)
+    marginalizableKeys.clear();
+  return marginalizableKeys;
+}
+
+/* ************************************************************************* */
+// Mark the frontal keys of all cliques below 'clique' that have 'key' in their
+// separator. These have to be re-eliminated to move 'key' below them.
+static void markCliquesInvolving(Key key, const ISAM2::sharedClique& clique,
+                                 FastList<Key>* markedKeys) {
+  const auto& conditional = clique->conditional();
+  if (std::find(conditional->beginParents(), conditional->endParents(), key) !=
+      conditional->endParents()) {
+    markedKeys->insert(markedKeys->end(), conditional->beginFrontals(),
+                       conditional->endFrontals());
+    for (const auto& child : clique->children)
+      markCliquesInvolving(key, child, markedKeys);
+  }
+}
+
+/* ************************************************************************* */
+void ISAM2::constrainSlidingWindow(const KeyVector& marginalizableKeys,
+                                   ISAM2UpdateParams* updateParams) const {
+  gttic(constrainSlidingWindow);
+  // All window variables go after the marginalizable ones, keeping any groups
+  // requested by the caller in the same relative order.
+  FastMap<Key, int> constrainedKeys;
+  for (const auto& key_timestamp : keyTimestamps_)
+    constrainedKeys[key_timestamp.first] = 1;
+  if (updateParams->constrainedKeys) {
+    for (const auto& key_group : *updateParams->constrainedKeys)
+      constrainedKeys[key_group.first] = key_group.second + 1;
+  }
+  for (Key key : marginalizableKeys) constrainedKeys[key] = 0;
+  updateParams->constrainedKeys = constrainedKeys;
+
+  // Re-eliminate the marginalizable variables and everything below them that
+  // depends on them, so that they become leaves.
+  FastList<Key> extraReelimKeys;
+  if (updateParams->extraReelimKeys)
+    extraReelimKeys = *updateParams->extraReelimKeys;
+  for (Key key : marginalizableKeys) {
+    auto node = nodes_.find(key);
+    if (node == nodes_.end()) continue;  // new variable, not yet in the tree
+    extraReelimKeys.push_back(key);
+    for (const auto& child : node->second->children)
+      markCliquesInvolving(key, child, &extraReelimKeys);
+  }
+  updateParams->extraReelimKeys = extraReelimKeys;
 }
 
 /* ************************************************************************* */
@@ -414,6 +530,38 @@ ISAM2Result ISAM2::update(
 ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
                           const Values& newTheta,
                           const ISAM2UpdateParams& updateParams) {
+  if (!params_.isSlidingWindow())
+    return updateInternal(newFactors, newTheta, updateParams);
+
+  // Stamp new variables and find the ones that left the window
+  stampNewVariables(newTheta, updateParams);
+  KeyVector marginalizableKeys = findMarginalizableKeys();
+
+  ISAM2Result result;
+  if (marginalizableKeys.empty()) {
+    result = updateInternal(newFactors, newTheta, updateParams);
+  } else {
+    ISAM2UpdateParams windowParams = updateParams;
+    constrainSlidingWindow(marginalizableKeys, &windowParams);
+    result = updateInternal(newFactors, newTheta, windowParams);
+
+    // Variables may have been removed altogether during the update
+    gttic(marginalizeSlidingWindow);
+    FastList<Key> leafKeys;
+    for (Key key : marginalizableKeys)
+      if (theta_.exists(key)) leafKeys.push_back(key);
+    if (!leafKeys.empty()) marginalizeLeaves(leafKeys);
+    result.marginalizedKeys.assign(leafKeys.begin(), leafKeys.end());
+    result.cliques = this->nodes().size();
+    gttoc(marginalizeSlidingWindow);
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+ISAM2Result ISAM2::updateInternal(const NonlinearFactorGraph& newFactors,
+                                  const Values& newTheta,
+                                  const ISAM2UpdateParams& updateParams) {
   gttic(ISAM2_update);
   this->update_count_ += 1;
   UpdateImpl::LogStartingUpdate(newFactors, *this);
@@ -658,35 +806,46 @@ void ISAM2::marginalizeLeaves(
   // At this point we have updated the BayesTree, now update the remaining iSAM2
   // data structures
 
+  // Remove the factors to remove that have been summarized in the newly-added
+  // marginal factors
+  NonlinearFactorGraph removedFactors;
+  for (const auto index : factorIndicesToRemove) {
+    removedFactors.push_back(nonlinearFactors_[index]);
+    nonlinearFactors_.remove(index);
+    if (params_.cacheLinearizedFactors) linearFactors_.remove(index);
+  }
+  variableIndex_.remove(factorIndicesToRemove.begin(),
+                        factorIndicesToRemove.end(), removedFactors);
+
   // Gather factors to add - the new marginal factors
   GaussianFactorGraph factorsToAdd;
+  NonlinearFactorGraph nonlinearFactorsToAdd;
   for (const auto& key_factors : marginalFactors) {
     for (const auto& factor : key_factors.second) {
       if (factor) {
         factorsToAdd.push_back(factor);
-        if (marginalFactorsIndices)
-          marginalFactorsIndices->push_back(nonlinearFactors_.size());
-        nonlinearFactors_.push_back(
+        nonlinearFactorsToAdd.push_back(
             boost::make_shared<LinearContainerFactor>(factor));
-        if (params_.cacheLinearizedFactors) linearFactors_.push_back(factor);
         for (Key factorKey : *factor) {
           fixedVariables_.insert(factorKey);
         }
       }
     }
   }
-  variableIndex_.augment(factorsToAdd);  // Augment the variable index
 
-  // Remove the factors to remove that have been summarized in the newly-added
-  // marginal factors
-  NonlinearFactorGraph removedFactors;
-  for (const auto index : factorIndicesToRemove) {
-    removedFactors.push_back(nonlinearFactors_[index]);
-    nonlinearFactors_.remove(index);
-    if (params_.cacheLinearizedFactors) linearFactors_.remove(index);
+  // Add them, in the slots just freed if findUnusedFactorSlots is set
+  const FactorIndices newFactorsIndices = nonlinearFactors_.add_factors(
+      nonlinearFactorsToAdd, params_.findUnusedFactorSlots);
+  if (params_.cacheLinearizedFactors) {
+    linearFactors_.resize(nonlinearFactors_.size());
+    for (size_t i = 0; i < factorsToAdd.size(); ++i)
+      linearFactors_[newFactorsIndices[i]] = factorsToAdd[i];
   }
-  variableIndex_.remove(factorIndicesToRemove.begin(),
-                        factorIndicesToRemove.end(), removedFactors);
+  variableIndex_.augment(factorsToAdd, newFactorsIndices);
+  if (marginalFactorsIndices)
+    marginalFactorsIndices->insert(marginalFactorsIndices->end(),
+                                   newFactorsIndices.begin(),
+                                   newFactorsIndices.end());
 
   if (deletedFactorsIndices)
     deletedFactorsIndices->assign(factorIndicesToRemove.begin(),
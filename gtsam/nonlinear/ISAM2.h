@@ -27,6 +27,7 @@
 #include <gtsam/nonlinear/ISAM2UpdateParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
+#include <map>
 #include <vector>
 
 namespace gtsam {
@@ -96,6 +97,12 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   int update_count_;  ///< Counter incremented every update(), used to determine
                       ///< periodic relinearization
 
+  /** Timestamps of the variables in the window, only maintained when
+   * ISAM2Params::slidingWindowMode is enabled.  The multimap orders the
+   * variables from oldest to newest. */
+  FastMap<Key, double> keyTimestamps_;
+  std::multimap<double, Key> timestampKeys_;
+
  public:
   using This = ISAM2;                       ///< This class
   using Base = BayesTree<ISAM2Clique>;      ///< The BayesTree base class
@@ -160,6 +167,12 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   /**
    * Add new factors, updating the solution and relinearizing as needed.
    *
+   * When ISAM2Params::slidingWindowMode is enabled, the new variables are
+   * stamped with ISAM2UpdateParams::newKeyTimestamps, the ordering is
+   * constrained to keep the variables that left the window at the leaves, and
+   * those are marginalized out at the end of the update (see
+   * ISAM2Result::marginalizedKeys).
+   *
    * Alternative signature of update() (see its documentation above), with all
    * additional parameters in one structure. This form makes easier to keep
    * future API/ABI compatibility if parameters change.
@@ -201,6 +214,11 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
       boost::optional<FactorIndices&> marginalFactorsIndices = boost::none,
       boost::optional<FactorIndices&> deletedFactorsIndices = boost::none);
 
+  /// Access the timestamps of the variables in the sliding window
+  const FastMap<Key, double>& getKeyTimestamps() const {
+    return keyTimestamps_;
+  }
+
   /// Access the current linearization point
   const Values& getLinearizationPoint() const { return theta_; }
 
@@ -281,6 +299,22 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   /// @}
 
  protected:
+  /// The ISAM2 update step proper, without the sliding-window bookkeeping
+  ISAM2Result updateInternal(const NonlinearFactorGraph& newFactors,
+                             const Values& newTheta,
+                             const ISAM2UpdateParams& updateParams);
+
+  /// Record the timestamps of new variables in the sliding window
+  void stampNewVariables(const Values& newTheta,
+                         const ISAM2UpdateParams& updateParams);
+
+  /// Find the variables that left the sliding window, oldest first
+  KeyVector findMarginalizableKeys() const;
+
+  /// Constrain the ordering so that marginalizable keys end up at the leaves
+  void constrainSlidingWindow(const KeyVector& marginalizableKeys,
+                              ISAM2UpdateParams* updateParams) const;
+
   /// Remove marked top and either recalculate in batch or incrementally.
   void recalculate(const ISAM2UpdateParams& updateParams,
                    const KeySet& relinKeys, ISAM2Result* result);
@@ -86,4 +86,37 @@ string ISAM2Params::factorizationTranslator(
   return s;
 }
 
+/* ************************************************************************* */
+ISAM2Params::SlidingWindowMode ISAM2Params::slidingWindowModeTranslator(
+    const string& str) {
+  string s = str;
+  boost::algorithm::to_upper(s);
+  if (s == "TIME_LAG") return ISAM2Params::TIME_LAG;
+  if (s == "COUNT_LAG") return ISAM2Params::COUNT_LAG;
+
+  /* default is NO_SLIDING_WINDOW */
+  return ISAM2Params::NO_SLIDING_WINDOW;
+}
+
+/* ************************************************************************* */
+string ISAM2Params::slidingWindowModeTranslator(
+    const ISAM2Params::SlidingWindowMode& value) {
+  string s;
+  switch (value) {
+    case ISAM2Params::NO_SLIDING_WINDOW:
+      s = "NO_SLIDING_WINDOW";
+      break;
+    case ISAM2Params::TIME_LAG:
+      s = "TIME_LAG";
+      break;
+    case ISAM2Params::COUNT_LAG:
+      s = "COUNT_LAG";
+      break;
+    default:
+      s = "UNDEFINED";
+      break;
+  }
+  return s;
+}
+
 }  // namespace gtsam
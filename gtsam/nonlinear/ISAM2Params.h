@@ -223,6 +223,27 @@ struct GTSAM_EXPORT ISAM2Params {
   /// cost of having to search for slots every time a factor is added.
   bool findUnusedFactorSlots;
 
+  /** Sliding-window (fixed-lag) operation.  With TIME_LAG, every variable is
+   * stamped with the timestamp passed in ISAM2UpdateParams::newKeyTimestamps,
+   * and variables older than the newest timestamp minus slidingWindowLag are
+   * marginalized out.  With COUNT_LAG, only the slidingWindowLag most recent
+   * variables are kept.  In both modes the ordering is constrained so that the
+   * oldest variables are eliminated first and stay at the leaves of the Bayes
+   * tree, where they can be removed with marginalizeLeaves().  Enabling a
+   * sliding window also enables findUnusedFactorSlots, so that the memory
+   * footprint stays bounded by the window size (default: NO_SLIDING_WINDOW).
+   */
+  enum SlidingWindowMode { NO_SLIDING_WINDOW, TIME_LAG, COUNT_LAG };
+  SlidingWindowMode slidingWindowMode;
+
+  double slidingWindowLag;  ///< Window length, in seconds with TIME_LAG or in
+                            ///< number of variables with COUNT_LAG
+
+  size_t slidingWindowBatchSize;  ///< Only marginalize once at least this many
+                                  ///< variables have left the window, to
+                                  ///< amortize the Bayes tree surgery over
+                                  ///< several updates (default: 1)
+
   /**
    * Specify parameters as constructor arguments
    * See the documentation of member variables above.
@@ -246,7 +267,10 @@ struct GTSAM_EXPORT ISAM2Params {
         keyFormatter(_keyFormatter),
         enableDetailedResults(_enableDetailedResults),
         enablePartialRelinearizationCheck(false),
-        findUnusedFactorSlots(false) {}
+        findUnusedFactorSlots(false),
+        slidingWindowMode(NO_SLIDING_WINDOW),
+        slidingWindowLag(0.0),
+        slidingWindowBatchSize(1) {}
 
   /// print iSAM2 parameters
   void print(const std::string& str = "") const {
@@ -288,6 +312,11 @@ struct GTSAM_EXPORT ISAM2Params {
          << enablePartialRelinearizationCheck << "\n";
     cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots
          << "\n";
+    cout << "slidingWindowMode:                 "
+         << slidingWindowModeTranslator(slidingWindowMode) << "\n";
+    cout << "slidingWindowLag:                  " << slidingWindowLag << "\n";
+    cout << "slidingWindowBatchSize:            " << slidingWindowBatchSize
+         << "\n";
     cout.flush();
   }
 
@@ -312,6 +341,14 @@ struct GTSAM_EXPORT ISAM2Params {
   bool isEnablePartialRelinearizationCheck() const {
     return enablePartialRelinearizationCheck;
   }
+  std::string getSlidingWindowMode() const {
+    return slidingWindowModeTranslator(slidingWindowMode);
+  }
+  double getSlidingWindowLag() const { return slidingWindowLag; }
+  size_t getSlidingWindowBatchSize() const { return slidingWindowBatchSize; }
+  bool isSlidingWindow() const {
+    return slidingWindowMode != NO_SLIDING_WINDOW;
+  }
 
   void setOptimizationParams(OptimizationParams optimizationParams) {
     this->optimizationParams = optimizationParams;
@@ -344,6 +381,15 @@ struct GTSAM_EXPORT ISAM2Params {
       bool enablePartialRelinearizationCheck) {
     this->enablePartialRelinearizationCheck = enablePartialRelinearizationCheck;
   }
+  void setSlidingWindowMode(const std::string& slidingWindowMode) {
+    this->slidingWindowMode = slidingWindowModeTranslator(slidingWindowMode);
+  }
+  void setSlidingWindowLag(double slidingWindowLag) {
+    this->slidingWindowLag = slidingWindowLag;
+  }
+  void setSlidingWindowBatchSize(size_t slidingWindowBatchSize) {
+    this->slidingWindowBatchSize = slidingWindowBatchSize;
+  }
 
   GaussianFactorGraph::Eliminate getEliminationFunction() const {
     return factorization == CHOLESKY
@@ -358,6 +404,9 @@ struct GTSAM_EXPORT ISAM2Params {
 
   static Factorization factorizationTranslator(const std::string& str);
   static std::string factorizationTranslator(const Factorization& value);
+  static SlidingWindowMode slidingWindowModeTranslator(const std::string& str);
+  static std::string slidingWindowModeTranslator(
+      const SlidingWindowMode& value);
 
   /// @}
 };
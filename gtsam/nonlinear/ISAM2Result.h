@@ -110,6 +110,10 @@ struct ISAM2Result {
   /** All keys that were marked during the update process. */
   KeySet markedKeys;
 
+  /** Keys of variables that left the sliding window and were marginalized out
+   * at the end of this update (see ISAM2Params::slidingWindowMode). */
+  KeyVector marginalizedKeys;
+
   /**
    * A struct holding detailed results, which must be enabled with
    * ISAM2Params::enableDetailedResults.
@@ -69,6 +69,12 @@ struct ISAM2UpdateParams {
    * the deltas become too small down in the tree. This flagg forces a full
    * solve instead. */
   bool forceFullSolve{false};
+
+  /** Timestamps of the new variables, used only when the sliding-window mode
+   * is enabled (see ISAM2Params::slidingWindowMode).  New variables without a
+   * timestamp are stamped with the most recent timestamp seen so far, or with
+   * the update count in COUNT_LAG mode. */
+  boost::optional<FastMap<Key, double>> newKeyTimestamps{boost::none};
 };
 
 }  // namespace gtsam
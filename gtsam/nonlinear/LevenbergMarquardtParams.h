@@ -22,6 +22,7 @@
 
 #include <gtsam/nonlinear/NonlinearOptimizerParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/inference/OrderingCache.h>
 
 namespace gtsam {
 
@@ -109,7 +110,7 @@ public:
   static LevenbergMarquardtParams EnsureHasOrdering(LevenbergMarquardtParams params,
                                                     const NonlinearFactorGraph& graph) {
     if (!params.ordering)
-      params.ordering = Ordering::Create(params.orderingType, graph);
+      params.ordering = OrderingCache::Create(params.orderingType, graph);
     return params;
   }
 
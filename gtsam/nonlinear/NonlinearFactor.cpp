@@ -17,6 +17,7 @@
  */
 
 #include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/linear/linearExceptions.h>
 #include <boost/make_shared.hpp>
 #include <boost/format.hpp>
 
@@ -137,30 +138,39 @@ boost::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
   if (!active(x))
     return boost::shared_ptr<JacobianFactor>();
 
-  // Call evaluate error to get Jacobians and RHS vector b
+  // Call evaluate error to get Jacobians and the error vector
   std::vector<Matrix> A(size());
-  Vector b = -unwhitenedError(x, A);
-  check(noiseModel_, b.size());
-
-  // Whiten the corresponding system now
-  if (noiseModel_)
-    noiseModel_->WhitenSystem(A, b);
+  const Vector e = unwhitenedError(x, A);
+  check(noiseModel_, e.size());
 
-  // Fill in terms, needed to create JacobianFactor below
-  std::vector<std::pair<Key, Matrix> > terms(size());
+  // A Jacobian that evaluateError did not set is caught here, as it has no rows
+  FastVector<DenseIndex> dims(size());
   for (size_t j = 0; j < size(); ++j) {
-    terms[j].first = keys()[j];
-    terms[j].second.swap(A[j]);
+    if (A[j].rows() != e.size())
+      throw InvalidMatrixBlock(e.size(), A[j].rows());
+    dims[j] = A[j].cols();
   }
 
   // TODO pass unwhitened + noise model to Gaussian factor
   using noiseModel::Constrained;
+  SharedDiagonal model;
   if (noiseModel_ && noiseModel_->isConstrained())
-    return GaussianFactor::shared_ptr(
-        new JacobianFactor(terms, b,
-            boost::static_pointer_cast<Constrained>(noiseModel_)->unit()));
-  else
-    return GaussianFactor::shared_ptr(new JacobianFactor(terms, b));
+    model = boost::static_pointer_cast<Constrained>(noiseModel_)->unit();
+
+  // Copy the system straight into the augmented matrix of the factor
+  boost::shared_ptr<JacobianFactor> factor(
+      new JacobianFactor(keys_, boost::make_iterator_range(dims.begin(),
+          dims.begin() + size()), e.size(), model));
+  VerticalBlockMatrix& Ab = factor->matrixObject();
+  for (size_t j = 0; j < size(); ++j)
+    Ab(j) = A[j];
+  Ab(size()).col(0) = -e;
+
+  // Whiten the corresponding system now, in place
+  if (noiseModel_)
+    noiseModel_->WhitenSystem(Ab);
+
+  return factor;
 }
 
 /* ************************************************************************* */
@@ -248,6 +248,9 @@ public:
    * Linearize a non-linearFactorN to get a GaussianFactor,
    * \f$ Ax-b \approx h(x+\delta x)-z = h(x) + A \delta x - z \f$
    * Hence \f$ b = z - h(x) = - \mathtt{error\_vector}(x) \f$
+   *
+   * The Jacobians are copied straight into the augmented matrix of the
+   * JacobianFactor, which is then whitened in place.
    */
   boost::shared_ptr<GaussianFactor> linearize(const Values& x) const;
 
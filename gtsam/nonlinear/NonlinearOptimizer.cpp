@@ -151,7 +151,7 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
 
     if (boost::shared_ptr<PCGSolverParameters> pcg =
             boost::dynamic_pointer_cast<PCGSolverParameters>(params.iterativeParams)) {
-      delta = PCGSolver(*pcg).optimize(gfg);
+      delta = pcg->createSolver()->optimize(gfg);
     } else if (boost::shared_ptr<SubgraphSolverParameters> spcg =
                    boost::dynamic_pointer_cast<SubgraphSolverParameters>(params.iterativeParams)) {
       if (!params.ordering)
@@ -24,6 +24,7 @@
 
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/linear/VectorValues.h>
+#include <gtsam/geometry/Pose3.h>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -35,9 +36,11 @@
 #endif
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <sstream>
+#include <typeinfo>
 
 using namespace std;
 
@@ -52,19 +55,68 @@ namespace gtsam {
   Values::Values(Values&& other) : values_(std::move(other.values_)) {
   }
 
+  /* ************************************************************************* */
+  namespace {
+    /// Collects the values of type T to retract, and retracts them in a batch
+    template<class T>
+    class BatchRetract {
+      KeyVector keys_;
+      std::vector<const T*> values_;
+      Matrix deltas_;
+      size_t size_;
+
+    public:
+      BatchRetract() : size_(0) {}
+
+      /// Add value if it is of type T, returns false otherwise
+      bool add(Key key, const Value& value, const Vector& delta) {
+        if (typeid(value) != typeid(GenericValue<T>)
+            || delta.size() != traits<T>::dimension)
+          return false;
+        if (size_ == keys_.size()) {
+          keys_.resize(std::max<size_t>(8, 2 * size_));
+          values_.resize(keys_.size());
+          deltas_.conservativeResize(traits<T>::dimension, keys_.size());
+        }
+        keys_[size_] = key;
+        values_[size_] = &static_cast<const GenericValue<T>&>(value).value();
+        deltas_.col(size_++) = delta;
+        return true;
+      }
+
+      /// Retract all, and insert the results into values
+      template<class MAP>
+      void retract(MAP& values) {
+        if (size_ == 0)
+          return;
+        std::vector<T> local;
+        T::RetractBatch(deltas_.leftCols(size_), local);
+        for (size_t i = 0; i < size_; ++i)
+          values.insert(keys_[i], new GenericValue<T>(*values_[i] * local[i]));
+      }
+    };
+  }
+
   /* ************************************************************************* */
   Values::Values(const Values& other, const VectorValues& delta) {
+    // Rot3 and Pose3 values are retracted in batches, see Pose3::RetractBatch
+    BatchRetract<Rot3> rotations;
+    BatchRetract<Pose3> poses;
     for (const_iterator key_value = other.begin(); key_value != other.end(); ++key_value) {
       VectorValues::const_iterator it = delta.find(key_value->key);
       Key key = key_value->key;  // Non-const duplicate to deal with non-const insert argument
       if (it != delta.end()) {
         const Vector& v = it->second;
+        if (rotations.add(key, key_value->value, v) || poses.add(key, key_value->value, v))
+          continue;
         Value* retractedValue(key_value->value.retract_(v));  // Retract
         values_.insert(key, retractedValue);  // Add retracted result directly to result values
       } else {
         values_.insert(key, key_value->value.clone_());  // Add original version to result values
       }
     }
+    rotations.retract(values_);
+    poses.retract(values_);
   }
 
   /* ************************************************************************* */
@@ -21,11 +21,14 @@
 
 #include <gtsam/nonlinear/internal/ExecutionTrace.h>
 #include <gtsam/nonlinear/internal/CallRecord.h>
+#include <gtsam/nonlinear/internal/ExpressionTape.h>
 #include <gtsam/nonlinear/Values.h>
 
 #include <typeinfo>       // operator typeid
+#include <type_traits>
 #include <ostream>
 #include <map>
+#include <string>
 
 class ExpressionFactorBinaryTest;
 // Forward declare for testing
@@ -51,6 +54,46 @@ T upAligned(T value, unsigned requiredAlignment = TraceAlignment) {
   return upAlign(value, requiredAlignment);
 }
 
+/// Append the name of a type to s, see ExpressionNode::structure
+inline void AppendType(std::string& s, const std::type_info& type) {
+  s += type.name();
+  s += '\0';
+}
+
+/**
+ * Append the type and the raw bytes of x to s, see ExpressionNode::structure.
+ * Only for trivially copyable types, for which equal bytes mean equal values.
+ */
+template<class X>
+void AppendBytes(std::string& s, const X& x) {
+  static_assert(std::is_trivially_copyable<X>::value,
+      "AppendBytes needs a trivially copyable type");
+  AppendType(s, typeid(X));
+  s.append(reinterpret_cast<const char*>(&x), sizeof(X));
+}
+
+/// Append a double to s, with -0.0 and 0.0 giving the same bytes
+inline void AppendBytes(std::string& s, double x) {
+  const double normalized = (x == 0.0) ? 0.0 : x;
+  AppendType(s, typeid(double));
+  s.append(reinterpret_cast<const char*>(&normalized), sizeof(double));
+}
+
+/// The structure of a function or method pointer
+template<class P>
+std::string PointerStructure(const P& pointer) {
+  std::string s;
+  AppendBytes(s, pointer);
+  return s;
+}
+
+/// The structure of a function object if it holds a function pointer P, else empty
+template<class P, class F>
+std::string FunctionStructure(const F& f) {
+  const P* pointer = f.template target<P>();
+  return pointer ? PointerStructure(*pointer) : std::string();
+}
+
 //-----------------------------------------------------------------------------
 
 /**
@@ -111,6 +154,26 @@ public:
   /// Construct an execution trace for reverse AD
   virtual T traceExecution(const Values& values, ExecutionTrace<T>& trace,
       ExecutionTraceStorage* traceStorage) const = 0;
+
+  /**
+   * Compile the expression rooted here into an ExpressionTape, setting index
+   * to the instruction that evaluates this node.
+   * Returns false if this type of node cannot be compiled.
+   */
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    return false;
+  }
+
+  /**
+   * Append the structure of the expression rooted here to s: the type of every
+   * node, its function, and its constants and keys.  Expressions with the same
+   * structure have the same value, which ExpressionTape uses to share them.
+   * Returns false if the structure is not known, e.g., for a function object
+   * that is not a plain function or method pointer.
+   */
+  virtual bool structure(std::string& s) const {
+    return false;
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -150,6 +213,48 @@ public:
     return constant_;
   }
 
+  /// Compile into an ExpressionTape: just point to the constant
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    if (!ExpressionTape::Fixed<T>())
+      return false;
+    ExpressionTape::Instruction instruction =
+        tape.instruction(this, traits<T>::dimension);
+    instruction.forward = &Forward;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    ExpressionTape::Slot<const T*>(buffer, instruction.value) =
+        &static_cast<const ConstantExpression*>(instruction.node)->constant_;
+  }
+
+  /**
+   * Structure: the bytes of the constant if it is trivially copyable, else
+   * the address of this node, so only the same constant node matches.
+   */
+  virtual bool structure(std::string& s) const {
+    if (!ExpressionTape::Fixed<T>())
+      return false;
+    AppendType(s, typeid(*this));
+    appendConstant(s, std::is_trivially_copyable<T>());
+    return true;
+  }
+
+private:
+  void appendConstant(std::string& s, std::true_type) const {
+    AppendBytes(s, constant_);
+  }
+
+  void appendConstant(std::string& s, std::false_type) const {
+    AppendBytes(s, static_cast<const void*>(this));
+  }
+
+public:
+
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
@@ -204,6 +309,41 @@ public:
     return values.at<T>(key_);
   }
 
+  /// Compile into an ExpressionTape: the adjoint is added to the Jacobian block of the key
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    const DenseIndex block = tape.block(key_);
+    if (!ExpressionTape::Fixed<T>() || block < 0)
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    instruction.share = 0;  // reading a leaf is as cheap as sharing it
+    instruction.block = block;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    const LeafExpression& node =
+        *static_cast<const LeafExpression*>(instruction.node);
+    ExpressionTape::Store(instruction, buffer, values.at<T>(node.key_));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    Ab(instruction.block) += ExpressionTape::Adjoint<traits<T>::dimension>(
+        buffer, instruction.adjoint, rows);
+  }
+
+  /// Structure: the key
+  virtual bool structure(std::string& s) const {
+    AppendType(s, typeid(*this));
+    AppendBytes(s, key_);
+    return true;
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -230,12 +370,17 @@ template<class T, class A1>
 class UnaryExpression: public ExpressionNode<T> {
 
   typedef typename Expression<T>::template UnaryFunction<A1>::type Function;
+  typedef T (*Pointer)(const A1&, typename MakeOptionalJacobian<T, A1>::type);
   boost::shared_ptr<ExpressionNode<A1> > expression1_;
   Function function_;
+  std::string functionStructure_;  ///< Identifies the function, or empty
 
   /// Constructor with a unary function f, and input argument e1
-  UnaryExpression(Function f, const Expression<A1>& e1) :
-      expression1_(e1.root()), function_(f) {
+  UnaryExpression(Function f, const Expression<A1>& e1,
+      const std::string& functionStructure = std::string()) :
+      expression1_(e1.root()), function_(f), functionStructure_(
+          functionStructure.empty() ?
+              FunctionStructure<Pointer>(f) : functionStructure) {
     this->traceSize_ = upAligned(sizeof(Record)) + e1.traceSize();
   }
 
@@ -327,6 +472,46 @@ public:
     // Finally, the function call fills in the Jacobian dTdA1
     return function_(record->value1, record->dTdA1);
   }
+
+  /// Compile into an ExpressionTape, after the argument
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    size_t index1;
+    if (!ExpressionTape::Fixed<T>() || !ExpressionTape::Fixed<A1>()
+        || !expression1_->compile(tape, &index1))
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    tape.setArgument<T, A1>(instruction, 0, index1);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    const UnaryExpression& node =
+        *static_cast<const UnaryExpression*>(instruction.node);
+    ExpressionTape::Store(instruction, buffer, node.function_(
+        ExpressionTape::Value<A1>(buffer, instruction.argValue[0]),
+        ExpressionTape::Slot<typename Jacobian<T, A1>::type>(buffer,
+            instruction.jacobians[0])));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    ExpressionTape::ReverseThrough<T, A1>(instruction, 0, rows, buffer);
+  }
+
+  /// Structure: the function and the argument
+  virtual bool structure(std::string& s) const {
+    if (functionStructure_.empty())
+      return false;
+    AppendType(s, typeid(*this));
+    s += functionStructure_;
+    return expression1_->structure(s);
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -335,14 +520,21 @@ template<class T, class A1, class A2>
 class BinaryExpression: public ExpressionNode<T> {
 
   typedef typename Expression<T>::template BinaryFunction<A1, A2>::type Function;
+  typedef T (*Pointer)(const A1&, const A2&,
+      typename MakeOptionalJacobian<T, A1>::type,
+      typename MakeOptionalJacobian<T, A2>::type);
   boost::shared_ptr<ExpressionNode<A1> > expression1_;
   boost::shared_ptr<ExpressionNode<A2> > expression2_;
   Function function_;
+  std::string functionStructure_;  ///< Identifies the function, or empty
 
   /// Constructor with a binary function f, and two input arguments
   BinaryExpression(Function f, const Expression<A1>& e1,
-      const Expression<A2>& e2) :
-      expression1_(e1.root()), expression2_(e2.root()), function_(f) {
+      const Expression<A2>& e2,
+      const std::string& functionStructure = std::string()) :
+      expression1_(e1.root()), expression2_(e2.root()), function_(f),
+      functionStructure_(functionStructure.empty() ?
+          FunctionStructure<Pointer>(f) : functionStructure) {
     this->traceSize_ = //
         upAligned(sizeof(Record)) + e1.traceSize() + e2.traceSize();
   }
@@ -433,6 +625,53 @@ public:
     trace.setFunction(record);
     return function_(record->value1, record->value2, record->dTdA1, record->dTdA2);
   }
+
+  /// Compile into an ExpressionTape, after the arguments
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    size_t index1, index2;
+    if (!ExpressionTape::Fixed<T>() || !ExpressionTape::Fixed<A1>()
+        || !ExpressionTape::Fixed<A2>()
+        || !expression1_->compile(tape, &index1)
+        || !expression2_->compile(tape, &index2))
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    tape.setArgument<T, A1>(instruction, 0, index1);
+    tape.setArgument<T, A2>(instruction, 1, index2);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    const BinaryExpression& node =
+        *static_cast<const BinaryExpression*>(instruction.node);
+    ExpressionTape::Store(instruction, buffer, node.function_(
+        ExpressionTape::Value<A1>(buffer, instruction.argValue[0]),
+        ExpressionTape::Value<A2>(buffer, instruction.argValue[1]),
+        ExpressionTape::Slot<typename Jacobian<T, A1>::type>(buffer,
+            instruction.jacobians[0]),
+        ExpressionTape::Slot<typename Jacobian<T, A2>::type>(buffer,
+            instruction.jacobians[1])));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    ExpressionTape::ReverseThrough<T, A1>(instruction, 0, rows, buffer);
+    ExpressionTape::ReverseThrough<T, A2>(instruction, 1, rows, buffer);
+  }
+
+  /// Structure: the function and the arguments
+  virtual bool structure(std::string& s) const {
+    if (functionStructure_.empty())
+      return false;
+    AppendType(s, typeid(*this));
+    s += functionStructure_;
+    return expression1_->structure(s) && expression2_->structure(s);
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -441,16 +680,23 @@ template<class T, class A1, class A2, class A3>
 class TernaryExpression: public ExpressionNode<T> {
 
   typedef typename Expression<T>::template TernaryFunction<A1, A2, A3>::type Function;
+  typedef T (*Pointer)(const A1&, const A2&, const A3&,
+      typename MakeOptionalJacobian<T, A1>::type,
+      typename MakeOptionalJacobian<T, A2>::type,
+      typename MakeOptionalJacobian<T, A3>::type);
   boost::shared_ptr<ExpressionNode<A1> > expression1_;
   boost::shared_ptr<ExpressionNode<A2> > expression2_;
   boost::shared_ptr<ExpressionNode<A3> > expression3_;
   Function function_;
+  std::string functionStructure_;  ///< Identifies the function, or empty
 
   /// Constructor with a ternary function f, and two input arguments
   TernaryExpression(Function f, const Expression<A1>& e1,
-      const Expression<A2>& e2, const Expression<A3>& e3) :
+      const Expression<A2>& e2, const Expression<A3>& e3,
+      const std::string& functionStructure = std::string()) :
       expression1_(e1.root()), expression2_(e2.root()), expression3_(e3.root()), //
-      function_(f) {
+      function_(f), functionStructure_(functionStructure.empty() ?
+          FunctionStructure<Pointer>(f) : functionStructure) {
     this->traceSize_ = upAligned(sizeof(Record)) + //
         e1.traceSize() + e2.traceSize() + e3.traceSize();
   }
@@ -552,6 +798,60 @@ public:
     return function_(record->value1, record->value2, record->value3,
                      record->dTdA1, record->dTdA2, record->dTdA3);
   }
+
+  /// Compile into an ExpressionTape, after the arguments
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    size_t index1, index2, index3;
+    if (!ExpressionTape::Fixed<T>() || !ExpressionTape::Fixed<A1>()
+        || !ExpressionTape::Fixed<A2>() || !ExpressionTape::Fixed<A3>()
+        || !expression1_->compile(tape, &index1)
+        || !expression2_->compile(tape, &index2)
+        || !expression3_->compile(tape, &index3))
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    tape.setArgument<T, A1>(instruction, 0, index1);
+    tape.setArgument<T, A2>(instruction, 1, index2);
+    tape.setArgument<T, A3>(instruction, 2, index3);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    const TernaryExpression& node =
+        *static_cast<const TernaryExpression*>(instruction.node);
+    ExpressionTape::Store(instruction, buffer, node.function_(
+        ExpressionTape::Value<A1>(buffer, instruction.argValue[0]),
+        ExpressionTape::Value<A2>(buffer, instruction.argValue[1]),
+        ExpressionTape::Value<A3>(buffer, instruction.argValue[2]),
+        ExpressionTape::Slot<typename Jacobian<T, A1>::type>(buffer,
+            instruction.jacobians[0]),
+        ExpressionTape::Slot<typename Jacobian<T, A2>::type>(buffer,
+            instruction.jacobians[1]),
+        ExpressionTape::Slot<typename Jacobian<T, A3>::type>(buffer,
+            instruction.jacobians[2])));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    ExpressionTape::ReverseThrough<T, A1>(instruction, 0, rows, buffer);
+    ExpressionTape::ReverseThrough<T, A2>(instruction, 1, rows, buffer);
+    ExpressionTape::ReverseThrough<T, A3>(instruction, 2, rows, buffer);
+  }
+
+  /// Structure: the function and the arguments
+  virtual bool structure(std::string& s) const {
+    if (functionStructure_.empty())
+      return false;
+    AppendType(s, typeid(*this));
+    s += functionStructure_;
+    return expression1_->structure(s) && expression2_->structure(s)
+        && expression3_->structure(s);
+  }
 };
 
 //-----------------------------------------------------------------------------
@@ -635,6 +935,45 @@ class ScalarMultiplyNode : public ExpressionNode<T> {
     record->scalar_dTdA = scalar_;
     return scalar_ * value;
   }
+
+  /// Compile into an ExpressionTape, after the argument
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    size_t index1;
+    if (!ExpressionTape::Fixed<T>() || !expression_->compile(tape, &index1))
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    tape.setArgument(instruction, 0, index1);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    const ScalarMultiplyNode& node =
+        *static_cast<const ScalarMultiplyNode*>(instruction.node);
+    ExpressionTape::Store<T>(instruction, buffer,
+        node.scalar_ * ExpressionTape::Value<T>(buffer, instruction.argValue[0]));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    const ScalarMultiplyNode& node =
+        *static_cast<const ScalarMultiplyNode*>(instruction.node);
+    static const int Dim = traits<T>::dimension;
+    ExpressionTape::Adjoint<Dim>(buffer, instruction.argAdjoint[0], rows) +=
+        node.scalar_ * ExpressionTape::Adjoint<Dim>(buffer, instruction.adjoint, rows);
+  }
+
+  /// Structure: the scalar and the argument
+  virtual bool structure(std::string& s) const {
+    AppendType(s, typeid(*this));
+    AppendBytes(s, scalar_);
+    return expression_->structure(s);
+  }
 };
 
 
@@ -728,6 +1067,46 @@ class BinarySumNode : public ExpressionNode<T> {
     return expression1_->traceExecution(values, record->trace1, ptr1) +
            expression2_->traceExecution(values, record->trace2, ptr2);
   }
+
+  /// Compile into an ExpressionTape, after the terms
+  virtual bool compile(ExpressionTape& tape, size_t* index) const {
+    if (tape.find(this, index))
+      return true;
+    size_t index1, index2;
+    if (!ExpressionTape::Fixed<T>() || !expression1_ || !expression2_
+        || !expression1_->compile(tape, &index1)
+        || !expression2_->compile(tape, &index2))
+      return false;
+    ExpressionTape::Instruction instruction = tape.function<T>(this);
+    tape.setArgument(instruction, 0, index1);
+    tape.setArgument(instruction, 1, index2);
+    instruction.forward = &Forward;
+    instruction.reverse = &Reverse;
+    *index = tape.add(instruction);
+    return true;
+  }
+
+  static void Forward(const ExpressionTape::Instruction& instruction,
+      const Values& values, char* buffer) {
+    ExpressionTape::Store<T>(instruction, buffer,
+        ExpressionTape::Value<T>(buffer, instruction.argValue[0])
+            + ExpressionTape::Value<T>(buffer, instruction.argValue[1]));
+  }
+
+  static void Reverse(const ExpressionTape::Instruction& instruction,
+      DenseIndex rows, char* buffer, VerticalBlockMatrix& Ab) {
+    static const int Dim = traits<T>::dimension;
+    const Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Dim> > dFdT =
+        ExpressionTape::Adjoint<Dim>(buffer, instruction.adjoint, rows);
+    ExpressionTape::Adjoint<Dim>(buffer, instruction.argAdjoint[0], rows) += dFdT;
+    ExpressionTape::Adjoint<Dim>(buffer, instruction.argAdjoint[1], rows) += dFdT;
+  }
+
+  /// Structure: the arguments
+  virtual bool structure(std::string& s) const {
+    AppendType(s, typeid(*this));
+    return expression1_->structure(s) && expression2_->structure(s);
+  }
 };
 
 }  // namespace internal
@@ -0,0 +1,534 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ExpressionTape.h
+ * @author agent
+ * @brief Expressions compiled into a flat list of instructions
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/internal/ExecutionTrace.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/base/VerticalBlockMatrix.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+namespace internal {
+
+template<class T> class ExpressionNode;
+class ExpressionTape;
+class SharedSubexpressions;
+
+/**
+ * A subexpression that several tapes share: it has its own tape, and its value
+ * and Jacobians are evaluated once, after which the tapes that use it read
+ * them as if it were a leaf, see SharedSubexpressions.
+ */
+struct SharedSubexpression {
+  boost::shared_ptr<ExpressionTape> tape;  ///< Tape of the subexpression itself
+  KeyVector keys;  ///< Keys of the subexpression, in the order of the blocks
+  int dim;  ///< Dimension of the value
+  VerticalBlockMatrix jacobians;  ///< Jacobians, one block per key
+  std::vector<ExecutionTraceStorage> storage;  ///< Storage for the value
+  const void* value;  ///< The value, once evaluated
+  void (*evaluate)(SharedSubexpression&, const Values&);
+  void (*destroy)(SharedSubexpression&);
+
+  SharedSubexpression() : dim(0), value(0), evaluate(0), destroy(0) {}
+  ~SharedSubexpression() {
+    if (value)
+      destroy(*this);
+  }
+
+ private:
+  SharedSubexpression(const SharedSubexpression&);
+  SharedSubexpression& operator=(const SharedSubexpression&);
+};
+
+/**
+ * An ExpressionTape is an expression tree compiled once into a flat list of
+ * instructions, one per distinct node, in the order in which they have to be
+ * evaluated.  Every instruction has fixed slots in a single buffer for its
+ * value, its local Jacobians and its adjoint (the derivative of the root with
+ * respect to the node), and leaves know the Jacobian block they write into.
+ * Executing the tape is then a forward loop over the instructions followed by
+ * a backward loop, without walking the tree, without virtual calls, and with
+ * the buffer on the stack.  Nodes shared by several parents are evaluated once.
+ *
+ * Compilation fails, and ExpressionFactor falls back to the tree, if a node
+ * does not implement ExpressionNode::compile or has a dynamic dimension.
+ */
+class ExpressionTape {
+ public:
+  /// One node of the expression
+  struct Instruction {
+    typedef void (*Forward)(const Instruction&, const Values&, char*);
+    typedef void (*Reverse)(const Instruction&, DenseIndex, char*,
+        VerticalBlockMatrix&);
+    typedef void (*Destroy)(const Instruction&, char*);
+    typedef boost::shared_ptr<SharedSubexpression> (*Share)(const void*,
+        const SharedSubexpressions&);
+    typedef std::string (*Signature)(const void*);
+
+    Forward forward;  ///< Compute the value and local Jacobians
+    Reverse reverse;  ///< Pass the adjoint on to the arguments, or null
+    Destroy destroy;  ///< Destroy the value if it was stored, or null
+    Share share;  ///< Create a SharedSubexpression for the node, or null
+    Signature signature;  ///< Identify the node for sharing, with share
+    const void* node;  ///< The ExpressionNode this instruction evaluates
+    size_t value;  ///< Offset of the pointer to the value
+    size_t storage;  ///< Offset of the stored value, for function nodes
+    size_t adjoint;  ///< Offset of the adjoint
+    size_t jacobians[3];  ///< Offsets of the local Jacobians
+    size_t argValue[3];  ///< Offsets of the pointers to the argument values
+    size_t argAdjoint[3];  ///< Offsets of the argument adjoints
+    DenseIndex block;  ///< For leaves, the Jacobian block to add the adjoint to
+  };
+
+ private:
+  KeyVector keys_;
+  DenseIndex rows_;  ///< Dimension of the root, i.e., rows of every adjoint
+  std::vector<Instruction> instructions_;
+  std::map<const void*, size_t> compiled_;  ///< Node to instruction, while compiling
+  size_t valuesSize_;  ///< Bytes used for values and local Jacobians
+  size_t adjointsSize_;  ///< Bytes used for adjoints, which follow the values
+
+  /// Subexpressions read from elsewhere, and where their Jacobians go
+  struct SharedUse {
+    const SharedSubexpression* shared;
+    FastVector<DenseIndex> blocks;
+  };
+  const SharedSubexpressions* shared_;  ///< While compiling
+  std::list<SharedUse> uses_;
+
+  ExpressionTape(const KeyVector& keys, DenseIndex rows,
+      const SharedSubexpressions* shared) :
+      keys_(keys), rows_(rows), valuesSize_(0), adjointsSize_(0),
+      shared_(shared) {
+  }
+
+  ExpressionTape(const ExpressionTape&);
+  ExpressionTape& operator=(const ExpressionTape&);
+
+  static size_t Aligned(size_t bytes) {
+    return (bytes + TraceAlignment - 1) / TraceAlignment * TraceAlignment;
+  }
+
+  // Move the adjoints behind the values, once all values are allocated
+  void finalize() {
+    for (Instruction& instruction : instructions_) {
+      instruction.adjoint += valuesSize_;
+      for (size_t k = 0; k < 3; ++k)
+        instruction.argAdjoint[k] += valuesSize_;
+    }
+    compiled_.clear();
+    shared_ = 0;
+  }
+
+  // Add an instruction that reads the shared subexpression with the given signature
+  bool addShared(const void* node, const std::string& signature, size_t* index);
+
+  // Read the value of a shared subexpression
+  static void ForwardShared(const Instruction& instruction, const Values&,
+      char* buffer) {
+    const SharedUse& use = *static_cast<const SharedUse*>(instruction.node);
+    Slot<const void*>(buffer, instruction.value) = use.shared->value;
+  }
+
+  // Multiply the adjoint with the Jacobians of a shared subexpression
+  static void ReverseShared(const Instruction& instruction, DenseIndex rows,
+      char* buffer, VerticalBlockMatrix& Ab) {
+    const SharedUse& use = *static_cast<const SharedUse*>(instruction.node);
+    const Eigen::Map<Matrix> dFdS(&Slot<double>(buffer, instruction.adjoint),
+        rows, use.shared->dim);
+    for (size_t k = 0; k < use.blocks.size(); ++k)
+      Ab(use.blocks[k]).noalias() += dFdS * use.shared->jacobians(k);
+  }
+
+  // Nodes with the same structure get the same signature, see
+  // ExpressionNode::structure, and other nodes one of their own
+  template<class T>
+  static std::string Signature(const void* node) {
+    std::string signature;
+    if (!static_cast<const ExpressionNode<T>*>(node)->structure(signature)) {
+      signature = "#";
+      signature.append(reinterpret_cast<const char*>(&node), sizeof(node));
+    }
+    return signature;
+  }
+
+  // Create a SharedSubexpression for a node of type T
+  template<class T>
+  static boost::shared_ptr<SharedSubexpression> Share(const void* node,
+      const SharedSubexpressions& shared) {
+    const ExpressionNode<T>& root = *static_cast<const ExpressionNode<T>*>(node);
+    boost::shared_ptr<SharedSubexpression> subexpression(
+        new SharedSubexpression());
+    const std::set<Key> keys = root.keys();
+    subexpression->keys.assign(keys.begin(), keys.end());
+    subexpression->tape = Compile(root, subexpression->keys, &shared);
+    if (!subexpression->tape)
+      return boost::shared_ptr<SharedSubexpression>();
+    std::map<Key, int> dims;
+    root.dims(dims);
+    FastVector<int> widths;
+    for (Key key : subexpression->keys)
+      widths.push_back(dims[key]);
+    subexpression->dim = traits<T>::dimension;
+    subexpression->jacobians = VerticalBlockMatrix(widths, traits<T>::dimension);
+    subexpression->storage.resize(Aligned(sizeof(T)) / TraceAlignment);
+    subexpression->evaluate = &EvaluateShared<T>;
+    subexpression->destroy = &DestroyShared<T>;
+    return subexpression;
+  }
+
+  template<class T>
+  static void EvaluateShared(SharedSubexpression& subexpression,
+      const Values& values) {
+    if (subexpression.value)
+      DestroyShared<T>(subexpression);
+    subexpression.jacobians.matrix().setZero();
+    subexpression.value = new (subexpression.storage.data()) T(
+        subexpression.tape->execute<T>(values, subexpression.jacobians));
+  }
+
+  template<class T>
+  static void DestroyShared(SharedSubexpression& subexpression) {
+    static_cast<const T*>(subexpression.value)->~T();
+    subexpression.value = 0;
+  }
+
+ public:
+  /**
+   * Compile the expression rooted at root, returns null if that is not possible.
+   * Nodes in shared, if given, are not compiled but read from there.
+   */
+  template<class T>
+  static boost::shared_ptr<ExpressionTape> Compile(
+      const ExpressionNode<T>& root, const KeyVector& keys,
+      const SharedSubexpressions* shared = 0) {
+    boost::shared_ptr<ExpressionTape> tape;
+    if (traits<T>::dimension == Eigen::Dynamic)
+      return tape;
+    tape.reset(new ExpressionTape(keys, traits<T>::dimension, shared));
+    size_t index;
+    if (!root.compile(*tape, &index))
+      return boost::shared_ptr<ExpressionTape>();
+    tape->finalize();
+    return tape;
+  }
+
+  /// @name Compilation, used by ExpressionNode::compile
+  /// @{
+
+  /**
+   * If the node was compiled already, or is shared, set its instruction index.
+   * Returns false if the node still has to be compiled.
+   */
+  template<class T>
+  bool find(const ExpressionNode<T>* node, size_t* index) {
+    const std::map<const void*, size_t>::const_iterator it = compiled_.find(node);
+    if (it == compiled_.end())
+      return shared_ && addShared(node, Signature<T>(node), index);
+    *index = it->second;
+    return true;
+  }
+
+  /// Start an instruction for a node of dimension dim, with its value pointer and adjoint
+  Instruction instruction(const void* node, int dim) {
+    Instruction instruction;
+    std::memset(&instruction, 0, sizeof(Instruction));
+    instruction.node = node;
+    instruction.value = allocate(sizeof(const void*));
+    instruction.adjoint = adjointsSize_;
+    adjointsSize_ += Aligned(sizeof(double) * rows_ * dim);
+    return instruction;
+  }
+
+  /// Start an instruction for a function node, whose value is stored in the buffer
+  template<class T>
+  Instruction function(const void* node) {
+    Instruction instruction = this->instruction(node, traits<T>::dimension);
+    instruction.storage = allocate(sizeof(T));
+    instruction.destroy = &DestroyValue<T>;
+    instruction.share = &Share<T>;
+    instruction.signature = &Signature<T>;
+    return instruction;
+  }
+
+  /// Whether T has a fixed dimension, required for all nodes
+  template<class T>
+  static bool Fixed() {
+    return traits<T>::dimension != Eigen::Dynamic;
+  }
+
+  /// Allocate aligned space for the value of a node, or a local Jacobian
+  size_t allocate(size_t bytes) {
+    const size_t offset = valuesSize_;
+    valuesSize_ += Aligned(bytes);
+    return offset;
+  }
+
+  /// Make the instruction with the given index the k-th argument of an instruction
+  void setArgument(Instruction& instruction, size_t k, size_t index) const {
+    instruction.argValue[k] = instructions_[index].value;
+    instruction.argAdjoint[k] = instructions_[index].adjoint;
+  }
+
+  /// Same, also allocating the k-th local Jacobian dT/dA of the instruction
+  template<class T, class A>
+  void setArgument(Instruction& instruction, size_t k, size_t index) {
+    typedef Eigen::Matrix<double, traits<T>::dimension, traits<A>::dimension> JacobianTA;
+    instruction.jacobians[k] = allocate(sizeof(JacobianTA));
+    setArgument(instruction, k, index);
+  }
+
+  /// The Jacobian block of a key, or -1 if the key is not known
+  DenseIndex block(Key key) const {
+    const KeyVector::const_iterator it = std::find(keys_.begin(), keys_.end(),
+        key);
+    return it == keys_.end() ? -1 : it - keys_.begin();
+  }
+
+  /// Append the instruction of a node, and return its index
+  size_t add(const Instruction& instruction) {
+    return add(instruction, instruction.node);
+  }
+
+  /// Append an instruction that evaluates node
+  size_t add(const Instruction& instruction, const void* node) {
+    instructions_.push_back(instruction);
+    compiled_[node] = instructions_.size() - 1;
+    return instructions_.size() - 1;
+  }
+
+  /// @}
+  /// @name Execution, used by the instructions
+  /// @{
+
+  /// Typed access to a slot in the buffer
+  template<class X>
+  static X& Slot(char* buffer, size_t offset) {
+    return *reinterpret_cast<X*>(buffer + offset);
+  }
+
+  /// The value an instruction points to
+  template<class X>
+  static const X& Value(char* buffer, size_t offset) {
+    return *Slot<const X*>(buffer, offset);
+  }
+
+  /// Adjoint of a node of dimension Cols
+  template<int Cols>
+  static Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Cols> > Adjoint(
+      char* buffer, size_t offset, DenseIndex rows) {
+    return Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Cols> >(
+        &Slot<double>(buffer, offset), rows, Cols);
+  }
+
+  /// Store the value of an instruction and point to it
+  template<class T>
+  static void Store(const Instruction& instruction, char* buffer,
+      const T& value) {
+    Slot<const T*>(buffer, instruction.value) =
+        new (buffer + instruction.storage) T(value);
+  }
+
+  /// Destroy a value stored with Store
+  template<class T>
+  static void DestroyValue(const Instruction& instruction, char* buffer) {
+    Slot<T>(buffer, instruction.storage).~T();
+  }
+
+  /// Given dF/dT, multiply in the k-th local Jacobian dT/dA and add to dF/dA
+  template<class T, class A>
+  static void ReverseThrough(const Instruction& instruction, size_t k,
+      DenseIndex rows, char* buffer) {
+    typedef Eigen::Matrix<double, traits<T>::dimension, traits<A>::dimension> JacobianTA;
+    Adjoint<traits<A>::dimension>(buffer, instruction.argAdjoint[k], rows).noalias() +=
+        Adjoint<traits<T>::dimension>(buffer, instruction.adjoint, rows)
+            * Slot<JacobianTA>(buffer, instruction.jacobians[k]);
+  }
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// Number of instructions
+  size_t size() const { return instructions_.size(); }
+
+  /// The i-th instruction
+  const Instruction& operator[](size_t i) const { return instructions_[i]; }
+
+  /// Number of shared subexpressions the tape reads
+  size_t nrShared() const { return uses_.size(); }
+
+  /// Size of the buffer needed to execute the tape, in bytes
+  size_t bufferSize() const { return valuesSize_ + adjointsSize_; }
+
+  /**
+   * Evaluate the expression, adding its Jacobians to the blocks of Ab, which
+   * correspond to the keys the tape was compiled with.
+   */
+  template<class T>
+  T execute(const Values& values, VerticalBlockMatrix& Ab) const {
+    // Same as in Expression::valueAndJacobianMap, see there
+#ifdef _MSC_VER
+    auto storage = static_cast<ExecutionTraceStorage*>(
+        _aligned_malloc(bufferSize(), TraceAlignment));
+#else
+    ExecutionTraceStorage storage[bufferSize() / TraceAlignment];
+#endif
+    char* buffer = reinterpret_cast<char*>(storage);
+
+    // Forward pass, destroying the values computed so far if a function throws
+    size_t i = 0;
+    try {
+      for (; i < instructions_.size(); ++i)
+        instructions_[i].forward(instructions_[i], values, buffer);
+    } catch (...) {
+      destroy(buffer, i);
+#ifdef _MSC_VER
+      _aligned_free(storage);
+#endif
+      throw;
+    }
+    const Instruction& root = instructions_.back();
+    const T value = Value<T>(buffer, root.value);
+
+    // Reverse pass, starting from the identity at the root
+    std::memset(buffer + valuesSize_, 0, adjointsSize_);
+    Eigen::Map<Matrix>(&Slot<double>(buffer, root.adjoint), rows_, rows_).setIdentity();
+    for (size_t j = instructions_.size(); j-- > 0;) {
+      if (instructions_[j].reverse)
+        instructions_[j].reverse(instructions_[j], rows_, buffer, Ab);
+    }
+
+    destroy(buffer, instructions_.size());
+#ifdef _MSC_VER
+    _aligned_free(storage);
+#endif
+    return value;
+  }
+
+  /// @}
+
+ private:
+  // Destroy the values stored by the first n instructions
+  void destroy(char* buffer, size_t n) const {
+    for (size_t i = 0; i < n; ++i)
+      if (instructions_[i].destroy)
+        instructions_[i].destroy(instructions_[i], buffer);
+  }
+};
+
+/**
+ * The subexpressions that several ExpressionTapes have in common, i.e., the
+ * function nodes, other than leaves and constants, that appear in more than one
+ * tape.  Tapes compiled against a SharedSubexpressions read those nodes from
+ * it instead of evaluating them, after evaluate() was called for the values.
+ *
+ * Nodes are shared when they have the same structure, i.e., the same types,
+ * functions, constants and keys, see ExpressionNode::structure.  That includes
+ * the same Expression (e.g., the pose of a camera composed with a fixed
+ * calibration) used to build several factors, as well as the same expression
+ * built anew for each factor.  Nodes whose structure is not known, because they
+ * use a function object, are only shared when they are the same object.
+ * Nested shared subexpressions are evaluated in dependency order.
+ */
+class SharedSubexpressions {
+  typedef std::map<std::string, boost::shared_ptr<SharedSubexpression> > Map;
+  Map map_;
+  std::vector<SharedSubexpression*> order_;  ///< Children before parents
+
+ public:
+  /// Find the nodes shared by the given tapes, which may contain nulls
+  explicit SharedSubexpressions(const std::vector<const ExpressionTape*>& tapes) {
+    // Count how often each signature appears.  The order of first
+    // appearance has children before their parents.
+    typedef std::pair<std::string, const ExpressionTape::Instruction*> Candidate;
+    std::map<std::string, size_t> counts;
+    std::vector<Candidate> candidates;
+    for (const ExpressionTape* tape : tapes) {
+      if (!tape)
+        continue;
+      for (size_t i = 0; i < tape->size(); ++i) {
+        const ExpressionTape::Instruction& instruction = (*tape)[i];
+        if (!instruction.share)
+          continue;
+        std::string signature = instruction.signature(instruction.node);
+        if (counts[signature]++ == 0)
+          candidates.push_back(Candidate(std::move(signature), &instruction));
+      }
+    }
+    for (const Candidate& candidate : candidates) {
+      if (counts[candidate.first] < 2)
+        continue;
+      const ExpressionTape::Instruction& instruction = *candidate.second;
+      boost::shared_ptr<SharedSubexpression> subexpression =
+          instruction.share(instruction.node, *this);
+      if (subexpression) {
+        map_[candidate.first] = subexpression;
+        order_.push_back(subexpression.get());
+      }
+    }
+  }
+
+  /// Number of shared subexpressions
+  size_t size() const { return order_.size(); }
+
+  /// The shared subexpression for a node signature, or null
+  const SharedSubexpression* find(const std::string& signature) const {
+    const Map::const_iterator it = map_.find(signature);
+    return it == map_.end() ? 0 : it->second.get();
+  }
+
+  /// Evaluate all shared subexpressions, before executing the tapes that use them
+  void evaluate(const Values& values) {
+    for (SharedSubexpression* subexpression : order_)
+      subexpression->evaluate(*subexpression, values);
+  }
+};
+
+/* ************************************************************************* */
+inline bool ExpressionTape::addShared(const void* node,
+    const std::string& signature, size_t* index) {
+  const SharedSubexpression* subexpression = shared_->find(signature);
+  if (!subexpression)
+    return false;
+  SharedUse use;
+  use.shared = subexpression;
+  for (Key key : subexpression->keys) {
+    use.blocks.push_back(block(key));
+    if (use.blocks.back() < 0)
+      return false;
+  }
+  uses_.push_back(use);
+  Instruction instruction = this->instruction(&uses_.back(), subexpression->dim);
+  instruction.forward = &ForwardShared;
+  instruction.reverse = &ReverseShared;
+  *index = add(instruction, node);
+  return true;
+}
+
+}  // namespace internal
+}  // namespace gtsam
@@ -0,0 +1,236 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testExpressionTape.cpp
+ * @author agent
+ * @brief unit tests for compiled expressions
+ */
+
+#include <gtsam/nonlinear/expressions.h>
+#include <gtsam/nonlinear/ExpressionFactorGraph.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/geometry/Point3.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+typedef Expression<Point3> Point3_;
+typedef Expression<Pose3> Pose3_;
+typedef Expression<Rot3> Rot3_;
+
+/* ************************************************************************* */
+static Point2 uncalibrate(const Cal3_S2& K, const Point2& p,
+    OptionalJacobian<2, 5> Dcal, OptionalJacobian<2, 2> Dp) {
+  return K.uncalibrate(p, Dcal, Dp);
+}
+
+// Compile an expression for its sorted keys
+template<class T>
+static boost::shared_ptr<internal::ExpressionTape> compile(
+    const Expression<T>& expression) {
+  const set<Key> keys = expression.keys();
+  return internal::ExpressionTape::Compile(*expression.root(),
+      KeyVector(keys.begin(), keys.end()));
+}
+
+// Check that executing the tape gives the same value and Jacobians as the tree
+template<class T>
+static bool sameAsTree(const Expression<T>& expression, const Values& values) {
+  boost::shared_ptr<internal::ExpressionTape> tape = compile(expression);
+  if (!tape)
+    return false;
+  map<Key, int> dims;
+  expression.dims(dims);
+  FastVector<int> widths;
+  for (const auto& key_dim : dims)
+    widths.push_back(key_dim.second);
+  VerticalBlockMatrix Ab(widths, traits<T>::dimension);
+  Ab.matrix().setZero();
+
+  vector<Matrix> H(dims.size());
+  const T expected = expression.value(values, H);
+  const T actual = tape->execute<T>(values, Ab);
+  bool same = assert_equal(expected, actual);
+  for (size_t i = 0; i < H.size(); ++i)
+    same = assert_equal(H[i], Matrix(Ab(i)), 1e-9) && same;
+  return same;
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, Tree) {
+  // Binary(Leaf,Unary(Binary(Leaf,Leaf))), as in testExpression
+  Pose3_ x(1);
+  Point3_ p(2);
+  Expression<Cal3_S2> K(3);
+  Point3_ p_cam(x, &Pose3::transformTo, p);
+  Point2 (*f)(const Point3&, OptionalJacobian<2, 3>) = &PinholeBase::Project;
+  Expression<Point2> uv_hat(uncalibrate, K, Expression<Point2>(f, p_cam));
+
+  Values values;
+  values.insert(1, Pose3(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(0.5, 0.2, -1)));
+  values.insert(2, Point3(1.0, 2.0, 10.0));
+  values.insert(3, Cal3_S2(500, 500, 0, 320, 240));
+
+  EXPECT(sameAsTree(uv_hat, values));
+  EXPECT_LONGS_EQUAL(6, compile(uv_hat)->size());
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, SharedNodes) {
+  // R1 * R1 and a constant, the leaf is only compiled once
+  Rot3_ R1(1), R2(Rot3::Yaw(0.3));
+  Rot3_ product = (R1 * R1) * R2;
+  Values values;
+  values.insert(1, Rot3::RzRyRx(0.2, 0.1, -0.4));
+  EXPECT(sameAsTree(product, values));
+  EXPECT_LONGS_EQUAL(4, compile(product)->size());
+
+  // Sums and scalar multiples
+  const Point3_ p(7), q(8);
+  const Point3_ sum = 3.0 * p + q + 2.0 * p;
+  values.insert(7, Point3(1, 2, 3));
+  values.insert(8, Point3(-1, 0, 4));
+  EXPECT(sameAsTree(sum, values));
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, Fallback) {
+  // Dynamic dimensions cannot be compiled
+  const Expression<Vector> v(5);
+  EXPECT(!compile(v));
+
+  // Neither can keys that the tape does not know about
+  const Point3_ p(7);
+  EXPECT(!internal::ExpressionTape::Compile(*p.root(), KeyVector()));
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, ExpressionFactor) {
+  // A factor with a compiled expression linearizes like the tree
+  Pose3_ x(1);
+  Point3_ p(2);
+  const Point3 measured(0.1, 0.2, 3.0);
+  ExpressionFactor<Point3> factor(noiseModel::Isotropic::Sigma(3, 0.1),
+      measured, Point3_(x, &Pose3::transformTo, p));
+  Values values;
+  values.insert(1, Pose3(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(0.5, 0.2, -1)));
+  values.insert(2, Point3(1.0, 2.0, 10.0));
+
+  vector<Matrix> H(2);
+  Vector b = -factor.unwhitenedError(values, H);
+  factor.noiseModel()->WhitenSystem(H, b);
+  const JacobianFactor expected(1, H[0], 2, H[1], b);
+  EXPECT(assert_equal((const GaussianFactor&)expected, *factor.linearize(values), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, SharedSubexpressions) {
+  // The camera pose, composed from the body pose and a fixed body-to-camera
+  // offset, is used by all projection factors.
+  Pose3_ x(1);
+  const Pose3_ camera = x * Pose3_(Pose3(Rot3::Roll(-M_PI_2), Point3(0.1, 0, 0)));
+  const Expression<Cal3_S2> K(Cal3_S2(500, 500, 0, 320, 240));
+  Point2 (*f)(const Point3&, OptionalJacobian<2, 3>) = &PinholeBase::Project;
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(2, 1.0);
+
+  ExpressionFactorGraph graph;
+  Values values;
+  values.insert(1, Pose3(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(0.5, 0.2, -1)));
+  for (size_t j = 0; j < 3; ++j) {
+    const Point3_ p(10 + j);
+    const Expression<Point2> uv(uncalibrate, K,
+        Expression<Point2>(f, Point3_(camera, &Pose3::transformTo, p)));
+    graph.addExpressionFactor(uv, Point2(300 + 10 * j, 250), model);
+    values.insert(10 + j, Point3(1.0 * j, 8.0, 0.5));
+  }
+  graph.addExpressionFactor(x, Pose3(), noiseModel::Unit::Create(6));
+  graph.push_back(NonlinearFactor::shared_ptr());
+
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+  EXPECT_LONGS_EQUAL(1, graph.nrSharedSubexpressions());
+
+  // Shared subexpressions are evaluated anew for other values
+  values.update(1, Pose3(Rot3::Yaw(0.4), Point3(0.0, -0.3, 0.2)));
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+
+  // The analysis is redone when factors are added
+  graph.addExpressionFactor(Point3_(camera, &Pose3::transformFrom,
+      Point3_(Point3(1, 2, 3))), Point3(1, 1, 1),
+      noiseModel::Isotropic::Sigma(3, 0.5));
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+  EXPECT_LONGS_EQUAL(1, graph.nrSharedSubexpressions());
+}
+
+/* ************************************************************************* */
+TEST(ExpressionTape, StructurallyEqualSubexpressions) {
+  // Every factor builds the camera pose anew, from the same body pose, offset
+  // node and methods, so the poses have the same structure and are shared.
+  // A Pose3 constant is not trivially copyable, so it matches by node only.
+  const Pose3_ bodyTcamera(Pose3(Rot3::Roll(-M_PI_2), Point3(0.1, 0, 0)));
+  const Expression<Cal3_S2> K(Cal3_S2(500, 500, 0, 320, 240));
+  Point2 (*f)(const Point3&, OptionalJacobian<2, 3>) = &PinholeBase::Project;
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(2, 1.0);
+
+  ExpressionFactorGraph graph;
+  Values values;
+  values.insert(1, Pose3(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(0.5, 0.2, -1)));
+  for (size_t j = 0; j < 3; ++j) {
+    const Pose3_ camera = Pose3_(1) * bodyTcamera;
+    const Expression<Point2> uv(uncalibrate, K, Expression<Point2>(f,
+        Point3_(camera, &Pose3::transformTo, Point3_(10 + j))));
+    graph.addExpressionFactor(uv, Point2(300 + 10 * j, 250), model);
+    values.insert(10 + j, Point3(1.0 * j, 8.0, 0.5));
+  }
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+  EXPECT_LONGS_EQUAL(1, graph.nrSharedSubexpressions());
+
+  // A different offset, key or function makes a different structure, and so
+  // does an equal offset in a node of its own
+  const Pose3_ other = Pose3_(1) * Pose3_(Pose3(Rot3(), Point3(0.2, 0, 0)));
+  graph.addExpressionFactor(Point3_(other, &Pose3::transformTo, Point3_(10)),
+      Point3(), noiseModel::Unit::Create(3));
+  graph.addExpressionFactor(Point3_(Pose3_(2) * bodyTcamera,
+      &Pose3::transformTo, Point3_(10)), Point3(), noiseModel::Unit::Create(3));
+  graph.addExpressionFactor(Point3_(Pose3_(1) * Pose3_(Pose3(Rot3::Roll(-M_PI_2),
+      Point3(0.1, 0, 0))), &Pose3::transformTo, Point3_(10)), Point3(),
+      noiseModel::Unit::Create(3));
+  values.insert(2, Pose3());
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+  EXPECT_LONGS_EQUAL(1, graph.nrSharedSubexpressions());
+
+  // The same transformed landmark in two factors is shared as well
+  graph.addExpressionFactor(Point3_(Pose3_(1) * bodyTcamera,
+      &Pose3::transformFrom, Point3_(10)), Point3(), noiseModel::Unit::Create(3));
+  graph.addExpressionFactor(Point3_(Pose3_(1) * bodyTcamera,
+      &Pose3::transformFrom, Point3_(10)), Point3(1, 1, 1),
+      noiseModel::Unit::Create(3));
+  EXPECT(assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9));
+  EXPECT_LONGS_EQUAL(2, graph.nrSharedSubexpressions());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
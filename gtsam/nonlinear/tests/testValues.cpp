@@ -235,6 +235,40 @@ TEST(Values, retract_partial)
   CHECK(assert_equal(expected, Values(config0, delta)));
 }
 
+/* ************************************************************************* */
+TEST(Values, retract_batch)
+{
+  // Rot3 and Pose3 values are retracted in batches, the others one by one
+  Values config0;
+  VectorValues delta;
+  for (size_t i = 0; i < 20; ++i) {
+    config0.insert(Symbol('x', i), Pose3(Rot3::Ypr(0.1 * i, 0.2, -0.3),
+        Point3(1.0 * i, 2.0, 3.0)));
+    config0.insert(Symbol('r', i), Rot3::Rodrigues(0.3, -0.1 * i, 0.2));
+    config0.insert(Symbol('p', i), Point3(i, 0.0, 1.0));
+    if (i % 3 != 0) {
+      delta.insert(Symbol('x', i),
+          (Vector(6) << 0.1, -0.2, 0.01 * i, 1.0, 0.5, 0.0).finished());
+      delta.insert(Symbol('r', i), Vector3(0.0, 0.3, -0.01 * i));
+      delta.insert(Symbol('p', i), Vector3(1.0, 2.0, 3.0));
+    }
+  }
+
+  Values expected;
+  for (size_t i = 0; i < 20; ++i) {
+    const Symbol x('x', i), r('r', i), p('p', i);
+    const bool moved = delta.exists(x);
+    expected.insert(x, moved ? config0.at<Pose3>(x).retract(delta.at(x))
+        : config0.at<Pose3>(x));
+    expected.insert(r, moved ? config0.at<Rot3>(r).retract(delta.at(r))
+        : config0.at<Rot3>(r));
+    expected.insert(p, moved ? Point3(config0.at<Point3>(p) + delta.at(p))
+        : config0.at<Point3>(p));
+  }
+
+  CHECK(assert_equal(expected, config0.retract(delta)));
+}
+
 /* ************************************************************************* */
 TEST(Values, equals)
 {
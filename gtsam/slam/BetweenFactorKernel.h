@@ -0,0 +1,114 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ *  @file  BetweenFactorKernel.h
+ *  @brief Batched linearization of BetweenFactors
+ *  @author agent
+ **/
+#pragma once
+
+#include <gtsam/nonlinear/BatchLinearizer.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <Eigen/StdVector>
+#include <vector>
+
+namespace gtsam {
+
+  /**
+   * BatchLinearizer kernel for BetweenFactor<VALUE>.  It gathers the two
+   * variables of every active factor into contiguous arrays first, and then
+   * evaluates the errors one factor at a time with fixed-size Jacobians,
+   * written straight into preallocated JacobianFactors that are whitened in
+   * place.  The loop is not vectorized across factors.  Register it with
+   * \code
+   * linearizer.add<BetweenFactor<Pose3> >(
+   *     boost::make_shared<BetweenFactorKernel<Pose3> >());
+   * \endcode
+   * @tparam VALUE the Value type
+   * @addtogroup SLAM
+   */
+  template<class VALUE>
+  class BetweenFactorKernel: public BatchLinearizer::Kernel {
+
+  public:
+
+    typedef BetweenFactor<VALUE> Factor;
+
+  private:
+
+    enum { D = traits<VALUE>::dimension };
+    typedef Eigen::Matrix<double, D, D> Jacobian;
+    typedef typename traits<VALUE>::TangentVector TangentVector;
+    typedef std::vector<VALUE, Eigen::aligned_allocator<VALUE> > Buffer;
+
+  public:
+
+    /// Linearize the BetweenFactors graph[i] for all i in [first, last)
+    virtual void linearize(const NonlinearFactorGraph& graph,
+        const Values& values, FactorIndices::const_iterator first,
+        FactorIndices::const_iterator last,
+        GaussianFactorGraph& linearGraph) const {
+      // Gather the active factors, inactive ones stay null as in
+      // NoiseModelFactor::linearize
+      FactorIndices indices;
+      std::vector<const Factor*> factors;
+      Buffer x1, x2;
+      indices.reserve(last - first);
+      factors.reserve(last - first);
+      x1.reserve(last - first);
+      x2.reserve(last - first);
+      for (FactorIndices::const_iterator i = first; i != last; ++i) {
+        const Factor* factor = static_cast<const Factor*>(graph[*i].get());
+        if (!factor->active(values))
+          continue;
+        indices.push_back(*i);
+        factors.push_back(factor);
+        x1.push_back(values.at<VALUE>(factor->key1()));
+        x2.push_back(values.at<VALUE>(factor->key2()));
+      }
+      const size_t n = factors.size();
+
+      // Evaluate, the same as BetweenFactor::evaluateError
+      const FastVector<DenseIndex> dims(2, D);
+      Jacobian H1, H2;
+      for (size_t k = 0; k < n; ++k) {
+        const Factor& factor = *factors[k];
+        const VALUE hx = traits<VALUE>::Between(x1[k], x2[k], H1, H2);
+#ifdef SLOW_BUT_CORRECT_BETWEENFACTOR
+        Jacobian Hlocal;
+        const TangentVector e = traits<VALUE>::Local(factor.measured(), hx,
+            boost::none, Hlocal);
+        H1 = Hlocal * H1;
+        H2 = Hlocal * H2;
+#else
+        const TangentVector e = traits<VALUE>::Local(factor.measured(), hx);
+#endif
+
+        // Scatter
+        const SharedNoiseModel& model = factor.noiseModel();
+        if (model && model->dim() != D)
+          throw std::invalid_argument(
+              "BetweenFactorKernel: noise model dimension does not match");
+        boost::shared_ptr<JacobianFactor> jacobian = Allocate(factor.keys(),
+            dims, D, model);
+        VerticalBlockMatrix& Ab = jacobian->matrixObject();
+        Ab(0) = H1;
+        Ab(1) = H2;
+        Ab(2).col(0) = -e;
+        Whiten(model, *jacobian);
+        linearGraph[indices[k]] = jacobian;
+      }
+    }
+  }; // \class BetweenFactorKernel
+
+} /// namespace gtsam
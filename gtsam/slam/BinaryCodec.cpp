@@ -0,0 +1,180 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinaryCodec.cpp
+ * @brief   Conversion of noise models to and from doubles
+ * @author  agent
+ */
+
+#include <gtsam/slam/BinaryCodec.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+namespace internal {
+
+namespace {
+
+/// Noise model types, which are never renumbered
+enum NoiseModelType { UNIT, ISOTROPIC, DIAGONAL, GAUSSIAN, CONSTRAINED };
+
+enum RobustType {
+  NOT_ROBUST, NULL_ESTIMATOR, FAIR, HUBER, CAUCHY, TUKEY, WELSCH,
+  GEMAN_MCCLURE, DCS, L2_WITH_DEAD_ZONE
+};
+
+/// Whether x is a whole number in [0, max], so that it can be cast safely
+bool isCount(double x, double max) {
+  return x >= 0 && x <= max && x == std::floor(x);
+}
+
+template<class E>
+bool encodeEstimator(const noiseModel::mEstimator::Base& estimator,
+    RobustType type, vector<double>& record) {
+  const E* e = dynamic_cast<const E*>(&estimator);
+  if (!e)
+    return false;
+  record[2] = type;
+  record[3] = e->modelParameter();
+  return true;
+}
+
+} // namespace
+
+/* ************************************************************************* */
+void encodeNoiseModel(const noiseModel::Base& model, vector<double>& record) {
+  using namespace noiseModel;
+  record.assign(5, 0.0);
+  const Base* base = &model;
+  if (const Robust* robust = dynamic_cast<const Robust*>(&model)) {
+    const mEstimator::Base& estimator = *robust->robust();
+    if (dynamic_cast<const mEstimator::Null*>(&estimator))
+      record[2] = NULL_ESTIMATOR;
+    else if (!encodeEstimator<mEstimator::Fair>(estimator, FAIR, record)
+        && !encodeEstimator<mEstimator::Huber>(estimator, HUBER, record)
+        && !encodeEstimator<mEstimator::Cauchy>(estimator, CAUCHY, record)
+        && !encodeEstimator<mEstimator::Tukey>(estimator, TUKEY, record)
+        && !encodeEstimator<mEstimator::Welsch>(estimator, WELSCH, record)
+        && !encodeEstimator<mEstimator::GemanMcClure>(estimator, GEMAN_MCCLURE,
+            record)
+        && !encodeEstimator<mEstimator::DCS>(estimator, DCS, record)
+        && !encodeEstimator<mEstimator::L2WithDeadZone>(estimator,
+            L2_WITH_DEAD_ZONE, record))
+      throw invalid_argument("encodeNoiseModel: unsupported robust estimator");
+    record[4] = estimator.reweightScheme();
+    base = robust->noise().get();
+  }
+
+  const size_t dim = base->dim();
+  record[1] = dim;
+  if (dynamic_cast<const Unit*>(base)) {
+    record[0] = UNIT;
+  } else if (const Isotropic* isotropic = dynamic_cast<const Isotropic*>(base)) {
+    record[0] = ISOTROPIC;
+    record.push_back(isotropic->sigma());
+  } else if (const Constrained* constrained = dynamic_cast<const Constrained*>(base)) {
+    record[0] = CONSTRAINED;
+    const Vector& sigmas = constrained->sigmas();
+    const Vector& mu = constrained->mu();
+    record.insert(record.end(), sigmas.data(), sigmas.data() + dim);
+    record.insert(record.end(), mu.data(), mu.data() + dim);
+  } else if (const Diagonal* diagonal = dynamic_cast<const Diagonal*>(base)) {
+    record[0] = DIAGONAL;
+    const Vector sigmas = diagonal->sigmas();
+    record.insert(record.end(), sigmas.data(), sigmas.data() + dim);
+  } else if (const Gaussian* gaussian = dynamic_cast<const Gaussian*>(base)) {
+    record[0] = GAUSSIAN;
+    const Matrix R = gaussian->R();
+    for (size_t i = 0; i < dim; i++)
+      for (size_t j = 0; j < dim; j++)
+        record.push_back(R(i, j));
+  } else {
+    throw invalid_argument("encodeNoiseModel: unsupported noise model");
+  }
+}
+
+/* ************************************************************************* */
+SharedNoiseModel decodeNoiseModel(const double* record, size_t n) {
+  using namespace noiseModel;
+  // Check the header before any cast, and divide rather than multiply below,
+  // so that corrupt sizes can not overflow. A unit model has no data, so its
+  // dimension is only bounded by what an index can hold.
+  if (n < 5 || !isCount(record[0], CONSTRAINED)
+      || !isCount(record[1], std::numeric_limits<int>::max())
+      || !isCount(record[2], L2_WITH_DEAD_ZONE)
+      || !isCount(record[4], mEstimator::Base::Block))
+    throw invalid_argument("decodeNoiseModel: invalid noise model");
+  const size_t dim = static_cast<size_t>(record[1]);
+  const size_t m = n - 5; // number of doubles after the header
+  const double* d = record + 5;
+  SharedNoiseModel model;
+  switch (static_cast<int>(record[0])) {
+  case UNIT:
+    model = Unit::Create(dim);
+    break;
+  case ISOTROPIC:
+    if (m < 1)
+      throw invalid_argument("decodeNoiseModel: invalid noise model");
+    model = Isotropic::Sigma(dim, d[0], false);
+    break;
+  case DIAGONAL:
+    if (dim > m)
+      throw invalid_argument("decodeNoiseModel: invalid noise model");
+    model = Diagonal::Sigmas(Eigen::Map<const Vector>(d, dim), false);
+    break;
+  case GAUSSIAN: {
+    if (dim != 0 && dim > m / dim)
+      throw invalid_argument("decodeNoiseModel: invalid noise model");
+    Matrix R(dim, dim);
+    for (size_t i = 0; i < dim; i++)
+      for (size_t j = 0; j < dim; j++)
+        R(i, j) = d[dim * i + j];
+    model = Gaussian::SqrtInformation(R, false);
+    break;
+  }
+  case CONSTRAINED:
+    if (dim > m / 2)
+      throw invalid_argument("decodeNoiseModel: invalid noise model");
+    model = Constrained::MixedSigmas(Eigen::Map<const Vector>(d + dim, dim),
+        Eigen::Map<const Vector>(d, dim));
+    break;
+  default:
+    throw invalid_argument("decodeNoiseModel: invalid noise model");
+  }
+
+  const double k = record[3];
+  const mEstimator::Base::ReweightScheme reweight =
+      static_cast<mEstimator::Base::ReweightScheme>(static_cast<int>(record[4]));
+  mEstimator::Base::shared_ptr estimator;
+  switch (static_cast<int>(record[2])) {
+  case NOT_ROBUST: return model;
+  case NULL_ESTIMATOR: estimator = boost::make_shared<mEstimator::Null>(reweight); break;
+  case FAIR: estimator = mEstimator::Fair::Create(k, reweight); break;
+  case HUBER: estimator = mEstimator::Huber::Create(k, reweight); break;
+  case CAUCHY: estimator = mEstimator::Cauchy::Create(k, reweight); break;
+  case TUKEY: estimator = mEstimator::Tukey::Create(k, reweight); break;
+  case WELSCH: estimator = mEstimator::Welsch::Create(k, reweight); break;
+  case GEMAN_MCCLURE: estimator = mEstimator::GemanMcClure::Create(k, reweight); break;
+  case DCS: estimator = mEstimator::DCS::Create(k, reweight); break;
+  case L2_WITH_DEAD_ZONE: estimator = mEstimator::L2WithDeadZone::Create(k, reweight); break;
+  default:
+    throw invalid_argument("decodeNoiseModel: invalid noise model");
+  }
+  return Robust::Create(estimator, model);
+}
+
+} // namespace internal
+} // namespace gtsam
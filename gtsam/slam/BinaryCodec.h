@@ -0,0 +1,232 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinaryCodec.h
+ * @brief   Conversion of values, factors and noise models to and from doubles,
+ *          shared by the binary dataset files and binary serialization
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/sam/BearingRangeFactor.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/Pose2.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace gtsam {
+namespace internal {
+
+/* ************************************************************************* */
+// Codecs convert a value or measurement to and from 'width' doubles
+template<class T> struct Codec;
+
+template<> struct Codec<Point2> {
+  enum { width = 2 };
+  static void encode(const Point2& p, double* d) {
+    d[0] = p.x(); d[1] = p.y();
+  }
+  static Point2 decode(const double* d) {
+    return Point2(d[0], d[1]);
+  }
+};
+
+template<> struct Codec<Point3> {
+  enum { width = 3 };
+  static void encode(const Point3& p, double* d) {
+    d[0] = p.x(); d[1] = p.y(); d[2] = p.z();
+  }
+  static Point3 decode(const double* d) {
+    return Point3(d[0], d[1], d[2]);
+  }
+};
+
+// Stores cos and sin, rather than the angle, to round-trip exactly
+template<> struct Codec<Rot2> {
+  enum { width = 2 };
+  static void encode(const Rot2& R, double* d) {
+    d[0] = R.c(); d[1] = R.s();
+  }
+  static Rot2 decode(const double* d) {
+    return Rot2::fromCosSin(d[0], d[1]);
+  }
+};
+
+// Rotation matrix in row-major order
+template<> struct Codec<Rot3> {
+  enum { width = 9 };
+  static void encode(const Rot3& R, double* d) {
+    const Matrix3 M = R.matrix();
+    for (size_t i = 0; i < 3; i++)
+      for (size_t j = 0; j < 3; j++)
+        d[3 * i + j] = M(i, j);
+  }
+  static Rot3 decode(const double* d) {
+    Matrix3 M;
+    M << d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8];
+    return Rot3(M);
+  }
+};
+
+// Translation, followed by the rotation
+template<> struct Codec<Pose2> {
+  enum { width = 4 };
+  static void encode(const Pose2& pose, double* d) {
+    d[0] = pose.x(); d[1] = pose.y();
+    Codec<Rot2>::encode(pose.r(), d + 2);
+  }
+  static Pose2 decode(const double* d) {
+    return Pose2(Codec<Rot2>::decode(d + 2), Point2(d[0], d[1]));
+  }
+};
+
+// Rotation, followed by the translation
+template<> struct Codec<Pose3> {
+  enum { width = 12 };
+  static void encode(const Pose3& pose, double* d) {
+    Codec<Rot3>::encode(pose.rotation(), d);
+    Codec<Point3>::encode(pose.translation(), d + 9);
+  }
+  static Pose3 decode(const double* d) {
+    return Pose3(Codec<Rot3>::decode(d), Codec<Point3>::decode(d + 9));
+  }
+};
+
+template<> struct Codec<Cal3_S2> {
+  enum { width = 5 };
+  static void encode(const Cal3_S2& K, double* d) {
+    d[0] = K.fx(); d[1] = K.fy(); d[2] = K.skew(); d[3] = K.px(); d[4] = K.py();
+  }
+  static Cal3_S2 decode(const double* d) {
+    return Cal3_S2(d[0], d[1], d[2], d[3], d[4]);
+  }
+};
+
+template<> struct Codec<Cal3Bundler> {
+  enum { width = 5 };
+  static void encode(const Cal3Bundler& K, double* d) {
+    d[0] = K.fx(); d[1] = K.k1(); d[2] = K.k2(); d[3] = K.u0(); d[4] = K.v0();
+  }
+  static Cal3Bundler decode(const double* d) {
+    return Cal3Bundler(d[0], d[1], d[2], d[3], d[4]);
+  }
+};
+
+template<> struct Codec<SfmCamera> {
+  enum { width = 17 };
+  static void encode(const SfmCamera& camera, double* d) {
+    Codec<Pose3>::encode(camera.pose(), d);
+    Codec<Cal3Bundler>::encode(camera.calibration(), d + 12);
+  }
+  static SfmCamera decode(const double* d) {
+    return SfmCamera(Codec<Pose3>::decode(d), Codec<Cal3Bundler>::decode(d + 12));
+  }
+};
+
+typedef BearingRange<Pose2, Point2> BearingRange2D;
+template<> struct Codec<BearingRange2D> {
+  enum { width = 3 };
+  static void encode(const BearingRange2D& m, double* d) {
+    Codec<Rot2>::encode(m.bearing(), d);
+    d[2] = m.range();
+  }
+  static BearingRange2D decode(const double* d) {
+    return BearingRange2D(Codec<Rot2>::decode(d), d[2]);
+  }
+};
+
+/* ************************************************************************* */
+// FactorCodecs convert a factor to and from keys and a measurement
+template<class FACTOR> struct FactorCodec;
+
+template<class T> struct FactorCodec<PriorFactor<T> > {
+  typedef Codec<T> Measurement;
+  enum { arity = 1 };
+  static void encode(const PriorFactor<T>& f, double* d) {
+    Measurement::encode(f.prior(), d);
+  }
+  static NonlinearFactor::shared_ptr decode(const uint64_t* keys,
+      const double* d, const SharedNoiseModel& model) {
+    return boost::make_shared<PriorFactor<T> >(keys[0],
+        Measurement::decode(d), model);
+  }
+};
+
+template<class T> struct FactorCodec<BetweenFactor<T> > {
+  typedef Codec<T> Measurement;
+  enum { arity = 2 };
+  static void encode(const BetweenFactor<T>& f, double* d) {
+    Measurement::encode(f.measured(), d);
+  }
+  static NonlinearFactor::shared_ptr decode(const uint64_t* keys,
+      const double* d, const SharedNoiseModel& model) {
+    return boost::make_shared<BetweenFactor<T> >(keys[0], keys[1],
+        Measurement::decode(d), model);
+  }
+};
+
+typedef BearingRangeFactor<Pose2, Point2> BearingRangeFactor2D;
+template<> struct FactorCodec<BearingRangeFactor2D> {
+  typedef Codec<BearingRange2D> Measurement;
+  enum { arity = 2 };
+  static void encode(const BearingRangeFactor2D& f, double* d) {
+    Measurement::encode(f.measured(), d);
+  }
+  static NonlinearFactor::shared_ptr decode(const uint64_t* keys,
+      const double* d, const SharedNoiseModel& model) {
+    const BearingRange2D m = Measurement::decode(d);
+    return boost::make_shared<BearingRangeFactor2D>(keys[0], keys[1],
+        m.bearing(), m.range(), model);
+  }
+};
+
+typedef GeneralSFMFactor<SfmCamera, Point3> SfmFactor;
+template<> struct FactorCodec<SfmFactor> {
+  typedef Codec<Point2> Measurement;
+  enum { arity = 2 };
+  static void encode(const SfmFactor& f, double* d) {
+    Measurement::encode(f.measured(), d);
+  }
+  static NonlinearFactor::shared_ptr decode(const uint64_t* keys,
+      const double* d, const SharedNoiseModel& model) {
+    return boost::make_shared<SfmFactor>(Measurement::decode(d), model,
+        keys[0], keys[1]);
+  }
+};
+
+/* ************************************************************************* */
+// A noise model is stored as a record of doubles: type, dim, robust type,
+// robust parameter, reweight scheme, followed by nothing for Unit, sigma for
+// Isotropic, sigmas for Diagonal, sigmas and mu for Constrained, and R in
+// row-major order for Gaussian.
+
+/**
+ * Write the record of a noise model
+ * @throw std::invalid_argument if the noise model or robust estimator is not
+ *        supported
+ */
+GTSAM_EXPORT void encodeNoiseModel(const noiseModel::Base& model,
+    std::vector<double>& record);
+
+/**
+ * Create a noise model from a record of n doubles
+ * @throw std::invalid_argument if the record is not valid
+ */
+GTSAM_EXPORT SharedNoiseModel decodeNoiseModel(const double* record, size_t n);
+
+} // namespace internal
+} // namespace gtsam
@@ -0,0 +1,639 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinaryDataset.cpp
+ * @brief   Compact binary file format for datasets, loaded through mmap
+ * @author  agent
+ */
+
+#include <gtsam/slam/BinaryDataset.h>
+#include <gtsam/slam/BinaryCodec.h>
+#include <gtsam/base/MappedFile.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+// File layout: a Header, a directory of nrSections BinarySections, and then
+// the sections themselves, all 8-byte aligned. Within a section, the columns
+// follow each other, e.g., for factors: uint64 keys[count * arity], uint32
+// noise model indices[count] padded to 8 bytes, double data[count * width].
+namespace {
+
+using namespace internal;
+typedef BinarySection Section;
+
+const char kMagic[8] = { 'G', 'T', 'S', 'A', 'M', 'B', 'I', 'N' };
+const uint32_t kVersion = 1;
+const uint32_t kByteOrder = 0x01020304;
+
+struct Header {
+  char magic[8];
+  uint32_t version, byteOrder;
+  uint64_t nrSections, fileSize;
+};
+
+/// Section kinds, which are never renumbered
+enum Kind {
+  NOISE_MODELS = 1, ///< uint64 offsets[count + 1] into double records[]
+  FACTOR_ORDER = 2, ///< uint32 (section, row)[count], one per factor
+  VALUES_POSE2 = 16, ///< uint64 keys[count], double data[count * width]
+  VALUES_POSE3,
+  VALUES_POINT2,
+  VALUES_POINT3,
+  VALUES_SFM_CAMERA,
+  PRIOR_POSE2 = 32, ///< keys, noise model indices, and data, see above
+  PRIOR_POSE3,
+  BETWEEN_POSE2,
+  BETWEEN_POSE3,
+  BEARING_RANGE_POSE2_POINT2,
+  GENERAL_SFM,
+  SFM_CAMERAS = 64, ///< double data[count * width]
+  SFM_TRACKS, ///< double data[count * width], uint64 offsets[2][count + 1]
+  SFM_MEASUREMENTS, ///< uint64 cameras[count], double uv[count * 2]
+  SFM_SIFT_INDICES ///< uint64 (camera, point)[count]
+};
+
+/// Row of the FACTOR_ORDER section for a null factor
+const uint32_t kNullFactor = 0xFFFFFFFF;
+
+/// Noise model index for factors without a noise model
+const uint32_t kNoNoiseModel = 0xFFFFFFFF;
+
+inline uint64_t align8(uint64_t n) {
+  return (n + 7) & ~uint64_t(7);
+}
+
+/* ************************************************************************* */
+/// Encode the keys, measurement, and noise model of factor, if a FACTOR
+template<class FACTOR>
+bool encodeFactor(const NonlinearFactor& factor, uint64_t* keys, double* d,
+    SharedNoiseModel& model) {
+  const FACTOR* f = dynamic_cast<const FACTOR*>(&factor);
+  if (!f)
+    return false;
+  for (size_t i = 0; i < FactorCodec<FACTOR>::arity; i++)
+    keys[i] = f->keys()[i];
+  FactorCodec<FACTOR>::encode(*f, d);
+  model = f->noiseModel();
+  return true;
+}
+
+/// The supported factor types, in the order in which they are tried
+struct FactorType {
+  uint32_t kind, arity, width;
+  bool (*encode)(const NonlinearFactor&, uint64_t*, double*, SharedNoiseModel&);
+  NonlinearFactor::shared_ptr (*decode)(const uint64_t*, const double*,
+      const SharedNoiseModel&);
+};
+
+#define GTSAM_BINARY_FACTOR_TYPE(KIND, FACTOR) \
+  { KIND, FactorCodec<FACTOR>::arity, FactorCodec<FACTOR>::Measurement::width, \
+    &encodeFactor<FACTOR>, &FactorCodec<FACTOR>::decode }
+
+const FactorType kFactorTypes[] = {
+  GTSAM_BINARY_FACTOR_TYPE(BETWEEN_POSE2, BetweenFactor<Pose2>),
+  GTSAM_BINARY_FACTOR_TYPE(BETWEEN_POSE3, BetweenFactor<Pose3>),
+  GTSAM_BINARY_FACTOR_TYPE(PRIOR_POSE2, PriorFactor<Pose2>),
+  GTSAM_BINARY_FACTOR_TYPE(PRIOR_POSE3, PriorFactor<Pose3>),
+  GTSAM_BINARY_FACTOR_TYPE(BEARING_RANGE_POSE2_POINT2, BearingRangeFactor2D),
+  GTSAM_BINARY_FACTOR_TYPE(GENERAL_SFM, SfmFactor)
+};
+
+#undef GTSAM_BINARY_FACTOR_TYPE
+
+const FactorType* findFactorType(uint32_t kind) {
+  for (const FactorType& type : kFactorTypes)
+    if (type.kind == kind)
+      return &type;
+  return nullptr;
+}
+
+/* ************************************************************************* */
+/// Encode the key and value of a key-value pair, if a T
+template<class T>
+bool encodeValue(const Values::ConstKeyValuePair& key_value, uint64_t* key,
+    double* d) {
+  const GenericValue<T>* value =
+      dynamic_cast<const GenericValue<T>*>(&key_value.value);
+  if (!value)
+    return false;
+  *key = key_value.key;
+  Codec<T>::encode(value->value(), d);
+  return true;
+}
+
+/// Insert the 'count' values in a section
+template<class T>
+void decodeValues(const char* p, size_t count, Values& values) {
+  const uint64_t* keys = reinterpret_cast<const uint64_t*>(p);
+  const double* d = reinterpret_cast<const double*>(p + 8 * count);
+  for (size_t i = 0; i < count; i++, d += Codec<T>::width)
+    values.insert(keys[i], Codec<T>::decode(d));
+}
+
+/// The supported value types
+struct ValueType {
+  uint32_t kind, width;
+  bool (*encode)(const Values::ConstKeyValuePair&, uint64_t*, double*);
+  void (*decode)(const char*, size_t, Values&);
+};
+
+#define GTSAM_BINARY_VALUE_TYPE(KIND, T) \
+  { KIND, Codec<T>::width, &encodeValue<T>, &decodeValues<T> }
+
+const ValueType kValueTypes[] = {
+  GTSAM_BINARY_VALUE_TYPE(VALUES_POSE2, Pose2),
+  GTSAM_BINARY_VALUE_TYPE(VALUES_POSE3, Pose3),
+  GTSAM_BINARY_VALUE_TYPE(VALUES_POINT2, Point2),
+  GTSAM_BINARY_VALUE_TYPE(VALUES_POINT3, Point3),
+  GTSAM_BINARY_VALUE_TYPE(VALUES_SFM_CAMERA, SfmCamera)
+};
+
+#undef GTSAM_BINARY_VALUE_TYPE
+
+const ValueType* findValueType(uint32_t kind) {
+  for (const ValueType& type : kValueTypes)
+    if (type.kind == kind)
+      return &type;
+  return nullptr;
+}
+
+/* ************************************************************************* */
+/// A section being written, with its columns appended in turn
+struct SectionWriter {
+  Section section;
+  vector<char> bytes;
+
+  SectionWriter(uint32_t kind, uint64_t count, uint32_t arity = 0,
+      uint32_t width = 0) {
+    section.kind = kind;
+    section.arity = arity;
+    section.width = width;
+    section.reserved = 0;
+    section.count = count;
+    section.offset = section.size = 0;
+  }
+
+  /// Append a column, padded to 8 bytes
+  template<typename T>
+  void append(const vector<T>& column) {
+    const size_t n = column.size() * sizeof(T);
+    bytes.resize(align8(bytes.size() + n));
+    if (n)
+      memcpy(bytes.data() + bytes.size() - align8(n), column.data(), n);
+  }
+};
+
+/// Write the header, directory and sections to a file
+void writeSections(vector<SectionWriter>& sections, const string& filename) {
+  Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byteOrder = kByteOrder;
+  header.nrSections = sections.size();
+  uint64_t offset = sizeof(Header) + sections.size() * sizeof(Section);
+  for (SectionWriter& s : sections) {
+    s.section.offset = offset;
+    s.section.size = s.bytes.size();
+    offset += s.bytes.size();
+  }
+  header.fileSize = offset;
+
+  ofstream os(filename.c_str(), ios::binary);
+  if (!os)
+    throw runtime_error("writeBinary: can not open file " + filename);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  for (const SectionWriter& s : sections)
+    os.write(reinterpret_cast<const char*>(&s.section), sizeof(Section));
+  for (const SectionWriter& s : sections)
+    os.write(s.bytes.data(), s.bytes.size());
+  if (!os)
+    throw runtime_error("writeBinary: can not write file " + filename);
+}
+
+/// Minimum size of a section with the given kind and counts, or 0 if unknown
+uint64_t minimumSize(const Section& s) {
+  const uint64_t n = s.count;
+  if (s.kind == NOISE_MODELS)
+    return 8 * (n + 1);
+  if (s.kind == FACTOR_ORDER)
+    return 8 * n;
+  if (findValueType(s.kind))
+    return 8 * n + 8 * n * s.width;
+  if (findFactorType(s.kind))
+    return 8 * n * s.arity + align8(4 * n) + 8 * n * s.width;
+  switch (s.kind) {
+  case SFM_CAMERAS: return 8 * n * s.width;
+  case SFM_TRACKS: return 8 * n * s.width + 16 * (n + 1);
+  case SFM_MEASUREMENTS: return 24 * n;
+  case SFM_SIFT_INDICES: return 16 * n;
+  default: return 0;
+  }
+}
+
+/// Expected arity and width of known kinds
+bool hasLayout(const Section& s) {
+  if (const FactorType* type = findFactorType(s.kind))
+    return s.arity == type->arity && s.width == type->width;
+  if (const ValueType* type = findValueType(s.kind))
+    return s.width == type->width;
+  if (s.kind == SFM_CAMERAS)
+    return s.width == Codec<SfmCamera>::width;
+  if (s.kind == SFM_TRACKS)
+    return s.width == 6;
+  return true;
+}
+
+/// Check the header of a mapped file, and read its directory
+vector<Section> readDirectory(const MappedFile& file, const string& filename) {
+  if (!file.valid())
+    throw invalid_argument("BinaryGraphFile: can not find file " + filename);
+  Header header;
+  if (file.size() < sizeof(Header))
+    throw invalid_argument("BinaryGraphFile: file too short " + filename);
+  memcpy(&header, file.begin(), sizeof(Header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    throw invalid_argument("BinaryGraphFile: not a binary dataset file " + filename);
+  if (header.byteOrder != kByteOrder)
+    throw invalid_argument("BinaryGraphFile: different byte order in " + filename);
+  if (header.version > kVersion)
+    throw invalid_argument("BinaryGraphFile: unsupported version in " + filename);
+  if (header.fileSize != file.size()
+      || header.nrSections > (file.size() - sizeof(Header)) / sizeof(Section))
+    throw invalid_argument("BinaryGraphFile: truncated file " + filename);
+
+  vector<Section> sections(header.nrSections);
+  if (!sections.empty())
+    memcpy(sections.data(), file.begin() + sizeof(Header),
+        sections.size() * sizeof(Section));
+  for (const Section& s : sections) {
+    if (s.offset % 8 != 0 || s.offset > file.size()
+        || s.size > file.size() - s.offset || s.count > s.size
+        || s.size < minimumSize(s) || !hasLayout(s))
+      throw invalid_argument("BinaryGraphFile: invalid section in " + filename);
+  }
+  return sections;
+}
+
+} // namespace
+
+/* ************************************************************************* */
+void writeBinaryGraph(const NonlinearFactorGraph& graph, const Values& values,
+    const string& filename) {
+  const size_t nrFactorTypes = sizeof(kFactorTypes) / sizeof(FactorType);
+  const size_t nrValueTypes = sizeof(kValueTypes) / sizeof(ValueType);
+
+  // Columns of all values, by type
+  vector<vector<uint64_t> > valueKeys(nrValueTypes);
+  vector<vector<double> > valueData(nrValueTypes);
+  double d[Codec<SfmCamera>::width];
+  for (const auto& key_value : values) {
+    uint64_t key;
+    size_t t = 0;
+    while (t < nrValueTypes && !kValueTypes[t].encode(key_value, &key, d))
+      t++;
+    if (t == nrValueTypes)
+      throw invalid_argument("writeBinaryGraph: unsupported value type");
+    valueKeys[t].push_back(key);
+    valueData[t].insert(valueData[t].end(), d, d + kValueTypes[t].width);
+  }
+
+  // Columns of all factors, by type, sharing noise models
+  vector<vector<uint64_t> > factorKeys(nrFactorTypes);
+  vector<vector<uint32_t> > factorNoise(nrFactorTypes);
+  vector<vector<double> > factorData(nrFactorTypes);
+  vector<uint32_t> order; // (type, row) for now
+  order.reserve(2 * graph.size());
+  unordered_map<const noiseModel::Base*, uint32_t> noiseIndices;
+  vector<uint64_t> noiseOffsets(1, 0);
+  vector<double> noiseRecords, record;
+  uint64_t keys[2];
+  for (const auto& factor : graph) {
+    if (!factor) {
+      order.push_back(kNullFactor);
+      order.push_back(kNullFactor);
+      continue;
+    }
+    SharedNoiseModel model;
+    size_t t = 0;
+    while (t < nrFactorTypes && !kFactorTypes[t].encode(*factor, keys, d, model))
+      t++;
+    if (t == nrFactorTypes)
+      throw invalid_argument("writeBinaryGraph: unsupported factor type");
+
+    uint32_t noiseIndex = kNoNoiseModel;
+    if (model) {
+      auto inserted = noiseIndices.emplace(model.get(),
+          static_cast<uint32_t>(noiseIndices.size()));
+      if (inserted.second) {
+        encodeNoiseModel(*model, record);
+        noiseRecords.insert(noiseRecords.end(), record.begin(), record.end());
+        noiseOffsets.push_back(noiseRecords.size());
+      }
+      noiseIndex = inserted.first->second;
+    }
+
+    order.push_back(static_cast<uint32_t>(t));
+    order.push_back(static_cast<uint32_t>(factorNoise[t].size()));
+    factorKeys[t].insert(factorKeys[t].end(), keys, keys + kFactorTypes[t].arity);
+    factorNoise[t].push_back(noiseIndex);
+    factorData[t].insert(factorData[t].end(), d, d + kFactorTypes[t].width);
+  }
+
+  // Sections, with factor types mapped to section indices in the order
+  vector<SectionWriter> sections;
+  for (size_t t = 0; t < nrValueTypes; t++) {
+    if (valueKeys[t].empty())
+      continue;
+    sections.emplace_back(kValueTypes[t].kind, valueKeys[t].size(), 0,
+        kValueTypes[t].width);
+    sections.back().append(valueKeys[t]);
+    sections.back().append(valueData[t]);
+  }
+  if (!graph.empty()) {
+    vector<uint32_t> sectionIndex(nrFactorTypes);
+    for (size_t t = 0; t < nrFactorTypes; t++) {
+      if (factorNoise[t].empty())
+        continue;
+      sectionIndex[t] = static_cast<uint32_t>(sections.size());
+      sections.emplace_back(kFactorTypes[t].kind, factorNoise[t].size(),
+          kFactorTypes[t].arity, kFactorTypes[t].width);
+      sections.back().append(factorKeys[t]);
+      sections.back().append(factorNoise[t]);
+      sections.back().append(factorData[t]);
+    }
+    for (size_t i = 0; i < order.size(); i += 2)
+      if (order[i] != kNullFactor)
+        order[i] = sectionIndex[order[i]];
+    sections.emplace_back(NOISE_MODELS, noiseIndices.size());
+    sections.back().append(noiseOffsets);
+    sections.back().append(noiseRecords);
+    sections.emplace_back(FACTOR_ORDER, graph.size());
+    sections.back().append(order);
+  }
+  writeSections(sections, filename);
+}
+
+/* ************************************************************************* */
+BinaryGraphFile::BinaryGraphFile(const string& filename) :
+    file_(new MappedFile(filename)), order_(nullptr), noiseModels_(nullptr) {
+  sections_ = readDirectory(*file_, filename);
+  for (const Section& section : sections_) {
+    if (section.kind == FACTOR_ORDER)
+      order_ = &section;
+    else if (section.kind == NOISE_MODELS)
+      noiseModels_ = &section;
+  }
+  if (order_ && !noiseModels_)
+    throw invalid_argument("BinaryGraphFile: no noise models in " + filename);
+
+  // Check that the noise model records are within the section
+  if (noiseModels_) {
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data(*noiseModels_));
+    const uint64_t n = noiseModels_->count;
+    for (uint64_t j = 0; j < n; j++)
+      if (offsets[j] > offsets[j + 1])
+        throw invalid_argument("BinaryGraphFile: invalid noise models in " + filename);
+    if (offsets[0] != 0 || offsets[n] > (noiseModels_->size - 8 * (n + 1)) / 8)
+      throw invalid_argument("BinaryGraphFile: invalid noise models in " + filename);
+  }
+}
+
+/* ************************************************************************* */
+BinaryGraphFile::~BinaryGraphFile() {
+}
+
+/* ************************************************************************* */
+size_t BinaryGraphFile::nrFactors() const {
+  return order_ ? order_->count : 0;
+}
+
+/* ************************************************************************* */
+size_t BinaryGraphFile::nrValues() const {
+  size_t n = 0;
+  for (const Section& section : sections_)
+    if (findValueType(section.kind))
+      n += section.count;
+  return n;
+}
+
+/* ************************************************************************* */
+const char* BinaryGraphFile::data(const Section& section) const {
+  return file_->begin() + section.offset;
+}
+
+/* ************************************************************************* */
+SharedNoiseModel BinaryGraphFile::noiseModel(uint32_t j) const {
+  if (j == kNoNoiseModel)
+    return SharedNoiseModel();
+  if (j >= noiseModels_->count)
+    throw invalid_argument("BinaryGraphFile: invalid noise model index");
+  const char* p = data(*noiseModels_);
+  const uint64_t* offsets = reinterpret_cast<const uint64_t*>(p);
+  const double* records = reinterpret_cast<const double*>(
+      p + 8 * (noiseModels_->count + 1));
+  return decodeNoiseModel(records + offsets[j], offsets[j + 1] - offsets[j]);
+}
+
+/* ************************************************************************* */
+NonlinearFactor::shared_ptr BinaryGraphFile::factor(size_t i,
+    const vector<SharedNoiseModel>* noiseModels) const {
+  if (i >= nrFactors())
+    throw out_of_range("BinaryGraphFile::factor: invalid index");
+  const uint32_t* entry = reinterpret_cast<const uint32_t*>(data(*order_)) + 2 * i;
+  if (entry[0] == kNullFactor)
+    return NonlinearFactor::shared_ptr();
+  const FactorType* type = entry[0] < sections_.size() ?
+      findFactorType(sections_[entry[0]].kind) : nullptr;
+  const size_t row = entry[1];
+  if (!type || row >= sections_[entry[0]].count)
+    throw invalid_argument("BinaryGraphFile: invalid factor order");
+
+  const Section& section = sections_[entry[0]];
+  const char* p = data(section);
+  const uint64_t n = section.count;
+  const uint64_t* keys = reinterpret_cast<const uint64_t*>(p) + row * type->arity;
+  const uint32_t noiseIndex = reinterpret_cast<const uint32_t*>(
+      p + 8 * n * type->arity)[row];
+  const double* d = reinterpret_cast<const double*>(
+      p + 8 * n * type->arity + align8(4 * n)) + row * type->width;
+  if (noiseModels && noiseIndex != kNoNoiseModel) {
+    if (noiseIndex >= noiseModels->size())
+      throw invalid_argument("BinaryGraphFile: invalid noise model index");
+    return type->decode(keys, d, (*noiseModels)[noiseIndex]);
+  }
+  return type->decode(keys, d, noiseModel(noiseIndex));
+}
+
+/* ************************************************************************* */
+NonlinearFactor::shared_ptr BinaryGraphFile::factor(size_t i) const {
+  return factor(i, nullptr);
+}
+
+/* ************************************************************************* */
+NonlinearFactorGraph BinaryGraphFile::graph() const {
+  // Create noise models, and then factors, in parallel
+  vector<SharedNoiseModel> noiseModels(noiseModels_ ? noiseModels_->count : 0);
+  parallelFor(noiseModels.size(), [&](size_t j) {
+    noiseModels[j] = noiseModel(static_cast<uint32_t>(j));
+  });
+  NonlinearFactorGraph graph;
+  graph.resize(nrFactors());
+  parallelFor(nrFactors(), [&](size_t i) {
+    graph[i] = factor(i, &noiseModels);
+  });
+  return graph;
+}
+
+/* ************************************************************************* */
+Values BinaryGraphFile::values() const {
+  Values values;
+  for (const Section& section : sections_)
+    if (const ValueType* type = findValueType(section.kind))
+      type->decode(data(section), section.count, values);
+  return values;
+}
+
+/* ************************************************************************* */
+GraphAndValues readBinaryGraph(const string& filename) {
+  const BinaryGraphFile file(filename);
+  NonlinearFactorGraph::shared_ptr graph(
+      new NonlinearFactorGraph(file.graph()));
+  Values::shared_ptr values(new Values(file.values()));
+  return make_pair(graph, values);
+}
+
+/* ************************************************************************* */
+void writeBinarySfm(const SfmData& data, const string& filename) {
+  const size_t width = Codec<SfmCamera>::width;
+  vector<double> cameras(data.number_cameras() * width);
+  for (size_t i = 0; i < data.number_cameras(); i++)
+    Codec<SfmCamera>::encode(data.cameras[i], &cameras[i * width]);
+
+  // Points and colors, with the offsets of their measurements and indices
+  vector<double> points;
+  vector<uint64_t> measurementOffsets(1, 0), siftOffsets(1, 0);
+  vector<uint64_t> measurementCameras, siftIndices;
+  vector<double> uvs;
+  points.reserve(6 * data.number_tracks());
+  for (const SfmTrack& track : data.tracks) {
+    const double point[6] = { track.p.x(), track.p.y(), track.p.z(), track.r,
+        track.g, track.b };
+    points.insert(points.end(), point, point + 6);
+    for (const SfmMeasurement& m : track.measurements) {
+      measurementCameras.push_back(m.first);
+      uvs.push_back(m.second.x());
+      uvs.push_back(m.second.y());
+    }
+    for (const SiftIndex& index : track.siftIndices) {
+      siftIndices.push_back(index.first);
+      siftIndices.push_back(index.second);
+    }
+    measurementOffsets.push_back(measurementCameras.size());
+    siftOffsets.push_back(siftIndices.size() / 2);
+  }
+
+  vector<SectionWriter> sections;
+  sections.emplace_back(SFM_CAMERAS, data.number_cameras(), 0, width);
+  sections.back().append(cameras);
+  sections.emplace_back(SFM_TRACKS, data.number_tracks(), 0, 6);
+  sections.back().append(points);
+  sections.back().append(measurementOffsets);
+  sections.back().append(siftOffsets);
+  sections.emplace_back(SFM_MEASUREMENTS, measurementCameras.size());
+  sections.back().append(measurementCameras);
+  sections.back().append(uvs);
+  sections.emplace_back(SFM_SIFT_INDICES, siftIndices.size() / 2);
+  sections.back().append(siftIndices);
+  writeSections(sections, filename);
+}
+
+/* ************************************************************************* */
+bool readBinarySfm(const string& filename, SfmData& data) {
+  const MappedFile file(filename);
+  vector<Section> sections;
+  try {
+    sections = readDirectory(file, filename);
+  } catch (const invalid_argument& e) {
+    cout << "Error in readBinarySfm: " << e.what() << endl;
+    return false;
+  }
+  const Section *cameras = nullptr, *tracks = nullptr, *measurements = nullptr,
+      *sift = nullptr;
+  for (const Section& section : sections) {
+    if (section.kind == SFM_CAMERAS) cameras = &section;
+    if (section.kind == SFM_TRACKS) tracks = &section;
+    if (section.kind == SFM_MEASUREMENTS) measurements = &section;
+    if (section.kind == SFM_SIFT_INDICES) sift = &section;
+  }
+  if (!cameras || !tracks || !measurements || !sift) {
+    cout << "Error in readBinarySfm: no SfM data in " << filename << endl;
+    return false;
+  }
+
+  const double* c = reinterpret_cast<const double*>(file.begin() + cameras->offset);
+  data.cameras.reserve(data.cameras.size() + cameras->count);
+  for (size_t i = 0; i < cameras->count; i++)
+    data.cameras.push_back(Codec<SfmCamera>::decode(c + i * cameras->width));
+
+  const size_t nrTracks = tracks->count;
+  const double* points = reinterpret_cast<const double*>(file.begin() + tracks->offset);
+  const uint64_t* measurementOffsets =
+      reinterpret_cast<const uint64_t*>(points + 6 * nrTracks);
+  const uint64_t* siftOffsets = measurementOffsets + nrTracks + 1;
+  const uint64_t* measurementCameras =
+      reinterpret_cast<const uint64_t*>(file.begin() + measurements->offset);
+  const double* uvs =
+      reinterpret_cast<const double*>(measurementCameras + measurements->count);
+  const uint64_t* siftIndices =
+      reinterpret_cast<const uint64_t*>(file.begin() + sift->offset);
+  if (measurementOffsets[nrTracks] != measurements->count
+      || siftOffsets[nrTracks] != sift->count) {
+    cout << "Error in readBinarySfm: invalid tracks in " << filename << endl;
+    return false;
+  }
+
+  data.tracks.reserve(data.tracks.size() + nrTracks);
+  for (size_t j = 0; j < nrTracks; j++) {
+    if (measurementOffsets[j] > measurementOffsets[j + 1]
+        || siftOffsets[j] > siftOffsets[j + 1]) {
+      cout << "Error in readBinarySfm: invalid tracks in " << filename << endl;
+      return false;
+    }
+    SfmTrack track;
+    const double* point = points + 6 * j;
+    track.p = Point3(point[0], point[1], point[2]);
+    track.r = static_cast<float>(point[3]);
+    track.g = static_cast<float>(point[4]);
+    track.b = static_cast<float>(point[5]);
+    track.measurements.reserve(measurementOffsets[j + 1] - measurementOffsets[j]);
+    for (uint64_t k = measurementOffsets[j]; k < measurementOffsets[j + 1]; k++)
+      track.measurements.emplace_back(measurementCameras[k],
+          Point2(uvs[2 * k], uvs[2 * k + 1]));
+    track.siftIndices.reserve(siftOffsets[j + 1] - siftOffsets[j]);
+    for (uint64_t k = siftOffsets[j]; k < siftOffsets[j + 1]; k++)
+      track.siftIndices.emplace_back(siftIndices[2 * k], siftIndices[2 * k + 1]);
+    data.tracks.push_back(track);
+  }
+  return true;
+}
+
+} // namespace gtsam
@@ -0,0 +1,138 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinaryDataset.h
+ * @brief   Compact binary file format for datasets, loaded through mmap
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/slam/dataset.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+class MappedFile;
+
+namespace internal {
+/// Entry of the directory of a binary dataset file
+struct BinarySection {
+  uint32_t kind, arity, width, reserved;
+  uint64_t count, offset, size; ///< number of rows, and byte range in file
+};
+}
+
+/**
+ * @defgroup BinaryDataset Binary dataset files
+ *
+ * A binary dataset file stores a NonlinearFactorGraph and Values, or SfmData,
+ * as typed, columnar sections: e.g., all BetweenFactor<Pose3> keys are stored
+ * contiguously, followed by their noise model indices and measurements. The
+ * file starts with a versioned header and a directory of sections, and all
+ * sections are 8-byte aligned, so a memory-mapped file is read in place.
+ * Noise models shared by several factors are stored once.
+ *
+ * Supported are Pose2, Pose3, Point2, Point3 and SfmCamera values, and
+ * PriorFactor and BetweenFactor on Pose2 and Pose3, BearingRangeFactor<Pose2,
+ * Point2>, and GeneralSFMFactor<SfmCamera, Point3> factors, i.e., everything
+ * the loaders in dataset.h create. Noise models can be Gaussian, Diagonal,
+ * Constrained, Isotropic or Unit, optionally wrapped in a Robust model.
+ * Numbers are stored in the byte order of the machine that wrote the file,
+ * which is checked on reading.
+ * @{
+ */
+
+/**
+ * Write a graph and values to a binary dataset file
+ * @throw std::invalid_argument if a factor, value or noise model is not supported
+ * @throw std::runtime_error if the file can not be written
+ */
+GTSAM_EXPORT void writeBinaryGraph(const NonlinearFactorGraph& graph,
+    const Values& values, const std::string& filename);
+
+/**
+ * Read a graph and values from a binary dataset file
+ * @throw std::invalid_argument if the file can not be opened or is not valid
+ */
+GTSAM_EXPORT GraphAndValues readBinaryGraph(const std::string& filename);
+
+/**
+ * Write SfmData to a binary dataset file
+ * @throw std::runtime_error if the file can not be written
+ */
+GTSAM_EXPORT void writeBinarySfm(const SfmData& data,
+    const std::string& filename);
+
+/**
+ * Read SfmData from a binary dataset file
+ * @return false, with an error message, if the file could not be read
+ */
+GTSAM_EXPORT bool readBinarySfm(const std::string& filename, SfmData& data);
+
+/**
+ * A graph and values in a binary dataset file, mapped into memory. Opening
+ * the file only checks its header and directory: factors and values are
+ * created when asked for, either one at a time, or all at once, in parallel.
+ */
+class GTSAM_EXPORT BinaryGraphFile {
+public:
+
+  /**
+   * Map a binary dataset file
+   * @throw std::invalid_argument if the file can not be opened or is not valid
+   */
+  explicit BinaryGraphFile(const std::string& filename);
+
+  ~BinaryGraphFile();
+
+  /// Number of factors in the graph
+  size_t nrFactors() const;
+
+  /// Number of values
+  size_t nrValues() const;
+
+  /// Create factor i, with a noise model of its own
+  NonlinearFactor::shared_ptr factor(size_t i) const;
+
+  /// Create all factors, in order, sharing noise models as in the written graph
+  NonlinearFactorGraph graph() const;
+
+  /// Create all values
+  Values values() const;
+
+private:
+  typedef internal::BinarySection Section;
+
+  std::unique_ptr<MappedFile> file_;
+  std::vector<Section> sections_;
+  const Section* order_; ///< factor order, null if there are no factors
+  const Section* noiseModels_; ///< noise models, null if there are no factors
+
+  /// Pointer to the start of a section
+  const char* data(const Section& section) const;
+
+  /// Create noise model j, or null for a factor without noise model
+  SharedNoiseModel noiseModel(uint32_t j) const;
+
+  /// Create factor i, with the given noise models, or new ones if null
+  NonlinearFactor::shared_ptr factor(size_t i,
+      const std::vector<SharedNoiseModel>* noiseModels) const;
+};
+
+/// @}
+
+} // namespace gtsam
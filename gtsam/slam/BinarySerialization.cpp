@@ -0,0 +1,716 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinarySerialization.cpp
+ * @brief   Compact binary serialization of graphs, values and Bayes trees,
+ *          without boost archives
+ * @author  agent
+ */
+
+#include <gtsam/slam/BinarySerialization.h>
+#include <gtsam/slam/BinaryCodec.h>
+#include <gtsam/linear/HessianFactor.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <typeinfo>
+#include <unordered_map>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+// Every object starts with a header: a magic number, the object type and the
+// version of its schema. What follows is described with each encodeBinary.
+namespace {
+
+using namespace internal;
+
+const char kMagic[4] = { 'G', 'T', 'S', 'C' };
+const uint16_t kVersion = 1;
+
+/// Object types, which are never renumbered
+enum ObjectType {
+  VALUES = 1,
+  NONLINEAR_FACTOR_GRAPH,
+  VECTOR_VALUES,
+  GAUSSIAN_FACTOR_GRAPH,
+  GAUSSIAN_BAYES_NET,
+  GAUSSIAN_BAYES_TREE
+};
+
+const char* const kObjectNames[] = { "", "Values", "NonlinearFactorGraph",
+    "VectorValues", "GaussianFactorGraph", "GaussianBayesNet",
+    "GaussianBayesTree" };
+
+/// Noise model index for factors without a noise model
+const uint32_t kNoNoiseModel = 0xFFFFFFFF;
+
+/// Parent index of root cliques
+const uint64_t kNoParent = ~uint64_t(0);
+
+void writeHeader(BinaryWriter& writer, ObjectType type) {
+  writer.write(kMagic, sizeof(kMagic));
+  writer.write(static_cast<uint16_t>(type));
+  writer.write(kVersion);
+}
+
+void readHeader(BinaryReader& reader, ObjectType type) {
+  char magic[sizeof(kMagic)];
+  reader.read(magic, sizeof(kMagic));
+  const uint16_t actualType = reader.read<uint16_t>();
+  const uint16_t version = reader.read<uint16_t>();
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0 || actualType != type)
+    throw invalid_argument(string("decodeBinary: no ") + kObjectNames[type]
+        + " in buffer");
+  if (version == 0 || version > kVersion)
+    throw invalid_argument(string("decodeBinary: unsupported version of ")
+        + kObjectNames[type]);
+}
+
+/// Check that n more values of type T can be read, before allocating for them
+template<typename T>
+void checkRemaining(const BinaryReader& reader, uint64_t n) {
+  if (n > reader.remaining() / sizeof(T))
+    throw invalid_argument("BinaryReader: unexpected end of buffer");
+}
+
+/// Same for rows * cols values, without computing a product that may overflow
+template<typename T>
+void checkRemaining(const BinaryReader& reader, uint64_t rows, uint64_t cols) {
+  if (cols != 0 && rows > reader.remaining() / sizeof(T) / cols)
+    throw invalid_argument("BinaryReader: unexpected end of buffer");
+}
+
+/* ************************************************************************* */
+// Values: uint64 count, then per value a uint64 key, a uint16 type, and its
+// data. Fixed-size types are written as the doubles of their Codec.
+
+/// Value types, which are never renumbered
+enum ValueTag {
+  DOUBLE = 1, VECTOR, MATRIX, POINT2, POINT3, ROT2, ROT3, POSE2, POSE3,
+  CAL3_S2, CAL3_BUNDLER, SFM_CAMERA, VECTOR2, VECTOR3, VECTOR6
+};
+
+template<class T>
+void encodeFixed(const Value& value, BinaryWriter& writer) {
+  double d[Codec<T>::width];
+  Codec<T>::encode(static_cast<const GenericValue<T>&>(value).value(), d);
+  writer.write(d, Codec<T>::width);
+}
+
+template<class T>
+void decodeFixed(BinaryReader& reader, Key key, Values& values) {
+  double d[Codec<T>::width];
+  reader.read(d, Codec<T>::width);
+  values.insert(key, Codec<T>::decode(d));
+}
+
+void encodeDouble(const Value& value, BinaryWriter& writer) {
+  writer.write(static_cast<const GenericValue<double>&>(value).value());
+}
+
+void decodeDouble(BinaryReader& reader, Key key, Values& values) {
+  values.insert(key, reader.read<double>());
+}
+
+void encodeVector(const Value& value, BinaryWriter& writer) {
+  const Vector& v = static_cast<const GenericValue<Vector>&>(value).value();
+  writer.write(static_cast<uint32_t>(v.size()));
+  writer.write(v.data(), v.size());
+}
+
+void decodeVector(BinaryReader& reader, Key key, Values& values) {
+  const uint32_t n = reader.read<uint32_t>();
+  checkRemaining<double>(reader, n);
+  Vector v(n);
+  reader.read(v.data(), n);
+  values.insert(key, v);
+}
+
+template<int N>
+void encodeFixedVector(const Value& value, BinaryWriter& writer) {
+  typedef Eigen::Matrix<double, N, 1> VectorN;
+  writer.write(static_cast<const GenericValue<VectorN>&>(value).value().data(),
+      N);
+}
+
+template<int N>
+void decodeFixedVector(BinaryReader& reader, Key key, Values& values) {
+  Eigen::Matrix<double, N, 1> v;
+  reader.read(v.data(), N);
+  values.insert(key, v);
+}
+
+void encodeMatrix(const Value& value, BinaryWriter& writer) {
+  const Matrix& M = static_cast<const GenericValue<Matrix>&>(value).value();
+  writer.write(static_cast<uint32_t>(M.rows()));
+  writer.write(static_cast<uint32_t>(M.cols()));
+  writer.write(M.data(), M.size());
+}
+
+void decodeMatrix(BinaryReader& reader, Key key, Values& values) {
+  const uint32_t m = reader.read<uint32_t>(), n = reader.read<uint32_t>();
+  checkRemaining<double>(reader, m, n);
+  Matrix M(m, n);
+  reader.read(M.data(), M.size());
+  values.insert(key, M);
+}
+
+struct ValueType {
+  uint16_t tag;
+  const type_info& type;
+  void (*encode)(const Value&, BinaryWriter&);
+  void (*decode)(BinaryReader&, Key, Values&);
+};
+
+#define GTSAM_FIXED_VALUE_TYPE(TAG, T) \
+  { TAG, typeid(GenericValue<T>), &encodeFixed<T>, &decodeFixed<T> }
+#define GTSAM_FIXED_VECTOR_TYPE(TAG, N) \
+  { TAG, typeid(GenericValue<Vector ## N>), &encodeFixedVector<N>, \
+    &decodeFixedVector<N> }
+
+const ValueType kValueTypes[] = {
+  { DOUBLE, typeid(GenericValue<double>), &encodeDouble, &decodeDouble },
+  { VECTOR, typeid(GenericValue<Vector>), &encodeVector, &decodeVector },
+  { MATRIX, typeid(GenericValue<Matrix>), &encodeMatrix, &decodeMatrix },
+  GTSAM_FIXED_VALUE_TYPE(POINT2, Point2),
+  GTSAM_FIXED_VALUE_TYPE(POINT3, Point3),
+  GTSAM_FIXED_VALUE_TYPE(ROT2, Rot2),
+  GTSAM_FIXED_VALUE_TYPE(ROT3, Rot3),
+  GTSAM_FIXED_VALUE_TYPE(POSE2, Pose2),
+  GTSAM_FIXED_VALUE_TYPE(POSE3, Pose3),
+  GTSAM_FIXED_VALUE_TYPE(CAL3_S2, Cal3_S2),
+  GTSAM_FIXED_VALUE_TYPE(CAL3_BUNDLER, Cal3Bundler),
+  GTSAM_FIXED_VALUE_TYPE(SFM_CAMERA, SfmCamera),
+  GTSAM_FIXED_VECTOR_TYPE(VECTOR2, 2),
+  GTSAM_FIXED_VECTOR_TYPE(VECTOR3, 3),
+  GTSAM_FIXED_VECTOR_TYPE(VECTOR6, 6)
+};
+
+#undef GTSAM_FIXED_VALUE_TYPE
+#undef GTSAM_FIXED_VECTOR_TYPE
+
+/* ************************************************************************* */
+// Noise models: uint32 count, then per noise model the uint32 length of its
+// record, and the record itself, see BinaryCodec.h.
+class NoiseModelWriter {
+  unordered_map<const noiseModel::Base*, uint32_t> indices_;
+  vector<const noiseModel::Base*> models_;
+
+public:
+  /// Index of a noise model, which is added if not seen before
+  uint32_t add(const noiseModel::Base* model) {
+    if (!model)
+      return kNoNoiseModel;
+    auto inserted = indices_.emplace(model,
+        static_cast<uint32_t>(models_.size()));
+    if (inserted.second)
+      models_.push_back(model);
+    return inserted.first->second;
+  }
+
+  /// Index of a noise model that was added before
+  uint32_t index(const noiseModel::Base* model) const {
+    return model ? indices_.at(model) : kNoNoiseModel;
+  }
+
+  void write(BinaryWriter& writer) const {
+    writer.write(static_cast<uint32_t>(models_.size()));
+    vector<double> record;
+    for (const noiseModel::Base* model : models_) {
+      encodeNoiseModel(*model, record);
+      writer.write(static_cast<uint32_t>(record.size()));
+      writer.write(record.data(), record.size());
+    }
+  }
+};
+
+vector<SharedNoiseModel> readNoiseModels(BinaryReader& reader) {
+  const uint32_t n = reader.read<uint32_t>();
+  checkRemaining<uint32_t>(reader, n);
+  vector<SharedNoiseModel> models(n);
+  vector<double> record;
+  for (SharedNoiseModel& model : models) {
+    const uint32_t size = reader.read<uint32_t>();
+    checkRemaining<double>(reader, size);
+    record.resize(size);
+    reader.read(record.data(), size);
+    model = decodeNoiseModel(record.data(), size);
+  }
+  return models;
+}
+
+const SharedNoiseModel& noiseModelAt(const vector<SharedNoiseModel>& models,
+    uint32_t j) {
+  static const SharedNoiseModel none;
+  if (j == kNoNoiseModel)
+    return none;
+  if (j >= models.size())
+    throw invalid_argument("decodeBinary: invalid noise model index");
+  return models[j];
+}
+
+/* ************************************************************************* */
+// Nonlinear factors: a uint16 type, 0 for a null factor, and otherwise a
+// uint32 noise model index, the uint64 keys, and the doubles of the
+// measurement Codec.
+
+/// Factor types, which are never renumbered
+enum FactorTag {
+  NULL_FACTOR = 0,
+  PRIOR_POINT2, PRIOR_POINT3, PRIOR_ROT2, PRIOR_ROT3, PRIOR_POSE2, PRIOR_POSE3,
+  BETWEEN_POINT2, BETWEEN_POINT3, BETWEEN_ROT2, BETWEEN_ROT3, BETWEEN_POSE2,
+  BETWEEN_POSE3,
+  BEARING_RANGE_POSE2_POINT2,
+  GENERAL_SFM
+};
+
+template<class FACTOR>
+void encodeFactor(const NonlinearFactor& factor, BinaryWriter& writer) {
+  typedef FactorCodec<FACTOR> Codec;
+  const FACTOR& f = static_cast<const FACTOR&>(factor);
+  writer.write(f.keys().data(), Codec::arity);
+  double d[Codec::Measurement::width];
+  Codec::encode(f, d);
+  writer.write(d, Codec::Measurement::width);
+}
+
+template<class FACTOR>
+NonlinearFactor::shared_ptr decodeFactor(BinaryReader& reader,
+    const SharedNoiseModel& model) {
+  typedef FactorCodec<FACTOR> Codec;
+  uint64_t keys[Codec::arity];
+  reader.read(keys, Codec::arity);
+  double d[Codec::Measurement::width];
+  reader.read(d, Codec::Measurement::width);
+  return Codec::decode(keys, d, model);
+}
+
+struct FactorType {
+  uint16_t tag;
+  const type_info& type;
+  void (*encode)(const NonlinearFactor&, BinaryWriter&);
+  NonlinearFactor::shared_ptr (*decode)(BinaryReader&, const SharedNoiseModel&);
+};
+
+#define GTSAM_FACTOR_TYPE(TAG, FACTOR) \
+  { TAG, typeid(FACTOR), &encodeFactor<FACTOR>, &decodeFactor<FACTOR> }
+
+const FactorType kFactorTypes[] = {
+  GTSAM_FACTOR_TYPE(PRIOR_POINT2, PriorFactor<Point2>),
+  GTSAM_FACTOR_TYPE(PRIOR_POINT3, PriorFactor<Point3>),
+  GTSAM_FACTOR_TYPE(PRIOR_ROT2, PriorFactor<Rot2>),
+  GTSAM_FACTOR_TYPE(PRIOR_ROT3, PriorFactor<Rot3>),
+  GTSAM_FACTOR_TYPE(PRIOR_POSE2, PriorFactor<Pose2>),
+  GTSAM_FACTOR_TYPE(PRIOR_POSE3, PriorFactor<Pose3>),
+  GTSAM_FACTOR_TYPE(BETWEEN_POINT2, BetweenFactor<Point2>),
+  GTSAM_FACTOR_TYPE(BETWEEN_POINT3, BetweenFactor<Point3>),
+  GTSAM_FACTOR_TYPE(BETWEEN_ROT2, BetweenFactor<Rot2>),
+  GTSAM_FACTOR_TYPE(BETWEEN_ROT3, BetweenFactor<Rot3>),
+  GTSAM_FACTOR_TYPE(BETWEEN_POSE2, BetweenFactor<Pose2>),
+  GTSAM_FACTOR_TYPE(BETWEEN_POSE3, BetweenFactor<Pose3>),
+  GTSAM_FACTOR_TYPE(BEARING_RANGE_POSE2_POINT2, BearingRangeFactor2D),
+  GTSAM_FACTOR_TYPE(GENERAL_SFM, SfmFactor)
+};
+
+#undef GTSAM_FACTOR_TYPE
+
+/// Type of a value or factor, matched exactly, so derived types are refused
+template<class TYPE, size_t N, class T>
+const TYPE& findType(const TYPE (&types)[N], const T& object, const char* what) {
+  for (const TYPE& type : types)
+    if (type.type == typeid(object))
+      return type;
+  throw invalid_argument(string("encodeBinary: unsupported ") + what + " type "
+      + typeid(object).name());
+}
+
+template<class TYPE, size_t N>
+const TYPE& findType(const TYPE (&types)[N], uint16_t tag, const char* what) {
+  for (const TYPE& type : types)
+    if (type.tag == tag)
+      return type;
+  throw invalid_argument(string("decodeBinary: invalid ") + what + " type");
+}
+
+/* ************************************************************************* */
+// Gaussian factors: a uint16 type, 0 for a null factor, and otherwise the
+// uint32 number of keys, the uint64 keys, and the uint32 dimension of each.
+// Jacobians (and conditionals) continue with the uint32 number of frontals
+// (0 for a JacobianFactor), the uint64 number of rows, a uint32 noise model
+// index and the augmented matrix [A b], column by column. Hessians continue
+// with the upper triangle of the augmented information matrix, column by
+// column.
+enum GaussianFactorTag {
+  JACOBIAN = 1, HESSIAN, CONDITIONAL
+};
+
+void writeKeysAndDims(const GaussianFactor& factor, BinaryWriter& writer) {
+  writer.write(static_cast<uint32_t>(factor.size()));
+  writer.write(factor.keys().data(), factor.size());
+  for (auto it = factor.begin(); it != factor.end(); ++it)
+    writer.write(static_cast<uint32_t>(factor.getDim(it)));
+}
+
+/// Scratch space for decoding Gaussian factors, reused between factors
+struct GaussianFactorReader {
+  vector<uint32_t> dims;
+  const vector<SharedNoiseModel>& noiseModels;
+
+  explicit GaussianFactorReader(const vector<SharedNoiseModel>& models) :
+      noiseModels(models) {
+  }
+
+  KeyVector readKeysAndDims(BinaryReader& reader) {
+    const uint32_t n = reader.read<uint32_t>();
+    checkRemaining<uint64_t>(reader, n);
+    KeyVector keys(n);
+    reader.read(keys.data(), n);
+    dims.resize(n);
+    reader.read(dims.data(), n);
+    return keys;
+  }
+
+  GaussianFactor::shared_ptr read(BinaryReader& reader);
+};
+
+void writeGaussianFactor(const GaussianFactor::shared_ptr& factor,
+    const NoiseModelWriter& noiseModels, BinaryWriter& writer) {
+  if (!factor) {
+    writer.write(static_cast<uint16_t>(NULL_FACTOR));
+  } else if (const JacobianFactor* jacobian =
+      dynamic_cast<const JacobianFactor*>(factor.get())) {
+    const GaussianConditional* conditional =
+        dynamic_cast<const GaussianConditional*>(jacobian);
+    writer.write(static_cast<uint16_t>(conditional ? CONDITIONAL : JACOBIAN));
+    writeKeysAndDims(*jacobian, writer);
+    writer.write(static_cast<uint32_t>(conditional ? conditional->nrFrontals() : 0));
+    const VerticalBlockMatrix::constBlock Ab = jacobian->matrixObject().full();
+    writer.write(static_cast<uint64_t>(Ab.rows()));
+    writer.write(noiseModels.index(jacobian->get_model().get()));
+    if (Ab.rows() > 0)
+      for (DenseIndex j = 0; j < Ab.cols(); j++)
+        writer.write(Ab.col(j).data(), Ab.rows());
+  } else if (const HessianFactor* hessian =
+      dynamic_cast<const HessianFactor*>(factor.get())) {
+    writer.write(static_cast<uint16_t>(HESSIAN));
+    writeKeysAndDims(*hessian, writer);
+    const SymmetricBlockMatrix::constBlock info =
+        hessian->info().selfadjointView().nestedExpression();
+    for (DenseIndex j = 0; j < info.cols(); j++)
+      writer.write(info.col(j).data(), j + 1);
+  } else {
+    throw invalid_argument(string("encodeBinary: unsupported factor type ")
+        + typeid(*factor).name());
+  }
+}
+
+GaussianFactor::shared_ptr GaussianFactorReader::read(BinaryReader& reader) {
+  const uint16_t tag = reader.read<uint16_t>();
+  if (tag == NULL_FACTOR)
+    return GaussianFactor::shared_ptr();
+  if (tag != JACOBIAN && tag != HESSIAN && tag != CONDITIONAL)
+    throw invalid_argument("decodeBinary: invalid factor type");
+  KeyVector keys = readKeysAndDims(reader);
+  uint64_t cols = 1;
+  for (uint32_t dim : dims)
+    cols += dim;
+
+  if (tag == HESSIAN) {
+    // The first check bounds cols so that the triangle size does not overflow
+    checkRemaining<double>(reader, cols, (cols + 1) / 2);
+    checkRemaining<double>(reader, cols * (cols + 1) / 2);
+    SymmetricBlockMatrix info(dims, true);
+    SymmetricBlockMatrix::Block A = info.selfadjointView().nestedExpression();
+    for (DenseIndex j = 0; j < A.cols(); j++)
+      reader.read(A.col(j).data(), j + 1);
+    auto hessian = boost::make_shared<HessianFactor>();
+    hessian->keys() = std::move(keys);
+    hessian->info() = std::move(info);
+    return hessian;
+  }
+
+  const uint32_t nrFrontals = reader.read<uint32_t>();
+  const uint64_t rows = reader.read<uint64_t>();
+  const SharedNoiseModel& model = noiseModelAt(noiseModels,
+      reader.read<uint32_t>());
+  const SharedDiagonal diagonal =
+      boost::dynamic_pointer_cast<noiseModel::Diagonal>(model);
+  if (model && !diagonal)
+    throw invalid_argument("decodeBinary: invalid noise model for a Jacobian");
+  if (nrFrontals > keys.size() || (tag == JACOBIAN && nrFrontals != 0))
+    throw invalid_argument("decodeBinary: invalid number of frontals");
+  checkRemaining<double>(reader, rows, cols);
+  VerticalBlockMatrix Ab(dims, rows, true);
+  reader.read(Ab.matrix().data(), Ab.matrix().size());
+  if (tag == CONDITIONAL)
+    return boost::make_shared<GaussianConditional>(keys, nrFrontals, Ab,
+        diagonal);
+  if (diagonal && diagonal->dim() != rows)
+    throw InvalidNoiseModel(rows, diagonal->dim());
+  auto jacobian = boost::make_shared<JacobianFactor>();
+  jacobian->keys() = std::move(keys);
+  jacobian->matrixObject() = std::move(Ab);
+  jacobian->get_model() = diagonal;
+  return jacobian;
+}
+
+/// Add the noise models of Gaussian factors
+template<class FACTOR>
+void addNoiseModels(const FactorGraph<FACTOR>& graph,
+    NoiseModelWriter& noiseModels) {
+  for (const auto& factor : graph)
+    if (const JacobianFactor* jacobian =
+        dynamic_cast<const JacobianFactor*>(factor.get()))
+      noiseModels.add(jacobian->get_model().get());
+}
+
+GaussianConditional::shared_ptr readConditional(BinaryReader& reader,
+    GaussianFactorReader& factorReader) {
+  GaussianFactor::shared_ptr factor = factorReader.read(reader);
+  GaussianConditional::shared_ptr conditional =
+      boost::dynamic_pointer_cast<GaussianConditional>(factor);
+  if (factor && !conditional)
+    throw invalid_argument("decodeBinary: expected a GaussianConditional");
+  return conditional;
+}
+
+} // namespace
+
+/* ************************************************************************* */
+void encodeBinary(const Values& values, BinaryWriter& writer) {
+  writeHeader(writer, VALUES);
+  writer.write(static_cast<uint64_t>(values.size()));
+  for (const auto& key_value : values) {
+    const ValueType& type = findType(kValueTypes, key_value.value, "value");
+    writer.write(static_cast<uint64_t>(key_value.key));
+    writer.write(type.tag);
+    type.encode(key_value.value, writer);
+  }
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, Values& values) {
+  readHeader(reader, VALUES);
+  values.clear();
+  const uint64_t n = reader.read<uint64_t>();
+  for (uint64_t i = 0; i < n; i++) {
+    const Key key = reader.read<uint64_t>();
+    const uint16_t tag = reader.read<uint16_t>();
+    findType(kValueTypes, tag, "value").decode(reader, key, values);
+  }
+}
+
+/* ************************************************************************* */
+// NonlinearFactorGraph: the noise models, uint64 count, and the factors
+void encodeBinary(const NonlinearFactorGraph& graph, BinaryWriter& writer) {
+  NoiseModelWriter noiseModels;
+  vector<const FactorType*> types(graph.size());
+  for (size_t i = 0; i < graph.size(); i++) {
+    if (!graph[i])
+      continue;
+    types[i] = &findType(kFactorTypes, *graph[i], "factor");
+    noiseModels.add(static_cast<const NoiseModelFactor&>(*graph[i])
+        .noiseModel().get());
+  }
+
+  writeHeader(writer, NONLINEAR_FACTOR_GRAPH);
+  noiseModels.write(writer);
+  writer.write(static_cast<uint64_t>(graph.size()));
+  for (size_t i = 0; i < graph.size(); i++) {
+    if (!types[i]) {
+      writer.write(static_cast<uint16_t>(NULL_FACTOR));
+      continue;
+    }
+    const NoiseModelFactor& factor =
+        static_cast<const NoiseModelFactor&>(*graph[i]);
+    writer.write(types[i]->tag);
+    writer.write(noiseModels.index(factor.noiseModel().get()));
+    types[i]->encode(factor, writer);
+  }
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, NonlinearFactorGraph& graph) {
+  readHeader(reader, NONLINEAR_FACTOR_GRAPH);
+  const vector<SharedNoiseModel> noiseModels = readNoiseModels(reader);
+  const uint64_t n = reader.read<uint64_t>();
+  checkRemaining<uint16_t>(reader, n);
+  graph.resize(0);
+  graph.reserve(n);
+  for (uint64_t i = 0; i < n; i++) {
+    const uint16_t tag = reader.read<uint16_t>();
+    if (tag == NULL_FACTOR) {
+      graph.push_back(NonlinearFactor::shared_ptr());
+      continue;
+    }
+    const FactorType& type = findType(kFactorTypes, tag, "factor");
+    const SharedNoiseModel& model = noiseModelAt(noiseModels,
+        reader.read<uint32_t>());
+    graph.push_back(type.decode(reader, model));
+  }
+}
+
+/* ************************************************************************* */
+// VectorValues: uint64 count, the uint64 keys in increasing order, their
+// uint32 dimensions, and then all vectors as one contiguous array.
+void encodeBinary(const VectorValues& values, BinaryWriter& writer) {
+  vector<pair<Key, const Vector*> > sorted;
+  sorted.reserve(values.size());
+  for (const auto& key_value : values)
+    sorted.emplace_back(key_value.first, &key_value.second);
+  sort(sorted.begin(), sorted.end());
+
+  writeHeader(writer, VECTOR_VALUES);
+  writer.write(static_cast<uint64_t>(sorted.size()));
+  for (const auto& key_value : sorted)
+    writer.write(static_cast<uint64_t>(key_value.first));
+  for (const auto& key_value : sorted)
+    writer.write(static_cast<uint32_t>(key_value.second->size()));
+  for (const auto& key_value : sorted)
+    writer.write(key_value.second->data(), key_value.second->size());
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, VectorValues& values) {
+  readHeader(reader, VECTOR_VALUES);
+  const uint64_t n = reader.read<uint64_t>();
+  checkRemaining<uint64_t>(reader, n);
+  const uint64_t* keys = reinterpret_cast<const uint64_t*>(reader.position());
+  reader.skip(n * sizeof(uint64_t));
+  VectorValues::Dims dims;
+  uint64_t total = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t key;
+    memcpy(&key, keys + i, sizeof(key));
+    const uint32_t dim = reader.read<uint32_t>();
+    if (!dims.empty() && key <= dims.rbegin()->first)
+      throw invalid_argument("decodeBinary: VectorValues keys are not sorted");
+    dims.emplace_hint(dims.end(), key, dim);
+    total += dim;
+    checkRemaining<double>(reader, total);  // also keeps total from overflowing
+  }
+  checkRemaining<double>(reader, total);
+  Vector x(total);
+  reader.read(x.data(), total);
+  VectorValues(x, dims).swap(values);
+}
+
+/* ************************************************************************* */
+// GaussianFactorGraph: the noise models, uint64 count, and the factors
+void encodeBinary(const GaussianFactorGraph& graph, BinaryWriter& writer) {
+  NoiseModelWriter noiseModels;
+  addNoiseModels(graph, noiseModels);
+  writeHeader(writer, GAUSSIAN_FACTOR_GRAPH);
+  noiseModels.write(writer);
+  writer.write(static_cast<uint64_t>(graph.size()));
+  for (const auto& factor : graph)
+    writeGaussianFactor(factor, noiseModels, writer);
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, GaussianFactorGraph& graph) {
+  readHeader(reader, GAUSSIAN_FACTOR_GRAPH);
+  const vector<SharedNoiseModel> noiseModels = readNoiseModels(reader);
+  GaussianFactorReader factorReader(noiseModels);
+  const uint64_t n = reader.read<uint64_t>();
+  checkRemaining<uint16_t>(reader, n);
+  graph.resize(0);
+  graph.reserve(n);
+  for (uint64_t i = 0; i < n; i++)
+    graph.push_back(factorReader.read(reader));
+}
+
+/* ************************************************************************* */
+// GaussianBayesNet: the noise models, uint64 count, and the conditionals
+void encodeBinary(const GaussianBayesNet& bayesNet, BinaryWriter& writer) {
+  NoiseModelWriter noiseModels;
+  addNoiseModels(bayesNet, noiseModels);
+  writeHeader(writer, GAUSSIAN_BAYES_NET);
+  noiseModels.write(writer);
+  writer.write(static_cast<uint64_t>(bayesNet.size()));
+  for (const auto& conditional : bayesNet)
+    writeGaussianFactor(conditional, noiseModels, writer);
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, GaussianBayesNet& bayesNet) {
+  readHeader(reader, GAUSSIAN_BAYES_NET);
+  const vector<SharedNoiseModel> noiseModels = readNoiseModels(reader);
+  GaussianFactorReader factorReader(noiseModels);
+  const uint64_t n = reader.read<uint64_t>();
+  checkRemaining<uint16_t>(reader, n);
+  bayesNet.resize(0);
+  bayesNet.reserve(n);
+  for (uint64_t i = 0; i < n; i++)
+    bayesNet.push_back(readConditional(reader, factorReader));
+}
+
+/* ************************************************************************* */
+// GaussianBayesTree: the noise models, uint64 number of cliques, and the
+// cliques, parents first, each with the uint64 index of its parent clique and
+// its conditional.
+void encodeBinary(const GaussianBayesTree& bayesTree, BinaryWriter& writer) {
+  // Order the cliques depth-first, keeping the order of children
+  typedef GaussianBayesTree::sharedClique sharedClique;
+  vector<pair<sharedClique, uint64_t> > cliques; // with parent indices
+  vector<pair<sharedClique, uint64_t> > stack;
+  const auto& roots = bayesTree.roots();
+  for (auto root = roots.rbegin(); root != roots.rend(); ++root)
+    stack.emplace_back(*root, kNoParent);
+  while (!stack.empty()) {
+    cliques.push_back(stack.back());
+    stack.pop_back();
+    const auto& children = cliques.back().first->children;
+    for (auto child = children.rbegin(); child != children.rend(); ++child)
+      stack.emplace_back(*child, cliques.size() - 1);
+  }
+
+  NoiseModelWriter noiseModels;
+  for (const auto& clique : cliques)
+    noiseModels.add(clique.first->conditional()->get_model().get());
+  writeHeader(writer, GAUSSIAN_BAYES_TREE);
+  noiseModels.write(writer);
+  writer.write(static_cast<uint64_t>(cliques.size()));
+  for (const auto& clique : cliques) {
+    writer.write(clique.second);
+    writeGaussianFactor(clique.first->conditional(), noiseModels, writer);
+  }
+}
+
+/* ************************************************************************* */
+void decodeBinary(BinaryReader& reader, GaussianBayesTree& bayesTree) {
+  readHeader(reader, GAUSSIAN_BAYES_TREE);
+  const vector<SharedNoiseModel> noiseModels = readNoiseModels(reader);
+  GaussianFactorReader factorReader(noiseModels);
+  const uint64_t n = reader.read<uint64_t>();
+  checkRemaining<uint64_t>(reader, n);
+  bayesTree.clear();
+  vector<GaussianBayesTree::sharedClique> cliques(n);
+  for (uint64_t i = 0; i < n; i++) {
+    const uint64_t parent = reader.read<uint64_t>();
+    if (parent != kNoParent && parent >= i)
+      throw invalid_argument("decodeBinary: invalid parent clique");
+    GaussianConditional::shared_ptr conditional =
+        readConditional(reader, factorReader);
+    if (!conditional)
+      throw invalid_argument("decodeBinary: clique without conditional");
+    cliques[i] = boost::make_shared<GaussianBayesTreeClique>(conditional);
+    bayesTree.addClique(cliques[i], parent == kNoParent ?
+        GaussianBayesTree::sharedClique() : cliques[parent]);
+  }
+}
+
+} // namespace gtsam
@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BinarySerialization.h
+ * @brief   Compact binary serialization of graphs, values and Bayes trees,
+ *          without boost archives
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/linear/GaussianBayesNet.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/base/BinaryBuffer.h>
+
+#include <string>
+
+namespace gtsam {
+
+/**
+ * @defgroup BinarySerialization Binary serialization
+ *
+ * An alternative to the boost archives in serialization.h for the types that
+ * are shipped between processes most: every object is written as a small
+ * header, with a magic number, its type and the version of its schema,
+ * followed by plain numbers in native byte order. No type registration is
+ * needed, noise models shared by several factors are written once, and
+ * decoding reads straight from the buffer into the objects created, without
+ * intermediate copies.
+ *
+ * Values can be double, Vector, Vector2, Vector3, Vector6, Matrix, Point2,
+ * Point3, Rot2, Rot3, Pose2, Pose3, Cal3_S2, Cal3Bundler and SfmCamera.
+ * Nonlinear factors can be PriorFactor and BetweenFactor on Point2, Point3,
+ * Rot2, Rot3, Pose2 and Pose3, BearingRangeFactor<Pose2, Point2>, and
+ * GeneralSFMFactor<SfmCamera, Point3>, with noise models as in
+ * BinaryDataset.h. Gaussian factors can be JacobianFactor, HessianFactor and
+ * GaussianConditional. Null factors are preserved. Encoding anything else
+ * throws std::invalid_argument, and so does decoding a buffer that does not
+ * hold the expected object.
+ * @{
+ */
+
+GTSAM_EXPORT void encodeBinary(const Values& values, BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader, Values& values);
+
+GTSAM_EXPORT void encodeBinary(const NonlinearFactorGraph& graph,
+    BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader,
+    NonlinearFactorGraph& graph);
+
+GTSAM_EXPORT void encodeBinary(const VectorValues& values,
+    BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader, VectorValues& values);
+
+GTSAM_EXPORT void encodeBinary(const GaussianFactorGraph& graph,
+    BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader,
+    GaussianFactorGraph& graph);
+
+GTSAM_EXPORT void encodeBinary(const GaussianBayesNet& bayesNet,
+    BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader,
+    GaussianBayesNet& bayesNet);
+
+GTSAM_EXPORT void encodeBinary(const GaussianBayesTree& bayesTree,
+    BinaryWriter& writer);
+GTSAM_EXPORT void decodeBinary(BinaryReader& reader,
+    GaussianBayesTree& bayesTree);
+
+/// Serialize an object to a string, as serializeBinary in serialization.h
+template<class T>
+std::string serializeCompact(const T& object) {
+  BinaryWriter writer;
+  encodeBinary(object, writer);
+  return writer.buffer();
+}
+
+/// Deserialize an object from a string, replacing its contents
+template<class T>
+void deserializeCompact(const std::string& serialized, T& object) {
+  BinaryReader reader(serialized);
+  decodeBinary(reader, object);
+}
+
+/// @}
+
+} // namespace gtsam
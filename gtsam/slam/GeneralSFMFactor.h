@@ -152,23 +152,20 @@ public:
       // TODO warn if verbose output asked for
     }
 
-    // Whiten the system if needed
-    const SharedNoiseModel& noiseModel = this->noiseModel();
-    if (noiseModel && !noiseModel->isUnit()) {
-      // TODO: implement WhitenSystem for fixed size matrices and include
-      // above
-      H1 = noiseModel->Whiten(H1);
-      H2 = noiseModel->Whiten(H2);
-      b = noiseModel->Whiten(b);
-    }
-
     // Create new (unit) noiseModel, preserving constraints if applicable
+    const SharedNoiseModel& noiseModel = this->noiseModel();
     SharedDiagonal model;
     if (noiseModel && noiseModel->isConstrained()) {
       model = boost::static_pointer_cast<noiseModel::Constrained>(noiseModel)->unit();
     }
 
-    return boost::make_shared<BinaryJacobianFactor<2, DimC, DimL> >(key1, H1, key2, H2, b, model);
+    // Whiten the system in place if needed
+    boost::shared_ptr<BinaryJacobianFactor<2, DimC, DimL> > factor =
+        boost::make_shared<BinaryJacobianFactor<2, DimC, DimL> >(key1, H1, key2,
+            H2, b, model);
+    if (noiseModel && !noiseModel->isUnit())
+      noiseModel->WhitenSystem(factor->matrixObject());
+    return factor;
   }
 
   /** return the measured */
@@ -0,0 +1,275 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GraphChangeLog.cpp
+ * @brief   Append-only log of incremental graph changes, to stream the inputs
+ *          of ISAM2::update between processes
+ * @author  agent
+ */
+
+#include <gtsam/slam/GraphChangeLog.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+// A change log starts with a magic number and the version of its format,
+// followed by records, each a uint64 length and that many bytes. A record
+// holds the ISAM2UpdateParams, then the new factors and the new values, as
+// written by encodeBinary. In the parameters, optional fields are preceded
+// by a uint8 flag, and all containers by their uint64 size.
+namespace {
+
+const char kMagic[4] = { 'G', 'T', 'S', 'L' };
+const uint32_t kVersion = 1;
+
+template<class CONTAINER>
+void writeKeys(const CONTAINER& keys, BinaryWriter& writer) {
+  writer.write(static_cast<uint64_t>(keys.size()));
+  for (const auto& key : keys)
+    writer.write(static_cast<uint64_t>(key));
+}
+
+template<class CONTAINER>
+void readKeys(BinaryReader& reader, CONTAINER& keys) {
+  const uint64_t n = reader.read<uint64_t>();
+  if (n > reader.remaining() / sizeof(uint64_t))
+    throw invalid_argument("BinaryReader: unexpected end of buffer");
+  for (uint64_t i = 0; i < n; i++)
+    keys.insert(keys.end(), reader.read<uint64_t>());
+}
+
+/// Write whether an optional field is present, and return it
+template<class T>
+const T* writeFlag(const boost::optional<T>& field, BinaryWriter& writer) {
+  writer.write(static_cast<uint8_t>(field ? 1 : 0));
+  return field.get_ptr();
+}
+
+/// Read whether an optional field is present, and if so, make it empty
+template<class T>
+T* readFlag(BinaryReader& reader, boost::optional<T>& field) {
+  const uint8_t flag = reader.read<uint8_t>();
+  if (flag > 1)
+    throw invalid_argument("ChangeLogReader: invalid record");
+  if (flag)
+    field = T();
+  else
+    field = boost::none;
+  return field.get_ptr();
+}
+
+void encodeParams(const ISAM2UpdateParams& params, BinaryWriter& writer) {
+  writeKeys(params.removeFactorIndices, writer);
+  if (const FastMap<Key, int>* groups = writeFlag(params.constrainedKeys,
+      writer)) {
+    writer.write(static_cast<uint64_t>(groups->size()));
+    for (const auto& key_group : *groups) {
+      writer.write(static_cast<uint64_t>(key_group.first));
+      writer.write(static_cast<int32_t>(key_group.second));
+    }
+  }
+  if (const FastList<Key>* keys = writeFlag(params.noRelinKeys, writer))
+    writeKeys(*keys, writer);
+  if (const FastList<Key>* keys = writeFlag(params.extraReelimKeys, writer))
+    writeKeys(*keys, writer);
+  writer.write(static_cast<uint8_t>(params.force_relinearize));
+  if (const FastMap<FactorIndex, KeySet>* affected = writeFlag(
+      params.newAffectedKeys, writer)) {
+    writer.write(static_cast<uint64_t>(affected->size()));
+    for (const auto& index_keys : *affected) {
+      writer.write(static_cast<uint64_t>(index_keys.first));
+      writeKeys(index_keys.second, writer);
+    }
+  }
+  writer.write(static_cast<uint8_t>(params.forceFullSolve));
+  if (const FastMap<Key, double>* timestamps = writeFlag(
+      params.newKeyTimestamps, writer)) {
+    writer.write(static_cast<uint64_t>(timestamps->size()));
+    for (const auto& key_time : *timestamps) {
+      writer.write(static_cast<uint64_t>(key_time.first));
+      writer.write(key_time.second);
+    }
+  }
+}
+
+void decodeParams(BinaryReader& reader, ISAM2UpdateParams& params) {
+  params.removeFactorIndices.clear();
+  readKeys(reader, params.removeFactorIndices);
+  if (FastMap<Key, int>* groups = readFlag(reader, params.constrainedKeys)) {
+    const uint64_t n = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < n; i++) {
+      const Key key = reader.read<uint64_t>();
+      (*groups)[key] = reader.read<int32_t>();
+    }
+  }
+  if (FastList<Key>* keys = readFlag(reader, params.noRelinKeys))
+    readKeys(reader, *keys);
+  if (FastList<Key>* keys = readFlag(reader, params.extraReelimKeys))
+    readKeys(reader, *keys);
+  params.force_relinearize = reader.read<uint8_t>() != 0;
+  if (FastMap<FactorIndex, KeySet>* affected = readFlag(reader,
+      params.newAffectedKeys)) {
+    const uint64_t n = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < n; i++) {
+      const FactorIndex index = reader.read<uint64_t>();
+      readKeys(reader, (*affected)[index]);
+    }
+  }
+  params.forceFullSolve = reader.read<uint8_t>() != 0;
+  if (FastMap<Key, double>* timestamps = readFlag(reader,
+      params.newKeyTimestamps)) {
+    const uint64_t n = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < n; i++) {
+      const Key key = reader.read<uint64_t>();
+      (*timestamps)[key] = reader.read<double>();
+    }
+  }
+}
+
+/// Check the header of a change log, return false if there is none at all
+bool checkHeader(istream& is) {
+  char header[sizeof(kMagic) + sizeof(kVersion)];
+  is.read(header, sizeof(header));
+  if (is.gcount() == 0 && is.eof())
+    return false;
+  uint32_t version;
+  memcpy(&version, header + sizeof(kMagic), sizeof(version));
+  if (is.gcount() != sizeof(header)
+      || memcmp(header, kMagic, sizeof(kMagic)) != 0)
+    throw invalid_argument("ChangeLogReader: not a change log");
+  if (version == 0 || version > kVersion)
+    throw invalid_argument("ChangeLogReader: unsupported version");
+  return true;
+}
+
+} // namespace
+
+/* ************************************************************************* */
+ChangeLogWriter::ChangeLogWriter(ostream& os) :
+    os_(os), nrRecords_(0), nrBytes_(0) {
+  writeHeader();
+}
+
+/* ************************************************************************* */
+ChangeLogWriter::ChangeLogWriter(const string& filename, bool append) :
+    file_(new ofstream(filename.c_str(),
+        ios::binary | (append ? ios::app : ios::trunc))), os_(*file_),
+    nrRecords_(0), nrBytes_(0) {
+  if (!*file_)
+    throw runtime_error("ChangeLogWriter: can not open " + filename);
+  ifstream existing;
+  if (append)
+    existing.open(filename.c_str(), ios::binary);
+  if (!append || !checkHeader(existing))
+    writeHeader();
+}
+
+/* ************************************************************************* */
+ChangeLogWriter::~ChangeLogWriter() {
+}
+
+/* ************************************************************************* */
+void ChangeLogWriter::writeHeader() {
+  os_.write(kMagic, sizeof(kMagic));
+  os_.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+  os_.flush();
+  if (!os_)
+    throw runtime_error("ChangeLogWriter: could not write header");
+  nrBytes_ += sizeof(kMagic) + sizeof(kVersion);
+}
+
+/* ************************************************************************* */
+void ChangeLogWriter::write(const NonlinearFactorGraph& newFactors,
+    const Values& newTheta, const ISAM2UpdateParams& params) {
+  // Encode the whole record first, so a failure leaves the log untouched
+  record_.clear();
+  record_.write(uint64_t(0)); // length, filled in below
+  encodeParams(params, record_);
+  encodeBinary(newFactors, record_);
+  encodeBinary(newTheta, record_);
+  const uint64_t length = record_.size() - sizeof(uint64_t);
+  memcpy(&record_.buffer()[0], &length, sizeof(length));
+
+  os_.write(record_.buffer().data(), record_.size());
+  os_.flush();
+  if (!os_)
+    throw runtime_error("ChangeLogWriter: could not write record");
+  nrRecords_ += 1;
+  nrBytes_ += record_.size();
+}
+
+/* ************************************************************************* */
+ChangeLogReader::ChangeLogReader(istream& is) :
+    is_(is), nrRecords_(0) {
+  readHeader();
+}
+
+/* ************************************************************************* */
+ChangeLogReader::ChangeLogReader(const string& filename) :
+    file_(new ifstream(filename.c_str(), ios::binary)), is_(*file_),
+    nrRecords_(0) {
+  if (!*file_)
+    throw invalid_argument("ChangeLogReader: can not open " + filename);
+  readHeader();
+}
+
+/* ************************************************************************* */
+ChangeLogReader::~ChangeLogReader() {
+}
+
+/* ************************************************************************* */
+void ChangeLogReader::readHeader() {
+  if (!checkHeader(is_))
+    throw invalid_argument("ChangeLogReader: not a change log");
+}
+
+/* ************************************************************************* */
+bool ChangeLogReader::read(GraphChange& change) {
+  uint64_t length;
+  is_.read(reinterpret_cast<char*>(&length), sizeof(length));
+  if (is_.gcount() == 0 && is_.eof())
+    return false;
+  if (is_.gcount() != sizeof(length))
+    throw invalid_argument("ChangeLogReader: truncated record");
+  record_.resize(length);
+  is_.read(&record_[0], length);
+  if (static_cast<uint64_t>(is_.gcount()) != length)
+    throw invalid_argument("ChangeLogReader: truncated record");
+
+  BinaryReader reader(record_);
+  decodeParams(reader, change.params);
+  decodeBinary(reader, change.newFactors);
+  decodeBinary(reader, change.newTheta);
+  if (reader.remaining() != 0)
+    throw invalid_argument("ChangeLogReader: invalid record");
+  nrRecords_ += 1;
+  return true;
+}
+
+/* ************************************************************************* */
+size_t replayChangeLog(ChangeLogReader& reader, ISAM2& isam) {
+  GraphChange change;
+  size_t nrUpdates = 0;
+  while (reader.read(change)) {
+    isam.update(change.newFactors, change.newTheta, change.params);
+    nrUpdates += 1;
+  }
+  return nrUpdates;
+}
+
+} // namespace gtsam
@@ -0,0 +1,155 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GraphChangeLog.h
+ * @brief   Append-only log of incremental graph changes, to stream the inputs
+ *          of ISAM2::update between processes
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/slam/BinarySerialization.h>
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace gtsam {
+
+/**
+ * @defgroup GraphChangeLog Graph change logs
+ *
+ * A change log ships a growing graph from one process to another as a
+ * sequence of changes, rather than as the whole graph every time: every
+ * record holds the new factors, the initial estimates of new variables, and
+ * the indices of removed factors, i.e., exactly what is passed to one call of
+ * ISAM2::update, together with the rest of its ISAM2UpdateParams. Records are
+ * encoded with the compact binary serialization in BinarySerialization.h, so
+ * their size, and the time to write and read them, only depend on the size of
+ * the change.
+ *
+ * A log is a short header followed by records, each prefixed with its length,
+ * and is written to any output stream: a file, which can be appended to later,
+ * a named pipe, or the standard output of a process. A reader can follow the
+ * log as it is being written, and ISAM2 can be fed from it directly with
+ * replayChangeLog.
+ * @{
+ */
+
+/// One change to a graph, as passed to ISAM2::update
+struct GTSAM_EXPORT GraphChange {
+  NonlinearFactorGraph newFactors; ///< factors to add
+  Values newTheta; ///< initial estimates of the new variables
+  ISAM2UpdateParams params; ///< removed factor indices, and other parameters
+};
+
+/**
+ * Writes graph changes to a change log. Every record is flushed as soon as it
+ * is written, so a reader on the other end of a pipe sees it immediately.
+ */
+class GTSAM_EXPORT ChangeLogWriter {
+public:
+
+  /// Write a new change log to a stream, which must outlive the writer
+  explicit ChangeLogWriter(std::ostream& os);
+
+  /**
+   * Write to a file, or to a named pipe
+   * @param append Append to an existing log rather than overwriting it
+   * @throw std::runtime_error if the file can not be opened
+   * @throw std::invalid_argument if appending to a file that is not a log
+   */
+  explicit ChangeLogWriter(const std::string& filename, bool append = false);
+
+  ~ChangeLogWriter();
+
+  /**
+   * Append the arguments of one call to ISAM2::update
+   * @throw std::invalid_argument if a factor or value is not supported
+   * @throw std::runtime_error if the record can not be written
+   */
+  void write(const NonlinearFactorGraph& newFactors, const Values& newTheta,
+      const ISAM2UpdateParams& params = ISAM2UpdateParams());
+
+  /// Append a change
+  void write(const GraphChange& change) {
+    write(change.newFactors, change.newTheta, change.params);
+  }
+
+  /// Number of records written by this writer
+  size_t nrRecords() const { return nrRecords_; }
+
+  /// Number of bytes written by this writer, including the header
+  size_t nrBytes() const { return nrBytes_; }
+
+private:
+  std::unique_ptr<std::ofstream> file_; ///< only when writing to a file
+  std::ostream& os_;
+  BinaryWriter record_; ///< reused between records
+  size_t nrRecords_, nrBytes_;
+
+  void writeHeader();
+};
+
+/**
+ * Reads graph changes from a change log, one record at a time. Reading blocks
+ * until a whole record is available, so a log can be followed through a pipe
+ * while it is being written.
+ */
+class GTSAM_EXPORT ChangeLogReader {
+public:
+
+  /**
+   * Read a change log from a stream, which must outlive the reader
+   * @throw std::invalid_argument if the stream does not hold a change log
+   */
+  explicit ChangeLogReader(std::istream& is);
+
+  /**
+   * Read from a file, or from a named pipe
+   * @throw std::invalid_argument if the file can not be opened, or does not
+   * hold a change log
+   */
+  explicit ChangeLogReader(const std::string& filename);
+
+  ~ChangeLogReader();
+
+  /**
+   * Read the next change, replacing the contents of change
+   * @return false at the end of the log
+   * @throw std::invalid_argument if the record is truncated or not valid
+   */
+  bool read(GraphChange& change);
+
+  /// Number of records read so far
+  size_t nrRecords() const { return nrRecords_; }
+
+private:
+  std::unique_ptr<std::ifstream> file_; ///< only when reading from a file
+  std::istream& is_;
+  std::string record_; ///< reused between records
+  size_t nrRecords_;
+
+  void readHeader();
+};
+
+/**
+ * Feed all remaining changes in a log to ISAM2::update, in order
+ * @return the number of updates
+ */
+GTSAM_EXPORT size_t replayChangeLog(ChangeLogReader& reader, ISAM2& isam);
+
+/// @}
+
+} // namespace gtsam
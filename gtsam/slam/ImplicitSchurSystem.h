@@ -0,0 +1,241 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ImplicitSchurSystem.h
+ * @brief   PCG system that multiplies with all RegularImplicitSchurFactors at once
+ * @author  agent
+ */
+
+#pragma once
+
+#include <gtsam/slam/RegularImplicitSchurFactor.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/IterativeSolver.h>
+#include <gtsam/linear/PCGSolver.h>
+#include <gtsam/linear/Preconditioner.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * System for preconditionedConjugateGradient, like GaussianFactorGraphSystem,
+ * but the RegularImplicitSchurFactors in the graph are gathered into flat
+ * arrays once, with their point covariances as fixed-size matrices. The
+ * product y = F'*(F*x - E*P*E'*F*x) is then computed without VectorValues,
+ * in two parallel passes: first over points, which each project the errors of
+ * their own observations, and then over cameras, which each accumulate F'*e
+ * for their own observations, so no two threads write the same memory.
+ * All other factors, e.g., priors and LM damping, are multiplied as usual.
+ */
+template<class CAMERA>
+class ImplicitSchurSystem {
+
+public:
+
+  typedef RegularImplicitSchurFactor<CAMERA> Factor;
+
+private:
+
+  typedef typename CAMERA::Measurement Z;
+  static const int D = traits<CAMERA>::dimension; ///< Camera dimension
+  static const int ZDim = traits<Z>::dimension; ///< Measurement dimension
+
+  typedef Eigen::Matrix<double, ZDim, D> MatrixZD;
+  typedef Eigen::Matrix<double, ZDim, 3> MatrixZ3;
+  typedef Eigen::Matrix<double, ZDim, 1> VectorZ;
+  typedef Eigen::Matrix<double, D, 1> VectorD;
+
+  const Preconditioner& preconditioner_;
+  const KeyInfo& keyInfo_;
+  Vector b_; ///< -gradientAtZero of the whole graph, in keyInfo_ order
+  GaussianFactorGraph others_; ///< factors other than implicit Schur factors
+
+  // Observations, grouped by point: point j has [pointStart_[j], pointStart_[j+1])
+  std::vector<MatrixZD, Eigen::aligned_allocator<MatrixZD> > F_;
+  std::vector<MatrixZ3, Eigen::aligned_allocator<MatrixZ3> > E_;
+  std::vector<size_t> start_; ///< offset of the observing camera in x and y
+  std::vector<size_t> pointStart_;
+  std::vector<Matrix3, Eigen::aligned_allocator<Matrix3> > P_;
+
+  // Observations, grouped by camera: camera c has the observations
+  // cameraObservations_[cameraStart_[c], cameraStart_[c+1]), at cameraOffset_[c]
+  std::vector<size_t> cameraObservations_, cameraStart_, cameraOffset_;
+
+  /// Projected errors, one per observation
+  mutable std::vector<VectorZ, Eigen::aligned_allocator<VectorZ> > e_;
+
+public:
+
+  /// Gather the implicit Schur factors of gfg, laid out according to keyInfo
+  ImplicitSchurSystem(const GaussianFactorGraph& gfg,
+      const Preconditioner& preconditioner, const KeyInfo& keyInfo) :
+      preconditioner_(preconditioner), keyInfo_(keyInfo) {
+    b_ = -gfg.gradientAtZero().vector(keyInfo.ordering());
+
+    // Gather by point
+    std::map<size_t, std::vector<size_t> > byCamera;
+    pointStart_.push_back(0);
+    for (const GaussianFactor::shared_ptr& gf : gfg) {
+      const Factor* factor = dynamic_cast<const Factor*>(gf.get());
+      if (!factor || factor->E().cols() != 3) {
+        if (gf)
+          others_.push_back(gf);
+        continue;
+      }
+      for (size_t k = 0; k < factor->size(); ++k) {
+        const size_t start = keyInfo.at(factor->keys()[k]).start;
+        byCamera[start].push_back(F_.size());
+        F_.push_back(factor->FBlocks()[k]);
+        E_.push_back(factor->E().template block<ZDim, 3>(ZDim * k, 0));
+        start_.push_back(start);
+      }
+      pointStart_.push_back(F_.size());
+      P_.push_back(factor->getPointCovariance());
+    }
+    e_.resize(F_.size());
+
+    // Index by camera
+    cameraStart_.push_back(0);
+    for (const auto& camera : byCamera) {
+      cameraOffset_.push_back(camera.first);
+      cameraObservations_.insert(cameraObservations_.end(),
+          camera.second.begin(), camera.second.end());
+      cameraStart_.push_back(cameraObservations_.size());
+    }
+  }
+
+  /// Number of points, i.e., of implicit Schur factors
+  size_t nrPoints() const {
+    return P_.size();
+  }
+
+  /// Factors that are not implicit Schur factors
+  const GaussianFactorGraph& others() const {
+    return others_;
+  }
+
+  /// Compute r = b - A*x, with A the Hessian
+  void residual(const Vector& x, Vector& r) const {
+    getb(r);
+    Vector Ax = Vector::Zero(r.rows());
+    multiply(x, Ax);
+    r -= Ax;
+  }
+
+  /// Compute y = A*x, with A the Hessian
+  void multiply(const Vector& x, Vector& y) const {
+    y.setZero(keyInfo_.numCols());
+
+    parallelFor(nrPoints(), [&](size_t j) { projectPoint(j, x); });
+    parallelFor(cameraOffset_.size(), [&](size_t c) { accumulateCamera(c, y); });
+
+    if (!others_.empty()) {
+      const VectorValues vvX = buildVectorValues(x, keyInfo_);
+      VectorValues vvAtAx = keyInfo_.x0();
+      others_.multiplyHessianAdd(1.0, vvX, vvAtAx);
+      y += vvAtAx.vector(keyInfo_.ordering());
+    }
+  }
+
+  void leftPrecondition(const Vector& x, Vector& y) const {
+    preconditioner_.solve(x, y);
+  }
+  void rightPrecondition(const Vector& x, Vector& y) const {
+    preconditioner_.transposeSolve(x, y);
+  }
+  inline void scal(const double alpha, Vector& x) const {
+    x *= alpha;
+  }
+  inline double dot(const Vector& x, const Vector& y) const {
+    return x.dot(y);
+  }
+  inline void axpy(const double alpha, const Vector& x, Vector& y) const {
+    y += alpha * x;
+  }
+
+  /// Right-hand side b = F'*(I - E*P*E')*b, computed once on construction
+  void getb(Vector& b) const {
+    b = b_;
+  }
+
+private:
+
+  /// e_k = (I - E*P*E')*F*x for all observations k of point j
+  void projectPoint(size_t j, const Vector& x) const {
+    Vector3 d = Vector3::Zero();
+    for (size_t k = pointStart_[j]; k < pointStart_[j + 1]; ++k) {
+      e_[k].noalias() = F_[k] * x.segment<D>(start_[k]);
+      d.noalias() += E_[k].transpose() * e_[k];
+    }
+    const Vector3 Pd = P_[j] * d;
+    for (size_t k = pointStart_[j]; k < pointStart_[j + 1]; ++k)
+      e_[k].noalias() -= E_[k] * Pd;
+  }
+
+  /// y_c += F_k'*e_k for all observations k of camera c
+  void accumulateCamera(size_t c, Vector& y) const {
+    VectorD yc = VectorD::Zero();
+    for (size_t i = cameraStart_[c]; i < cameraStart_[c + 1]; ++i) {
+      const size_t k = cameraObservations_[i];
+      yc.noalias() += F_[k].transpose() * e_[k];
+    }
+    y.segment<D>(cameraOffset_[c]) += yc;
+  }
+};
+
+/**
+ * PCGSolver that uses an ImplicitSchurSystem instead of a
+ * GaussianFactorGraphSystem, for bundle adjustment with smart factors
+ * linearized as RegularImplicitSchurFactors.
+ */
+template<class CAMERA>
+class ImplicitSchurPCGSolver: public PCGSolver {
+public:
+
+  ImplicitSchurPCGSolver(const PCGSolverParameters& p) :
+      PCGSolver(p) {
+  }
+
+  using PCGSolver::optimize;
+
+  virtual VectorValues optimize(const GaussianFactorGraph& gfg,
+      const KeyInfo& keyInfo, const std::map<Key, Vector>& lambda,
+      const VectorValues& initial) {
+    /* build preconditioner */
+    preconditioner_->build(gfg, keyInfo, lambda);
+
+    /* apply pcg */
+    ImplicitSchurSystem<CAMERA> system(gfg, *preconditioner_, keyInfo);
+    Vector x0 = initial.vector(keyInfo.ordering());
+    const Vector sol = preconditionedConjugateGradient(system, x0, parameters_);
+
+    return buildVectorValues(sol, keyInfo);
+  }
+};
+
+/**
+ * Parameters for an ImplicitSchurPCGSolver. Set as the iterativeParams of a
+ * NonlinearOptimizer, they make it solve with an ImplicitSchurPCGSolver.
+ */
+template<class CAMERA>
+struct ImplicitSchurPCGSolverParameters: public PCGSolverParameters {
+  typedef PCGSolverParameters Base;
+  typedef boost::shared_ptr<ImplicitSchurPCGSolverParameters> shared_ptr;
+
+  virtual boost::shared_ptr<PCGSolver> createSolver() const {
+    return boost::make_shared<ImplicitSchurPCGSolver<CAMERA> >(*this);
+  }
+};
+
+} // namespace gtsam
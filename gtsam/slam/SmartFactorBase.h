@@ -29,6 +29,7 @@
 #include <gtsam/geometry/CameraSet.h>
 
 #include <boost/optional.hpp>
+#include <boost/serialization/version.hpp> // must precede optional.hpp in Boost 1.74
 #include <boost/serialization/optional.hpp>
 #include <boost/make_shared.hpp>
 #include <vector>
@@ -327,6 +328,33 @@ protected:
       F[i] = noiseModel_->Whiten(F[i]);
   }
 
+  /**
+   * Compute the whitened products CameraSet::SchurBlocks, one camera at a
+   * time, for the fused Schur complement: the same as computeJacobians and
+   * whitenJacobians, but without forming F and E. Does not call
+   * correctForMissingMeasurements.
+   */
+  void computeSchurBlocks(const Cameras& cameras, const Point3& point,
+      typename Cameras::template SchurBlocks<3>& blocks) const {
+    const size_t m = cameras.size();
+    const double invSigma = 1.0 / noiseModel_->sigma();
+    blocks.reset(m);
+    MatrixZD Fi;
+    Eigen::Matrix<double, ZDim, 3> Ei;
+    for (size_t i = 0; i < m; i++) {
+      const Z predicted = cameras[i].project2(point, Fi, Ei);
+      if (body_P_sensor_) {
+        const Pose3 w_Pose_body = cameras[i].pose() * body_P_sensor_->inverse();
+        Matrix J(6, 6);
+        w_Pose_body.compose(*body_P_sensor_, J);
+        Fi = Fi * J;
+      }
+      // As in computeJacobians, b = z - h(x_bar)
+      blocks.set(i, invSigma * Fi, invSigma * Ei,
+          -invSigma * traits<Z>::Local(measured_[i], predicted));
+    }
+  }
+
   /// Return Jacobians as RegularImplicitSchurFactor with raw access
   boost::shared_ptr<RegularImplicitSchurFactor<CAMERA> > //
   createRegularImplicitSchurFactor(const Cameras& cameras, const Point3& point,
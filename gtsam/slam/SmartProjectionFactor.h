@@ -199,7 +199,16 @@ public:
           Gs, gs, 0.0);
     }
 
-    // Jacobian could be 3D Point3 OR 2D Unit3, difference is E.cols().
+    // Triangulated point: fused Schur complement on fixed-size blocks, with
+    // scratch memory reused by all factors linearized on this thread
+    if (result_) {
+      static thread_local typename Cameras::template SchurBlocks<3> blocks;
+      Base::computeSchurBlocks(cameras, *result_, blocks);
+      return boost::make_shared<RegularHessianFactor<Base::Dim> >(this->keys_,
+          Cameras::SchurComplement(blocks, lambda, diagonalDamping));
+    }
+
+    // Point at infinity: Jacobian is with respect to a 2D Unit3.
     std::vector<typename Base::MatrixZD, Eigen::aligned_allocator<typename Base::MatrixZD> > Fblocks;
     Matrix E;
     Vector b;
@@ -28,6 +28,8 @@
 #include <gtsam/nonlinear/Values-inl.h>
 #include <gtsam/linear/Sampler.h>
 #include <gtsam/base/GenericValue.h>
+#include <gtsam/base/MappedFile.h>
+#include <gtsam/base/parallelFor.h>
 #include <gtsam/base/Lie.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/types.h>
@@ -38,17 +40,21 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 
 using namespace std;
 namespace fs = boost::filesystem;
 using namespace gtsam::symbol_shorthand;
 
-#define LINESIZE 81920
-
 namespace gtsam {
 
 /* ************************************************************************* */
@@ -108,12 +114,290 @@ GraphAndValues load2D(pair<string, SharedNoiseModel> dataset, int maxID,
       noiseFormat, kernelFunctionType);
 }
 
+/* ************************************************************************* */
+// The loaders below read a whole file at once, through a MappedFile, and split
+// it in chunks at line boundaries that are parsed in parallel. Fields are
+// parsed with a small tokenizer, which is much faster than iostreams.
+namespace {
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v'
+      || c == '\f';
+}
+
+inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+/// Powers of ten that are exactly representable as a double
+const double kPowersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+    1e21, 1e22 };
+
+/**
+ * Split a decimal number [b, e) in sign, mantissa, and base 10 exponent.
+ * Returns false if it is anything else, or has more than 19 significant
+ * digits, in which case the mantissa might not fit in 64 bits.
+ */
+bool decompose(const char* b, const char* e, bool& negative,
+    uint64_t& mantissa, int& exponent) {
+  const char* p = b;
+  negative = false;
+  if (p != e && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+  mantissa = 0;
+  exponent = 0;
+  int digits = 0;
+  bool any = false;
+  for (; p != e && isDigit(*p); ++p, any = true) {
+    if (mantissa || *p != '0') {
+      if (++digits > 19)
+        return false;
+      mantissa = 10 * mantissa + (*p - '0');
+    }
+  }
+  if (p != e && *p == '.') {
+    for (++p; p != e && isDigit(*p); ++p, any = true, --exponent) {
+      if (mantissa || *p != '0') {
+        if (++digits > 19)
+          return false;
+        mantissa = 10 * mantissa + (*p - '0');
+      }
+    }
+  }
+  if (!any)
+    return false;
+  if (p != e && (*p == 'e' || *p == 'E')) {
+    bool negativeExponent = false;
+    if (++p != e && (*p == '-' || *p == '+'))
+      negativeExponent = *p++ == '-';
+    if (p == e || !isDigit(*p))
+      return false;
+    int n = 0;
+    for (; p != e && isDigit(*p); ++p)
+      if (n < 10000)
+        n = 10 * n + (*p - '0');
+    exponent += negativeExponent ? -n : n;
+  }
+  return p == e;
+}
+
+/// Parse [b, e) with strtod or strtof, which has to consume all of it
+template<typename T>
+bool parseSlow(const char* b, const char* e, T& x,
+    T (*convert)(const char*, char**)) {
+  const string token(b, e);
+  char* end;
+  const T value = convert(token.c_str(), &end);
+  if (token.empty() || end != token.c_str() + token.size())
+    return false;
+  x = value;
+  return true;
+}
+
+/**
+ * Parse [b, e) as a double, correctly rounded like strtod. If mantissa and
+ * power of ten are both exact doubles, a single multiplication or division
+ * rounds correctly, which covers most numbers in datasets.
+ */
+bool parse(const char* b, const char* e, double& x) {
+  bool negative;
+  uint64_t mantissa;
+  int exponent;
+  if (decompose(b, e, negative, mantissa, exponent)
+      && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+    const double m = static_cast<double>(mantissa);
+    x = exponent < 0 ? m / kPowersOfTen[-exponent] : m * kPowersOfTen[exponent];
+    if (negative)
+      x = -x;
+    return true;
+  }
+  return parseSlow<double>(b, e, x, std::strtod);
+}
+
+/// Parse [b, e) as a float, correctly rounded like strtof
+bool parse(const char* b, const char* e, float& x) {
+  bool negative;
+  uint64_t mantissa;
+  int exponent;
+  if (decompose(b, e, negative, mantissa, exponent)
+      && mantissa <= (uint64_t(1) << 24) && exponent >= -10 && exponent <= 10) {
+    const float m = static_cast<float>(mantissa);
+    const float p = static_cast<float>(kPowersOfTen[std::abs(exponent)]);
+    x = exponent < 0 ? m / p : m * p;
+    if (negative)
+      x = -x;
+    return true;
+  }
+  return parseSlow<float>(b, e, x, std::strtof);
+}
+
+/// Parse [b, e) as an unsigned integer, e.g., an index or a Key
+template<typename UINT>
+typename std::enable_if<std::is_unsigned<UINT>::value, bool>::type parse(
+    const char* b, const char* e, UINT& x) {
+  if (b != e && *b == '+')
+    ++b;
+  if (b == e)
+    return false;
+  const UINT max = std::numeric_limits<UINT>::max();
+  UINT value = 0;
+  for (; b != e; ++b) {
+    if (!isDigit(*b))
+      return false;
+    const UINT digit = *b - '0';
+    if (value > (max - digit) / 10)
+      return false;  // does not fit in UINT
+    value = 10 * value + digit;
+  }
+  x = value;
+  return true;
+}
+
+/// Whitespace-separated fields in a range of text, e.g., a line
+class Fields {
+  const char* p_;
+  const char* end_;
+
+public:
+  Fields(const char* begin, const char* end) :
+      p_(begin), end_(end) {
+  }
+
+  /// Next field [b, e), or false if there are no more fields
+  bool next(const char*& b, const char*& e) {
+    while (p_ != end_ && isSpace(*p_))
+      ++p_;
+    if (p_ == end_)
+      return false;
+    b = p_;
+    while (p_ != end_ && !isSpace(*p_))
+      ++p_;
+    e = p_;
+    return true;
+  }
+
+  /// Whether there are no more fields
+  bool empty() {
+    while (p_ != end_ && isSpace(*p_))
+      ++p_;
+    return p_ == end_;
+  }
+
+  /// Parse the next field as a number
+  template<typename T>
+  bool read(T& x) {
+    const char *b, *e;
+    return next(b, e) && parse(b, e, x);
+  }
+
+  /// Parse the next fields as numbers, stopping at the first failure
+  template<typename T, typename ... Ts>
+  bool read(T& x, Ts&... xs) {
+    return read(x) && read(xs...);
+  }
+
+  /// Position after the last field read
+  const char* position() const {
+    return p_;
+  }
+};
+
+/// Call f(b, e) for every line [b, e) in [begin, end)
+template<class F>
+void forEachLine(const char* begin, const char* end, const F& f) {
+  while (begin < end) {
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n',
+        end - begin));
+    f(begin, newline ? newline : end);
+    if (!newline)
+      break;
+    begin = newline + 1;
+  }
+}
+
+typedef std::pair<const char*, const char*> TextRange;
+
+/// Split [begin, end) in chunks of about chunkSize bytes, at line boundaries
+vector<TextRange> splitLines(const char* begin, const char* end, size_t chunkSize) {
+  vector<TextRange> chunks;
+  while (begin < end) {
+    const char* stop = end;
+    if (static_cast<size_t>(end - begin) > chunkSize) {
+      const char* newline = static_cast<const char*>(std::memchr(
+          begin + chunkSize, '\n', end - begin - chunkSize));
+      if (newline)
+        stop = newline + 1;
+    }
+    chunks.emplace_back(begin, stop);
+    begin = stop;
+  }
+  return chunks;
+}
+
+/// Size of the chunks that are parsed in parallel
+const size_t kChunkSize = 1 << 18;
+
+/// Line types in 2D and 3D dataset files
+enum class Tag {
+  OTHER, VERTEX2, EDGE2, BEARING_RANGE, LANDMARK, VERTEX3, VERTEX3_QUAT,
+  EDGE3, EDGE3_QUAT
+};
+
+/// Read the tag at the start of a line
+Tag readTag(Fields& fields) {
+  const char *b, *e;
+  if (!fields.next(b, e))
+    return Tag::OTHER;
+  const string tag(b, e);
+  if (tag == "VERTEX2" || tag == "VERTEX_SE2" || tag == "VERTEX")
+    return Tag::VERTEX2;
+  if (tag == "EDGE2" || tag == "EDGE" || tag == "EDGE_SE2" || tag == "ODOMETRY")
+    return Tag::EDGE2;
+  if (tag == "BR")
+    return Tag::BEARING_RANGE;
+  if (tag == "LANDMARK")
+    return Tag::LANDMARK;
+  if (tag == "VERTEX3")
+    return Tag::VERTEX3;
+  if (tag == "VERTEX_SE3:QUAT")
+    return Tag::VERTEX3_QUAT;
+  if (tag == "EDGE3")
+    return Tag::EDGE3;
+  if (tag == "EDGE_SE3:QUAT")
+    return Tag::EDGE3_QUAT;
+  return Tag::OTHER;
+}
+
+} // namespace
+
+/* ************************************************************************* */
+// Wrap a noise model in a robust kernel, if asked
+static SharedNoiseModel robustify(const SharedNoiseModel& model,
+    KernelFunctionType kernelFunctionType) {
+  switch (kernelFunctionType) {
+  case KernelFunctionTypeNONE:
+    return model;
+    break;
+  case KernelFunctionTypeHUBER:
+    return noiseModel::Robust::Create(
+        noiseModel::mEstimator::Huber::Create(1.345), model);
+    break;
+  case KernelFunctionTypeTUKEY:
+    return noiseModel::Robust::Create(
+        noiseModel::mEstimator::Tukey::Create(4.6851), model);
+    break;
+  default:
+    throw invalid_argument("load2D: invalid kernel function type");
+  }
+}
+
 /* ************************************************************************* */
 // Read noise parameters and interpret them according to flags
-static SharedNoiseModel readNoiseModel(ifstream& is, bool smart,
+static SharedNoiseModel readNoiseModel(Fields& fields, bool smart,
     NoiseFormat noiseFormat, KernelFunctionType kernelFunctionType) {
-  double v1, v2, v3, v4, v5, v6;
-  is >> v1 >> v2 >> v3 >> v4 >> v5 >> v6;
+  double v1 = 0, v2 = 0, v3 = 0, v4 = 0, v5 = 0, v6 = 0;
+  fields.read(v1, v2, v3, v4, v5, v6);
 
   if (noiseFormat == NoiseFormatAUTO) {
     // Try to guess covariance matrix layout
@@ -174,21 +458,7 @@ static SharedNoiseModel readNoiseModel(ifstream& is, bool smart,
     throw invalid_argument("load2D: invalid noise format");
   }
 
-  switch (kernelFunctionType) {
-  case KernelFunctionTypeNONE:
-    return model;
-    break;
-  case KernelFunctionTypeHUBER:
-    return noiseModel::Robust::Create(
-        noiseModel::mEstimator::Huber::Create(1.345), model);
-    break;
-  case KernelFunctionTypeTUKEY:
-    return noiseModel::Robust::Create(
-        noiseModel::mEstimator::Tukey::Create(4.6851), model);
-    break;
-  default:
-    throw invalid_argument("load2D: invalid kernel function type");
-  }
+  return robustify(model, kernelFunctionType);
 }
 
 /* ************************************************************************* */
@@ -217,39 +487,117 @@ boost::optional<IndexedEdge> parseEdge(istream& is, const string& tag) {
   }
 }
 
+/* ************************************************************************* */
+namespace {
+
+/// A BETWEEN, BR or LANDMARK line in a 2D dataset file
+struct Measurement2D {
+  bool isBetween;
+  Key id1, id2;
+  Pose2 l1Xl2; ///< BETWEEN only
+  SharedNoiseModel model; ///< noise model in file, BETWEEN only
+  std::exception_ptr error; ///< thrown when reading the noise model
+  double bearing, range, bearingStd, rangeStd; ///< BR and LANDMARK only
+  bool nonUniform; ///< LANDMARK with a non-uniform covariance
+};
+
+/// Vertices and measurements in a chunk of a 2D dataset file, in file order
+struct Chunk2D {
+  vector<IndexedPose> poses;
+  vector<Measurement2D> measurements;
+};
+
+} // namespace
+
+/* ************************************************************************* */
+static void parse2D(const TextRange& range, bool smart, NoiseFormat noiseFormat,
+    KernelFunctionType kernelFunctionType, Chunk2D& chunk) {
+  forEachLine(range.first, range.second, [&](const char* b, const char* e) {
+    Fields fields(b, e);
+    const Tag tag = readTag(fields);
+    Measurement2D m;
+    if (tag == Tag::VERTEX2) {
+      Key id;
+      double x, y, yaw;
+      if (fields.read(id, x, y, yaw))
+        chunk.poses.emplace_back(id, Pose2(x, y, yaw));
+    } else if (tag == Tag::EDGE2) {
+      double x, y, yaw;
+      if (!fields.read(m.id1, m.id2, x, y, yaw))
+        return;
+      m.isBetween = true;
+      m.l1Xl2 = Pose2(x, y, yaw);
+      try {
+        m.model = readNoiseModel(fields, smart, noiseFormat, kernelFunctionType);
+      } catch (...) {
+        m.error = std::current_exception();
+      }
+      chunk.measurements.push_back(m);
+    } else if (tag == Tag::BEARING_RANGE) {
+      if (!fields.read(m.id1, m.id2, m.bearing, m.range, m.bearingStd,
+          m.rangeStd))
+        return;
+      m.isBetween = false;
+      m.nonUniform = false;
+      chunk.measurements.push_back(m);
+    } else if (tag == Tag::LANDMARK) {
+      // A landmark measurement, TODO Frank says: don't know why is converted to bearing-range
+      double lmx, lmy;
+      double v1, v2, v3;
+      if (!fields.read(m.id1, m.id2, lmx, lmy, v1, v2, v3))
+        return;
+      m.isBetween = false;
+
+      // Convert x,y to bearing,range
+      m.bearing = atan2(lmy, lmx);
+      m.range = sqrt(lmx * lmx + lmy * lmy);
+
+      // In our experience, the x-y covariance on landmark sightings is not very good, so assume
+      // it describes the uncertainty at a range of 10m, and convert that to bearing/range uncertainty.
+      m.nonUniform = !(std::abs(v1 - v3) < 1e-4);
+      if (!m.nonUniform) {
+        m.bearingStd = sqrt(v1 / 10.0);
+        m.rangeStd = sqrt(v1);
+      } else {
+        m.bearingStd = 1;
+        m.rangeStd = 1;
+      }
+      chunk.measurements.push_back(m);
+    }
+  });
+}
+
 /* ************************************************************************* */
 GraphAndValues load2D(const string& filename, SharedNoiseModel model, Key maxID,
     bool addNoise, bool smart, NoiseFormat noiseFormat,
     KernelFunctionType kernelFunctionType) {
 
-  ifstream is(filename.c_str());
-  if (!is)
+  const MappedFile file(filename);
+  if (!file.valid())
     throw invalid_argument("load2D: can not find file " + filename);
 
+  // Parse chunks of lines in parallel, including the noise models in file
+  const vector<TextRange> ranges = splitLines(file.begin(), file.end(), kChunkSize);
+  vector<Chunk2D> chunks(ranges.size());
+  parallelFor(ranges.size(), [&](size_t i) {
+    parse2D(ranges[i], smart, noiseFormat, kernelFunctionType, chunks[i]);
+  });
+
   Values::shared_ptr initial(new Values);
   NonlinearFactorGraph::shared_ptr graph(new NonlinearFactorGraph);
 
-  string tag;
-
   // load the poses
-  while (!is.eof()) {
-    if (!(is >> tag))
-      break;
-
-    const auto indexed_pose = parseVertex(is, tag);
-    if (indexed_pose) {
-      Key id = indexed_pose->first;
+  for (const Chunk2D& chunk : chunks) {
+    for (const IndexedPose& indexed_pose : chunk.poses) {
+      Key id = indexed_pose.first;
 
       // optional filter
       if (maxID && id >= maxID)
         continue;
 
-      initial->insert(id, indexed_pose->second);
+      initial->insert(id, indexed_pose.second);
     }
-    is.ignore(LINESIZE, '\n');
   }
-  is.clear(); /* clears the end-of-file and error flags */
-  is.seekg(0, ios::beg);
 
   // If asked, create a sampler with random number generator
   Sampler sampler;
@@ -264,82 +612,46 @@ GraphAndValues load2D(const string& filename, SharedNoiseModel model, Key maxID,
     sampler = Sampler(noise);
   }
 
-  // Parse the pose constraints
-  Key id1, id2;
+  // Add the measurements in file order, as sampling noise is sequential
   bool haveLandmark = false;
   const bool useModelInFile = !model;
-  while (!is.eof()) {
-    if (!(is >> tag))
-      break;
-
-    auto between_pose = parseEdge(is, tag);
-    if (between_pose) {
-      std::tie(id1, id2) = between_pose->first;
-      Pose2& l1Xl2 = between_pose->second;
-
-      // read noise model
-      SharedNoiseModel modelInFile = readNoiseModel(is, smart, noiseFormat,
-          kernelFunctionType);
-
-      // optional filter
-      if (maxID && (id1 >= maxID || id2 >= maxID))
+  for (const Chunk2D& chunk : chunks) {
+    for (const Measurement2D& m : chunk.measurements) {
+      const Key id1 = m.id1, id2 = m.id2;
+      if (m.isBetween) {
+        if (m.error)
+          std::rethrow_exception(m.error);
+
+        // optional filter
+        if (maxID && (id1 >= maxID || id2 >= maxID))
+          continue;
+
+        if (useModelInFile)
+          model = m.model;
+
+        Pose2 l1Xl2 = m.l1Xl2;
+        if (addNoise)
+          l1Xl2 = l1Xl2.retract(sampler.sample());
+
+        // Insert vertices if pure odometry file
+        if (!initial->exists(id1))
+          initial->insert(id1, Pose2());
+        if (!initial->exists(id2))
+          initial->insert(id2, initial->at<Pose2>(id1) * l1Xl2);
+
+        NonlinearFactor::shared_ptr factor(
+            new BetweenFactor<Pose2>(id1, id2, l1Xl2, model));
+        graph->push_back(factor);
         continue;
-
-      if (useModelInFile)
-        model = modelInFile;
-
-      if (addNoise)
-        l1Xl2 = l1Xl2.retract(sampler.sample());
-
-      // Insert vertices if pure odometry file
-      if (!initial->exists(id1))
-        initial->insert(id1, Pose2());
-      if (!initial->exists(id2))
-        initial->insert(id2, initial->at<Pose2>(id1) * l1Xl2);
-
-      NonlinearFactor::shared_ptr factor(
-          new BetweenFactor<Pose2>(id1, id2, l1Xl2, model));
-      graph->push_back(factor);
-    }
-    // Parse measurements
-    double bearing, range, bearing_std, range_std;
-
-    // A bearing-range measurement
-    if (tag == "BR") {
-      is >> id1 >> id2 >> bearing >> range >> bearing_std >> range_std;
-    }
-
-    // A landmark measurement, TODO Frank says: don't know why is converted to bearing-range
-    if (tag == "LANDMARK") {
-      double lmx, lmy;
-      double v1, v2, v3;
-
-      is >> id1 >> id2 >> lmx >> lmy >> v1 >> v2 >> v3;
-
-      // Convert x,y to bearing,range
-      bearing = atan2(lmy, lmx);
-      range = sqrt(lmx * lmx + lmy * lmy);
-
-      // In our experience, the x-y covariance on landmark sightings is not very good, so assume
-      // it describes the uncertainty at a range of 10m, and convert that to bearing/range uncertainty.
-      if (std::abs(v1 - v3) < 1e-4) {
-        bearing_std = sqrt(v1 / 10.0);
-        range_std = sqrt(v1);
-      } else {
-        bearing_std = 1;
-        range_std = 1;
-        if (!haveLandmark) {
-          cout
-              << "Warning: load2D is a very simple dataset loader and is ignoring the\n"
-                  "non-uniform covariance on LANDMARK measurements in this file."
-              << endl;
-          haveLandmark = true;
-        }
       }
-    }
 
-    // Do some common stuff for bearing-range measurements
-    if (tag == "LANDMARK" || tag == "BR") {
+      if (m.nonUniform && !haveLandmark) {
+        cout
+            << "Warning: load2D is a very simple dataset loader and is ignoring the\n"
+                "non-uniform covariance on LANDMARK measurements in this file."
+            << endl;
+        haveLandmark = true;
+      }
 
       // optional filter
       if (maxID && id1 >= maxID)
@@ -347,23 +659,22 @@ GraphAndValues load2D(const string& filename, SharedNoiseModel model, Key maxID,
 
       // Create noise model
       noiseModel::Diagonal::shared_ptr measurementNoise =
-          noiseModel::Diagonal::Sigmas((Vector(2) << bearing_std, range_std).finished());
+          noiseModel::Diagonal::Sigmas((Vector(2) << m.bearingStd, m.rangeStd).finished());
 
       // Add to graph
-      *graph += BearingRangeFactor<Pose2, Point2>(id1, L(id2), bearing, range,
-          measurementNoise);
+      *graph += BearingRangeFactor<Pose2, Point2>(id1, L(id2), m.bearing,
+          m.range, measurementNoise);
 
       // Insert poses or points if they do not exist yet
       if (!initial->exists(id1))
         initial->insert(id1, Pose2());
       if (!initial->exists(L(id2))) {
         Pose2 pose = initial->at<Pose2>(id1);
-        Point2 local(cos(bearing) * range, sin(bearing) * range);
+        Point2 local(cos(m.bearing) * m.range, sin(m.bearing) * m.range);
         Point2 global = pose.transformFrom(local);
         initial->insert(L(id2), global);
       }
     }
-    is.ignore(LINESIZE, '\n');
   }
 
   return make_pair(graph, initial);
@@ -510,105 +821,242 @@ void writeG2o(const NonlinearFactorGraph& graph, const Values& estimate,
   stream.close();
 }
 
+/* ************************************************************************* */
+// Parse "x y z roll pitch yaw", or "x y z qx qy qz qw" if quaternion
+static bool readPose3(Fields& fields, bool quaternion, Pose3& pose) {
+  double x, y, z;
+  if (!fields.read(x, y, z))
+    return false;
+  if (!quaternion) {
+    double roll, pitch, yaw;
+    if (!fields.read(roll, pitch, yaw))
+      return false;
+    pose = Pose3(Rot3::Ypr(yaw, pitch, roll), {x, y, z});
+  } else {
+    double qx, qy, qz, qw;
+    if (!fields.read(qx, qy, qz, qw))
+      return false;
+    pose = Pose3(Rot3::Quaternion(qw, qx, qy, qz), {x, y, z});
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+// Parse the rest of a VERTEX3 or VERTEX_SE3:QUAT line
+static bool readVertex3(Fields& fields, Tag tag, Key& id, Pose3& pose) {
+  return fields.read(id) && readPose3(fields, tag == Tag::VERTEX3_QUAT, pose);
+}
+
+/* ************************************************************************* */
+// Parse the rest of an EDGE3 or EDGE_SE3:QUAT line, or return null
+static BetweenFactor<Pose3>::shared_ptr readBetweenPose3(Fields& fields,
+    Tag tag, KernelFunctionType kernelFunctionType = KernelFunctionTypeNONE) {
+  BetweenFactor<Pose3>::shared_ptr factor;
+  Key id1, id2;
+  Pose3 l1Xl2;
+  if (!fields.read(id1, id2) || !readPose3(fields, tag == Tag::EDGE3_QUAT, l1Xl2))
+    return factor;
+
+  // Upper triangle of the information matrix, zero where missing
+  Matrix m = Matrix::Zero(6, 6);
+  for (size_t i = 0; i < 6; i++) {
+    for (size_t j = i; j < 6; j++) {
+      double mij = 0;
+      fields.read(mij);
+      m(i, j) = mij;
+      m(j, i) = mij;
+    }
+  }
+
+  SharedNoiseModel model;
+  if (tag == Tag::EDGE3) {
+    model = noiseModel::Gaussian::Information(m);
+  } else {
+    Matrix mgtsam(6, 6);
+
+    mgtsam.block<3, 3>(0, 0) = m.block<3, 3>(3, 3);  // cov rotation
+    mgtsam.block<3, 3>(3, 3) = m.block<3, 3>(0, 0);  // cov translation
+    mgtsam.block<3, 3>(0, 3) = m.block<3, 3>(0, 3);  // off diagonal
+    mgtsam.block<3, 3>(3, 0) = m.block<3, 3>(3, 0);  // off diagonal
+
+    model = noiseModel::Gaussian::Information(mgtsam);
+  }
+  factor.reset(new BetweenFactor<Pose3>(id1, id2, l1Xl2,
+      robustify(model, kernelFunctionType)));
+  return factor;
+}
+
+/* ************************************************************************* */
+namespace {
+
+/// Vertices and edges in a chunk of a 3D dataset file, in file order
+struct Chunk3D {
+  vector<pair<Key, Pose3> > poses;
+  vector<BetweenFactor<Pose3>::shared_ptr> factors;
+  std::exception_ptr error; ///< thrown when creating a noise model
+};
+
+} // namespace
+
+/* ************************************************************************* */
+// Parse chunks of a 3D dataset file in parallel, up to the first error in each
+static vector<Chunk3D> parse3D(const MappedFile& file, bool parsePoses,
+    bool parseFactors) {
+  const vector<TextRange> ranges = splitLines(file.begin(), file.end(), kChunkSize);
+  vector<Chunk3D> chunks(ranges.size());
+  parallelFor(ranges.size(), [&](size_t i) {
+    Chunk3D& chunk = chunks[i];
+    try {
+      forEachLine(ranges[i].first, ranges[i].second,
+          [&](const char* b, const char* e) {
+            Fields fields(b, e);
+            const Tag tag = readTag(fields);
+            if (parsePoses && (tag == Tag::VERTEX3 || tag == Tag::VERTEX3_QUAT)) {
+              Key id;
+              Pose3 pose;
+              if (readVertex3(fields, tag, id, pose))
+                chunk.poses.emplace_back(id, pose);
+            } else if (parseFactors
+                && (tag == Tag::EDGE3 || tag == Tag::EDGE3_QUAT)) {
+              const auto factor = readBetweenPose3(fields, tag);
+              if (factor)
+                chunk.factors.push_back(factor);
+            }
+          });
+    } catch (...) {
+      chunk.error = std::current_exception();
+    }
+  });
+  return chunks;
+}
+
 /* ************************************************************************* */
 std::map<Key, Pose3> parse3DPoses(const string& filename) {
-  ifstream is(filename.c_str());
-  if (!is)
+  const MappedFile file(filename);
+  if (!file.valid())
     throw invalid_argument("parse3DPoses: can not find file " + filename);
 
   std::map<Key, Pose3> poses;
-  while (!is.eof()) {
-    char buf[LINESIZE];
-    is.getline(buf, LINESIZE);
-    istringstream ls(buf);
-    string tag;
-    ls >> tag;
-
-    if (tag == "VERTEX3") {
-      Key id;
-      double x, y, z, roll, pitch, yaw;
-      ls >> id >> x >> y >> z >> roll >> pitch >> yaw;
-      poses.emplace(id, Pose3(Rot3::Ypr(yaw, pitch, roll), {x, y, z}));
-    }
-    if (tag == "VERTEX_SE3:QUAT") {
-      Key id;
-      double x, y, z, qx, qy, qz, qw;
-      ls >> id >> x >> y >> z >> qx >> qy >> qz >> qw;
-      poses.emplace(id, Pose3(Rot3::Quaternion(qw, qx, qy, qz), {x, y, z}));
-    }
+  for (const Chunk3D& chunk : parse3D(file, true, false)) {
+    for (const auto& key_pose : chunk.poses)
+      poses.emplace(key_pose.first, key_pose.second);
   }
   return poses;
 }
 
 /* ************************************************************************* */
 BetweenFactorPose3s parse3DFactors(const string& filename) {
-  ifstream is(filename.c_str());
-  if (!is) throw invalid_argument("parse3DFactors: can not find file " + filename);
+  const MappedFile file(filename);
+  if (!file.valid()) throw invalid_argument("parse3DFactors: can not find file " + filename);
 
   std::vector<BetweenFactor<Pose3>::shared_ptr> factors;
-  while (!is.eof()) {
-    char buf[LINESIZE];
-    is.getline(buf, LINESIZE);
-    istringstream ls(buf);
-    string tag;
-    ls >> tag;
-
-    if (tag == "EDGE3") {
-      Key id1, id2;
-      double x, y, z, roll, pitch, yaw;
-      ls >> id1 >> id2 >> x >> y >> z >> roll >> pitch >> yaw;
-      Matrix m(6, 6);
-      for (size_t i = 0; i < 6; i++)
-        for (size_t j = i; j < 6; j++) ls >> m(i, j);
-      SharedNoiseModel model = noiseModel::Gaussian::Information(m);
-      factors.emplace_back(new BetweenFactor<Pose3>(
-          id1, id2, Pose3(Rot3::Ypr(yaw, pitch, roll), {x, y, z}), model));
-    }
-    if (tag == "EDGE_SE3:QUAT") {
-      Key id1, id2;
-      double x, y, z, qx, qy, qz, qw;
-      ls >> id1 >> id2 >> x >> y >> z >> qx >> qy >> qz >> qw;
-      Matrix m(6, 6);
-      for (size_t i = 0; i < 6; i++) {
-        for (size_t j = i; j < 6; j++) {
-          double mij;
-          ls >> mij;
-          m(i, j) = mij;
-          m(j, i) = mij;
-        }
-      }
-      Matrix mgtsam(6, 6);
-
-      mgtsam.block<3, 3>(0, 0) = m.block<3, 3>(3, 3);  // cov rotation
-      mgtsam.block<3, 3>(3, 3) = m.block<3, 3>(0, 0);  // cov translation
-      mgtsam.block<3, 3>(0, 3) = m.block<3, 3>(0, 3);  // off diagonal
-      mgtsam.block<3, 3>(3, 0) = m.block<3, 3>(3, 0);  // off diagonal
-
-      SharedNoiseModel model = noiseModel::Gaussian::Information(mgtsam);
-      factors.emplace_back(new BetweenFactor<Pose3>(
-          id1, id2, Pose3(Rot3::Quaternion(qw, qx, qy, qz), {x, y, z}), model));
-    }
+  for (const Chunk3D& chunk : parse3D(file, false, true)) {
+    if (chunk.error)
+      std::rethrow_exception(chunk.error);
+    factors.insert(factors.end(), chunk.factors.begin(), chunk.factors.end());
   }
   return factors;
 }
 
 /* ************************************************************************* */
 GraphAndValues load3D(const string& filename) {
-  const auto factors = parse3DFactors(filename);
+  const MappedFile file(filename);
+  if (!file.valid())
+    throw invalid_argument("load3D: can not find file " + filename);
+
+  // Parse the file once, for both factors and poses
+  const vector<Chunk3D> chunks = parse3D(file, true, true);
   NonlinearFactorGraph::shared_ptr graph(new NonlinearFactorGraph);
-  for (const auto& factor : factors) {
-    graph->push_back(factor);
+  for (const Chunk3D& chunk : chunks) {
+    if (chunk.error)
+      std::rethrow_exception(chunk.error);
+    for (const auto& factor : chunk.factors) {
+      graph->push_back(factor);
+    }
   }
 
-  const auto poses = parse3DPoses(filename);
+  // The first pose with a given key wins
   Values::shared_ptr initial(new Values);
-  for (const auto& key_pose : poses) {
-    initial->insert(key_pose.first, key_pose.second);
+  for (const Chunk3D& chunk : chunks) {
+    for (const auto& key_pose : chunk.poses) {
+      if (!initial->exists(key_pose.first))
+        initial->insert(key_pose.first, key_pose.second);
+    }
   }
 
   return make_pair(graph, initial);
 }
 
+/* ************************************************************************* */
+namespace {
+
+/// A batch of streamG2o
+struct G2oBatch {
+  NonlinearFactorGraph graph;
+  Values values;
+  std::exception_ptr error; ///< thrown when creating a noise model
+};
+
+} // namespace
+
+/* ************************************************************************* */
+void streamG2o(const string& filename, const DatasetCallback& callback,
+    KernelFunctionType kernelFunctionType, size_t batchSize) {
+  const MappedFile file(filename);
+  if (!file.valid())
+    throw invalid_argument("streamG2o: can not find file " + filename);
+
+  // Parse a window of batches in parallel, then hand them over in file order
+  const vector<TextRange> ranges = splitLines(file.begin(), file.end(),
+      std::max<size_t>(batchSize, 1));
+  const size_t windowSize = 16;
+  for (size_t first = 0; first < ranges.size(); first += windowSize) {
+    vector<G2oBatch> window(std::min(windowSize, ranges.size() - first));
+    parallelFor(window.size(), [&](size_t i) {
+      G2oBatch& batch = window[i];
+      try {
+        forEachLine(ranges[first + i].first, ranges[first + i].second,
+            [&](const char* b, const char* e) {
+              Fields fields(b, e);
+              const Tag tag = readTag(fields);
+              if (tag == Tag::VERTEX2) {
+                Key id;
+                double x, y, yaw;
+                if (fields.read(id, x, y, yaw)
+                    && !batch.values.exists(id))
+                  batch.values.insert(id, Pose2(x, y, yaw));
+              } else if (tag == Tag::EDGE2) {
+                Key id1, id2;
+                double x, y, yaw;
+                if (fields.read(id1, id2, x, y, yaw))
+                  batch.graph.emplace_shared<BetweenFactor<Pose2> >(id1, id2,
+                      Pose2(x, y, yaw), readNoiseModel(fields, true,
+                          NoiseFormatG2O, kernelFunctionType));
+              } else if (tag == Tag::VERTEX3 || tag == Tag::VERTEX3_QUAT) {
+                Key id;
+                Pose3 pose;
+                if (readVertex3(fields, tag, id, pose)
+                    && !batch.values.exists(id))
+                  batch.values.insert(id, pose);
+              } else if (tag == Tag::EDGE3 || tag == Tag::EDGE3_QUAT) {
+                const auto factor = readBetweenPose3(fields, tag,
+                    kernelFunctionType);
+                if (factor)
+                  batch.graph.push_back(factor);
+              }
+            });
+      } catch (...) {
+        batch.error = std::current_exception();
+      }
+    });
+    for (const G2oBatch& batch : window) {
+      if (batch.error)
+        std::rethrow_exception(batch.error);
+      callback(batch.graph, batch.values);
+    }
+  }
+}
+
 /* ************************************************************************* */
 Rot3 openGLFixedRotation() { // this is due to different convention for cameras in gtsam and openGL
   /* R = [ 1   0   0
@@ -648,32 +1096,42 @@ Pose3 gtsam2openGL(const Pose3& PoseGTSAM) {
 /* ************************************************************************* */
 bool readBundler(const string& filename, SfmData &data) {
   // Load the data file
-  ifstream is(filename.c_str(), ifstream::in);
-  if (!is) {
+  const MappedFile file(filename);
+  if (!file.valid()) {
     cout << "Error in readBundler: can not find the file!!" << endl;
     return false;
   }
 
   // Ignore the first line
-  char aux[500];
-  is.getline(aux, 500);
+  const char* begin = static_cast<const char*>(std::memchr(file.begin(), '\n',
+      file.end() - file.begin()));
+  Fields is(begin ? begin + 1 : file.end(), file.end());
 
   // Get the number of camera poses and 3D points
   size_t nrPoses, nrPoints;
-  is >> nrPoses >> nrPoints;
+  if (!is.read(nrPoses, nrPoints)) {
+    cout << "Error in readBundler: can not read the header!!" << endl;
+    return false;
+  }
 
   // Get the information for the camera poses
   for (size_t i = 0; i < nrPoses; i++) {
     // Get the focal length and the radial distortion parameters
     float f, k1, k2;
-    is >> f >> k1 >> k2;
-    Cal3Bundler K(f, k1, k2);
 
     // Get the rotation matrix
     float r11, r12, r13;
     float r21, r22, r23;
     float r31, r32, r33;
-    is >> r11 >> r12 >> r13 >> r21 >> r22 >> r23 >> r31 >> r32 >> r33;
+
+    // Get the translation vector
+    float tx, ty, tz;
+    if (!is.read(f, k1, k2, r11, r12, r13, r21, r22, r23, r31, r32, r33, tx,
+        ty, tz)) {
+      cout << "Error in readBundler: can not read pose " << i << endl;
+      return false;
+    }
+    Cal3Bundler K(f, k1, k2);
 
     // Bundler-OpenGL rotation matrix
     Rot3 R(r11, r12, r13, r21, r22, r23, r31, r32, r33);
@@ -685,10 +1143,6 @@ bool readBundler(const string& filename, SfmData &data) {
       return false;
     }
 
-    // Get the translation vector
-    float tx, ty, tz;
-    is >> tx >> ty >> tz;
-
     Pose3 pose = openGL2gtsam(R, tx, ty, tz);
 
     data.cameras.emplace_back(pose, K);
@@ -699,28 +1153,28 @@ bool readBundler(const string& filename, SfmData &data) {
   for (size_t j = 0; j < nrPoints; j++) {
     SfmTrack track;
 
-    // Get the 3D position
+    // Get the 3D position, the color information, and the visibility information
     float x, y, z;
-    is >> x >> y >> z;
-    track.p = Point3(x, y, z);
-
-    // Get the color information
     float r, g, b;
-    is >> r >> g >> b;
+    size_t nvisible = 0;
+    if (!is.read(x, y, z, r, g, b, nvisible)) {
+      cout << "Error in readBundler: can not read point " << j << endl;
+      return false;
+    }
+    track.p = Point3(x, y, z);
     track.r = r / 255.f;
     track.g = g / 255.f;
     track.b = b / 255.f;
 
-    // Now get the visibility information
-    size_t nvisible = 0;
-    is >> nvisible;
-
     track.measurements.reserve(nvisible);
     track.siftIndices.reserve(nvisible);
     for (size_t k = 0; k < nvisible; k++) {
       size_t cam_idx = 0, point_idx = 0;
       float u, v;
-      is >> cam_idx >> point_idx >> u >> v;
+      if (!is.read(cam_idx, point_idx, u, v)) {
+        cout << "Error in readBundler: can not read point " << j << endl;
+        return false;
+      }
       track.measurements.emplace_back(cam_idx, Point2(u, -v));
       track.siftIndices.emplace_back(cam_idx, point_idx);
     }
@@ -728,49 +1182,107 @@ bool readBundler(const string& filename, SfmData &data) {
     data.tracks.push_back(track);
   }
 
-  is.close();
   return true;
 }
 
+/* ************************************************************************* */
+namespace {
+
+/// A line "i j u v" in a BAL file
+struct BALObservation {
+  size_t i, j;
+  float u, v;
+};
+
+} // namespace
+
 /* ************************************************************************* */
 bool readBAL(const string& filename, SfmData &data) {
   // Load the data file
-  ifstream is(filename.c_str(), ifstream::in);
-  if (!is) {
+  const MappedFile file(filename);
+  if (!file.valid()) {
     cout << "Error in readBAL: can not find the file!!" << endl;
     return false;
   }
+  Fields is(file.begin(), file.end());
 
   // Get the number of camera poses and 3D points
   size_t nrPoses, nrPoints, nrObservations;
-  is >> nrPoses >> nrPoints >> nrObservations;
+  if (!is.read(nrPoses, nrPoints, nrObservations)) {
+    cout << "Error in readBAL: can not read the header!!" << endl;
+    return false;
+  }
 
-  data.tracks.resize(nrPoints);
+  // An observation takes at least 7 characters and a point 5, so a header that
+  // promises more than the rest of the file can hold is rejected before
+  // anything is allocated for it
+  const size_t remaining = file.end() - is.position();
+  if (nrObservations > remaining / 7 || nrPoints > remaining / 5) {
+    cout << "Error in readBAL: the header does not match the file!!" << endl;
+    return false;
+  }
+
+  // The observations are normally on a line each, which we parse in parallel
+  vector<const char*> lines;
+  lines.reserve(nrObservations);
+  const char* p = is.position();
+  while (lines.size() < nrObservations) {
+    while (p != file.end() && isSpace(*p))
+      ++p;
+    if (p == file.end())
+      break;
+    lines.push_back(p);
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n',
+        file.end() - p));
+    p = newline ? newline + 1 : file.end();
+  }
+  vector<BALObservation> observations(nrObservations);
+  std::atomic<bool> oneObservationPerLine(lines.size() == nrObservations);
+  if (oneObservationPerLine) {
+    parallelFor(nrObservations, [&](size_t k) {
+      const char* end = k + 1 < nrObservations ? lines[k + 1] : p;
+      Fields line(lines[k], end);
+      BALObservation& o = observations[k];
+      if (!line.read(o.i, o.j, o.u, o.v) || !line.empty())
+        oneObservationPerLine = false;
+    });
+  }
+  if (oneObservationPerLine) {
+    is = Fields(p, file.end());
+  } else {
+    for (BALObservation& o : observations) {
+      if (!is.read(o.i, o.j, o.u, o.v)) {
+        cout << "Error in readBAL: can not read the observations!!" << endl;
+        return false;
+      }
+    }
+  }
 
   // Get the information for the observations
-  for (size_t k = 0; k < nrObservations; k++) {
-    size_t i = 0, j = 0;
-    float u, v;
-    is >> i >> j >> u >> v;
-    data.tracks[j].measurements.emplace_back(i, Point2(u, -v));
+  data.tracks.resize(nrPoints);
+  for (const BALObservation& o : observations) {
+    if (o.j >= nrPoints) {
+      cout << "Error in readBAL: invalid point " << o.j << endl;
+      return false;
+    }
+    data.tracks[o.j].measurements.emplace_back(o.i, Point2(o.u, -o.v));
   }
 
   // Get the information for the camera poses
   for (size_t i = 0; i < nrPoses; i++) {
-    // Get the Rodrigues vector
+    // Get the Rodrigues vector, the translation vector, and the focal length
+    // and the radial distortion parameters
     float wx, wy, wz;
-    is >> wx >> wy >> wz;
-    Rot3 R = Rot3::Rodrigues(wx, wy, wz); // BAL-OpenGL rotation matrix
-
-    // Get the translation vector
     float tx, ty, tz;
-    is >> tx >> ty >> tz;
+    float f, k1, k2;
+    if (!is.read(wx, wy, wz, tx, ty, tz, f, k1, k2)) {
+      cout << "Error in readBAL: can not read camera " << i << endl;
+      return false;
+    }
+    Rot3 R = Rot3::Rodrigues(wx, wy, wz); // BAL-OpenGL rotation matrix
 
     Pose3 pose = openGL2gtsam(R, tx, ty, tz);
 
-    // Get the focal length and the radial distortion parameters
-    float f, k1, k2;
-    is >> f >> k1 >> k2;
     Cal3Bundler K(f, k1, k2);
 
     data.cameras.emplace_back(pose, K);
@@ -780,7 +1292,10 @@ bool readBAL(const string& filename, SfmData &data) {
   for (size_t j = 0; j < nrPoints; j++) {
     // Get the 3D position
     float x, y, z;
-    is >> x >> y >> z;
+    if (!is.read(x, y, z)) {
+      cout << "Error in readBAL: can not read point " << j << endl;
+      return false;
+    }
     SfmTrack& track = data.tracks[j];
     track.p = Point3(x, y, z);
     track.r = 0.4f;
@@ -788,7 +1303,6 @@ bool readBAL(const string& filename, SfmData &data) {
     track.b = 0.4f;
   }
 
-  is.close();
   return true;
 }
 
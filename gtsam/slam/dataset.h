@@ -33,6 +33,7 @@
 #include <gtsam/base/types.h>
 
 #include <boost/smart_ptr/shared_ptr.hpp>
+#include <functional>
 #include <string>
 #include <utility> // for pair
 #include <vector>
@@ -147,6 +148,27 @@ GTSAM_EXPORT void save2D(const NonlinearFactorGraph& graph,
 GTSAM_EXPORT GraphAndValues readG2o(const std::string& g2oFile, const bool is3D = false,
     KernelFunctionType kernelFunctionType = KernelFunctionTypeNONE);
 
+/// Callback of streamG2o, called with the factors and values of every batch
+typedef std::function<void(const NonlinearFactorGraph&, const Values&)> DatasetCallback;
+
+/**
+ * @brief Stream a 2D or 3D g2o file in batches, rather than loading it at
+ * once. Batches of about batchSize bytes are parsed in parallel, a window of
+ * 16 at a time, and once a window is parsed its batches are handed to the
+ * callback in file order, so e.g. ISAM2 can be updated batch by batch without
+ * holding the whole graph in memory. Parsing does not overlap with the
+ * callback. Unlike readG2o, vertices are not created for pure odometry files,
+ * and the kernel applies to 3D edges as well.
+ * @param filename The name of the g2o file
+ * @param callback Called with the BetweenFactors and poses in every batch
+ * @param kernelFunctionType whether to wrap the noise model in a robust kernel
+ * @param batchSize Approximate size of a batch, in bytes
+ */
+GTSAM_EXPORT void streamG2o(const std::string& filename,
+    const DatasetCallback& callback,
+    KernelFunctionType kernelFunctionType = KernelFunctionTypeNONE,
+    size_t batchSize = 1 << 20);
+
 /**
  * @brief This function writes a g2o file from
  * NonlinearFactorGraph and a Values structure
@@ -0,0 +1,203 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testBinaryDataset.cpp
+ * @brief   Unit tests for BinaryDataset.cpp
+ * @author  agent
+ */
+
+#include <gtsam/slam/BinaryDataset.h>
+#include <gtsam/slam/BinaryCodec.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+using namespace gtsam;
+
+static const string binaryFile = "testBinaryDataset.bin";
+
+/* ************************************************************************* */
+// Write a graph and values, and check that reading them back gives the same
+static bool roundTrips(const NonlinearFactorGraph& graph,
+    const Values& values) {
+  writeBinaryGraph(graph, values, binaryFile);
+  NonlinearFactorGraph::shared_ptr actualGraph;
+  Values::shared_ptr actualValues;
+  boost::tie(actualGraph, actualValues) = readBinaryGraph(binaryFile);
+  return assert_equal(graph, *actualGraph, 1e-9)
+      && assert_equal(values, *actualValues, 1e-9);
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, readG2o) {
+  const string g2oFile = findExampleDataFile("pose2example");
+  GraphAndValues expected = readG2o(g2oFile);
+  EXPECT(roundTrips(*expected.first, *expected.second));
+
+  // Writing the binary file back to g2o gives the original graph
+  const GraphAndValues actual = readBinaryGraph(binaryFile);
+  const string g2oRewritten = "testBinaryDataset.g2o";
+  writeG2o(*actual.first, *actual.second, g2oRewritten);
+  GraphAndValues rewritten = readG2o(g2oRewritten);
+  EXPECT(assert_equal(*expected.first, *rewritten.first, 1e-5));
+  EXPECT(assert_equal(*expected.second, *rewritten.second, 1e-5));
+  remove(g2oRewritten.c_str());
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, readG2oHuber) {
+  const string g2oFile = findExampleDataFile("pose2example");
+  GraphAndValues expected = readG2o(g2oFile, false, KernelFunctionTypeHUBER);
+  const SharedNoiseModel unit = noiseModel::Unit::Create(3);
+  expected.first->emplace_shared<PriorFactor<Pose2> >(0, Pose2(), unit);
+  expected.first->push_back(NonlinearFactor::shared_ptr());
+  expected.first->emplace_shared<PriorFactor<Pose2> >(1, Pose2(), unit);
+  EXPECT(roundTrips(*expected.first, *expected.second));
+
+  // Noise models are shared as in the written graph
+  const NonlinearFactorGraph actual = BinaryGraphFile(binaryFile).graph();
+  const size_t n = actual.size();
+  auto f0 = boost::dynamic_pointer_cast<NoiseModelFactor>(actual[n - 3]);
+  auto f1 = boost::dynamic_pointer_cast<NoiseModelFactor>(actual[n - 1]);
+  CHECK(f0 && f1 && !actual[n - 2]);
+  EXPECT(f0->noiseModel() == f1->noiseModel());
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, readG2o3D) {
+  for (const string& name : { "pose3example", "pose3example-offdiagonal" }) {
+    GraphAndValues expected = readG2o(findExampleDataFile(name), true);
+    expected.first->emplace_shared<PriorFactor<Pose3> >(0,
+        expected.second->at<Pose3>(0), noiseModel::Isotropic::Sigma(6, 0.1));
+    EXPECT(roundTrips(*expected.first, *expected.second));
+  }
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, load2DVictoriaPark) {
+  GraphAndValues expected = load2D(findExampleDataFile("victoria_park.txt"));
+  EXPECT(roundTrips(*expected.first, *expected.second));
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, readBAL) {
+  SfmData expected;
+  CHECK(readBAL(findExampleDataFile("dubrovnik-3-7-pre"), expected));
+  expected.tracks[0].siftIndices.emplace_back(1, 2);
+  writeBinarySfm(expected, binaryFile);
+
+  SfmData actual;
+  CHECK(readBinarySfm(binaryFile, actual));
+  CHECK_EQUAL(expected.number_cameras(), actual.number_cameras());
+  CHECK_EQUAL(expected.number_tracks(), actual.number_tracks());
+  for (size_t i = 0; i < expected.number_cameras(); i++)
+    EXPECT(assert_equal(expected.cameras[i], actual.cameras[i], 1e-9));
+  for (size_t j = 0; j < expected.number_tracks(); j++) {
+    const SfmTrack& e = expected.tracks[j];
+    const SfmTrack& a = actual.tracks[j];
+    EXPECT(assert_equal(e.p, a.p, 1e-9));
+    EXPECT(e.r == a.r && e.g == a.g && e.b == a.b);
+    CHECK_EQUAL(e.number_measurements(), a.number_measurements());
+    for (size_t k = 0; k < e.number_measurements(); k++) {
+      EXPECT_LONGS_EQUAL(e.measurements[k].first, a.measurements[k].first);
+      EXPECT(assert_equal(e.measurements[k].second, a.measurements[k].second));
+    }
+    EXPECT(e.siftIndices == a.siftIndices);
+  }
+
+  // The SfM graph and initial estimate round-trip as well
+  NonlinearFactorGraph graph;
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(2, 1.0);
+  for (size_t j = 0; j < expected.number_tracks(); j++)
+    for (const SfmMeasurement& m : expected.tracks[j].measurements)
+      graph.emplace_shared<GeneralSFMFactor<SfmCamera, Point3> >(m.second,
+          model, m.first, expected.number_cameras() + j);
+  EXPECT(roundTrips(graph, initialCamerasAndPointsEstimate(expected)));
+
+  // A graph file is not SfM data
+  SfmData none;
+  EXPECT(!readBinarySfm(binaryFile, none));
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, BinaryGraphFile) {
+  GraphAndValues expected = readG2o(findExampleDataFile("pose3example"), true);
+  writeBinaryGraph(*expected.first, *expected.second, binaryFile);
+
+  const BinaryGraphFile file(binaryFile);
+  CHECK_EQUAL(expected.first->size(), file.nrFactors());
+  CHECK_EQUAL(expected.second->size(), file.nrValues());
+  for (size_t i = file.nrFactors(); i-- > 0;)
+    EXPECT(assert_equal(*expected.first->at(i), *file.factor(i), 1e-9));
+  CHECK_EXCEPTION(file.factor(file.nrFactors()), std::out_of_range);
+  remove(binaryFile.c_str());
+}
+
+/* ************************************************************************* */
+TEST(BinaryDataset, invalid) {
+  CHECK_EXCEPTION(BinaryGraphFile("/not/a/file"), std::invalid_argument);
+  CHECK_EXCEPTION(BinaryGraphFile(findExampleDataFile("pose2example")),
+      std::invalid_argument);
+
+  // Unsupported factors are not written
+  NonlinearFactorGraph graph;
+  graph.emplace_shared<PriorFactor<Point2> >(0, Point2(0, 0),
+      noiseModel::Unit::Create(2));
+  CHECK_EXCEPTION(writeBinaryGraph(graph, Values(), binaryFile),
+      std::invalid_argument);
+
+  // A truncated file is rejected
+  GraphAndValues expected = readG2o(findExampleDataFile("pose2example"));
+  writeBinaryGraph(*expected.first, *expected.second, binaryFile);
+  string contents;
+  {
+    ifstream is(binaryFile.c_str(), ios::binary);
+    contents.assign(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+  }
+  ofstream(binaryFile.c_str(), ios::binary).write(contents.data(),
+      contents.size() - 8);
+  CHECK_EXCEPTION(readBinaryGraph(binaryFile), std::invalid_argument);
+  remove(binaryFile.c_str());
+
+  // Noise model records with a corrupt dimension are rejected
+  const SharedNoiseModel model = noiseModel::Gaussian::SqrtInformation(
+      (Matrix2() << 2, 1, 0, 3).finished());
+  vector<double> record;
+  internal::encodeNoiseModel(*model, record);
+  EXPECT(model->equals(
+      *internal::decodeNoiseModel(record.data(), record.size())));
+  for (double dim : {3.0, -1.0, 1.5, 1e300, numeric_limits<double>::quiet_NaN()}) {
+    record[1] = dim;
+    CHECK_EXCEPTION(internal::decodeNoiseModel(record.data(), record.size()),
+        std::invalid_argument);
+  }
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
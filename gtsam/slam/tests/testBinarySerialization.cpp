@@ -0,0 +1,201 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testBinarySerialization.cpp
+ * @brief   Unit tests for BinarySerialization.cpp
+ * @author  agent
+ */
+
+#include <gtsam/slam/BinarySerialization.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/sam/BearingRangeFactor.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// Serialize and deserialize, and check that the result is the same
+template<class T>
+static bool roundTrips(const T& expected) {
+  T actual;
+  deserializeCompact(serializeCompact(expected), actual);
+  return assert_equal(expected, actual, 1e-9);
+}
+
+/* ************************************************************************* */
+// A small planar SLAM graph, with shared, robust and constrained noise models
+static NonlinearFactorGraph planarSLAMGraph() {
+  const SharedNoiseModel odometry = noiseModel::Diagonal::Sigmas(
+      Vector3(0.1, 0.1, 0.05));
+  const SharedNoiseModel measurement = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.345),
+      noiseModel::Isotropic::Sigma(2, 0.2));
+  NonlinearFactorGraph graph;
+  graph.emplace_shared<PriorFactor<Pose2> >(X(0), Pose2(),
+      noiseModel::Constrained::All(3));
+  graph.emplace_shared<BetweenFactor<Pose2> >(X(0), X(1), Pose2(2, 0, 0),
+      odometry);
+  graph.emplace_shared<BetweenFactor<Pose2> >(X(1), X(2), Pose2(2, 0, 0),
+      odometry);
+  graph.push_back(NonlinearFactor::shared_ptr());
+  graph.emplace_shared<BearingRangeFactor<Pose2, Point2> >(X(0), L(1),
+      Rot2::fromDegrees(45), sqrt(8.0), measurement);
+  graph.emplace_shared<BearingRangeFactor<Pose2, Point2> >(X(2), L(1),
+      Rot2::fromDegrees(90), 2.0, measurement);
+  return graph;
+}
+
+static Values planarSLAMValues() {
+  Values values;
+  values.insert(X(0), Pose2(0.1, -0.1, 0.05));
+  values.insert(X(1), Pose2(2.1, 0.1, -0.05));
+  values.insert(X(2), Pose2(3.9, 0.2, 0.1));
+  values.insert(L(1), Point2(2.1, 2.1));
+  return values;
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, Values) {
+  Values values = planarSLAMValues();
+  values.insert(1, 3.5);
+  values.insert(2, Vector3(1, 2, 3));
+  values.insert(10, Vector(Vector3(4, 5, 6)));
+  values.insert(3, (Matrix(2, 3) << 1, 2, 3, 4, 5, 6).finished());
+  values.insert(4, Point3(1, 2, 3));
+  values.insert(5, Rot3::Ypr(0.1, 0.2, 0.3));
+  values.insert(6, Pose3(Rot3::Ypr(0.3, 0.2, 0.1), Point3(4, 5, 6)));
+  values.insert(7, Cal3_S2(500, 510, 0.1, 320, 240));
+  values.insert(8, Cal3Bundler(500, 1e-3, 1e-5, 320, 240));
+  values.insert(9, SfmCamera(Pose3(), Cal3Bundler(400, 0, 0, 0, 0)));
+  EXPECT(roundTrips(values));
+  EXPECT(roundTrips(Values()));
+
+  // Deserializing replaces the contents
+  Values actual = values;
+  deserializeCompact(serializeCompact(planarSLAMValues()), actual);
+  EXPECT(assert_equal(planarSLAMValues(), actual));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, NonlinearFactorGraph) {
+  const NonlinearFactorGraph graph = planarSLAMGraph();
+  EXPECT(roundTrips(graph));
+  EXPECT(roundTrips(NonlinearFactorGraph()));
+
+  // Shared noise models stay shared
+  NonlinearFactorGraph actual;
+  deserializeCompact(serializeCompact(graph), actual);
+  EXPECT(!actual[3]);
+  const auto noiseModelOf = [&](size_t i) {
+    return boost::static_pointer_cast<NoiseModelFactor>(actual[i])->noiseModel();
+  };
+  EXPECT(noiseModelOf(1) == noiseModelOf(2));
+  EXPECT(noiseModelOf(4) == noiseModelOf(5));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, GeneralSFMFactor) {
+  NonlinearFactorGraph graph;
+  graph.emplace_shared<PriorFactor<Point3> >(L(1), Point3(1, 2, 3),
+      noiseModel::Isotropic::Sigma(3, 0.1));
+  graph.emplace_shared<GeneralSFMFactor<SfmCamera, Point3> >(Point2(10, 20),
+      noiseModel::Unit::Create(2), X(1), L(1));
+  graph.emplace_shared<BetweenFactor<Rot3> >(X(1), X(2),
+      Rot3::Ypr(0.1, 0.2, 0.3), noiseModel::Unit::Create(3));
+  graph.emplace_shared<PriorFactor<Pose3> >(X(1), Pose3(),
+      noiseModel::Gaussian::Covariance(Matrix::Identity(6, 6)));
+  EXPECT(roundTrips(graph));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, GaussianFactorGraph) {
+  GaussianFactorGraph graph = *planarSLAMGraph().linearize(planarSLAMValues());
+  graph.push_back(GaussianFactor::shared_ptr());
+  graph.emplace_shared<HessianFactor>(X(1), X(2), 2 * I_3x3, I_3x3,
+      Vector3(1, 2, 3), 4 * I_3x3, Vector3(4, 5, 6), 7.0);
+  graph.emplace_shared<JacobianFactor>(L(1), 3 * I_2x2, Vector2(1, 2));
+  EXPECT(roundTrips(graph));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, VectorValues) {
+  VectorValues values;
+  values.insert(X(2), Vector3(1, 2, 3));
+  values.insert(L(1), Vector2(4, 5));
+  values.insert(X(0), Vector1::Constant(6));
+  EXPECT(roundTrips(values));
+  EXPECT(roundTrips(VectorValues()));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, BayesNetAndTree) {
+  const GaussianFactorGraph graph =
+      *planarSLAMGraph().linearize(planarSLAMValues());
+  const Ordering ordering = Ordering::Colamd(graph);
+  EXPECT(roundTrips(*graph.eliminateSequential(ordering)));
+
+  const GaussianBayesTree bayesTree = *graph.eliminateMultifrontal(ordering);
+  EXPECT(roundTrips(bayesTree));
+  GaussianBayesTree actual;
+  deserializeCompact(serializeCompact(bayesTree), actual);
+  EXPECT(assert_equal(bayesTree.optimize(), actual.optimize()));
+}
+
+/* ************************************************************************* */
+TEST(BinarySerialization, invalid) {
+  // Unsupported factors
+  NonlinearFactorGraph graph;
+  graph.emplace_shared<PriorFactor<Cal3_S2> >(1, Cal3_S2(),
+      noiseModel::Unit::Create(5));
+  CHECK_EXCEPTION(serializeCompact(graph), std::invalid_argument);
+
+  // A buffer holding another type, or truncated
+  const string serialized = serializeCompact(planarSLAMValues());
+  CHECK_EXCEPTION(deserializeCompact(serialized, graph), std::invalid_argument);
+  Values values;
+  CHECK_EXCEPTION(deserializeCompact(serialized.substr(0, 40), values),
+      std::invalid_argument);
+  CHECK_EXCEPTION(deserializeCompact(string("GTSC"), values),
+      std::invalid_argument);
+
+  // A Jacobian whose number of rows times columns overflows 64 bits
+  GaussianFactorGraph gfg;
+  gfg.emplace_shared<JacobianFactor>(1, Matrix::Identity(7, 2), Vector::Zero(7));
+  string corrupted = serializeCompact(gfg);
+  const uint64_t rows = 7, hugeRows = numeric_limits<uint64_t>::max() / 3 + 1;
+  const size_t offset = corrupted.find(string(
+      reinterpret_cast<const char*>(&rows), sizeof(rows)));
+  CHECK(offset != string::npos);
+  corrupted.replace(offset, sizeof(rows),
+      reinterpret_cast<const char*>(&hugeRows), sizeof(hugeRows));
+  GaussianFactorGraph actual;
+  CHECK_EXCEPTION(deserializeCompact(corrupted, actual), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -26,6 +26,7 @@
 
 #include <CppUnitLite/TestHarness.h>
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -328,6 +329,45 @@ TEST( dataSet, readG2oTukey)
   EXPECT(assert_equal(expectedGraph,*actualGraph,1e-5));
 }
 
+/* ************************************************************************* */
+TEST( dataSet, streamG2o)
+{
+  // Small batches, such that every batch holds a few lines only
+  for (bool is3D : {false, true}) {
+    const string g2oFile = findExampleDataFile(is3D ? "pose3example" : "pose2example");
+    NonlinearFactorGraph::shared_ptr expectedGraph;
+    Values::shared_ptr expectedValues;
+    boost::tie(expectedGraph, expectedValues) = readG2o(g2oFile, is3D);
+
+    NonlinearFactorGraph actualGraph;
+    Values actualValues;
+    size_t nrBatches = 0;
+    streamG2o(g2oFile, [&](const NonlinearFactorGraph& graph, const Values& values) {
+      actualGraph.push_back(graph);
+      actualValues.insert(values);
+      ++nrBatches;
+    }, KernelFunctionTypeNONE, 100);
+    EXPECT(nrBatches > 5);
+    EXPECT(assert_equal(*expectedGraph, actualGraph, 1e-9));
+    EXPECT(assert_equal(*expectedValues, actualValues, 1e-9));
+  }
+
+  // A single batch, with a robust kernel
+  const string g2oFile = findExampleDataFile("pose2example");
+  NonlinearFactorGraph::shared_ptr expectedGraph;
+  Values::shared_ptr expectedValues;
+  boost::tie(expectedGraph, expectedValues) = readG2o(g2oFile, false, KernelFunctionTypeHUBER);
+  size_t nrBatches = 0;
+  streamG2o(g2oFile, [&](const NonlinearFactorGraph& graph, const Values& values) {
+    EXPECT(assert_equal(*expectedGraph, graph, 1e-9));
+    EXPECT(assert_equal(*expectedValues, values, 1e-9));
+    ++nrBatches;
+  }, KernelFunctionTypeHUBER);
+  EXPECT_LONGS_EQUAL(1, nrBatches);
+
+  CHECK_EXCEPTION(streamG2o("no_such_file.g2o", DatasetCallback()), std::invalid_argument);
+}
+
 /* ************************************************************************* */
 TEST( dataSet, writeG2o)
 {
@@ -384,6 +424,20 @@ TEST( dataSet, writeG2o3DNonDiagonalNoise)
   EXPECT(assert_equal(*expectedGraph,*actualGraph,1e-4));
 }
 
+/* ************************************************************************* */
+TEST( dataSet, readBAL_corruptHeader)
+{
+  // A header promising far more observations than the file holds
+  const string filename = createRewrittenFileName(
+      findExampleDataFile("dubrovnik-3-7-pre"));
+  {
+    ofstream os(filename.c_str());
+    os << "3 7 1000000000000\n0 0 -385.98 387.12\n";
+  }
+  SfmData mydata;
+  EXPECT(!readBAL(filename, mydata));
+}
+
 /* ************************************************************************* */
 TEST( dataSet, readBAL_Dubrovnik)
 {
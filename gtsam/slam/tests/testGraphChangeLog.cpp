@@ -0,0 +1,178 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGraphChangeLog.cpp
+ * @brief   Unit tests for GraphChangeLog.cpp
+ * @author  agent
+ */
+
+#include <gtsam/slam/GraphChangeLog.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <cstdio>
+#include <sstream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+static const SharedNoiseModel odometryNoise =
+    noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+
+/* ************************************************************************* */
+// The changes of a small pose graph: a prior, then one pose per step, and a
+// loop closure that replaces the odometry factor with index 2
+static vector<GraphChange> poseGraphChanges() {
+  vector<GraphChange> changes(5);
+  changes[0].newFactors.emplace_shared<PriorFactor<Pose2> >(X(0), Pose2(),
+      noiseModel::Unit::Create(3));
+  changes[0].newTheta.insert(X(0), Pose2(0.01, 0.02, 0.03));
+  for (size_t i = 1; i < 4; i++) {
+    changes[i].newFactors.emplace_shared<BetweenFactor<Pose2> >(X(i - 1), X(i),
+        Pose2(1, 0, M_PI_2), odometryNoise);
+    changes[i].newTheta.insert(X(i), Pose2(0.1 * i, 1.0 * i, 0.5 * i));
+  }
+  changes[3].params.force_relinearize = true;
+  changes[3].params.noRelinKeys = FastList<Key>();
+  changes[3].params.noRelinKeys->push_back(X(0));
+  changes[4].newFactors.emplace_shared<BetweenFactor<Pose2> >(X(3), X(0),
+      Pose2(1, 0, M_PI_2), odometryNoise);
+  changes[4].newFactors.emplace_shared<BetweenFactor<Pose2> >(X(1), X(2),
+      Pose2(1.1, 0, M_PI_2), odometryNoise);
+  changes[4].params.removeFactorIndices = FactorIndices{2};
+  changes[4].params.constrainedKeys = FastMap<Key, int>();
+  (*changes[4].params.constrainedKeys)[X(3)] = 1;
+  return changes;
+}
+
+/* ************************************************************************* */
+static bool equal(const GraphChange& expected, const GraphChange& actual) {
+  const ISAM2UpdateParams &e = expected.params, &a = actual.params;
+  return assert_equal(expected.newFactors, actual.newFactors)
+      && assert_equal(expected.newTheta, actual.newTheta)
+      && e.removeFactorIndices == a.removeFactorIndices
+      && e.constrainedKeys == a.constrainedKeys
+      && e.noRelinKeys == a.noRelinKeys
+      && e.extraReelimKeys == a.extraReelimKeys
+      && e.force_relinearize == a.force_relinearize
+      && e.newAffectedKeys == a.newAffectedKeys
+      && e.forceFullSolve == a.forceFullSolve
+      && e.newKeyTimestamps == a.newKeyTimestamps;
+}
+
+/* ************************************************************************* */
+TEST(GraphChangeLog, stream) {
+  vector<GraphChange> expected = poseGraphChanges();
+  ISAM2UpdateParams& params = expected[2].params;
+  params.extraReelimKeys = FastList<Key>();
+  params.extraReelimKeys->push_back(X(0));
+  params.extraReelimKeys->push_back(X(1));
+  params.newAffectedKeys = FastMap<FactorIndex, KeySet>();
+  (*params.newAffectedKeys)[0].insert(X(1));
+  (*params.newAffectedKeys)[0].insert(X(2));
+  params.forceFullSolve = true;
+  params.newKeyTimestamps = FastMap<Key, double>();
+  (*params.newKeyTimestamps)[X(2)] = 0.25;
+
+  stringstream ss;
+  ChangeLogWriter writer(ss);
+  for (const GraphChange& change : expected)
+    writer.write(change);
+  EXPECT_LONGS_EQUAL(5, writer.nrRecords());
+  EXPECT_LONGS_EQUAL(ss.str().size(), writer.nrBytes());
+
+  // Records only hold the change: the last one does not grow with the graph
+  stringstream last;
+  ChangeLogWriter(last).write(expected[4]);
+  EXPECT(last.str().size() < ss.str().size() / 3);
+
+  ChangeLogReader reader(ss);
+  GraphChange actual;
+  for (const GraphChange& change : expected) {
+    CHECK(reader.read(actual));
+    EXPECT(equal(change, actual));
+  }
+  EXPECT(!reader.read(actual));
+  EXPECT_LONGS_EQUAL(5, reader.nrRecords());
+}
+
+/* ************************************************************************* */
+TEST(GraphChangeLog, replay) {
+  const vector<GraphChange> changes = poseGraphChanges();
+  ISAM2 expected;
+  stringstream ss;
+  ChangeLogWriter writer(ss);
+  for (const GraphChange& change : changes) {
+    expected.update(change.newFactors, change.newTheta, change.params);
+    writer.write(change);
+  }
+
+  ChangeLogReader reader(ss);
+  ISAM2 actual;
+  EXPECT_LONGS_EQUAL(5, replayChangeLog(reader, actual));
+  EXPECT(assert_equal(expected.calculateEstimate(),
+      actual.calculateEstimate()));
+  EXPECT(!actual.getFactorsUnsafe()[2]);
+}
+
+/* ************************************************************************* */
+TEST(GraphChangeLog, appendToFile) {
+  const string filename = "testGraphChangeLog.log";
+  const vector<GraphChange> changes = poseGraphChanges();
+  {
+    ChangeLogWriter writer(filename);
+    writer.write(changes[0]);
+    writer.write(changes[1]);
+  }
+  {
+    ChangeLogWriter writer(filename, true);
+    writer.write(changes[2]);
+  }
+
+  ChangeLogReader reader(filename);
+  GraphChange actual;
+  for (size_t i = 0; i < 3; i++) {
+    CHECK(reader.read(actual));
+    EXPECT(equal(changes[i], actual));
+  }
+  EXPECT(!reader.read(actual));
+  remove(filename.c_str());
+}
+
+/* ************************************************************************* */
+TEST(GraphChangeLog, invalid) {
+  stringstream text("EDGE2 0 1 0 0 0");
+  CHECK_EXCEPTION(ChangeLogReader reader(text), std::invalid_argument);
+  CHECK_EXCEPTION(ChangeLogReader reader("/nonexistent.log"),
+      std::invalid_argument);
+
+  // A record cut short, e.g., by a writer that died
+  stringstream ss;
+  ChangeLogWriter(ss).write(poseGraphChanges()[1]);
+  stringstream truncated(ss.str().substr(0, ss.str().size() - 10));
+  ChangeLogReader reader(truncated);
+  GraphChange change;
+  CHECK_EXCEPTION(reader.read(change), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -19,6 +19,11 @@
 #include <gtsam/slam/JacobianFactorQ.h>
 #include <gtsam/slam/JacobianFactorQR.h>
 #include <gtsam/slam/RegularImplicitSchurFactor.h>
+#include <gtsam/slam/ImplicitSchurSystem.h>
+#include <gtsam/slam/SmartProjectionPoseFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/geometry/Cal3_S2.h>
 #include <gtsam/geometry/CalibratedCamera.h>
 #include <gtsam/geometry/Point2.h>
 
@@ -278,6 +283,121 @@ TEST(regularImplicitSchurFactor, hessianDiagonal)
   EXPECT(assert_equal(actualBD[3],actualInfo2.block<6,6>(12,12)));
 }
 
+/* ************************************************************************* */
+TEST(regularImplicitSchurFactor, ImplicitSchurSystem) {
+  // Two points, seen in cameras {0,1,3} and {1,2,3}, and a prior on each camera
+  Matrix E = Matrix::Zero(6, 3);
+  E.block<2,2>(0, 0) = I_2x2;
+  E.block<2,3>(2, 0) = 2 * Matrix::Ones(2, 3);
+  E.block<2,2>(4, 1) = I_2x2;
+  Matrix E2 = E;
+  E2.block<2,1>(0, 2) << 1, -1;
+  GaussianFactorGraph gfg;
+  gfg.emplace_shared<RegularImplicitSchurFactor<CalibratedCamera> >(keys,
+      FBlocks, E, (E.transpose() * E).inverse(), b);
+  gfg.emplace_shared<RegularImplicitSchurFactor<CalibratedCamera> >(
+      KeyVector{1, 2, 3}, FBlocks, E2, (E2.transpose() * E2).inverse(),
+      Vector(-b));
+  for (Key j = 0; j < 4; j++)
+    gfg.emplace_shared<JacobianFactor>(j, (j + 1.0) * I_6x6,
+        Vector::Constant(6, 0.1 * j));
+
+  const KeyInfo keyInfo(gfg);
+  const std::map<Key, Vector> lambda;
+  DummyPreconditioner preconditioner;
+  const GaussianFactorGraphSystem expected(gfg, preconditioner, keyInfo, lambda);
+  const ImplicitSchurSystem<CalibratedCamera> actual(gfg, preconditioner,
+      keyInfo);
+  LONGS_EQUAL(2, actual.nrPoints());
+  LONGS_EQUAL(4, actual.others().size());
+
+  Vector expectedB(24), actualB(24);
+  expected.getb(expectedB);
+  actual.getb(actualB);
+  EXPECT(assert_equal(expectedB, actualB, 1e-9));
+
+  Vector x(24), expectedY(24), actualY(24);
+  for (size_t i = 0; i < 24; i++)
+    x(i) = std::sin(1.0 + i);
+  expected.multiply(x, expectedY);
+  actual.multiply(x, actualY);
+  EXPECT(assert_equal(expectedY, actualY, 1e-9));
+
+  // Solving with PCG gives the same result as with the default system
+  PCGSolverParameters parameters;
+  parameters.preconditioner_ =
+      boost::make_shared<DummyPreconditionerParameters>();
+  parameters.setEpsilon_abs(1e-12);
+  parameters.setEpsilon_rel(1e-12);
+  EXPECT(assert_equal(PCGSolver(parameters).optimize(gfg),
+      ImplicitSchurPCGSolver<CalibratedCamera>(parameters).optimize(gfg), 1e-6));
+}
+
+/* ************************************************************************* */
+typedef PinholePose<Cal3_S2> Camera;
+
+// Counts the solvers that a NonlinearOptimizer creates from these parameters
+struct CountingParameters: public ImplicitSchurPCGSolverParameters<Camera> {
+  mutable size_t nrSolvers = 0;
+  virtual boost::shared_ptr<PCGSolver> createSolver() const {
+    ++nrSolvers;
+    return ImplicitSchurPCGSolverParameters<Camera>::createSolver();
+  }
+};
+
+TEST(ImplicitSchurPCGSolver, LevenbergMarquardt) {
+  // Eight cameras on a circle, looking at the corners of a cube
+  Cal3_S2::shared_ptr K(new Cal3_S2(50.0, 50.0, 0.0, 50.0, 50.0));
+  vector<Pose3> poses;
+  for (size_t i = 0; i < 8; ++i) {
+    const double theta = 2 * M_PI * i / 8;
+    poses.push_back(PinholeBase::LookatPose(
+        Point3(30 * cos(theta), 30 * sin(theta), 0), Point3(), Point3(0, 0, 1)));
+  }
+  vector<Point3> points;
+  for (double x : {-10.0, 10.0})
+    for (double y : {-10.0, 10.0})
+      for (double z : {-10.0, 10.0})
+        points.push_back(Point3(x, y, z));
+
+  // Smart factors linearized as implicit Schur factors, and two priors
+  SmartProjectionParams smartParams;
+  smartParams.setLinearizationMode(IMPLICIT_SCHUR);
+  NonlinearFactorGraph graph;
+  for (const Point3& point : points) {
+    auto smart = boost::make_shared<SmartProjectionPoseFactor<Cal3_S2> >(
+        noiseModel::Isotropic::Sigma(2, 1.0), K, smartParams);
+    for (size_t i = 0; i < poses.size(); ++i)
+      smart->add(Camera(poses[i], K).project(point), i);
+    graph.push_back(smart);
+  }
+  const SharedNoiseModel priorNoise = noiseModel::Isotropic::Sigma(6, 0.1);
+  graph.emplace_shared<PriorFactor<Pose3> >(0, poses[0], priorNoise);
+  graph.emplace_shared<PriorFactor<Pose3> >(1, poses[1], priorNoise);
+
+  Values initial;
+  const Pose3 delta(Rot3::Rodrigues(-0.01, 0.02, 0.025), Point3(0.05, -0.1, 0.2));
+  for (size_t i = 0; i < poses.size(); ++i)
+    initial.insert(i, poses[i].compose(delta));
+
+  // LM with the implicit Schur PCG solver finds the cameras
+  LevenbergMarquardtParams params;
+  params.linearSolverType = NonlinearOptimizerParams::Iterative;
+  params.relativeErrorTol = 1e-10;
+  params.absoluteErrorTol = 1e-10;
+  auto pcg = boost::make_shared<CountingParameters>();
+  pcg->preconditioner_ =
+      boost::make_shared<BlockJacobiPreconditionerParameters>();
+  pcg->setEpsilon_abs(1e-10);
+  pcg->setEpsilon_rel(1e-10);
+  params.iterativeParams = pcg;
+  const Values actual = LevenbergMarquardtOptimizer(graph, initial, params).optimize();
+
+  EXPECT(pcg->nrSolvers > 0);
+  for (size_t i = 0; i < poses.size(); ++i)
+    EXPECT(assert_equal(poses[i], actual.at<Pose3>(i), 1e-4));
+}
+
 /* ************************************************************************* */
 int main(void) {
   TestResult tr;
@@ -30,6 +30,12 @@ namespace gtsam {
     const Ordering& order) :
   Base(factorGraph, structure, order) {}
 
+  /* ************************************************************************* */
+  SymbolicEliminationTree::SymbolicEliminationTree(
+    const SymbolicFactorGraph& factorGraph, const FlatVariableIndex& structure,
+    const Ordering& order) :
+  Base(factorGraph, structure, order) {}
+
   /* ************************************************************************* */
   SymbolicEliminationTree::SymbolicEliminationTree(
     const SymbolicFactorGraph& factorGraph, const Ordering& order) :
@@ -40,6 +40,11 @@ namespace gtsam {
     SymbolicEliminationTree(const SymbolicFactorGraph& factorGraph,
       const VariableIndex& structure, const Ordering& order);
 
+    /** Build the elimination tree of a factor graph using pre-computed column structure stored
+     *  in a FlatVariableIndex. */
+    SymbolicEliminationTree(const SymbolicFactorGraph& factorGraph,
+      const FlatVariableIndex& structure, const Ordering& order);
+
     /** Build the elimination tree of a factor graph.  Note that this has to compute the column
      *  structure as a VariableIndex, so if you already have this precomputed, use the other
      *  constructor instead.
@@ -0,0 +1,212 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testFlatVariableIndex.cpp
+ * @brief   Unit tests for FlatVariableIndex class
+ * @author  agent
+ */
+
+#include <gtsam/inference/FlatVariableIndex.h>
+#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/symbolic/SymbolicFactorGraph.h>
+#include <gtsam/symbolic/SymbolicEliminationTree.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/assign/std/list.hpp>
+using namespace boost::assign;
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Check that a FlatVariableIndex holds exactly what a VariableIndex holds
+static bool sameStructure(const VariableIndex& expected,
+    const FlatVariableIndex& actual) {
+  if (expected.size() != actual.size()
+      || expected.nEntries() != actual.nEntries()
+      || expected.nFactors() != actual.nFactors())
+    return false;
+  size_t j = 0;
+  for (const VariableIndex::value_type& key_factors : expected) {
+    const FlatVariableIndex::Factors factors = actual.column(j++);
+    if (actual.key(j - 1) != key_factors.first
+        || factors.size() != key_factors.second.size()
+        || !equal(factors.begin(), factors.end(), key_factors.second.begin()))
+      return false;
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+// Chain with loop closures, added with keys out of order
+static SymbolicFactorGraph loopyGraph(size_t n) {
+  SymbolicFactorGraph graph;
+  for (size_t i = n - 1; i > 0; --i) {
+    graph.push_factor(i - 1, i);
+    if (i % 3 == 0)
+      graph.push_factor(i / 3, i);
+  }
+  graph.push_factor(0);
+  return graph;
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, constructors) {
+  const SymbolicFactorGraph graph = loopyGraph(50);
+  const VariableIndex expected(graph);
+  EXPECT(sameStructure(expected, FlatVariableIndex(graph)));
+  EXPECT(sameStructure(expected, FlatVariableIndex(expected)));
+  EXPECT(assert_equal(FlatVariableIndex(graph), FlatVariableIndex(expected)));
+
+  const FlatVariableIndex actual(graph);
+  LONGS_EQUAL(50, actual.size());
+  EXPECT(actual.exists(49));
+  EXPECT(!actual.exists(50));
+  LONGS_EQUAL(50, actual.find(50));
+  CHECK_EXCEPTION(actual[50], std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, augment) {
+  // Adding factors one by one moves columns around and compacts the array
+  const SymbolicFactorGraph graph = loopyGraph(200);
+  FlatVariableIndex actual;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    SymbolicFactorGraph single;
+    single.push_back(graph[i]);
+    actual.augment(single);
+  }
+  EXPECT(sameStructure(VariableIndex(graph), actual));
+  EXPECT(assert_equal(FlatVariableIndex(graph), actual));
+
+  actual.compact();
+  EXPECT(assert_equal(FlatVariableIndex(graph), actual));
+
+  // Augment with explicit factor indices
+  SymbolicFactorGraph extra;
+  extra.push_factor(3, 300);
+  FactorIndices newIndices;
+  newIndices.push_back(400);
+  actual.augment(extra, newIndices);
+  LONGS_EQUAL(401, actual.nFactors());
+  LONGS_EQUAL(400, actual[300][0]);
+  LONGS_EQUAL(400, actual[3][actual[3].size() - 1]);
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, buildMatchesAugment) {
+  // Factors with unsorted, repeated keys and empty slots
+  SymbolicFactorGraph fg;
+  for (size_t i = 0; i < 50; ++i) {
+    if (i % 7 == 3)
+      fg.push_back(SymbolicFactor::shared_ptr());
+    else
+      fg.push_factor((i * 13) % 17, (i * 5) % 11 + 20, i % 3);
+  }
+
+  FlatVariableIndex expected;
+  expected.augment(fg);
+  const FlatVariableIndex actual(fg);
+  LONGS_EQUAL(50, actual.nFactors());
+  EXPECT(assert_equal(expected, actual));
+  EXPECT(sameStructure(VariableIndex(fg), actual));
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, remove) {
+  SymbolicFactorGraph fg1, fg2;
+  fg1.push_factor(0, 1);
+  fg1.push_factor(0, 2);
+  fg1.push_factor(5, 9);
+  fg1.push_factor(2, 3);
+  fg2.push_factor(1, 3);
+  fg2.push_factor(2, 4);
+  fg2.push_factor(3, 5);
+  fg2.push_factor(5, 6);
+
+  SymbolicFactorGraph fgOriginal;
+  fgOriginal.push_back(fg1);
+  fgOriginal.push_back(fg2);
+  FlatVariableIndex actual(fgOriginal);
+
+  SymbolicFactorGraph fg2removed(fgOriginal);
+  fg2removed.remove(0); fg2removed.remove(1); fg2removed.remove(2); fg2removed.remove(3);
+
+  vector<size_t> indices;
+  indices.push_back(0); indices.push_back(1); indices.push_back(2); indices.push_back(3);
+  actual.remove(indices.begin(), indices.end(), fg1);
+  std::list<Key> unusedVariables; unusedVariables += 0, 9;
+  actual.removeUnusedVariables(unusedVariables.begin(), unusedVariables.end());
+
+  EXPECT(assert_equal(FlatVariableIndex(fg2removed), actual));
+  CHECK_EXCEPTION(actual.remove(indices.begin(), indices.end(), fg1),
+      std::invalid_argument);
+  std::list<Key> usedVariables; usedVariables += 3;
+  CHECK_EXCEPTION(
+      actual.removeUnusedVariables(usedVariables.begin(), usedVariables.end()),
+      std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, orderingAndEliminationTree) {
+  const SymbolicFactorGraph graph = loopyGraph(100);
+  const VariableIndex variableIndex(graph);
+  const FlatVariableIndex flatIndex(graph);
+
+  const Ordering expected = Ordering::Colamd(variableIndex);
+  EXPECT(assert_equal(expected, Ordering::Colamd(flatIndex)));
+
+  FastMap<Key, int> groups;
+  groups[10] = 1;
+  groups[20] = 1;
+  EXPECT(assert_equal(Ordering::ColamdConstrained(variableIndex, groups),
+      Ordering::ColamdConstrained(flatIndex, groups)));
+  KeyVector last;
+  last.push_back(10);
+  last.push_back(20);
+  EXPECT(assert_equal(Ordering::ColamdConstrainedLast(variableIndex, last, true),
+      Ordering::ColamdConstrainedLast(flatIndex, last, true)));
+  EXPECT(assert_equal(Ordering::ColamdConstrainedFirst(variableIndex, last),
+      Ordering::ColamdConstrainedFirst(flatIndex, last)));
+
+  const SymbolicEliminationTree expectedTree(graph, variableIndex, expected);
+  const SymbolicEliminationTree actualTree(graph, flatIndex, expected);
+  EXPECT(assert_equal(expectedTree, actualTree));
+}
+
+/* ************************************************************************* */
+TEST(FlatVariableIndex, MetisIndex) {
+  SymbolicFactorGraph graph;
+  graph.push_factor(0, 1);
+  graph.push_factor(1, 2, 3);
+  graph.push_factor(3);
+  graph.push_factor(7);
+  const MetisIndex metisIndex((FlatVariableIndex(graph)));
+
+  // Variable 7 is isolated but still has an (empty) adjacency list
+  LONGS_EQUAL(5, metisIndex.nValues());
+  const vector<int32_t> expectedXadj = {0, 1, 4, 6, 8, 8};
+  const vector<int32_t> expectedAdj = {1, 0, 2, 3, 1, 3, 1, 2};
+  EXPECT(expectedXadj == metisIndex.xadj());
+  EXPECT(expectedAdj == metisIndex.adj());
+  EXPECT_LONGS_EQUAL(7, metisIndex.intToKey(4));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
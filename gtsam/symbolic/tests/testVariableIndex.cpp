@@ -89,6 +89,26 @@ TEST(VariableIndex, augment2) {
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(VariableIndex, buildMatchesAugment) {
+  // Enough factors to be built in several ranges, with unsorted and repeated
+  // keys and empty slots
+  SymbolicFactorGraph fg;
+  for (size_t i = 0; i < 2500; ++i) {
+    if (i % 7 == 3)
+      fg.push_back(SymbolicFactor::shared_ptr());
+    else
+      fg.push_factor((i * 13) % 170, (i * 5) % 110 + 200, i % 3);
+  }
+
+  VariableIndex expected;
+  expected.augment(fg);
+  VariableIndex actual(fg);
+
+  LONGS_EQUAL(2500, actual.nFactors());
+  EXPECT(assert_equal(expected, actual));
+}
+
 /* ************************************************************************* */
 TEST(VariableIndex, remove) {
 
@@ -22,6 +22,10 @@
 #include <gtsam/linear/GaussianJunctionTree.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/GaussianFactor.h>
+#include <gtsam/symbolic/SymbolicFactorGraph.h>
+#include <gtsam/base/parallelFor.h>
+
+#include <algorithm>
 
 using namespace std;
 
@@ -59,8 +63,10 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
   // Add the new variables to theta
   theta_.insert(newTheta);
   // Add new variables to the end of the ordering
-  for (const auto& key_value : newTheta) {
-    ordering_.push_back(key_value.key);
+  if (!incrementalOrdering_) {
+    for (const auto& key_value : newTheta) {
+      ordering_.push_back(key_value.key);
+    }
   }
   // Augment Delta
   delta_.insert(newTheta.zeroVectors());
@@ -71,13 +77,22 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
 
   // remove factors in factorToRemove
   for(const size_t i : factorsToRemove){
-    if(factors_[i])
+    if(factors_[i]) {
+      NonlinearFactorGraph removedFactor;
+      removedFactor.push_back(factors_[i]);
+      variableIndex_.remove(&i, &i + 1, removedFactor);
       factors_[i].reset();
+    }
   }
 
   // Update the Timestamps associated with the factor keys
   updateKeyTimestampMap(timestamps);
 
+  // In incremental mode, the new variables go after the existing ones, by timestamp
+  if (incrementalOrdering_) {
+    appendToOrdering(newTheta);
+  }
+
   // Get current timestamp
   double current_timestamp = getCurrentTimestamp();
 
@@ -86,9 +101,11 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
       current_timestamp - smootherLag_);
 
   // Reorder
-  gttic(reorder);
-  reorder(marginalizableKeys);
-  gttoc(reorder);
+  if (!incrementalOrdering_) {
+    gttic(reorder);
+    reorder(marginalizableKeys);
+    gttoc(reorder);
+  }
 
   // Optimize
   gttic(optimize);
@@ -111,8 +128,10 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
 /* ************************************************************************* */
 void BatchFixedLagSmoother::insertFactors(
     const NonlinearFactorGraph& newFactors) {
+  FactorIndices slots;
+  slots.reserve(newFactors.size());
   for(const auto& factor: newFactors) {
-    Key index;
+    size_t index;
     // Insert the factor into an existing hole in the factor graph, if possible
     if (availableSlots_.size() > 0) {
       index = availableSlots_.front();
@@ -122,22 +141,22 @@ void BatchFixedLagSmoother::insertFactors(
       index = factors_.size();
       factors_.push_back(factor);
     }
-    // Update the FactorIndex
-    for(Key key: *factor) {
-      factorIndex_[key].insert(index);
-    }
+    slots.push_back(index);
   }
+  // Update the variable index
+  variableIndex_.augment(newFactors, slots);
 }
 
 /* ************************************************************************* */
 void BatchFixedLagSmoother::removeFactors(
     const set<size_t>& deleteFactors) {
+  FactorIndices slots;
+  NonlinearFactorGraph removedFactors;
   for(size_t slot: deleteFactors) {
     if (factors_.at(slot)) {
-      // Remove references to this factor from the FactorIndex
-      for(Key key: *(factors_.at(slot))) {
-        factorIndex_[key].erase(slot);
-      }
+      // Remember the factor, to remove references to it from the variable index
+      slots.push_back(slot);
+      removedFactors.push_back(factors_.at(slot));
       // Remove the factor from the factor graph
       factors_.remove(slot);
       // Add the factor's old slot to the list of available slots
@@ -148,6 +167,7 @@ void BatchFixedLagSmoother::removeFactors(
           << ", but it is already NULL." << endl;
     }
   }
+  variableIndex_.remove(slots.begin(), slots.end(), removedFactors);
 }
 
 /* ************************************************************************* */
@@ -157,8 +177,9 @@ void BatchFixedLagSmoother::eraseKeys(const KeyVector& keys) {
     // Erase the key from the values
     theta_.erase(key);
 
-    // Erase the key from the factor index
-    factorIndex_.erase(key);
+    // Erase the key from the variable index. All of its factors were removed already.
+    if (variableIndex_.find(key) != variableIndex_.end())
+      variableIndex_.removeUnusedVariables(&key, &key + 1);
 
     // Erase the key from the set of linearized keys
     if (linearKeys_.exists(key)) {
@@ -169,8 +190,10 @@ void BatchFixedLagSmoother::eraseKeys(const KeyVector& keys) {
   eraseKeyTimestampMap(keys);
 
   // Remove marginalized keys from the ordering and delta
+  const KeySet erased(keys.begin(), keys.end());
+  ordering_.erase(remove_if(ordering_.begin(), ordering_.end(),
+      [&erased](Key key) { return erased.exists(key); }), ordering_.end());
   for(Key key: keys) {
-    ordering_.erase(find(ordering_.begin(), ordering_.end(), key));
     delta_.erase(key);
   }
 }
@@ -178,7 +201,20 @@ void BatchFixedLagSmoother::eraseKeys(const KeyVector& keys) {
 /* ************************************************************************* */
 void BatchFixedLagSmoother::reorder(const KeyVector& marginalizeKeys) {
   // COLAMD groups will be used to place marginalize keys in Group 0, and everything else in Group 1
-  ordering_ = Ordering::ColamdConstrainedFirst(factors_, marginalizeKeys);
+  ordering_ = Ordering::ColamdConstrainedFirst(variableIndex_, marginalizeKeys);
+}
+
+/* ************************************************************************* */
+void BatchFixedLagSmoother::appendToOrdering(const Values& newTheta) {
+  // Variables without a timestamp go last
+  auto timestamp = [this](Key key) {
+    const KeyTimestampMap::const_iterator iter = keyTimestampMap_.find(key);
+    return iter != keyTimestampMap_.end() ? iter->second : numeric_limits<double>::max();
+  };
+  KeyVector newKeys = newTheta.keys();
+  stable_sort(newKeys.begin(), newKeys.end(),
+      [&timestamp](Key a, Key b) { return timestamp(a) < timestamp(b); });
+  ordering_.insert(ordering_.end(), newKeys.begin(), newKeys.end());
 }
 
 /* ************************************************************************* */
@@ -208,6 +244,32 @@ FixedLagSmoother::Result BatchFixedLagSmoother::optimize() {
     return result;
   }
 
+  // The damped systems consist of the linearized factors, followed by a prior
+  // on every variable. Their structure is the same for all iterations, so the
+  // variable index of the factors is extended with the priors only once.
+  gttic(structure);
+  KeyVector priorKeys;
+  vector<const Vector*> priorMeans;
+  set<size_t> priorDims;
+  priorKeys.reserve(delta_.size());
+  priorMeans.reserve(delta_.size());
+  for(const auto& key_value: delta_) {
+    priorKeys.push_back(key_value.first);
+    priorMeans.push_back(&key_value.second);
+    priorDims.insert(key_value.second.size());
+  }
+  VariableIndex dampedStructure(variableIndex_);
+  {
+    SymbolicFactorGraph priors;
+    FactorIndices slots;
+    for(Key key: priorKeys) {
+      priors.emplace_shared<SymbolicFactor>(key);
+      slots.push_back(factors_.size() + slots.size());
+    }
+    dampedStructure.augment(priors, slots);
+  }
+  gttoc(structure);
+
   // Use a custom optimization loop so the linearization points can be controlled
   double previousError;
   VectorValues newDelta;
@@ -218,35 +280,51 @@ FixedLagSmoother::Result BatchFixedLagSmoother::optimize() {
     gttic(optimizer_iteration);
     {
       // Linearize graph around the linearization point
-      GaussianFactorGraph linearFactorGraph = *factors_.linearize(theta_);
+      gttic(linearize);
+      GaussianFactorGraph linearFactorGraph = linearizer_ ?
+          *linearizer_->linearize(factors_, theta_) : *factors_.linearize(theta_);
+      gttoc(linearize);
+
+      // Factors that are inactive at this linearization point leave holes that
+      // the cached structure does not know about
+      bool inactiveFactors = false;
+      for(size_t i = 0; i < factors_.size() && !inactiveFactors; ++i) {
+        inactiveFactors = factors_[i] && !linearFactorGraph[i];
+      }
+      boost::optional<VariableIndex> inactiveStructure;
 
       // Keep increasing lambda until we make make progress
       while (true) {
 
         // Add prior factors at the current solution
         gttic(damp);
+        const size_t nrFactors = linearFactorGraph.size();
         GaussianFactorGraph dampedFactorGraph(linearFactorGraph);
-        dampedFactorGraph.reserve(linearFactorGraph.size() + delta_.size());
+        dampedFactorGraph.resize(nrFactors + priorKeys.size());
         {
           // for each of the variables, add a prior at the current solution
           double sigma = 1.0 / sqrt(lambda);
-          for(const auto& key_value: delta_) {
-            size_t dim = key_value.second.size();
-            Matrix A = Matrix::Identity(dim, dim);
-            Vector b = key_value.second;
-            SharedDiagonal model = noiseModel::Isotropic::Sigma(dim, sigma);
-            GaussianFactor::shared_ptr prior(
-                new JacobianFactor(key_value.first, A, b, model));
-            dampedFactorGraph.push_back(prior);
+          map<size_t, SharedDiagonal> models;
+          for(size_t dim: priorDims) {
+            models[dim] = noiseModel::Isotropic::Sigma(dim, sigma);
           }
+          parallelFor(priorKeys.size(), [&](size_t k) {
+            const Vector& b = *priorMeans[k];
+            const size_t dim = b.size();
+            dampedFactorGraph[nrFactors + k] = boost::make_shared<JacobianFactor>(
+                priorKeys[k], Matrix::Identity(dim, dim), b, models.at(dim));
+          });
         }
         gttoc(damp);
         result.intermediateSteps++;
 
         gttic(solve);
         // Solve Damped Gaussian Factor Graph
-        newDelta = dampedFactorGraph.optimize(ordering_,
-            parameters_.getEliminationFunction());
+        if (inactiveFactors && !inactiveStructure)
+          inactiveStructure = VariableIndex(dampedFactorGraph);
+        newDelta = dampedFactorGraph.eliminateMultifrontal(ordering_,
+            parameters_.getEliminationFunction(),
+            inactiveFactors ? *inactiveStructure : dampedStructure)->optimize();
         // update the evalpoint with the new delta
         evalpoint = theta_.retract(newDelta);
         gttoc(solve);
@@ -313,10 +391,10 @@ void BatchFixedLagSmoother::marginalize(const KeyVector& marginalizeKeys) {
 
   // Identify all of the factors involving any marginalized variable. These must be removed.
   set<size_t> removedFactorSlots;
-  const VariableIndex variableIndex(factors_);
   for(Key key: marginalizeKeys) {
-    const auto& slots = variableIndex[key];
-    removedFactorSlots.insert(slots.begin(), slots.end());
+    const VariableIndex::const_iterator slots = variableIndex_.find(key);
+    if (slots != variableIndex_.end())
+      removedFactorSlots.insert(slots->second.begin(), slots->second.end());
   }
 
   // Add the removed factors to a factor graph
@@ -21,7 +21,9 @@
 #pragma once
 
 #include <gtsam_unstable/nonlinear/FixedLagSmoother.h>
+#include <gtsam/nonlinear/BatchLinearizer.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/inference/VariableIndex.h>
 #include <queue>
 
 namespace gtsam {
@@ -33,9 +35,18 @@ public:
   /// Typedef for a shared pointer to an Incremental Fixed-Lag Smoother
   typedef boost::shared_ptr<BatchFixedLagSmoother> shared_ptr;
 
-  /** default constructor */
-  BatchFixedLagSmoother(double smootherLag = 0.0, const LevenbergMarquardtParams& parameters = LevenbergMarquardtParams(), bool enforceConsistency = true) :
-    FixedLagSmoother(smootherLag), parameters_(parameters), enforceConsistency_(enforceConsistency) { };
+  /**
+   * default constructor
+   * @param incrementalOrdering If true, keep the elimination ordering of the window
+   *   incrementally, appending new variables in timestamp order and dropping
+   *   marginalized ones, instead of computing a constrained COLAMD ordering of the
+   *   whole window on every update. This suits sequential windows, e.g., odometry
+   *   or IMU chains, for which time order is a good elimination order.
+   */
+  BatchFixedLagSmoother(double smootherLag = 0.0, const LevenbergMarquardtParams& parameters = LevenbergMarquardtParams(),
+      bool enforceConsistency = true, bool incrementalOrdering = false) :
+    FixedLagSmoother(smootherLag), parameters_(parameters), enforceConsistency_(enforceConsistency),
+    incrementalOrdering_(incrementalOrdering) { };
 
   /** destructor */
   virtual ~BatchFixedLagSmoother() { };
@@ -82,6 +93,16 @@ public:
     return parameters_;
   }
 
+  /** Whether the elimination ordering is kept incrementally */
+  bool incrementalOrdering() const {
+    return incrementalOrdering_;
+  }
+
+  /** Linearize with the given BatchLinearizer, or with NonlinearFactorGraph::linearize if null */
+  void setLinearizer(const boost::shared_ptr<const BatchLinearizer>& linearizer) {
+    linearizer_ = linearizer;
+  }
+
   /** Access the current set of factors */
   const NonlinearFactorGraph& getFactors() const {
     return factors_;
@@ -128,9 +149,6 @@ public:
 
 protected:
 
-  /** A typedef defining an Key-Factor mapping **/
-  typedef std::map<Key, std::set<Key> > FactorIndex;
-
   /** The L-M optimization parameters **/
   LevenbergMarquardtParams parameters_;
 
@@ -139,6 +157,9 @@ protected:
    * smoothing window. This idea is from ??? TODO: Look up paper reference **/
   bool enforceConsistency_;
 
+  /** A flag indicating if the ordering is kept incrementally, rather than recomputed on every update **/
+  bool incrementalOrdering_;
+
   /** The nonlinear factors **/
   NonlinearFactorGraph factors_;
 
@@ -157,8 +178,12 @@ protected:
   /** The set of available factor graph slots. These occur because we are constantly deleting factors, leaving holes. **/
   std::queue<size_t> availableSlots_;
 
-  /** A cross-reference structure to allow efficient factor lookups by key **/
-  FactorIndex factorIndex_;
+  /** A cross-reference structure to allow efficient factor lookups by key, kept up to date
+   * as factors are inserted and removed, so it can be reused for ordering and elimination **/
+  VariableIndex variableIndex_;
+
+  /** Optional linearizer, shared with other optimizers **/
+  boost::shared_ptr<const BatchLinearizer> linearizer_;
 
   /** Augment the list of factors with a set of new factors */
   void insertFactors(const NonlinearFactorGraph& newFactors);
@@ -172,6 +197,9 @@ protected:
   /** Use colamd to update into an efficient ordering */
   void reorder(const KeyVector& marginalizeKeys = KeyVector());
 
+  /** Append new variables to the end of the ordering, oldest first */
+  void appendToOrdering(const Values& newTheta);
+
   /** Optimize the current graph using a modified version of L-M */
   Result optimize();
 
@@ -0,0 +1,194 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ConcurrentFilteringAndSmoothingRuntime.cpp
+ * @brief   Runs the smoother of the Concurrent Filtering and Smoothing architecture
+ *          on a background thread, and synchronizes it with the filter.
+ * @author  agent
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothingRuntime.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+static double seconds(ConcurrentFilteringAndSmoothingRuntime::Clock::duration d) {
+  return std::chrono::duration<double>(d).count();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::Buffer::swap(Buffer& other) {
+  std::swap(factors, other.factors);
+  std::swap(summarizedFactors, other.summarizedFactors);
+  values.swap(other.values);
+  separatorValues.swap(other.separatorValues);
+  std::swap(time, other.time);
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::Buffer::clear() {
+  factors.resize(0);
+  summarizedFactors.resize(0);
+  values.clear();
+  separatorValues.clear();
+  time = Clock::time_point();
+}
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::ConcurrentFilteringAndSmoothingRuntime(
+    ConcurrentFilter& filter, ConcurrentSmoother& smoother,
+    const std::function<void()>& updateSmoother) :
+    filter_(filter), smoother_(smoother), updateSmoother_(updateSmoother),
+    smootherReady_(false), filterReady_(false), stop_(false) {
+  thread_ = std::thread(&ConcurrentFilteringAndSmoothingRuntime::run, this);
+}
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::~ConcurrentFilteringAndSmoothingRuntime() {
+  stop();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  filterReadyCondition_.notify_all();
+  smootherReadyCondition_.notify_all();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::Statistics
+ConcurrentFilteringAndSmoothingRuntime::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+/* ************************************************************************* */
+bool ConcurrentFilteringAndSmoothingRuntime::synchronizeIfReady() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_)
+      std::rethrow_exception(error_);
+    if (!smootherReady_ || stop_)
+      return false;
+    smootherBuffer_.swap(filterSide_);
+    smootherReady_ = false;
+  }
+  synchronizeFilter();
+  return true;
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::synchronize() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    smootherReadyCondition_.wait(lock, [this] { return smootherReady_ || stop_; });
+    if (error_)
+      std::rethrow_exception(error_);
+    if (!smootherReady_ || stop_)
+      return;
+    smootherBuffer_.swap(filterSide_);
+    smootherReady_ = false;
+  }
+  synchronizeFilter();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::synchronizeFilter() {
+  const Clock::time_point start = Clock::now();
+  const Clock::time_point handed = filterSide_.time;
+
+  // Apply the smoother summarization to the filter
+  filter_.presync();
+  filter_.synchronize(filterSide_.summarizedFactors, filterSide_.separatorValues);
+
+  // Get the updates for the smoother
+  filterSide_.clear();
+  filter_.getSmootherFactors(filterSide_.factors, filterSide_.values);
+  filter_.getSummarizedFactors(filterSide_.summarizedFactors, filterSide_.separatorValues);
+  filter_.postsync();
+
+  // Hand them to the smoother thread
+  const Clock::time_point end = Clock::now();
+  filterSide_.time = end;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filterBuffer_.swap(filterSide_);
+    filterReady_ = true;
+
+    statistics_.synchronizations += 1;
+    statistics_.lastSyncLatency = seconds(end - start);
+    statistics_.maxSyncLatency = std::max(statistics_.maxSyncLatency, statistics_.lastSyncLatency);
+    if (handed != Clock::time_point()) {
+      statistics_.lastSmootherLag = seconds(start - handed);
+      statistics_.maxSmootherLag = std::max(statistics_.maxSmootherLag, statistics_.lastSmootherLag);
+    }
+  }
+  filterReadyCondition_.notify_all();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::run() {
+  // Time at which the filter handed over the factors the smoother last consumed
+  Clock::time_point handed;
+  try {
+    while (true) {
+      // Publish the smoother summarization
+      smootherSide_.clear();
+      smoother_.presync();
+      smoother_.getSummarizedFactors(smootherSide_.summarizedFactors, smootherSide_.separatorValues);
+      smootherSide_.time = handed;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        smootherBuffer_.swap(smootherSide_);
+        smootherReady_ = true;
+        smootherReadyCondition_.notify_all();
+
+        // Wait for the filter to synchronize with it, or stop once it has not
+        filterReadyCondition_.wait(lock, [this] { return filterReady_ || stop_; });
+        if (!filterReady_)
+          return;
+        filterBuffer_.swap(smootherSide_);
+        filterReady_ = false;
+      }
+      handed = smootherSide_.time;
+
+      // Apply the filter updates to the smoother, and update it
+      smoother_.synchronize(smootherSide_.factors, smootherSide_.values,
+          smootherSide_.summarizedFactors, smootherSide_.separatorValues);
+      smoother_.postsync();
+      const Clock::time_point start = Clock::now();
+      updateSmoother_();
+      const double duration = seconds(Clock::now() - start);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      statistics_.smootherUpdates += 1;
+      statistics_.lastSmootherUpdate = duration;
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+      stop_ = true;
+    }
+    smootherReadyCondition_.notify_all();
+  }
+}
+
+}/// namespace gtsam
@@ -0,0 +1,145 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ConcurrentFilteringAndSmoothingRuntime.h
+ * @brief   Runs the smoother of the Concurrent Filtering and Smoothing architecture
+ *          on a background thread, and synchronizes it with the filter.
+ * @author  agent
+ */
+
+// \callgraph
+#pragma once
+
+#include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothing.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace gtsam {
+
+/**
+ * Runtime for Concurrent Filtering and Smoothing. The filter stays on the
+ * caller's thread: the caller updates it as usual, and calls
+ * synchronizeIfReady() at points where the filter may be synchronized, e.g.,
+ * after every filter update. The smoother runs on a background thread, where
+ * it alternates between updating and publishing its summarization.
+ *
+ * The synchronization of 'synchronize(filter, smoother)' is split in two
+ * halves that exchange their data through double buffers, which are swapped
+ * under a lock. Neither half waits for the other to compute anything, so the
+ * filter is never blocked by a smoother update: synchronizeIfReady() returns
+ * false immediately if the smoother is still busy.
+ *
+ * The smoother is only touched by the background thread, and the filter only
+ * by the caller, so neither should be accessed from elsewhere while running.
+ */
+class GTSAM_UNSTABLE_EXPORT ConcurrentFilteringAndSmoothingRuntime {
+public:
+
+  typedef std::chrono::steady_clock Clock;
+
+  /** Statistics, with all durations in seconds */
+  struct Statistics {
+    size_t synchronizations; ///< Number of completed synchronizations
+    size_t smootherUpdates; ///< Number of completed smoother updates
+    double lastSyncLatency; ///< Time the filter spent in the last synchronization
+    double maxSyncLatency; ///< Maximum of lastSyncLatency
+    double lastSmootherLag; ///< Time from handing filter factors to the smoother, until the filter received the resulting summarization
+    double maxSmootherLag; ///< Maximum of lastSmootherLag
+    double lastSmootherUpdate; ///< Duration of the last smoother update
+
+    Statistics() :
+        synchronizations(0), smootherUpdates(0), lastSyncLatency(0), maxSyncLatency(0),
+        lastSmootherLag(0), maxSmootherLag(0), lastSmootherUpdate(0) {
+    }
+  };
+
+  /**
+   * Start the smoother thread.
+   * @param filter The filter, which is used on the caller's thread only
+   * @param smoother The smoother, which is used on the background thread only
+   * @param updateSmoother Function that updates the smoother, e.g., calling smoother.update()
+   */
+  ConcurrentFilteringAndSmoothingRuntime(ConcurrentFilter& filter, ConcurrentSmoother& smoother,
+      const std::function<void()>& updateSmoother);
+
+  /** Start the smoother thread, using 'smoother.update()' to update the smoother */
+  template<class SMOOTHER>
+  ConcurrentFilteringAndSmoothingRuntime(ConcurrentFilter& filter, SMOOTHER& smoother) :
+      ConcurrentFilteringAndSmoothingRuntime(filter, smoother, [&smoother]() { smoother.update(); }) {
+  }
+
+  /** Stops the smoother thread */
+  ~ConcurrentFilteringAndSmoothingRuntime();
+
+  /**
+   * Synchronize the filter with the smoother, if the smoother has published a
+   * summarization since the last synchronization. Call from the filter's thread.
+   * Exceptions thrown by the smoother thread are rethrown here.
+   * @return true if synchronized, false if the smoother was still busy or stopped
+   */
+  bool synchronizeIfReady();
+
+  /**
+   * Wait for the smoother to publish its summarization, then synchronize.
+   * Call from the filter's thread. Returns without synchronizing if stopped.
+   */
+  void synchronize();
+
+  /**
+   * Stop the smoother thread, after it has updated with the factors of the last
+   * synchronization, if any
+   */
+  void stop();
+
+  /** Statistics so far */
+  Statistics statistics() const;
+
+private:
+
+  /** The data one half of the synchronization hands to the other */
+  struct Buffer {
+    NonlinearFactorGraph factors, summarizedFactors;
+    Values values, separatorValues;
+    Clock::time_point time;
+
+    void swap(Buffer& other);
+    void clear();
+  };
+
+  ConcurrentFilter& filter_;
+  ConcurrentSmoother& smoother_;
+  std::function<void()> updateSmoother_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable smootherReadyCondition_, filterReadyCondition_;
+  Buffer smootherBuffer_, filterBuffer_; ///< published by the smoother/filter, guarded by mutex_
+  bool smootherReady_, filterReady_, stop_; ///< guarded by mutex_
+  std::exception_ptr error_; ///< thrown by the smoother thread, guarded by mutex_
+  Statistics statistics_; ///< guarded by mutex_
+
+  Buffer filterSide_, smootherSide_; ///< working copies, owned by either thread
+  std::thread thread_;
+
+  /** The loop of the smoother thread */
+  void run();
+
+  /** The filter half of the synchronization, on the summarization in filterSide_ */
+  void synchronizeFilter();
+
+}; // ConcurrentFilteringAndSmoothingRuntime
+
+}/// namespace gtsam
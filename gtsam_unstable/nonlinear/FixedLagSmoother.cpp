@@ -19,6 +19,8 @@
 
 #include <gtsam_unstable/nonlinear/FixedLagSmoother.h>
 
+#include <algorithm>
+
 namespace gtsam {
 
 /* ************************************************************************* */
@@ -39,9 +41,55 @@ void FixedLagSmoother::print(const std::string& s, const KeyFormatter& keyFormat
 /* ************************************************************************* */
 bool FixedLagSmoother::equals(const FixedLagSmoother& rhs, double tol) const {
   return std::abs(smootherLag_ - rhs.smootherLag_) < tol
+      && timestampKeyMap_.size() == rhs.timestampKeyMap_.size()
       && std::equal(timestampKeyMap_.begin(), timestampKeyMap_.end(), rhs.timestampKeyMap_.begin());
 }
 
+/* ************************************************************************* */
+void FixedLagSmoother::TimestampKeyIndex::insert(double timestamp, Key key) {
+  if (entries_.empty() || entries_.back().first <= timestamp)
+    entries_.emplace_back(timestamp, key);
+  else
+    entries_.emplace(entries_.begin() + (upper_bound(timestamp) - begin()), timestamp, key);
+}
+
+/* ************************************************************************* */
+void FixedLagSmoother::TimestampKeyIndex::erase(double timestamp, Key key) {
+  const value_type entry(timestamp, key);
+  if (entries_.empty()) {
+    return;
+  } else if (entries_.front() == entry) {
+    entries_.pop_front();
+  } else if (entries_.back() == entry) {
+    entries_.pop_back();
+  } else {
+    const_iterator end = upper_bound(timestamp);
+    const_iterator iter = std::find(lower_bound(timestamp), end, entry);
+    if (iter != end)
+      entries_.erase(entries_.begin() + (iter - begin()));
+  }
+}
+
+/* ************************************************************************* */
+void FixedLagSmoother::TimestampKeyIndex::eraseBefore(double timestamp) {
+  while (!entries_.empty() && entries_.front().first < timestamp)
+    entries_.pop_front();
+}
+
+/* ************************************************************************* */
+FixedLagSmoother::TimestampKeyIndex::const_iterator
+FixedLagSmoother::TimestampKeyIndex::lower_bound(double timestamp) const {
+  return std::lower_bound(entries_.begin(), entries_.end(), timestamp,
+      [](const value_type& entry, double t) { return entry.first < t; });
+}
+
+/* ************************************************************************* */
+FixedLagSmoother::TimestampKeyIndex::const_iterator
+FixedLagSmoother::TimestampKeyIndex::upper_bound(double timestamp) const {
+  return std::upper_bound(entries_.begin(), entries_.end(), timestamp,
+      [](double t, const value_type& entry) { return t < entry.first; });
+}
+
 /* ************************************************************************* */
 void FixedLagSmoother::updateKeyTimestampMap(const KeyTimestampMap& timestamps) {
   // Loop through each key and add/update it in the map
@@ -51,23 +99,16 @@ void FixedLagSmoother::updateKeyTimestampMap(const KeyTimestampMap& timestamps)
 
     // If the key already exists
     if(keyIter != keyTimestampMap_.end()) {
-      // Find the entry in the Timestamp-Key database
-      std::pair<TimestampKeyMap::iterator,TimestampKeyMap::iterator> range = timestampKeyMap_.equal_range(keyIter->second);
-      TimestampKeyMap::iterator timeIter = range.first;
-      while(timeIter->second != key_timestamp.first) {
-        ++timeIter;
-      }
-      // remove the entry in the Timestamp-Key database
-      timestampKeyMap_.erase(timeIter);
-      // insert an entry at the new time
-      timestampKeyMap_.insert(TimestampKeyMap::value_type(key_timestamp.second, key_timestamp.first));
+      // Move the entry in the Timestamp-Key index to the new time
+      timestampKeyMap_.erase(keyIter->second, key_timestamp.first);
+      timestampKeyMap_.insert(key_timestamp.second, key_timestamp.first);
       // update the Key-Timestamp database
       keyIter->second = key_timestamp.second;
     } else {
       // Add the Key-Timestamp database
       keyTimestampMap_.insert(key_timestamp);
-      // Add the key to the Timestamp-Key database
-      timestampKeyMap_.insert(TimestampKeyMap::value_type(key_timestamp.second, key_timestamp.first));
+      // Add the key to the Timestamp-Key index
+      timestampKeyMap_.insert(key_timestamp.second, key_timestamp.first);
     }
   }
 }
@@ -75,17 +116,8 @@ void FixedLagSmoother::updateKeyTimestampMap(const KeyTimestampMap& timestamps)
 /* ************************************************************************* */
 void FixedLagSmoother::eraseKeyTimestampMap(const KeyVector& keys) {
   for(Key key: keys) {
-    // Erase the key from the Timestamp->Key map
-    double timestamp = keyTimestampMap_.at(key);
-
-    TimestampKeyMap::iterator iter = timestampKeyMap_.lower_bound(timestamp);
-    while(iter != timestampKeyMap_.end() && iter->first == timestamp) {
-      if(iter->second == key) {
-        timestampKeyMap_.erase(iter++);
-      } else {
-        ++iter;
-      }
-    }
+    // Erase the key from the Timestamp->Key index
+    timestampKeyMap_.erase(keyTimestampMap_.at(key), key);
     // Erase the key from the Key->Timestamp map
     keyTimestampMap_.erase(key);
   }
@@ -94,7 +126,7 @@ void FixedLagSmoother::eraseKeyTimestampMap(const KeyVector& keys) {
 /* ************************************************************************* */
 double FixedLagSmoother::getCurrentTimestamp() const {
   if(timestampKeyMap_.size() > 0) {
-    return timestampKeyMap_.rbegin()->first;
+    return timestampKeyMap_.back().first;
   } else {
     return -std::numeric_limits<double>::max();
   }
@@ -103,8 +135,8 @@ double FixedLagSmoother::getCurrentTimestamp() const {
 /* ************************************************************************* */
 KeyVector FixedLagSmoother::findKeysBefore(double timestamp) const {
   KeyVector keys;
-  TimestampKeyMap::const_iterator end = timestampKeyMap_.lower_bound(timestamp);
-  for(TimestampKeyMap::const_iterator iter = timestampKeyMap_.begin(); iter != end; ++iter) {
+  TimestampKeyIndex::const_iterator end = timestampKeyMap_.lower_bound(timestamp);
+  for(TimestampKeyIndex::const_iterator iter = timestampKeyMap_.begin(); iter != end; ++iter) {
     keys.push_back(iter->second);
   }
   return keys;
@@ -113,8 +145,8 @@ KeyVector FixedLagSmoother::findKeysBefore(double timestamp) const {
 /* ************************************************************************* */
 KeyVector FixedLagSmoother::findKeysAfter(double timestamp) const {
   KeyVector keys;
-  TimestampKeyMap::const_iterator begin = timestampKeyMap_.upper_bound(timestamp);
-  for(TimestampKeyMap::const_iterator iter = begin; iter != timestampKeyMap_.end(); ++iter) {
+  TimestampKeyIndex::const_iterator begin = timestampKeyMap_.upper_bound(timestamp);
+  for(TimestampKeyIndex::const_iterator iter = begin; iter != timestampKeyMap_.end(); ++iter) {
     keys.push_back(iter->second);
   }
   return keys;
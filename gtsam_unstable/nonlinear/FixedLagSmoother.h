@@ -25,6 +25,7 @@
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
 
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -39,7 +40,46 @@ public:
 
   /// Typedef for a Key-Timestamp map/database
   typedef std::map<Key, double> KeyTimestampMap;
-  typedef std::multimap<double, Key> TimestampKeyMap;
+
+  /**
+   * Keys sorted by timestamp. Keys typically arrive, and are marginalized, in
+   * time order, so the entries are kept in a deque: inserting at the back and
+   * erasing at the front are O(1). An out-of-order insert or erase finds its
+   * position by binary search, but then shifts the entries after it, which is
+   * O(n) in the number of keys. Keys with equal timestamps stay in insertion
+   * order, as they did in the std::multimap this index replaces.
+   */
+  class GTSAM_UNSTABLE_EXPORT TimestampKeyIndex {
+  public:
+    typedef std::pair<double, Key> value_type;
+    typedef std::deque<value_type>::const_iterator const_iterator;
+
+    /** Add a key at the given timestamp */
+    void insert(double timestamp, Key key);
+
+    /** Remove a key with the given timestamp, if present */
+    void erase(double timestamp, Key key);
+
+    /** Remove all keys with timestamps before the given time */
+    void eraseBefore(double timestamp);
+
+    /** First entry with a timestamp not before the given time */
+    const_iterator lower_bound(double timestamp) const;
+
+    /** First entry with a timestamp after the given time */
+    const_iterator upper_bound(double timestamp) const;
+
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /** The most recent entry */
+    const value_type& back() const { return entries_.back(); }
+
+  private:
+    std::deque<value_type> entries_;
+  };
 
   /**
    * Meta information returned about the update
@@ -108,7 +148,7 @@ protected:
   double smootherLag_;
 
   /** The current timestamp associated with each tracked key */
-  TimestampKeyMap timestampKeyMap_;
+  TimestampKeyIndex timestampKeyMap_;
   KeyTimestampMap keyTimestampMap_;
 
   /** Update the Timestamps associated with the keys */
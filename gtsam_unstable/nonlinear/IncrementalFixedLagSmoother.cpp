@@ -164,12 +164,11 @@ FixedLagSmoother::Result IncrementalFixedLagSmoother::update(
 
 /* ************************************************************************* */
 void IncrementalFixedLagSmoother::eraseKeysBefore(double timestamp) {
-  TimestampKeyMap::iterator end = timestampKeyMap_.lower_bound(timestamp);
-  TimestampKeyMap::iterator iter = timestampKeyMap_.begin();
-  while (iter != end) {
+  TimestampKeyIndex::const_iterator end = timestampKeyMap_.lower_bound(timestamp);
+  for (TimestampKeyIndex::const_iterator iter = timestampKeyMap_.begin(); iter != end; ++iter) {
     keyTimestampMap_.erase(iter->second);
-    timestampKeyMap_.erase(iter++);
   }
+  timestampKeyMap_.eraseBefore(timestamp);
 }
 
 /* ************************************************************************* */
@@ -180,7 +179,7 @@ void IncrementalFixedLagSmoother::createOrderingConstraints(
     constrainedKeys = FastMap<Key, int>();
     // Generate ordering constraints so that the marginalizable variables will be eliminated first
     // Set all variables to Group1
-    for(const TimestampKeyMap::value_type& timestamp_key: timestampKeyMap_) {
+    for(const TimestampKeyIndex::value_type& timestamp_key: timestampKeyMap_) {
       constrainedKeys->operator[](timestamp_key.second) = 1;
     }
     // Set marginalizable variables to Group0
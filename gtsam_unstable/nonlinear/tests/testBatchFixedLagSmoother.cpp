@@ -28,6 +28,7 @@
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/slam/PriorFactor.h>
 #include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/BetweenFactorKernel.h>
 
 using namespace std;
 using namespace gtsam;
@@ -238,6 +239,107 @@ TEST( BatchFixedLagSmoother, Example )
   }
 }
 
+/* ************************************************************************* */
+TEST( BatchFixedLagSmoother, IncrementalOrdering )
+{
+  // Keeping the ordering incrementally gives the same estimates as reordering
+  // the window on every update, on an odometry chain with a loop closure
+  SharedDiagonal odometerNoise = noiseModel::Diagonal::Sigmas(Vector2(0.1, 0.1));
+  typedef BatchFixedLagSmoother::KeyTimestampMap Timestamps;
+  BatchFixedLagSmoother expected(7.0, LevenbergMarquardtParams());
+  BatchFixedLagSmoother actual(7.0, LevenbergMarquardtParams(), true, true);
+  EXPECT(!expected.incrementalOrdering());
+  EXPECT(actual.incrementalOrdering());
+
+  for(size_t i = 0; i <= 15; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    Timestamps newTimestamps;
+    if (i == 0)
+      newFactors.push_back(PriorFactor<Point2>(Key(0), Point2(0.0, 0.0), odometerNoise));
+    else
+      newFactors.push_back(BetweenFactor<Point2>(Key(i-1), Key(i), Point2(1.0, 0.0), odometerNoise));
+    if (i == 6)
+      newFactors.push_back(BetweenFactor<Point2>(Key(2), Key(5), Point2(3.5, 0.0), odometerNoise));
+    newValues.insert(Key(i), Point2(double(i)+0.1, -0.1));
+    newTimestamps[Key(i)] = double(i);
+
+    expected.update(newFactors, newValues, newTimestamps);
+    actual.update(newFactors, newValues, newTimestamps);
+    EXPECT(assert_equal(expected.calculateEstimate(), actual.calculateEstimate(), 1e-6));
+  }
+
+  // The ordering is the window, oldest first
+  Ordering window;
+  for(size_t i = 8; i <= 15; ++i)
+    window.push_back(Key(i));
+  EXPECT(assert_equal(window, actual.getOrdering()));
+  EXPECT_LONGS_EQUAL(8, actual.timestamps().size());
+}
+
+/* ************************************************************************* */
+TEST( BatchFixedLagSmoother, Linearizer )
+{
+  // Linearizing with a BatchLinearizer gives the same estimates, on an
+  // odometry chain
+  SharedDiagonal odometerNoise = noiseModel::Diagonal::Sigmas(Vector2(0.1, 0.1));
+  typedef BatchFixedLagSmoother::KeyTimestampMap Timestamps;
+  BatchFixedLagSmoother expected(7.0, LevenbergMarquardtParams());
+  BatchFixedLagSmoother actual(7.0, LevenbergMarquardtParams());
+  boost::shared_ptr<BatchLinearizer> linearizer = boost::make_shared<BatchLinearizer>();
+  linearizer->add<BetweenFactor<Point2> >(
+      boost::make_shared<BetweenFactorKernel<Point2> >());
+  actual.setLinearizer(linearizer);
+
+  for(size_t i = 0; i <= 15; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    Timestamps newTimestamps;
+    if (i == 0)
+      newFactors.push_back(PriorFactor<Point2>(Key(0), Point2(0.0, 0.0), odometerNoise));
+    else
+      newFactors.push_back(BetweenFactor<Point2>(Key(i-1), Key(i), Point2(1.0, 0.0), odometerNoise));
+    newValues.insert(Key(i), Point2(double(i)+0.1, -0.1));
+    newTimestamps[Key(i)] = double(i);
+
+    expected.update(newFactors, newValues, newTimestamps);
+    actual.update(newFactors, newValues, newTimestamps);
+    EXPECT(assert_equal(expected.calculateEstimate(), actual.calculateEstimate(), 1e-6));
+  }
+}
+
+/* ************************************************************************* */
+TEST( FixedLagSmoother, TimestampKeyIndex )
+{
+  FixedLagSmoother::TimestampKeyIndex index;
+  index.insert(1.0, 10);
+  index.insert(2.0, 20);
+  index.insert(2.0, 21);
+  index.insert(0.5, 5); // out of order
+  index.insert(3.0, 30);
+  LONGS_EQUAL(5, index.size());
+  EXPECT_LONGS_EQUAL(5, index.begin()->second);
+  EXPECT_LONGS_EQUAL(30, index.back().second);
+
+  // Keys with equal timestamps stay in insertion order
+  EXPECT_LONGS_EQUAL(20, index.lower_bound(2.0)->second);
+  EXPECT_LONGS_EQUAL(30, index.upper_bound(2.0)->second);
+  EXPECT_LONGS_EQUAL(21, (index.upper_bound(2.0) - 1)->second);
+
+  // Erase from the middle, and ignore absent keys
+  index.erase(2.0, 20);
+  index.erase(2.0, 99);
+  LONGS_EQUAL(4, index.size());
+  EXPECT_LONGS_EQUAL(21, index.lower_bound(2.0)->second);
+
+  // Expire old keys
+  index.eraseBefore(2.0);
+  LONGS_EQUAL(2, index.size());
+  EXPECT_LONGS_EQUAL(21, index.begin()->second);
+  index.eraseBefore(10.0);
+  EXPECT(index.empty());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -0,0 +1,133 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testConcurrentFilteringAndSmoothingRuntime.cpp
+ * @brief   Unit tests for the threaded Concurrent Filtering and Smoothing runtime
+ * @author  agent
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothingRuntime.h>
+#include <gtsam_unstable/nonlinear/ConcurrentBatchFilter.h>
+#include <gtsam_unstable/nonlinear/ConcurrentBatchSmoother.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <CppUnitLite/TestHarness.h>
+
+#include <stdexcept>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+const Pose3 poseOdometry( Rot3::RzRyRx(Vector3(0.05, 0.10, -0.75)), Point3(1.0, -0.25, 0.10) );
+const Pose3 poseError( Rot3::RzRyRx(Vector3(0.01, 0.02, -0.1)), Point3(0.05, -0.05, 0.02) );
+
+const SharedDiagonal noisePrior = noiseModel::Isotropic::Sigma(6, 0.10);
+const SharedDiagonal noiseOdometery = noiseModel::Diagonal::Sigmas((Vector(6) << 0.1, 0.1, 0.1, 0.5, 0.5, 0.5).finished());
+
+// Add pose i to the filter, moving pose i-3 to the smoother
+void updateFilter(ConcurrentBatchFilter& filter, Key i) {
+  NonlinearFactorGraph newFactors;
+  Values newValues;
+  if (i == 0) {
+    newFactors.push_back(PriorFactor<Pose3>(0, Pose3(), noisePrior));
+    newValues.insert(0, poseError);
+  } else {
+    newFactors.push_back(BetweenFactor<Pose3>(i - 1, i, poseOdometry, noiseOdometery));
+    newValues.insert(i, filter.calculateEstimate<Pose3>(i - 1).compose(poseOdometry).compose(poseError));
+  }
+  FastList<Key> keysToMove;
+  if (i >= 3)
+    keysToMove.push_back(i - 3);
+  filter.update(newFactors, newValues, keysToMove);
+}
+
+} // namespace
+
+/* ************************************************************************* */
+TEST( ConcurrentFilteringAndSmoothingRuntime, synchronize )
+{
+  // The runtime synchronizes exactly as updating the smoother and calling
+  // synchronize(filter, smoother) in turn
+  ConcurrentBatchFilter expectedFilter, actualFilter;
+  ConcurrentBatchSmoother expectedSmoother, actualSmoother;
+  {
+    ConcurrentFilteringAndSmoothingRuntime runtime(actualFilter, actualSmoother);
+    for (Key i = 0; i < 10; ++i) {
+      updateFilter(expectedFilter, i);
+      expectedSmoother.update();
+      synchronize(expectedFilter, expectedSmoother);
+
+      updateFilter(actualFilter, i);
+      runtime.synchronize();
+      EXPECT(assert_equal(expectedFilter.calculateEstimate(), actualFilter.calculateEstimate(), 1e-9));
+    }
+    // Stopping updates the smoother with the factors of the last synchronization
+    runtime.stop();
+    expectedSmoother.update();
+    EXPECT_LONGS_EQUAL(10, runtime.statistics().synchronizations);
+    EXPECT_LONGS_EQUAL(10, runtime.statistics().smootherUpdates);
+  }
+  EXPECT(assert_equal(expectedSmoother.calculateEstimate(), actualSmoother.calculateEstimate(), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST( ConcurrentFilteringAndSmoothingRuntime, synchronizeIfReady )
+{
+  // Keep updating the filter, synchronizing whenever the smoother is ready
+  ConcurrentBatchFilter filter;
+  ConcurrentBatchSmoother smoother;
+  ConcurrentFilteringAndSmoothingRuntime runtime(filter, smoother);
+  size_t synchronizations = 0;
+  for (Key i = 0; i < 20; ++i) {
+    updateFilter(filter, i);
+    if (runtime.synchronizeIfReady())
+      ++synchronizations;
+  }
+  runtime.synchronize();
+  ++synchronizations;
+  runtime.stop();
+
+  // After stopping, the smoother does not publish anymore
+  EXPECT(!runtime.synchronizeIfReady());
+  runtime.synchronize();
+  EXPECT_LONGS_EQUAL(synchronizations, runtime.statistics().synchronizations);
+
+  // All old poses moved to the smoother, and are close to the ground truth
+  const Values estimate = smoother.calculateEstimate();
+  EXPECT(estimate.exists(0));
+  Pose3 expected;
+  for (Key i = 0; i < 17 && estimate.exists(i); ++i) {
+    EXPECT(assert_equal(expected, estimate.at<Pose3>(i), 1e-2));
+    expected = expected.compose(poseOdometry);
+  }
+}
+
+/* ************************************************************************* */
+TEST( ConcurrentFilteringAndSmoothingRuntime, error )
+{
+  // Exceptions thrown while updating the smoother surface in the filter's thread
+  ConcurrentBatchFilter filter;
+  ConcurrentBatchSmoother smoother;
+  ConcurrentFilteringAndSmoothingRuntime runtime(filter, smoother,
+      []() { throw std::runtime_error("smoother failed"); });
+  updateFilter(filter, 0);
+  runtime.synchronize();
+  CHECK_EXCEPTION(runtime.synchronize(), std::runtime_error);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
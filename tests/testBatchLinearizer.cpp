@@ -0,0 +1,153 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testBatchLinearizer.cpp
+ * @brief   Unit tests for BatchLinearizer and BetweenFactorKernel
+ * @author  agent
+ */
+
+#include <gtsam/nonlinear/BatchLinearizer.h>
+#include <gtsam/slam/BetweenFactorKernel.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/make_shared.hpp>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// A BetweenFactor that is not handled by the BetweenFactor kernel
+class ScaledBetweenFactor: public BetweenFactor<Pose2> {
+public:
+  ScaledBetweenFactor(Key key1, Key key2, const Pose2& measured,
+      const SharedNoiseModel& model) :
+      BetweenFactor<Pose2>(key1, key2, measured, model) {
+  }
+  Vector evaluateError(const Pose2& p1, const Pose2& p2,
+      boost::optional<Matrix&> H1 = boost::none,
+      boost::optional<Matrix&> H2 = boost::none) const {
+    const Vector e = BetweenFactor<Pose2>::evaluateError(p1, p2, H1, H2);
+    if (H1) *H1 *= 2.0;
+    if (H2) *H2 *= 2.0;
+    return 2.0 * e;
+  }
+};
+
+/* ************************************************************************* */
+// A BetweenFactor that is only active while its first pose is at x < 1.5
+class GatedBetweenFactor: public BetweenFactor<Pose2> {
+public:
+  GatedBetweenFactor(Key key1, Key key2, const Pose2& measured,
+      const SharedNoiseModel& model) :
+      BetweenFactor<Pose2>(key1, key2, measured, model) {
+  }
+  bool active(const Values& values) const {
+    return values.at<Pose2>(key1()).x() < 1.5;
+  }
+};
+
+/* ************************************************************************* */
+TEST(BatchLinearizer, Pose2) {
+  NonlinearFactorGraph graph;
+  Values values;
+  const SharedNoiseModel diagonal = noiseModel::Diagonal::Sigmas(
+      Vector3(0.1, 0.2, 0.05));
+  const SharedNoiseModel robust = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(0.1), diagonal);
+  const SharedNoiseModel constrained = noiseModel::Constrained::MixedSigmas(
+      Vector3(0.1, 0.0, 0.05));
+  for (size_t i = 0; i < 6; ++i)
+    values.insert(X(i), Pose2(0.9 * i, 0.1 * i * i, 0.2 * i));
+  graph.push_back(PriorFactor<Pose2>(X(0), Pose2(), diagonal));
+  for (size_t i = 0; i + 1 < 6; ++i)
+    graph.push_back(BetweenFactor<Pose2>(X(i), X(i + 1), Pose2(1.0, 0.0, 0.1),
+        i % 3 == 0 ? diagonal : i % 3 == 1 ? robust : constrained));
+  graph.push_back(NonlinearFactor::shared_ptr());
+  graph.push_back(ScaledBetweenFactor(X(0), X(5), Pose2(4.0, 1.0, 1.0),
+      diagonal));
+
+  BatchLinearizer linearizer;
+  linearizer.add<BetweenFactor<Pose2> >(
+      boost::make_shared<BetweenFactorKernel<Pose2> >());
+  LONGS_EQUAL(1, linearizer.nrKernels());
+  EXPECT(linearizer.hasKernel(*graph[1]));
+  EXPECT(!linearizer.hasKernel(*graph[0]));
+  EXPECT(!linearizer.hasKernel(*graph.back()));
+
+  const GaussianFactorGraph expected = *graph.linearize(values);
+  const GaussianFactorGraph actual = *linearizer.linearize(graph, values);
+  EXPECT(!actual[6]);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(BatchLinearizer, Pose3) {
+  NonlinearFactorGraph graph;
+  Values values;
+  Matrix6 information = Matrix6::Identity() * 100.0;
+  information(0, 4) = information(4, 0) = 5.0;
+  const SharedNoiseModel gaussian = noiseModel::Gaussian::Information(
+      information);
+  for (size_t i = 0; i < 5; ++i)
+    values.insert(X(i), Pose3(Rot3::RzRyRx(0.1 * i, -0.2 * i, 0.3),
+        Point3(1.0 * i, 0.5, -0.1 * i)));
+  for (size_t i = 0; i + 1 < 5; ++i)
+    graph.emplace_shared<BetweenFactor<Pose3> >(X(i), X(i + 1),
+        Pose3(Rot3::Yaw(0.1), Point3(1.0, 0.0, 0.0)), gaussian);
+
+  BatchLinearizer linearizer;
+  linearizer.add<BetweenFactor<Pose3> >(
+      boost::make_shared<BetweenFactorKernel<Pose3> >());
+  EXPECT(assert_equal(*graph.linearize(values),
+      *linearizer.linearize(graph, values), 1e-9));
+
+  // Without kernels everything is linearized one by one
+  EXPECT(assert_equal(*graph.linearize(values),
+      *BatchLinearizer().linearize(graph, values), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(BatchLinearizer, inactive) {
+  NonlinearFactorGraph graph;
+  Values values;
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(3, 0.1);
+  for (size_t i = 0; i < 5; ++i)
+    values.insert(X(i), Pose2(0.9 * i, 0.1 * i, 0.2 * i));
+  for (size_t i = 0; i + 1 < 5; ++i)
+    graph.emplace_shared<GatedBetweenFactor>(X(i), X(i + 1),
+        Pose2(1.0, 0.0, 0.1), model);
+
+  // The kernel can also be registered for a derived factor with the same error
+  BatchLinearizer linearizer;
+  linearizer.add<GatedBetweenFactor>(
+      boost::make_shared<BetweenFactorKernel<Pose2> >());
+
+  const GaussianFactorGraph expected = *graph.linearize(values);
+  const GaussianFactorGraph actual = *linearizer.linearize(graph, values);
+  EXPECT(actual[0] && actual[1]);
+  EXPECT(!actual[2] && !actual[3]);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
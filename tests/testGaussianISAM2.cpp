@@ -818,6 +818,89 @@ TEST(ISAM2, calculate_nnz)
   EXPECT_LONGS_EQUAL(expected, actual);
 }
 
+/* ************************************************************************* */
+// Linear chain with skip edges, run through a sliding-window ISAM2.  Because
+// the problem is linear, marginalization is exact and the newest estimate has
+// to agree with a batch solve over the whole history.
+static void runSlidingWindowChain(const ISAM2Params& params, size_t nrSteps,
+                                  ISAM2* isam, NonlinearFactorGraph* fullGraph,
+                                  Values* fullValues) {
+  const SharedNoiseModel noise = noiseModel::Isotropic::Sigma(2, 0.1);
+  for (size_t i = 0; i < nrSteps; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    newValues.insert(i, Point2(i, 0.0));
+    if (i == 0) {
+      newFactors += PriorFactor<Point2>(0, Point2(0, 0), noise);
+    } else {
+      newFactors += BetweenFactor<Point2>(
+          i - 1, i, Point2(1.0 + 0.01 * (i % 3), 0.02 * (i % 2)), noise);
+      if (i > 1)
+        newFactors += BetweenFactor<Point2>(i - 2, i,
+                                            Point2(2.0, 0.01 * (i % 4)), noise);
+    }
+    fullGraph->push_back(newFactors);
+    fullValues->insert(newValues);
+
+    ISAM2UpdateParams updateParams;
+    updateParams.newKeyTimestamps = FastMap<Key, double>();
+    (*updateParams.newKeyTimestamps)[i] = 0.1 * i;
+    isam->update(newFactors, newValues, updateParams);
+  }
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, slidingWindowCountLag) {
+  ISAM2Params params;
+  params.slidingWindowMode = ISAM2Params::COUNT_LAG;
+  params.slidingWindowLag = 5;
+  ISAM2 isam(params);
+  NonlinearFactorGraph fullGraph;
+  Values fullValues;
+  runSlidingWindowChain(params, 40, &isam, &fullGraph, &fullValues);
+
+  // Only the 5 most recent variables remain
+  const Values estimate = isam.calculateBestEstimate();
+  EXPECT_LONGS_EQUAL(5, estimate.size());
+  for (Key key = 35; key < 40; ++key) EXPECT(estimate.exists(key));
+  EXPECT_LONGS_EQUAL(5, isam.getKeyTimestamps().size());
+  EXPECT(isam.params().findUnusedFactorSlots);
+
+  // Factor slots are reused, so the graph does not grow with the history
+  EXPECT(isam.getFactorsUnsafe().size() < 20);
+
+  // Compare with batch
+  const Values expected =
+      fullValues.retract(fullGraph.linearize(fullValues)->optimize());
+  EXPECT(assert_equal(expected.at<Point2>(39), estimate.at<Point2>(39), 1e-6));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, slidingWindowTimeLagBatched) {
+  ISAM2Params params;
+  params.slidingWindowMode = ISAM2Params::TIME_LAG;
+  params.slidingWindowLag = 0.5;
+  params.slidingWindowBatchSize = 3;
+  ISAM2 isam(params);
+  NonlinearFactorGraph fullGraph;
+  Values fullValues;
+  runSlidingWindowChain(params, 30, &isam, &fullGraph, &fullValues);
+
+  // Keys older than 2.9 - 0.5 have left the window, at most 2 of them may be
+  // waiting for a full batch
+  const FastMap<Key, double>& timestamps = isam.getKeyTimestamps();
+  EXPECT(timestamps.size() >= 6 && timestamps.size() <= 8);
+  for (const auto& key_timestamp : timestamps)
+    EXPECT(key_timestamp.second >= 2.9 - 0.5 - 0.3 - 1e-9);
+  EXPECT_LONGS_EQUAL(timestamps.size(),
+                     isam.getLinearizationPoint().size());
+
+  const Values expected =
+      fullValues.retract(fullGraph.linearize(fullValues)->optimize());
+  EXPECT(assert_equal(expected.at<Point2>(29),
+                      isam.calculateBestEstimate().at<Point2>(29), 1e-6));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
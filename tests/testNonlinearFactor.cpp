@@ -30,8 +30,11 @@
 #include <tests/smallExample.h>
 #include <tests/simulated2D.h>
 #include <gtsam/linear/GaussianFactor.h>
+#include <gtsam/linear/linearExceptions.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
 
 using namespace std;
 using namespace gtsam;
@@ -233,6 +236,68 @@ TEST( NonlinearFactor, linearize_constraint2 )
   CHECK(assert_equal((const GaussianFactor&)expected, *actual));
 }
 
+/* ************************************************************************* */
+// Linearize by whitening the Jacobians one by one, as NoiseModelFactor used to
+static GaussianFactor::shared_ptr linearizeByTerms(
+    const NoiseModelFactor& factor, const Values& values) {
+  vector<Matrix> A(factor.size());
+  Vector b = -factor.unwhitenedError(values, A);
+  factor.noiseModel()->WhitenSystem(A, b);
+  vector<pair<Key, Matrix> > terms;
+  for (size_t j = 0; j < factor.size(); ++j)
+    terms.push_back(make_pair(factor.keys()[j], A[j]));
+  return boost::make_shared<JacobianFactor>(terms, b);
+}
+
+/* ************************************************************************* */
+TEST( NonlinearFactor, linearize_inPlace )
+{
+  Values values;
+  values.insert(X(1), Pose2(1.0, 2.0, 0.3));
+  values.insert(X(2), Pose2(2.0, 2.5, 0.1));
+  const Pose2 measured(0.9, 0.4, -0.1);
+
+  Matrix3 cov;
+  cov << 0.1, 0.02, 0.0, 0.02, 0.2, 0.01, 0.0, 0.01, 0.05;
+  vector<SharedNoiseModel> models;
+  models.push_back(noiseModel::Gaussian::Covariance(cov));
+  models.push_back(noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.05)));
+  models.push_back(noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(0.1),
+      noiseModel::Isotropic::Sigma(3, 0.1)));
+
+  for (const SharedNoiseModel& model : models) {
+    BetweenFactor<Pose2> factor(X(1), X(2), measured, model);
+    EXPECT(assert_equal(*linearizeByTerms(factor, values),
+        *factor.linearize(values), 1e-9));
+  }
+
+  simulated2D::Prior prior(Point2(1.0, -1.0), noiseModel::Unit::Create(2), X(3));
+  values.insert(X(3), Point2(1.0, 2.0));
+  EXPECT(assert_equal(*linearizeByTerms(prior, values), *prior.linearize(values)));
+}
+
+/* ************************************************************************* */
+// A factor that forgets to set its Jacobian
+class ForgetfulFactor : public NoiseModelFactor1<Point2> {
+public:
+  ForgetfulFactor(Key key) :
+      NoiseModelFactor1<Point2>(noiseModel::Unit::Create(2), key) {
+  }
+  virtual Vector evaluateError(const Point2& p,
+      boost::optional<Matrix&> H = boost::none) const {
+    return p;
+  }
+};
+
+/* ************************************************************************* */
+TEST( NonlinearFactor, linearize_jacobianNotSet )
+{
+  Values values;
+  values.insert(X(1), Point2(1.0, 2.0));
+  CHECK_EXCEPTION(ForgetfulFactor(X(1)).linearize(values), InvalidMatrixBlock);
+}
+
 /* ************************************************************************* */
 class TestFactor4 : public NoiseModelFactor4<double, double, double, double> {
 public:
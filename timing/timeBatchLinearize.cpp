@@ -0,0 +1,96 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeBatchLinearize.cpp
+* @brief   Time linearizing g2o pose graphs one factor at a time versus with
+*          a BatchLinearizer that handles the BetweenFactors in batches.
+* @author  agent
+*/
+
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/BetweenFactorKernel.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/nonlinear/BatchLinearizer.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <boost/make_shared.hpp>
+
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+static void timeDataset(const string& dataset, bool is3D, size_t nrTrials) {
+  NonlinearFactorGraph::shared_ptr graph;
+  Values::shared_ptr initial;
+  boost::tie(graph, initial) = readG2o(findExampleDataFile(dataset), is3D);
+
+  BatchLinearizer linearizer;
+  linearizer.add<BetweenFactor<Pose2> >(
+      boost::make_shared<BetweenFactorKernel<Pose2> >());
+  linearizer.add<BetweenFactor<Pose3> >(
+      boost::make_shared<BetweenFactorKernel<Pose3> >());
+
+  if (!assert_equal(*graph->linearize(*initial),
+      *linearizer.linearize(*graph, *initial), 1e-9))
+    throw runtime_error("BatchLinearizer result differs on " + dataset);
+
+  const double perFactor = bestOf(nrTrials, [&]() {
+    graph->linearize(*initial);
+  });
+  const double batched = bestOf(nrTrials, [&]() {
+    linearizer.linearize(*graph, *initial);
+  });
+  cout << setw(40) << dataset << setw(10) << graph->size() << setw(14)
+      << setprecision(4) << perFactor * 1e3 << setw(14) << batched * 1e3
+      << setw(10) << perFactor / batched << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeBatchLinearize [g2o dataset is3D] [nrTrials]
+  const size_t nrTrials = argc > 3 ? atoi(argv[3]) : 50;
+
+  try {
+    cout << setw(40) << "dataset" << setw(10) << "factors" << setw(14)
+        << "factor[ms]" << setw(14) << "batch[ms]" << setw(10) << "speedup"
+        << endl;
+    if (argc > 2) {
+      timeDataset(argv[1], atoi(argv[2]) != 0, nrTrials);
+    } else {
+      timeDataset("noisyToyGraph.txt", false, nrTrials);
+      timeDataset("pose3example-grid.txt", true, nrTrials);
+    }
+  } catch (std::exception& e) {
+    cout << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
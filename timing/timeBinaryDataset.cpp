@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeBinaryDataset.cpp
+* @brief   Time loading graphs from binary dataset files, against the text
+*          loaders and boost binary archives of the same graphs.
+* @author  agent
+*/
+
+#include <gtsam/slam/BinaryDataset.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/serialization.h>
+
+#include <boost/serialization/export.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+using namespace gtsam;
+
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal, "gtsam_noiseModel_Diagonal");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Gaussian, "gtsam_noiseModel_Gaussian");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic, "gtsam_noiseModel_Isotropic");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Unit, "gtsam_noiseModel_Unit");
+GTSAM_VALUE_EXPORT(gtsam::Pose2);
+GTSAM_VALUE_EXPORT(gtsam::Pose3);
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose2>, "gtsam::BetweenFactorPose2");
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose3>, "gtsam::BetweenFactorPose3");
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+static string readFile(const string& filename) {
+  ifstream is(filename.c_str(), ios::binary);
+  return string(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+}
+
+/* ************************************************************************* */
+static void report(const string& name, const string& method, double time,
+    size_t bytes) {
+  cout << setw(30) << name << setw(14) << method << setw(14)
+      << setprecision(4) << time * 1e3 << setw(14) << bytes / 1024 << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeBinaryDataset [nrTrials]
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 10;
+  const string binaryFile = "timeBinaryDataset.bin";
+  const string archiveFile = "timeBinaryDataset.archive";
+
+  const vector<pair<string, bool> > datasets = { { "w20000.txt", false }, {
+      "sphere2500.txt", true }, { "pose3example-offdiagonal.txt", true } };
+
+  cout << setw(30) << "file" << setw(14) << "method" << setw(14) << "time[ms]"
+      << setw(14) << "size[kB]" << endl;
+  for (const auto& dataset : datasets) {
+    const string filename = findExampleDataFile(dataset.first);
+    const bool is3D = dataset.second;
+    const GraphAndValues graphAndValues = readG2o(filename, is3D);
+    const NonlinearFactorGraph& graph = *graphAndValues.first;
+    const Values& values = *graphAndValues.second;
+
+    const auto time = [&](const string& method, const string& file,
+        const function<void()>& f) {
+      const double best = bestOf(nrTrials, f);
+      report(dataset.first, method, best, readFile(file).size());
+    };
+    time("readG2o", filename, [&]() { readG2o(filename, is3D); });
+
+    // Boost binary archives, written to and read from a file
+    string graphArchive;
+    time("boost write", archiveFile, [&]() {
+      graphArchive = serializeBinary(graph, "graph");
+      ofstream(archiveFile.c_str(), ios::binary) << graphArchive
+          << serializeBinary(values, "values");
+    });
+    time("boost read", archiveFile, [&]() {
+      NonlinearFactorGraph g;
+      Values v;
+      const string contents = readFile(archiveFile);
+      deserializeBinary(contents.substr(0, graphArchive.size()), g, "graph");
+      deserializeBinary(contents.substr(graphArchive.size()), v, "values");
+    });
+
+    // Binary dataset file
+    time("binary write", binaryFile,
+        [&]() { writeBinaryGraph(graph, values, binaryFile); });
+    time("binary read", binaryFile, [&]() { readBinaryGraph(binaryFile); });
+    time("binary open", binaryFile, [&]() {
+      const BinaryGraphFile file(binaryFile);
+      file.factor(file.nrFactors() / 2);
+    });
+  }
+  remove(binaryFile.c_str());
+  remove(archiveFile.c_str());
+  return 0;
+}
@@ -0,0 +1,135 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeBinarySerialization.cpp
+* @brief   Time compact binary serialization against boost binary archives,
+*          for graphs, values, linear systems and Bayes trees.
+* @author  agent
+*/
+
+#include <gtsam/slam/BinarySerialization.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/base/serialization.h>
+
+#include <boost/serialization/export.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Constrained, "gtsam_noiseModel_Constrained");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal, "gtsam_noiseModel_Diagonal");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Gaussian, "gtsam_noiseModel_Gaussian");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic, "gtsam_noiseModel_Isotropic");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Unit, "gtsam_noiseModel_Unit");
+BOOST_CLASS_EXPORT_GUID(gtsam::JacobianFactor, "gtsam::JacobianFactor");
+BOOST_CLASS_EXPORT_GUID(gtsam::HessianFactor , "gtsam::HessianFactor");
+BOOST_CLASS_EXPORT_GUID(gtsam::GaussianConditional , "gtsam::GaussianConditional");
+GTSAM_VALUE_EXPORT(gtsam::Pose2);
+GTSAM_VALUE_EXPORT(gtsam::Pose3);
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose2>, "gtsam::BetweenFactorPose2");
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose3>, "gtsam::BetweenFactorPose3");
+BOOST_CLASS_EXPORT_GUID(gtsam::PriorFactor<gtsam::Pose2>, "gtsam::PriorFactorPose2");
+BOOST_CLASS_EXPORT_GUID(gtsam::PriorFactor<gtsam::Pose3>, "gtsam::PriorFactorPose3");
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+// Time writing and reading an object with boost archives and compactly
+template<class T>
+static void timeObject(const string& dataset, const string& name,
+    const T& object, size_t nrTrials) {
+  string archive, compact;
+  const double boostWrite = bestOf(nrTrials,
+      [&]() { archive = serializeBinary(object, name); });
+  const double boostRead = bestOf(nrTrials, [&]() {
+    T actual;
+    deserializeBinary(archive, actual, name);
+  });
+  const double compactWrite = bestOf(nrTrials,
+      [&]() { compact = serializeCompact(object); });
+  const double compactRead = bestOf(nrTrials, [&]() {
+    T actual;
+    deserializeCompact(compact, actual);
+  });
+
+  cout << setw(16) << dataset << setw(22) << name << setprecision(4)
+      << setw(10) << boostWrite * 1e3 << setw(10) << boostRead * 1e3
+      << setw(10) << archive.size() / 1024 << setw(10) << compactWrite * 1e3
+      << setw(10) << compactRead * 1e3 << setw(10) << compact.size() / 1024
+      << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeBinarySerialization [nrTrials]
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 10;
+
+  const vector<pair<string, bool> > datasets = { { "w20000.txt", false }, {
+      "sphere2500.txt", true } };
+
+  cout << "times in ms, sizes in kB" << endl;
+  cout << setw(16) << "file" << setw(22) << "object" << setw(10) << "boost w"
+      << setw(10) << "boost r" << setw(10) << "size" << setw(10) << "compact w"
+      << setw(10) << "compact r" << setw(10) << "size" << endl;
+  for (const auto& dataset : datasets) {
+    const string filename = findExampleDataFile(dataset.first);
+    const GraphAndValues graphAndValues = readG2o(filename, dataset.second);
+    NonlinearFactorGraph& graph = *graphAndValues.first;
+    Values& values = *graphAndValues.second;
+    if (dataset.second) {
+      // sphere2500 has no initial estimate: compose the odometry chain
+      values.insert(0, Pose3());
+      for (const auto& factor : graph) {
+        const auto between = boost::dynamic_pointer_cast<BetweenFactor<Pose3> >(
+            factor);
+        if (between && between->key2() == between->key1() + 1)
+          values.insert(between->key2(),
+              values.at<Pose3>(between->key1()) * between->measured());
+      }
+      graph.emplace_shared<PriorFactor<Pose3> >(0, Pose3(),
+          noiseModel::Unit::Create(6));
+    } else {
+      graph.emplace_shared<PriorFactor<Pose2> >(values.keys().front(), Pose2(),
+          noiseModel::Unit::Create(3));
+    }
+
+    const GaussianFactorGraph linear = *graph.linearize(values);
+    const GaussianBayesTree bayesTree = *linear.eliminateMultifrontal();
+
+    timeObject(dataset.first, "NonlinearFactorGraph", graph, nrTrials);
+    timeObject(dataset.first, "Values", values, nrTrials);
+    timeObject(dataset.first, "GaussianFactorGraph", linear, nrTrials);
+    timeObject(dataset.first, "VectorValues", bayesTree.optimize(), nrTrials);
+    timeObject(dataset.first, "GaussianBayesTree", bayesTree, nrTrials);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeDatasetParsing.cpp
+* @brief   Time the dataset loaders on the files in examples/Data, against
+*          merely reading all fields of a file with an ifstream.
+* @author  agent
+*/
+
+#include <gtsam/slam/dataset.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+// Read all fields of a file with operator>>, as the loaders used to
+static size_t readFields(const string& filename) {
+  ifstream is(filename.c_str());
+  string field;
+  size_t n = 0;
+  while (is >> field)
+    ++n;
+  return n;
+}
+
+/* ************************************************************************* */
+static void report(const string& name, const string& method, double time,
+    double reference) {
+  cout << setw(28) << name << setw(14) << method << setw(14)
+      << setprecision(4) << time * 1e3 << setw(14) << reference * 1e3 << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeDatasetParsing [nrTrials]
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 10;
+
+  typedef function<void(const string&)> Loader;
+  const vector<pair<string, Loader> > loadersTORO = {
+      { "load2D", [](const string& f) { load2D(f); } } };
+  const vector<pair<string, Loader> > loaders2D = {
+      { "readG2o", [](const string& f) { readG2o(f); } },
+      { "streamG2o", [](const string& f) {
+        streamG2o(f, [](const NonlinearFactorGraph&, const Values&) {});
+      } } };
+  const vector<pair<string, Loader> > loaders3D = {
+      { "load3D", [](const string& f) { load3D(f); } },
+      { "streamG2o", [](const string& f) {
+        streamG2o(f, [](const NonlinearFactorGraph&, const Values&) {});
+      } } };
+  const vector<pair<string, Loader> > loadersBAL = {
+      { "readBAL", [](const string& f) { SfmData data; readBAL(f, data); } } };
+  const vector<pair<string, Loader> > loadersBundler = {
+      { "readBundler", [](const string& f) { SfmData data; readBundler(f, data); } } };
+
+  const vector<pair<string, const vector<pair<string, Loader> >*> > datasets = {
+      { "noisyToyGraph.txt", &loaders2D }, { "w100.graph", &loadersTORO },
+      { "victoria_park.txt", &loadersTORO }, { "w20000.txt", &loaders2D },
+      { "pose3example.txt", &loaders3D },
+      { "sphere2500.txt", &loaders3D }, { "sphere_smallnoise.graph", &loaders3D },
+      { "dubrovnik-3-7-pre.txt", &loadersBAL },
+      { "Balbianello.out", &loadersBundler } };
+
+  cout << setw(28) << "file" << setw(14) << "method" << setw(14) << "time[ms]"
+      << setw(14) << "ifstream[ms]" << endl;
+  for (const auto& dataset : datasets) {
+    const string filename = findExampleDataFile(dataset.first);
+    const double reference = bestOf(nrTrials, [&]() { readFields(filename); });
+    for (const auto& loader : *dataset.second)
+      report(dataset.first, loader.first,
+          bestOf(nrTrials, [&]() { loader.second(filename); }), reference);
+  }
+  return 0;
+}
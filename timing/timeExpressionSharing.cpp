@@ -0,0 +1,108 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeExpressionSharing.cpp
+* @brief   Time linearizing projection factors of a camera mounted on a robot,
+*          factor by factor versus with the camera poses they have in common
+*          evaluated once by ExpressionFactorGraph::linearizeShared.
+* @author  agent
+*/
+
+#include <gtsam/slam/expressions.h>
+#include <gtsam/nonlinear/ExpressionFactorGraph.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+// Every pose sees nrPoints landmarks through a camera with a fixed offset.  If
+// rebuild is set, every factor builds the camera pose expression anew.
+static void timeRig(size_t nrPoses, size_t nrPoints, bool rebuild,
+    size_t nrTrials) {
+  const Pose3 bodyTcamera(Rot3::Roll(-M_PI_2), Point3(0.1, 0, 0));
+  const Expression<Cal3_S2> K(Cal3_S2(500, 500, 0, 320, 240));
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(2, 1.0);
+
+  ExpressionFactorGraph graph;
+  Values values;
+  for (size_t j = 0; j < nrPoints; ++j)
+    values.insert(Symbol('l', j), Point3(0.1 * j, 8.0, 0.01 * j));
+  for (size_t i = 0; i < nrPoses; ++i) {
+    const Symbol x('x', i);
+    values.insert(x, Pose3(Rot3::Yaw(0.01 * i), Point3(0.1 * i, 0, 0)));
+    const Pose3_ camera = Pose3_(x) * Pose3_(bodyTcamera);
+    for (size_t j = 0; j < nrPoints; ++j) {
+      const Pose3_ pose = rebuild ? Pose3_(x) * Pose3_(bodyTcamera) : camera;
+      const Point2_ uv = uncalibrate(K,
+          project(transformTo(pose, Point3_(Symbol('l', j)))));
+      graph.addExpressionFactor(uv, Point2(320, 240), model);
+    }
+  }
+
+  if (!assert_equal(*graph.linearize(values), *graph.linearizeShared(values),
+      1e-9))
+    throw runtime_error("linearizeShared result differs");
+  if (graph.nrSharedSubexpressions() != nrPoses)
+    throw runtime_error("linearizeShared did not share the camera poses");
+
+  const double perFactor = bestOf(nrTrials, [&]() {
+    graph.linearize(values);
+  });
+  const double shared = bestOf(nrTrials, [&]() {
+    graph.linearizeShared(values);
+  });
+  cout << setw(10) << nrPoses << setw(10) << nrPoints << setw(10)
+      << (rebuild ? "rebuilt" : "same") << setw(14) << setprecision(4)
+      << perFactor * 1e3 << setw(14) << shared * 1e3 << setw(10)
+      << perFactor / shared << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeExpressionSharing [nrTrials]
+  const size_t nrTrials = argc > 1 ? atoi(argv[1]) : 20;
+
+  cout << setw(10) << "poses" << setw(10) << "points" << setw(10) << "camera"
+      << setw(14) << "factor [ms]" << setw(14) << "shared [ms]" << setw(10)
+      << "speedup" << endl;
+  try {
+    for (bool rebuild : {false, true}) {
+      timeRig(100, 10, rebuild, nrTrials);
+      timeRig(100, 50, rebuild, nrTrials);
+    }
+  } catch (const exception& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
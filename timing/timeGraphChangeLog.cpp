@@ -0,0 +1,133 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeGraphChangeLog.cpp
+* @brief   Time streaming a growing pose graph as a change log, against
+*          serializing the whole graph and values after every update.
+* @author  agent
+*/
+
+#include <gtsam/slam/GraphChangeLog.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/serialization.h>
+
+#include <boost/serialization/export.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace gtsam;
+
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Diagonal, "gtsam_noiseModel_Diagonal");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Gaussian, "gtsam_noiseModel_Gaussian");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Isotropic, "gtsam_noiseModel_Isotropic");
+BOOST_CLASS_EXPORT_GUID(gtsam::noiseModel::Unit, "gtsam_noiseModel_Unit");
+GTSAM_VALUE_EXPORT(gtsam::Pose2);
+BOOST_CLASS_EXPORT_GUID(gtsam::BetweenFactor<gtsam::Pose2>, "gtsam::BetweenFactorPose2");
+BOOST_CLASS_EXPORT_GUID(gtsam::PriorFactor<gtsam::Pose2>, "gtsam::PriorFactorPose2");
+
+typedef chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point start) {
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeGraphChangeLog [nrPoses [reportInterval]]
+  const size_t nrPoses = argc > 1 ? atoi(argv[1]) : 5000;
+  const size_t interval = argc > 2 ? atoi(argv[2]) : 1000;
+
+  // Split w20000 into one change per pose, with the factors it completes, and
+  // the pose itself, initialized by dead reckoning
+  const NonlinearFactorGraph::shared_ptr measurements = readG2o(
+      findExampleDataFile("w20000.txt")).first;
+  vector<GraphChange> changes(nrPoses);
+  changes[0].newFactors.emplace_shared<PriorFactor<Pose2> >(0, Pose2(),
+      noiseModel::Unit::Create(3));
+  changes[0].newTheta.insert(0, Pose2());
+  for (const auto& factor : *measurements) {
+    const auto between = boost::static_pointer_cast<BetweenFactor<Pose2> >(
+        factor);
+    const Key i = max(between->key1(), between->key2());
+    if (i >= nrPoses)
+      continue;
+    changes[i].newFactors.push_back(between);
+    if (between->key1() + 1 == i && between->key2() == i)
+      changes[i].newTheta.insert(i,
+          changes[i - 1].newTheta.at<Pose2>(i - 1) * between->measured());
+  }
+
+  // Front end: append a change log record, or serialize everything
+  cout << "times in ms, sizes in kB, per update" << endl;
+  cout << setw(8) << "poses" << setw(12) << "log write" << setw(10) << "size"
+      << setw(12) << "boost" << setw(10) << "size" << setw(12) << "compact"
+      << setw(10) << "size" << endl;
+  stringstream log;
+  ChangeLogWriter writer(log);
+  NonlinearFactorGraph graph;
+  Values values;
+  double logTime = 0;
+  size_t logBytes = writer.nrBytes();
+  for (size_t i = 0; i < nrPoses; i++) {
+    const Clock::time_point start = Clock::now();
+    writer.write(changes[i]);
+    logTime += seconds(start);
+    graph.push_back(changes[i].newFactors);
+    values.insert(changes[i].newTheta);
+
+    if ((i + 1) % interval == 0) {
+      Clock::time_point start = Clock::now();
+      const size_t boostBytes = serializeBinary(graph).size()
+          + serializeBinary(values).size();
+      const double boostTime = seconds(start);
+      start = Clock::now();
+      const size_t compactBytes = serializeCompact(graph).size()
+          + serializeCompact(values).size();
+      const double compactTime = seconds(start);
+      cout << setw(8) << i + 1 << setprecision(4) << setw(12)
+          << logTime / interval * 1e3 << setw(10)
+          << (writer.nrBytes() - logBytes) / interval / 1024.0 << setw(12)
+          << boostTime * 1e3 << setw(10) << boostBytes / 1024 << setw(12)
+          << compactTime * 1e3 << setw(10) << compactBytes / 1024 << endl;
+      logTime = 0;
+      logBytes = writer.nrBytes();
+    }
+  }
+
+  // Back end: read the log, and replay it into ISAM2
+  Clock::time_point start = Clock::now();
+  {
+    stringstream copy(log.str());
+    ChangeLogReader reader(copy);
+    GraphChange change;
+    while (reader.read(change))
+      ;
+  }
+  const double readTime = seconds(start);
+  start = Clock::now();
+  ChangeLogReader reader(log);
+  ISAM2Params params; // Dogleg, as Gauss-Newton diverges from dead reckoning
+  params.optimizationParams = ISAM2DoglegParams();
+  ISAM2 isam(params);
+  replayChangeLog(reader, isam);
+  const double replayTime = seconds(start);
+  cout << "reading " << nrPoses << " records: " << readTime * 1e3
+      << " ms, replaying them into ISAM2: " << replayTime * 1e3 << " ms"
+      << endl;
+  return 0;
+}
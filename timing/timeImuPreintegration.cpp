@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeImuPreintegration.cpp
+* @brief   Time IMU preintegration, one measurement at a time versus in a batch,
+*          and the mean propagation of the tangent and manifold variants.
+* @author  agent
+*/
+
+#include <gtsam/navigation/ImuFactor.h>
+#include <gtsam/navigation/ManifoldPreintegration.h>
+#include <gtsam/navigation/TangentPreintegration.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Best time of nrTrials calls to f, in seconds
+template<class F>
+static double bestOf(size_t nrTrials, F f) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    f();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+static void report(const string& name, double time, size_t n) {
+  cout << setw(28) << name << setw(14) << setprecision(4) << time * 1e3
+      << setw(14) << time * 1e9 / n << endl;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeImuPreintegration [nrMeasurements] [nrTrials]
+  const size_t n = argc > 1 ? atoi(argv[1]) : 100000;
+  const size_t nrTrials = argc > 2 ? atoi(argv[2]) : 10;
+
+  // A 200Hz IMU on a vehicle that turns and accelerates
+  const double dt = 0.005;
+  Matrix accs(3, n), omegas(3, n);
+  for (size_t j = 0; j < n; ++j) {
+    const double t = j * dt;
+    accs.col(j) << 0.5 * sin(t), 0.2 * cos(0.5 * t), -9.81 + 0.1 * sin(2 * t);
+    omegas.col(j) << 0.01 * cos(t), 0.02 * sin(0.3 * t), 0.1;
+  }
+
+  auto p = PreintegrationParams::MakeSharedU(9.81);
+  p->accelerometerCovariance = 1e-4 * I_3x3;
+  p->gyroscopeCovariance = 1e-6 * I_3x3;
+  p->integrationCovariance = 1e-8 * I_3x3;
+
+  cout << setw(28) << "method" << setw(14) << "time[ms]" << setw(14)
+      << "per sample[ns]" << endl;
+
+  PreintegratedImuMeasurements single(p), batch(p);
+  report("integrateMeasurement", bestOf(nrTrials, [&]() {
+    single.resetIntegration();
+    for (size_t j = 0; j < n; ++j)
+      single.integrateMeasurement(accs.col(j), omegas.col(j), dt);
+  }), n);
+  report("integrateMeasurements", bestOf(nrTrials, [&]() {
+    batch.resetIntegration();
+    batch.integrateMeasurements(accs, omegas, dt);
+  }), n);
+  if (!single.equals(batch, 1e-9))
+    cout << "Warning: batch and single preintegration differ" << endl;
+
+  // Mean propagation and Jacobians only, without covariance propagation
+  Matrix9 A;
+  Matrix93 B, C;
+  TangentPreintegration tangent(p);
+  report("TangentPreintegration", bestOf(nrTrials, [&]() {
+    tangent.resetIntegration();
+    for (size_t j = 0; j < n; ++j)
+      tangent.update(accs.col(j), omegas.col(j), dt, &A, &B, &C);
+  }), n);
+  ManifoldPreintegration manifold(p);
+  report("ManifoldPreintegration", bestOf(nrTrials, [&]() {
+    manifold.resetIntegration();
+    for (size_t j = 0; j < n; ++j)
+      manifold.update(accs.col(j), omegas.col(j), dt, &A, &B, &C);
+  }), n);
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeParallelOrdering.cpp
+* @brief   Compare orderings for parallel multifrontal elimination: the
+*          speedup predicted from the shape of the Bayes tree, and the
+*          speedup actually measured with TBB.
+* @author  agent
+*/
+
+#include <gtsam/base/timing.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/inference/Ordering.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Dense partial Cholesky flop count of each clique, accumulated over the tree
+struct TreeWork {
+  double total = 0.0;  // Work of all cliques, i.e. the serial time
+  double criticalPath = 0.0;  // Heaviest root-to-leaf path, i.e. time with infinite threads
+  size_t height = 0;  // Cliques on the longest root-to-leaf path
+};
+
+static void accumulate(const GaussianBayesTree::sharedClique& clique,
+    TreeWork& work, double& path, size_t& height) {
+  const double f = (double) clique->conditional()->get_R().rows();
+  const double s = (double) clique->conditional()->get_S().cols();
+  const double mine = f * f * f / 3.0 + f * f * s + f * s * s;
+  work.total += mine;
+  double childPath = 0.0;
+  size_t childHeight = 0;
+  for (const GaussianBayesTree::sharedClique& child : clique->children) {
+    double p = 0.0;
+    size_t h = 0;
+    accumulate(child, work, p, h);
+    childPath = max(childPath, p);
+    childHeight = max(childHeight, h);
+  }
+  path = mine + childPath;
+  height = 1 + childHeight;
+}
+
+static TreeWork treeWork(const GaussianBayesTree& bayesTree) {
+  TreeWork work;
+  for (const GaussianBayesTree::sharedClique& root : bayesTree.roots()) {
+    double path = 0.0;
+    size_t height = 0;
+    accumulate(root, work, path, height);
+    work.criticalPath = max(work.criticalPath, path);
+    work.height = max(work.height, height);
+  }
+  return work;
+}
+
+/* ************************************************************************* */
+// Best time of nrTrials multifrontal eliminations, in seconds
+static double timeElimination(const GaussianFactorGraph& graph,
+    const Ordering& ordering, size_t nrTrials) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    graph.eliminateMultifrontal(ordering, EliminateCholesky);
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeParallelOrdering [2D dataset] [nrThreads] [nrTrials]
+  const string dataset = argc > 1 ? argv[1] : "w20000";
+  const int nrThreads = argc > 2 ? atoi(argv[2]) : 4;
+  const size_t nrTrials = argc > 3 ? atoi(argv[3]) : 5;
+
+  try {
+    cout << "Loading " << dataset << "..." << endl;
+    NonlinearFactorGraph::shared_ptr graph;
+    Values::shared_ptr initial;
+    boost::tie(graph, initial) = load2D(findExampleDataFile(dataset));
+    const Key firstKey = initial->begin()->key;
+    graph->push_back(PriorFactor<Pose2>(firstKey, initial->at<Pose2>(firstKey),
+        noiseModel::Isotropic::Sigma(3, 1e-3)));
+    const GaussianFactorGraph::shared_ptr linear = graph->linearize(*initial);
+    const FlatVariableIndex variableIndex(*linear);
+
+    vector<pair<string, Ordering::OrderingType> > types;
+    types.push_back(make_pair("COLAMD", Ordering::COLAMD));
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+    types.push_back(make_pair("METIS", Ordering::METIS));
+#endif
+    types.push_back(make_pair("NESTED_DISSECTION", Ordering::NESTED_DISSECTION));
+
+    cout << setw(18) << "ordering" << setw(10) << "height" << setw(12)
+        << "pred(inf)" << setw(10) << "pred(" << nrThreads << ")" << setw(12)
+        << "serial[s]" << setw(12) << "parallel[s]" << setw(10) << "actual"
+        << endl;
+    for (const auto& name_type : types) {
+      Ordering ordering;
+      switch (name_type.second) {
+      case Ordering::COLAMD:
+        ordering = Ordering::Colamd(variableIndex);
+        break;
+      case Ordering::METIS:
+        ordering = Ordering::Metis(variableIndex);
+        break;
+      default:
+        ordering = Ordering::NestedDissection(variableIndex);
+        break;
+      }
+
+      // Predicted speedup, from Brent's bound T_p >= max(T_1 / p, T_inf)
+      const TreeWork work = treeWork(
+          *linear->eliminateMultifrontal(ordering, EliminateCholesky));
+      const double predictedInf = work.total / work.criticalPath;
+      const double predicted = work.total
+          / max(work.total / nrThreads, work.criticalPath);
+
+      // Actual speedup
+      double serial, parallel;
+#ifdef GTSAM_USE_TBB
+      {
+        tbb::task_scheduler_init init(1);
+        serial = timeElimination(*linear, ordering, nrTrials);
+      }
+      {
+        tbb::task_scheduler_init init(nrThreads);
+        parallel = timeElimination(*linear, ordering, nrTrials);
+      }
+#else
+      serial = parallel = timeElimination(*linear, ordering, nrTrials);
+#endif
+
+      cout << setw(18) << name_type.first << setw(10) << work.height
+          << setw(12) << setprecision(3) << predictedInf << setw(12)
+          << predicted << setw(12) << serial << setw(12) << parallel
+          << setw(10) << serial / parallel << endl;
+    }
+#ifndef GTSAM_USE_TBB
+    cout << "GTSAM was built without TBB, actual speedup is always 1" << endl;
+#endif
+  } catch (std::exception& e) {
+    cout << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -30,6 +30,12 @@ using namespace gtsam;
   STATEMENT; \
   gttoc_(TITLE);
 
+// One batch call on n elements
+#define BATCH(TITLE,STATEMENT) \
+  gttic_(TITLE); \
+  STATEMENT; \
+  gttoc_(TITLE);
+
 int main()
 {
   int n = 5000000;
@@ -48,6 +54,20 @@ int main()
   TEST(between_derivatives, T.between(T2,H1,H2))
   TEST(Logmap, Pose3::Logmap(T.between(T2)))
 
+  // Batch versions on fewer, random twists, so they fit in memory
+  n = 100000;
+  cout << "NOTE:  Batch times are reported for " << n << " elements" << endl;
+  const Matrix xis = 0.5 * Matrix::Random(6, n);
+  vector<Pose3> poses;
+  Matrix logs;
+  Vector6 xi;
+  TEST(Expmap_one_by_one, xi = xis.col(i); Pose3::Expmap(xi))
+  BATCH(ExpmapBatch, Pose3::ExpmapBatch(xis, poses))
+  TEST(Logmap_one_by_one, Pose3::Logmap(poses[i]))
+  BATCH(LogmapBatch, Pose3::LogmapBatch(poses, logs))
+  TEST(Retract_one_by_one, xi = xis.col(i); Pose3::Retract(xi))
+  BATCH(RetractBatch, Pose3::RetractBatch(xis, poses))
+
   // Print timings
   tictoc_print_();
 
@@ -19,6 +19,7 @@
 #include <iostream>
 
 #include <gtsam/geometry/Rot3.h>
+#include <gtsam/geometry/SO3.h>
 
 using namespace std;
 using namespace gtsam;
@@ -32,6 +33,16 @@ using namespace gtsam;
   cout << 1000 * seconds << " milliseconds" << endl;                  \
   cout << (1e9 * seconds / static_cast<double>(n)) << " nanosecs/call" << endl;
 
+// Time one batch call on n elements, reported per element
+#define BATCH(TITLE, STATEMENT)                                       \
+  cout << endl << TITLE << endl;                                      \
+  timeLog = clock();                                                  \
+  STATEMENT;                                                          \
+  timeLog2 = clock();                                                 \
+  seconds = static_cast<double>(timeLog2 - timeLog) / CLOCKS_PER_SEC; \
+  cout << 1000 * seconds << " milliseconds" << endl;                  \
+  cout << (1e9 * seconds / static_cast<double>(n)) << " nanosecs/element" << endl;
+
 int main() {
   int n = 100000;
   clock_t timeLog, timeLog2;
@@ -51,5 +62,19 @@ int main() {
   TEST("Slow rotation matrix", Rot3::Rz(z) * Rot3::Ry(y) * Rot3::Rx(x))
   TEST("Fast Rotation matrix", Rot3::RzRyRx(x, y, z))
 
+  // Batch versions on n random tangent vectors
+  const Matrix omegas = Matrix::Random(3, n);
+  Matrix matrices, H, logs;
+  vector<Rot3> rotations;
+  Vector3 omega;
+  Matrix3 H3;
+  TEST("Expmap, one by one", omega = omegas.col(i); SO3::Expmap(omega))
+  BATCH("ExpmapBatch", so3::ExpmapBatch(omegas, matrices))
+  TEST("Expmap with derivative, one by one",
+       omega = omegas.col(i); SO3::Expmap(omega, H3))
+  BATCH("ExpmapBatch with derivative", so3::ExpmapBatch(omegas, matrices, H))
+  BATCH("LogmapBatch", so3::LogmapBatch(matrices, logs))
+  BATCH("Rot3::RetractBatch", Rot3::RetractBatch(omegas, rotations))
+
   return 0;
 }
@@ -13,6 +13,7 @@
 #include <gtsam/slam/RegularImplicitSchurFactor.h>
 #include <gtsam/geometry/Cal3Bundler.h>
 #include <gtsam/geometry/PinholePose.h>
+#include <gtsam/geometry/CameraSet.h>
 
 #include <boost/assign/list_of.hpp>
 #include <boost/assign/std/vector.hpp>
@@ -25,6 +26,7 @@ using namespace gtsam;
 #define SLOW
 #define RAW
 #define HESSIAN
+#define SCHUR
 #define NUM_ITERATIONS 1000
 
 // Create CSV file for results
@@ -116,6 +118,30 @@ void timeAll(size_t m, size_t N) {
   }
 #endif
 
+#ifdef SCHUR
+  { // Schur complement from F, E and b, versus fused from fixed-size blocks
+    typedef CameraSet<CAMERA> Set;
+    gttic_(SchurComplement);
+    for (size_t t = 0; t < N; t++)
+      Set::SchurComplement(Fblocks, E, b);
+    gttoc_(SchurComplement);
+    tictoc_getNode(schurTimer, SchurComplement)
+    os << schurTimer->secs() / NUM_ITERATIONS << ", ";
+
+    typename Set::template SchurBlocks<3> blocks;
+    gttic_(FusedSchur);
+    for (size_t t = 0; t < N; t++) {
+      blocks.reset(m);
+      for (size_t i = 0; i < m; i++)
+        blocks.set(i, Fblocks[i], E.block<2, 3>(2 * i, 0), b.segment<2>(2 * i));
+      Set::SchurComplement(blocks);
+    }
+    gttoc_(FusedSchur);
+    tictoc_getNode(fusedTimer, FusedSchur)
+    os << fusedTimer->secs() / NUM_ITERATIONS << ", ";
+  }
+#endif
+
   os << m << endl;
 
 } // timeAll
@@ -137,6 +163,10 @@ int main(void) {
   os << "RawImplicit,";
   os << "RawJacobianQ,";
   os << "RawJacobianQR,";
+#endif
+#ifdef SCHUR
+  os << "SchurComplement,";
+  os << "FusedSchur,";
 #endif
   os << "m" << endl;
   // define images
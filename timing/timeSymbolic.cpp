@@ -0,0 +1,94 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeSymbolic.cpp
+* @brief   Time the symbolic phase of batch elimination (variable index,
+*          ordering, elimination tree, junction tree) separately from the
+*          numeric phase (multifrontal factorization).
+* @author  agent
+*/
+
+#include <gtsam/base/timing.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianEliminationTree.h>
+#include <gtsam/linear/GaussianJunctionTree.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/FlatVariableIndex.h>
+#include <gtsam/inference/Ordering.h>
+
+using namespace std;
+using namespace gtsam;
+
+int main(int argc, char *argv[]) {
+  // Usage: timeSymbolic [2D dataset] [nrTrials]
+  const string dataset = argc > 1 ? argv[1] : "w20000";
+  const size_t nrTrials = argc > 2 ? atoi(argv[2]) : 10;
+
+  try {
+    cout << "Loading " << dataset << "..." << endl;
+    const string datasetFile = findExampleDataFile(dataset);
+    NonlinearFactorGraph::shared_ptr graph;
+    Values::shared_ptr initial;
+    boost::tie(graph, initial) = load2D(datasetFile);
+    const Key firstKey = initial->begin()->key;
+    graph->push_back(PriorFactor<Pose2>(firstKey, initial->at<Pose2>(firstKey),
+        noiseModel::Isotropic::Sigma(3, 1e-3)));
+    const GaussianFactorGraph::shared_ptr linear = graph->linearize(*initial);
+    cout << linear->size() << " factors, " << initial->size() << " variables" << endl;
+
+    for (size_t trial = 0; trial < nrTrials; ++trial) {
+      gttic_(Symbolic);
+      gttic_(VariableIndex);
+      const VariableIndex variableIndex(*linear);
+      gttoc_(VariableIndex);
+      gttic_(Ordering);
+      const Ordering ordering = Ordering::Colamd(variableIndex);
+      gttoc_(Ordering);
+      gttic_(EliminationTree);
+      const GaussianEliminationTree etree(*linear, variableIndex, ordering);
+      gttoc_(EliminationTree);
+      gttic_(JunctionTree);
+      const GaussianJunctionTree junctionTree(etree);
+      gttoc_(JunctionTree);
+      gttoc_(Symbolic);
+
+      // Same symbolic phase using the flat variable index
+      gttic_(SymbolicFlat);
+      gttic_(FlatVariableIndex);
+      const FlatVariableIndex flatIndex(*linear);
+      gttoc_(FlatVariableIndex);
+      gttic_(FlatOrdering);
+      const Ordering flatOrdering = Ordering::Colamd(flatIndex);
+      gttoc_(FlatOrdering);
+      gttic_(FlatEliminationTree);
+      const GaussianEliminationTree flatEtree(*linear, flatIndex, flatOrdering);
+      gttoc_(FlatEliminationTree);
+      gttoc_(SymbolicFlat);
+
+      gttic_(Numeric);
+      const GaussianBayesTree::shared_ptr bayesTree =
+          junctionTree.eliminate(EliminateCholesky).first;
+      gttoc_(Numeric);
+      tictoc_finishedIteration_();
+    }
+    tictoc_print_();
+  } catch (std::exception& e) {
+    cout << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
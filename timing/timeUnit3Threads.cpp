@@ -0,0 +1,78 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    timeUnit3Threads.cpp
+* @brief   Time linearizing EssentialMatrixFactors on several threads. All
+*          factors share one EssentialMatrix, and hence one cached Unit3 basis.
+* @author  agent
+*/
+
+#include <gtsam/slam/EssentialMatrixFactor.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+// Best time of nrTrials linearizations of graph split over nrThreads, in s
+static double timeThreads(const NonlinearFactorGraph& graph,
+    const Values& values, size_t nrThreads, size_t nrTrials) {
+  double best = numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nrTrials; ++trial) {
+    const auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t t = 0; t < nrThreads; ++t)
+      threads.emplace_back([&, t]() {
+        for (size_t i = t; i < graph.size(); i += nrThreads)
+          graph[i]->linearize(values);
+      });
+    for (thread& th : threads)
+      th.join();
+    const chrono::duration<double> elapsed = chrono::steady_clock::now()
+        - start;
+    best = min(best, elapsed.count());
+  }
+  return best;
+}
+
+/* ************************************************************************* */
+int main(int argc, char *argv[]) {
+  // Usage: timeUnit3Threads [nrFactors] [nrTrials]
+  const size_t nrFactors = argc > 1 ? atoi(argv[1]) : 100000;
+  const size_t nrTrials = argc > 2 ? atoi(argv[2]) : 10;
+
+  const Key key = 1;
+  const SharedNoiseModel model = noiseModel::Isotropic::Sigma(1, 0.01);
+  NonlinearFactorGraph graph;
+  for (size_t i = 0; i < nrFactors; ++i) {
+    const double u = 0.001 * (i % 500), v = 0.002 * (i % 250);
+    graph.emplace_shared<EssentialMatrixFactor>(key, Point2(u, v),
+        Point2(u + 0.1, v - 0.05), model);
+  }
+  Values values;
+  values.insert(key, EssentialMatrix(Rot3::Yaw(0.1), Unit3(1, 0.1, 0)));
+
+  const size_t maxThreads = max(1u, thread::hardware_concurrency());
+  cout << setw(10) << "threads" << setw(14) << "time[ms]" << setw(10)
+      << "speedup" << endl;
+  const double single = timeThreads(graph, values, 1, nrTrials);
+  for (size_t nrThreads = 1; nrThreads <= maxThreads; nrThreads *= 2) {
+    const double time = timeThreads(graph, values, nrThreads, nrTrials);
+    cout << setw(10) << nrThreads << setw(14) << setprecision(4) << time * 1e3
+        << setw(10) << single / time << endl;
+  }
+  return 0;
+}